@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <benchmark/benchmark.h>
+#include <common_robotics_utilities/math.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization.hpp>
+#include <voxelized_geometry_tools/scene_generation.hpp>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+#include <voxelized_geometry_tools/signed_distance_field_generation.hpp>
+
+/// Benchmarks of the hot paths. Every benchmark takes two arguments: the
+/// number of cells per axis of a cubic grid, and the obstacle density as a
+/// percentage of filled cells. Scenes are generated from a fixed seed so runs
+/// are comparable.
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+constexpr double kResolution = 0.1;
+constexpr uint32_t kSeed = 42;
+constexpr size_t kNumQueries = 4096;
+
+/// Registers every combination of grid size and obstacle density.
+void GridSizeAndDensityArguments(benchmark::internal::Benchmark* benchmark)
+{
+  for (const int64_t cells_per_axis : {32, 64, 128})
+  {
+    for (const int64_t density_percent : {1, 10, 30})
+    {
+      benchmark->Args({cells_per_axis, density_percent});
+    }
+  }
+}
+
+/// Fills a cubic map with random axis-aligned boxes until roughly the
+/// requested fraction of cells is filled; the rest is free.
+CollisionMap MakeClutteredMap(const benchmark::State& state)
+{
+  const int64_t cells_per_axis = state.range(0);
+  const double density = static_cast<double>(state.range(1)) / 100.0;
+  const double size = static_cast<double>(cells_per_axis) * kResolution;
+  const GridSizes grid_sizes(kResolution, size, size, size);
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", grid_sizes,
+                   CollisionCell(0.0f));
+  std::mt19937_64 prng(kSeed);
+  const int64_t max_box_cells = std::max(INT64_C(2), cells_per_axis / 8);
+  std::uniform_int_distribution<int64_t> corner_dist(0, cells_per_axis - 1);
+  std::uniform_int_distribution<int64_t> extent_dist(1, max_box_cells);
+  const int64_t target_filled = static_cast<int64_t>(
+      density * static_cast<double>(grid_sizes.TotalCells()));
+  int64_t num_filled = 0;
+  while (num_filled < target_filled)
+  {
+    const GridIndex lower(
+        corner_dist(prng), corner_dist(prng), corner_dist(prng));
+    const GridIndex extent(
+        extent_dist(prng), extent_dist(prng), extent_dist(prng));
+    for (int64_t x_index = lower.X();
+         x_index < std::min(lower.X() + extent.X(), cells_per_axis); x_index++)
+    {
+      for (int64_t y_index = lower.Y();
+           y_index < std::min(lower.Y() + extent.Y(), cells_per_axis);
+           y_index++)
+      {
+        for (int64_t z_index = lower.Z();
+             z_index < std::min(lower.Z() + extent.Z(), cells_per_axis);
+             z_index++)
+        {
+          auto query = map.GetMutable(x_index, y_index, z_index);
+          if (query.Value().Occupancy() < 0.5f)
+          {
+            query.Value().Occupancy() = 1.0f;
+            num_filled++;
+          }
+        }
+      }
+    }
+  }
+  return map;
+}
+
+std::vector<GridIndex> GetFilledIndices(const CollisionMap& map)
+{
+  std::vector<GridIndex> filled;
+  for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+      {
+        if (map.GetImmutable(x_index, y_index, z_index).Value().Occupancy()
+            > 0.5f)
+        {
+          filled.push_back(GridIndex(x_index, y_index, z_index));
+        }
+      }
+    }
+  }
+  return filled;
+}
+
+SignedDistanceField<std::vector<float>> MakeSDF(const CollisionMap& map)
+{
+  return map.ExtractSignedDistanceField(
+      std::numeric_limits<float>::infinity(), false, true, false)
+          .DistanceField();
+}
+
+/// Random query locations strictly inside the grid.
+common_robotics_utilities::math::VectorVector4d MakeQueryLocations(
+    const CollisionMap& map)
+{
+  std::mt19937_64 prng(kSeed);
+  const double margin = kResolution;
+  const double size
+      = static_cast<double>(map.GetNumXCells()) * kResolution - margin;
+  std::uniform_real_distribution<double> location_dist(margin, size);
+  common_robotics_utilities::math::VectorVector4d locations;
+  for (size_t idx = 0; idx < kNumQueries; idx++)
+  {
+    locations.push_back(Eigen::Vector4d(
+        location_dist(prng), location_dist(prng), location_dist(prng), 1.0));
+  }
+  return locations;
+}
+
+void BM_BuildDistanceFieldSerial(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  const std::vector<GridIndex> filled = GetFilledIndices(map);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(
+        signed_distance_field_generation::BuildDistanceFieldSerial(
+            map.GetOriginTransform(), map.GetGridSizes(), filled));
+  }
+}
+BENCHMARK(BM_BuildDistanceFieldSerial)->Apply(GridSizeAndDensityArguments);
+
+void BM_BuildDistanceFieldParallel(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  const std::vector<GridIndex> filled = GetFilledIndices(map);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(
+        signed_distance_field_generation::BuildDistanceFieldParallel(
+            map.GetOriginTransform(), map.GetGridSizes(), filled));
+  }
+}
+BENCHMARK(BM_BuildDistanceFieldParallel)->Apply(GridSizeAndDensityArguments);
+
+void BM_ExtractSignedDistanceField(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(map.ExtractSignedDistanceField(
+        std::numeric_limits<float>::infinity(), false, true, false));
+  }
+}
+BENCHMARK(BM_ExtractSignedDistanceField)->Apply(GridSizeAndDensityArguments);
+
+void BM_ExtractSignedDistanceFieldVirtualBorder(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(map.ExtractSignedDistanceField(
+        std::numeric_limits<float>::infinity(), false, true, true));
+  }
+}
+BENCHMARK(BM_ExtractSignedDistanceFieldVirtualBorder)
+    ->Apply(GridSizeAndDensityArguments);
+
+void BM_EstimateDistance(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  const auto sdf = MakeSDF(map);
+  const auto locations = MakeQueryLocations(map);
+  for (auto _ : state)
+  {
+    for (const Eigen::Vector4d& location : locations)
+    {
+      benchmark::DoNotOptimize(sdf.EstimateDistance4d(location));
+    }
+  }
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(locations.size()));
+}
+BENCHMARK(BM_EstimateDistance)->Apply(GridSizeAndDensityArguments);
+
+void BM_GetCoarseGradient(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  const auto sdf = MakeSDF(map);
+  const auto locations = MakeQueryLocations(map);
+  for (auto _ : state)
+  {
+    for (const Eigen::Vector4d& location : locations)
+    {
+      benchmark::DoNotOptimize(sdf.GetCoarseGradient4d(location, true));
+    }
+  }
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(locations.size()));
+}
+BENCHMARK(BM_GetCoarseGradient)->Apply(GridSizeAndDensityArguments);
+
+void BM_GetFineGradient(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  const auto sdf = MakeSDF(map);
+  const auto locations = MakeQueryLocations(map);
+  for (auto _ : state)
+  {
+    for (const Eigen::Vector4d& location : locations)
+    {
+      benchmark::DoNotOptimize(
+          sdf.GetFineGradient4d(location, kResolution * 0.25));
+    }
+  }
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(locations.size()));
+}
+BENCHMARK(BM_GetFineGradient)->Apply(GridSizeAndDensityArguments);
+
+void BM_GetAutoDiffGradient(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  const auto sdf = MakeSDF(map);
+  const auto locations = MakeQueryLocations(map);
+  for (auto _ : state)
+  {
+    for (const Eigen::Vector4d& location : locations)
+    {
+      benchmark::DoNotOptimize(sdf.GetAutoDiffGradient4d(location));
+    }
+  }
+  state.SetItemsProcessed(
+      state.iterations() * static_cast<int64_t>(locations.size()));
+}
+BENCHMARK(BM_GetAutoDiffGradient)->Apply(GridSizeAndDensityArguments);
+
+void BM_UpdateConnectedComponents(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    CollisionMap working_map = map;
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(working_map.UpdateConnectedComponents());
+  }
+}
+BENCHMARK(BM_UpdateConnectedComponents)->Apply(GridSizeAndDensityArguments);
+
+void BM_ComputeComponentTopology(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    CollisionMap working_map = map;
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(working_map.ComputeComponentTopology(
+        CollisionMap::FILLED_COMPONENTS, false));
+  }
+}
+BENCHMARK(BM_ComputeComponentTopology)->Apply(GridSizeAndDensityArguments);
+
+void BM_ComputeLocalExtremaMap(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  const auto sdf = MakeSDF(map);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(sdf.ComputeLocalExtremaMap());
+  }
+}
+BENCHMARK(BM_ComputeLocalExtremaMap)
+    ->Apply(GridSizeAndDensityArguments)
+    ->Unit(benchmark::kMillisecond);
+
+/// Random clutter scene filling a cubic workspace of the benchmark's grid
+/// size, with one box and one cylinder per density percent.
+scene_generation::Scene MakeClutterScene(const benchmark::State& state)
+{
+  const double size = static_cast<double>(state.range(0)) * kResolution;
+  const int32_t num_objects = static_cast<int32_t>(state.range(1));
+  return scene_generation::MakeRandomClutterScene(
+      Eigen::Vector3d::Constant(size), num_objects, num_objects, size * 0.05,
+      size * 0.25, kSeed);
+}
+
+void BM_RasterizeScene(benchmark::State& state)
+{
+  const double size = static_cast<double>(state.range(0)) * kResolution;
+  const scene_generation::Scene scene = MakeClutterScene(state);
+  const GridSizes grid_sizes(kResolution, size, size, size);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(scene_generation::MakeCollisionMap(
+        scene, Eigen::Isometry3d::Identity(), "world", grid_sizes, false,
+        true));
+  }
+}
+BENCHMARK(BM_RasterizeScene)->Apply(GridSizeAndDensityArguments);
+
+/// Voxelizes a simulated 160x120 depth image of a random clutter scene,
+/// taken from outside the grid, with the CPU backend.
+void BM_CpuVoxelization(benchmark::State& state)
+{
+  const double size = static_cast<double>(state.range(0)) * kResolution;
+  const scene_generation::Scene scene = MakeClutterScene(state);
+  const CollisionMap static_environment(
+      Eigen::Isometry3d::Identity(), "world",
+      GridSizes(kResolution, size, size, size), CollisionCell(0.5f));
+  // Camera looks along +x (the optical z axis) from just outside the grid.
+  const Eigen::Isometry3d X_WC
+      = Eigen::Translation3d(-0.5, size * 0.5, size * 0.5)
+        * Eigen::Quaterniond(
+            Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitZ())
+            * Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitX()));
+  const auto cloud = scene_generation::SimulateDepthCamera(
+      scene, X_WC, 160, 120, M_PI_2, size * 2.0, 0.005, kSeed, true);
+  const pointcloud_voxelization::PointCloudVoxelizationFilterOptions
+      filter_options(1.0, 1, 1);
+  const auto voxelizer = pointcloud_voxelization::MakePointCloudVoxelizer(
+      pointcloud_voxelization::BackendOptions::CPU, {});
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(voxelizer->VoxelizePointClouds(
+        static_environment, 0.5, filter_options, {cloud}));
+  }
+  state.SetItemsProcessed(state.iterations() * cloud->Size());
+}
+BENCHMARK(BM_CpuVoxelization)->Apply(GridSizeAndDensityArguments);
+
+void BM_CollisionMapSerialize(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  std::vector<uint8_t> buffer;
+  for (auto _ : state)
+  {
+    buffer.clear();
+    benchmark::DoNotOptimize(CollisionMap::Serialize(map, buffer));
+  }
+  state.SetBytesProcessed(
+      state.iterations() * static_cast<int64_t>(buffer.size()));
+}
+BENCHMARK(BM_CollisionMapSerialize)->Apply(GridSizeAndDensityArguments);
+
+void BM_CollisionMapDeserialize(benchmark::State& state)
+{
+  const CollisionMap map = MakeClutteredMap(state);
+  std::vector<uint8_t> buffer;
+  CollisionMap::Serialize(map, buffer);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(CollisionMap::Deserialize(buffer, 0));
+  }
+  state.SetBytesProcessed(
+      state.iterations() * static_cast<int64_t>(buffer.size()));
+}
+BENCHMARK(BM_CollisionMapDeserialize)->Apply(GridSizeAndDensityArguments);
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+BENCHMARK_MAIN();
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace voxelized_geometry_tools
+{
+/// Process-wide pool of fixed-size memory blocks. Blocks are carved out of
+/// larger slabs and recycled through per-slab free lists rather than returned
+/// to the system allocator, which avoids allocator churn (and fragmentation)
+/// when many equally-sized chunks are repeatedly allocated and released, as
+/// in long-running DSH mapping. A slab is returned to the system allocator as
+/// soon as all of its blocks are free, except that one empty slab per block
+/// size is kept, so that a block repeatedly allocated and released at a slab
+/// boundary does not allocate a slab each time. ReleaseUnusedSlabs() returns
+/// those too.
+class ChunkMemoryPool
+{
+public:
+  /// Slabs hold as many blocks as fit in this many bytes, but at least one
+  /// and at most kMaxBlocksPerSlab, so that neither large chunks nor single
+  /// chunk values tie up much more memory than they use.
+  static constexpr size_t kSlabBytes = 256 * 1024;
+  static constexpr size_t kMaxBlocksPerSlab = 64;
+
+  /// The pool is intentionally never destroyed, so that blocks may be
+  /// released safely during static destruction.
+  static ChunkMemoryPool& Instance()
+  {
+    static ChunkMemoryPool* pool = new ChunkMemoryPool();
+    return *pool;
+  }
+
+  void* Allocate(const size_t block_bytes)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::set<uintptr_t>& available_slabs = available_slabs_[block_bytes];
+    if (available_slabs.empty())
+    {
+      available_slabs.insert(AllocateSlab(block_bytes));
+    }
+    // Prefer the lowest slab, so blocks pack into as few slabs as possible.
+    const uintptr_t slab_address = *available_slabs.begin();
+    Slab& slab = slabs_.at(slab_address);
+    void* block = slab.free_blocks.back();
+    slab.free_blocks.pop_back();
+    if (slab.free_blocks.empty())
+    {
+      available_slabs.erase(available_slabs.begin());
+    }
+    if (empty_slabs_[block_bytes] == slab_address)
+    {
+      empty_slabs_[block_bytes] = 0;
+    }
+    return block;
+  }
+
+  void Deallocate(void* block, const size_t block_bytes)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto slab_itr = FindContainingSlab(block);
+    Slab& slab = slab_itr->second;
+    if (slab.free_blocks.empty())
+    {
+      available_slabs_[block_bytes].insert(slab_itr->first);
+    }
+    slab.free_blocks.push_back(block);
+    if (slab.free_blocks.size() < slab.num_blocks)
+    {
+      return;
+    }
+    // Keep one empty slab per block size, and release any other.
+    uintptr_t& empty_slab = empty_slabs_[block_bytes];
+    if (empty_slab == 0)
+    {
+      empty_slab = slab_itr->first;
+    }
+    else
+    {
+      ReleaseSlab(slab_itr);
+    }
+  }
+
+  /// Return every slab with no blocks in use to the system allocator.
+  /// Returns the number of bytes released.
+  size_t ReleaseUnusedSlabs()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t released_bytes = 0;
+    for (auto& empty_slab : empty_slabs_)
+    {
+      if (empty_slab.second != 0)
+      {
+        released_bytes += ReleaseSlab(slabs_.find(empty_slab.second));
+        empty_slab.second = 0;
+      }
+    }
+    return released_bytes;
+  }
+
+  /// Total bytes held by the pool, whether in use or free.
+  size_t TotalBytes()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_bytes_;
+  }
+
+private:
+  struct Slab
+  {
+    size_t block_bytes = 0;
+    size_t stride = 0;
+    size_t num_blocks = 0;
+    std::vector<void*> free_blocks;
+
+    Slab() {}
+
+    Slab(const size_t slab_block_bytes, const size_t slab_stride,
+         const size_t slab_num_blocks)
+        : block_bytes(slab_block_bytes), stride(slab_stride),
+          num_blocks(slab_num_blocks) {}
+  };
+
+  ChunkMemoryPool() {}
+
+  uintptr_t AllocateSlab(const size_t block_bytes)
+  {
+    // Round up so every block in the slab stays maximally aligned.
+    const size_t alignment = alignof(std::max_align_t);
+    const size_t stride = ((block_bytes + alignment - 1) / alignment)
+                          * alignment;
+    size_t num_blocks = kSlabBytes / stride;
+    if (num_blocks < 1)
+    {
+      num_blocks = 1;
+    }
+    else if (num_blocks > kMaxBlocksPerSlab)
+    {
+      num_blocks = kMaxBlocksPerSlab;
+    }
+    uint8_t* slab_start
+        = static_cast<uint8_t*>(::operator new(stride * num_blocks));
+    const uintptr_t slab_address = reinterpret_cast<uintptr_t>(slab_start);
+    Slab& slab = slabs_[slab_address];
+    slab = Slab(block_bytes, stride, num_blocks);
+    slab.free_blocks.reserve(num_blocks);
+    for (size_t idx = num_blocks; idx > 0; idx--)
+    {
+      slab.free_blocks.push_back(slab_start + ((idx - 1) * stride));
+    }
+    total_bytes_ += stride * num_blocks;
+    return slab_address;
+  }
+
+  /// Returns the number of bytes released.
+  size_t ReleaseSlab(const std::map<uintptr_t, Slab>::iterator slab_itr)
+  {
+    const Slab& slab = slab_itr->second;
+    const size_t slab_bytes = slab.stride * slab.num_blocks;
+    available_slabs_[slab.block_bytes].erase(slab_itr->first);
+    total_bytes_ -= slab_bytes;
+    ::operator delete(reinterpret_cast<void*>(slab_itr->first));
+    slabs_.erase(slab_itr);
+    return slab_bytes;
+  }
+
+  std::map<uintptr_t, Slab>::iterator FindContainingSlab(const void* block)
+  {
+    const uintptr_t address = reinterpret_cast<uintptr_t>(block);
+    auto slab_itr = slabs_.upper_bound(address);
+    --slab_itr;
+    return slab_itr;
+  }
+
+  std::mutex mutex_;
+  /// Slabs, keyed by their start address.
+  std::map<uintptr_t, Slab> slabs_;
+  /// Slabs with free blocks, by block size.
+  std::unordered_map<size_t, std::set<uintptr_t>> available_slabs_;
+  /// The empty slab kept for each block size, or zero if there is none.
+  std::unordered_map<size_t, uintptr_t> empty_slabs_;
+  size_t total_bytes_ = 0;
+};
+
+/// Stateless allocator backed by ChunkMemoryPool, for the backing stores of
+/// DSH chunks, which are always one of two sizes (a single chunk value or a
+/// full chunk of cells).
+template<typename T>
+class ChunkPoolAllocator
+{
+public:
+  using value_type = T;
+
+  ChunkPoolAllocator() {}
+
+  template<typename U>
+  ChunkPoolAllocator(const ChunkPoolAllocator<U>&) {}
+
+  T* allocate(const size_t n)
+  {
+    return static_cast<T*>(
+        ChunkMemoryPool::Instance().Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, const size_t n)
+  {
+    ChunkMemoryPool::Instance().Deallocate(pointer, n * sizeof(T));
+  }
+};
+
+template<typename T, typename U>
+bool operator==(const ChunkPoolAllocator<T>&, const ChunkPoolAllocator<U>&)
+{
+  return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const ChunkPoolAllocator<T>&, const ChunkPoolAllocator<U>&)
+{
+  return false;
+}
+}  // namespace voxelized_geometry_tools
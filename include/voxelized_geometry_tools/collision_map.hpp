@@ -16,6 +16,9 @@
 #include <common_robotics_utilities/maybe.hpp>
 #include <common_robotics_utilities/serialization.hpp>
 #include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/copy_on_write_tiled_vector.hpp>
+#include <voxelized_geometry_tools/dirty_tile_tracker.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
 #include <voxelized_geometry_tools/signed_distance_field.hpp>
 #include <voxelized_geometry_tools/signed_distance_field_generation.hpp>
 #include <voxelized_geometry_tools/topology_computation.hpp>
@@ -51,9 +54,12 @@ using CollisionCellSerializer
 using CollisionCellDeserializer
     = common_robotics_utilities::serialization::Deserializer<CollisionCell>;
 
+/// Copies of a CollisionMap share storage until written, a tile at a time.
+using CollisionMapBackingStore = CopyOnWriteTiledVector<CollisionCell>;
+
 class CollisionMap
     : public common_robotics_utilities::voxel_grid
-        ::VoxelGridBase<CollisionCell, std::vector<CollisionCell>>
+        ::VoxelGridBase<CollisionCell, CollisionMapBackingStore>
 {
 private:
   using DeserializedCollisionMap
@@ -62,12 +68,13 @@ private:
   uint32_t number_of_components_ = 0u;
   std::string frame_;
   bool components_valid_ = false;
+  DirtyTileTracker dirty_tiles_;
 
   /// Implement the VoxelGridBase interface.
 
   /// We need to implement cloning.
   std::unique_ptr<common_robotics_utilities::voxel_grid
-      ::VoxelGridBase<CollisionCell, std::vector<CollisionCell>>>
+      ::VoxelGridBase<CollisionCell, CollisionMapBackingStore>>
   DoClone() const override;
 
   /// We need to serialize the frame and locked flag.
@@ -80,7 +87,8 @@ private:
       const std::vector<uint8_t>& buffer, const uint64_t starting_offset,
       const CollisionCellDeserializer& value_deserializer) override;
 
-  /// Invalidate connected components on mutable access.
+  /// Invalidate connected components and mark the cell's tile dirty on
+  /// mutable access.
   bool OnMutableAccess(const int64_t x_index,
                        const int64_t y_index,
                        const int64_t z_index) override;
@@ -116,7 +124,7 @@ public:
       const common_robotics_utilities::voxel_grid::GridSizes& sizes,
       const CollisionCell& default_value, const CollisionCell& oob_value)
       : common_robotics_utilities::voxel_grid
-          ::VoxelGridBase<CollisionCell, std::vector<CollisionCell>>(
+          ::VoxelGridBase<CollisionCell, CollisionMapBackingStore>(
               origin_transform, sizes, default_value, oob_value),
         number_of_components_(0u), frame_(frame), components_valid_(false)
   {
@@ -132,7 +140,7 @@ public:
       const common_robotics_utilities::voxel_grid::GridSizes& sizes,
       const CollisionCell& default_value, const CollisionCell& oob_value)
       : common_robotics_utilities::voxel_grid
-          ::VoxelGridBase<CollisionCell, std::vector<CollisionCell>>(
+          ::VoxelGridBase<CollisionCell, CollisionMapBackingStore>(
               sizes, default_value, oob_value), number_of_components_(0u),
         frame_(frame), components_valid_(false)
   {
@@ -145,7 +153,7 @@ public:
 
   CollisionMap()
       : common_robotics_utilities::voxel_grid
-          ::VoxelGridBase<CollisionCell, std::vector<CollisionCell>>() {}
+          ::VoxelGridBase<CollisionCell, CollisionMapBackingStore>() {}
 
   bool AreComponentsValid() const { return components_valid_; }
 
@@ -155,6 +163,54 @@ public:
   /// Use this to invalidate the current components.
   void ForceComponentsToBeInvalid() { components_valid_ = false; }
 
+  /// Dirty-tile tracking records which tiles of the grid have changed since
+  /// the last ClearDirtyTiles(), so that downstream consumers (incremental SDF
+  /// updates, message deltas, re-labeling) can limit work to changed regions.
+  /// Tracking is off by default. When on, mutable access and the pointcloud
+  /// voxelizers mark tiles dirty; writes made through GetMutableRawData() must
+  /// be marked by the caller. Tracking state is not serialized, and loading a
+  /// map into a tracking map marks every tile dirty. Note that
+  /// UpdateConnectedComponents() writes every cell, so fetch dirty tiles
+  /// before updating components.
+  void EnableDirtyTileTracking(const int64_t tile_size);
+
+  void EnableDirtyTileTracking() { EnableDirtyTileTracking(16); }
+
+  void DisableDirtyTileTracking() { dirty_tiles_ = DirtyTileTracker(); }
+
+  bool IsDirtyTileTrackingEnabled() const { return dirty_tiles_.IsEnabled(); }
+
+  int64_t GetDirtyTileSize() const { return dirty_tiles_.TileSize(); }
+
+  bool HasDirtyTiles() const { return dirty_tiles_.HasDirtyTiles(); }
+
+  /// Returns the cell regions of dirty tiles, clipped to the grid.
+  std::vector<GridIndexRegion> GetDirtyTiles() const
+  {
+    return dirty_tiles_.GetDirtyTiles();
+  }
+
+  void ClearDirtyTiles() { dirty_tiles_.Clear(); }
+
+  /// Marking is safe to call concurrently, and does nothing if tracking is off.
+  void MarkCellDirty(
+      const common_robotics_utilities::voxel_grid::GridIndex& index)
+  {
+    dirty_tiles_.MarkCell(index.X(), index.Y(), index.Z());
+  }
+
+  void MarkDataIndexDirty(const int64_t data_index)
+  {
+    dirty_tiles_.MarkDataIndex(data_index);
+  }
+
+  void MarkRegionDirty(const GridIndexRegion& region)
+  {
+    dirty_tiles_.MarkRegion(region);
+  }
+
+  void MarkAllDirty() { dirty_tiles_.MarkAll(); }
+
   double GetResolution() const { return GetCellSizes().x(); }
 
   const std::string& GetFrame() const { return frame_; }
@@ -266,7 +322,7 @@ public:
       }
     };
     return signed_distance_field_generation::ExtractSignedDistanceField
-        <CollisionCell, std::vector<CollisionCell>, BackingStore>(
+        <CollisionCell, CollisionMapBackingStore, BackingStore>(
             *this, is_filled_fn, oob_value, GetFrame(), use_parallel,
             add_virtual_border);
   }
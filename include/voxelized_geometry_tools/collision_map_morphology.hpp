@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <voxelized_geometry_tools/collision_map.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace collision_map_morphology
+{
+/// Morphological operations on the obstacle cells of a CollisionMap, using a
+/// spherical structuring element of the given radius (in meters, measured
+/// between cell centers). Obstacle cells are filled cells (occupancy > 0.5),
+/// plus unknown cells (occupancy == 0.5) if unknown_is_filled is set.
+///
+/// These threshold an exact squared Euclidean distance transform of the
+/// obstacle mask, computed with separable per-axis passes in integer cell
+/// units, so no float SDF is generated. The returned map is a copy of map in
+/// which cells that join the obstacle set are set to filled (1.0), filled
+/// cells that leave it are set to free (0.0), and all other cells (including
+/// unknown cells that leave it) are unchanged; the changed cells are marked
+/// dirty and components are invalidated. Cells outside the grid are ignored,
+/// so the grid border neither grows nor erodes obstacles.
+
+/// Inflates obstacles: every cell within radius of an obstacle cell becomes
+/// an obstacle, e.g. to inflate obstacles by a robot's radius.
+CollisionMap Dilate(
+    const CollisionMap& map, const double radius,
+    const bool unknown_is_filled, const bool use_parallel);
+
+/// Shrinks obstacles: every obstacle cell within radius of a non-obstacle cell
+/// stops being an obstacle.
+CollisionMap Erode(
+    const CollisionMap& map, const double radius,
+    const bool unknown_is_filled, const bool use_parallel);
+
+/// Erode then dilate, removing obstacles thinner than the structuring element.
+CollisionMap Open(
+    const CollisionMap& map, const double radius,
+    const bool unknown_is_filled, const bool use_parallel);
+
+/// Dilate then erode, filling gaps narrower than the structuring element.
+CollisionMap Close(
+    const CollisionMap& map, const double radius,
+    const bool unknown_is_filled, const bool use_parallel);
+
+/// Lower-level operations on obstacle masks, one byte per cell in the same
+/// order as the CollisionMap backing store, with 1 for obstacle cells.
+std::vector<uint8_t> MakeObstacleMask(
+    const CollisionMap& map, const bool unknown_is_filled,
+    const bool use_parallel);
+
+/// Sets every cell within radius_in_cells of a cell with value feature_value
+/// to feature_value. Growing value 1 dilates, growing value 0 erodes.
+void GrowMask(
+    const int64_t num_x_cells, const int64_t num_y_cells,
+    const int64_t num_z_cells, const double radius_in_cells,
+    const uint8_t feature_value, const bool use_parallel,
+    std::vector<uint8_t>& mask);
+}  // namespace collision_map_morphology
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,403 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace voxelized_geometry_tools
+{
+/// Vector-like container that stores its elements in fixed-size tiles shared
+/// between copies. Copying is O(number of tiles) pointer copies, and a tile is
+/// only duplicated the first time it is mutably accessed while shared, so a
+/// copy of a grid that is then partially updated costs only the tiles that
+/// changed. Suitable as the BackingStore of a VoxelGridBase.
+///
+/// As with std::vector, concurrent reads are safe, as are concurrent writes
+/// to distinct elements, but only if no tile being written is shared with
+/// another copy; call MakeUnique() first, or split work by tile, before
+/// writing in parallel. Elements are not contiguous, so there is no data();
+/// use ToVector() and Assign() to exchange contiguous buffers.
+template<typename T, size_t TileSize=4096>
+class CopyOnWriteTiledVector
+{
+public:
+  static_assert((TileSize > 0) && ((TileSize & (TileSize - 1)) == 0),
+                "TileSize must be a power of two");
+
+  using Tile = std::vector<T>;
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+
+private:
+  template<typename ContainerType, typename ValueType>
+  class IteratorBase
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ValueType*;
+    using reference = ValueType&;
+
+    IteratorBase() {}
+
+    IteratorBase(ContainerType* container, const size_t index)
+        : container_(container), index_(index) {}
+
+    /// Allows conversion from iterator to const_iterator.
+    template<typename OtherContainerType, typename OtherValueType>
+    IteratorBase(
+        const IteratorBase<OtherContainerType, OtherValueType>& other)
+        : container_(other.Container()), index_(other.Index()) {}
+
+    ContainerType* Container() const { return container_; }
+
+    size_t Index() const { return index_; }
+
+    reference operator*() const { return (*container_)[index_]; }
+
+    pointer operator->() const { return &((*container_)[index_]); }
+
+    reference operator[](const difference_type offset) const
+    {
+      return (*container_)[Offset(offset)];
+    }
+
+    IteratorBase& operator++() { index_++; return *this; }
+
+    IteratorBase operator++(int)
+    {
+      IteratorBase previous = *this;
+      index_++;
+      return previous;
+    }
+
+    IteratorBase& operator--() { index_--; return *this; }
+
+    IteratorBase operator--(int)
+    {
+      IteratorBase previous = *this;
+      index_--;
+      return previous;
+    }
+
+    IteratorBase& operator+=(const difference_type offset)
+    {
+      index_ = Offset(offset);
+      return *this;
+    }
+
+    IteratorBase& operator-=(const difference_type offset)
+    {
+      index_ = Offset(-offset);
+      return *this;
+    }
+
+    IteratorBase operator+(const difference_type offset) const
+    {
+      return IteratorBase(container_, Offset(offset));
+    }
+
+    IteratorBase operator-(const difference_type offset) const
+    {
+      return IteratorBase(container_, Offset(-offset));
+    }
+
+    difference_type operator-(const IteratorBase& other) const
+    {
+      return static_cast<difference_type>(index_)
+             - static_cast<difference_type>(other.index_);
+    }
+
+    bool operator==(const IteratorBase& other) const
+    {
+      return index_ == other.index_;
+    }
+
+    bool operator!=(const IteratorBase& other) const
+    {
+      return index_ != other.index_;
+    }
+
+    bool operator<(const IteratorBase& other) const
+    {
+      return index_ < other.index_;
+    }
+
+    bool operator>(const IteratorBase& other) const
+    {
+      return index_ > other.index_;
+    }
+
+    bool operator<=(const IteratorBase& other) const
+    {
+      return index_ <= other.index_;
+    }
+
+    bool operator>=(const IteratorBase& other) const
+    {
+      return index_ >= other.index_;
+    }
+
+  private:
+    size_t Offset(const difference_type offset) const
+    {
+      return static_cast<size_t>(
+          static_cast<difference_type>(index_) + offset);
+    }
+
+    ContainerType* container_ = nullptr;
+    size_t index_ = 0;
+  };
+
+public:
+  using iterator = IteratorBase<CopyOnWriteTiledVector, T>;
+  using const_iterator = IteratorBase<const CopyOnWriteTiledVector, const T>;
+
+  static constexpr size_t TileCapacity() { return TileSize; }
+
+  CopyOnWriteTiledVector() {}
+
+  CopyOnWriteTiledVector(const size_t count, const T& value)
+  {
+    resize(count, value);
+  }
+
+  explicit CopyOnWriteTiledVector(const size_t count)
+      : CopyOnWriteTiledVector(count, T()) {}
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  void clear()
+  {
+    tiles_.clear();
+    size_ = 0;
+  }
+
+  void reserve(const size_t count) { tiles_.reserve(NumTilesForSize(count)); }
+
+  void resize(const size_t count) { resize(count, T()); }
+
+  void resize(const size_t count, const T& value)
+  {
+    if (count < size_)
+    {
+      const size_t num_tiles = NumTilesForSize(count);
+      tiles_.resize(num_tiles);
+      if (num_tiles > 0)
+      {
+        const size_t last_tile_size = count - ((num_tiles - 1) * TileSize);
+        if (tiles_.back()->size() != last_tile_size)
+        {
+          GetMutableTile(num_tiles - 1).resize(last_tile_size);
+        }
+      }
+    }
+    else if (count > size_)
+    {
+      size_t covered = size_;
+      if (tiles_.size() > 0 && tiles_.back()->size() < TileSize)
+      {
+        Tile& last_tile = GetMutableTile(tiles_.size() - 1);
+        const size_t added
+            = std::min(TileSize - last_tile.size(), count - covered);
+        last_tile.resize(last_tile.size() + added, value);
+        covered += added;
+      }
+      tiles_.reserve(NumTilesForSize(count));
+      while (covered < count)
+      {
+        const size_t tile_size = std::min(TileSize, count - covered);
+        tiles_.push_back(std::make_shared<Tile>(tile_size, value));
+        covered += tile_size;
+      }
+    }
+    size_ = count;
+  }
+
+  void push_back(const T& value)
+  {
+    if (tiles_.empty() || tiles_.back()->size() == TileSize)
+    {
+      tiles_.push_back(std::make_shared<Tile>());
+      tiles_.back()->reserve(TileSize);
+    }
+    GetMutableTile(tiles_.size() - 1).push_back(value);
+    size_++;
+  }
+
+  const T& operator[](const size_t index) const
+  {
+    return (*tiles_[index / TileSize])[index % TileSize];
+  }
+
+  T& operator[](const size_t index)
+  {
+    return GetMutableTile(index / TileSize)[index % TileSize];
+  }
+
+  const T& at(const size_t index) const
+  {
+    EnforceIndexInRange(index);
+    return (*this)[index];
+  }
+
+  T& at(const size_t index)
+  {
+    EnforceIndexInRange(index);
+    return (*this)[index];
+  }
+
+  const T& front() const { return at(0); }
+
+  T& front() { return at(0); }
+
+  const T& back() const { return at(size_ - 1); }
+
+  T& back() { return at(size_ - 1); }
+
+  iterator begin() { return iterator(this, 0); }
+
+  iterator end() { return iterator(this, size_); }
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+
+  const_iterator end() const { return const_iterator(this, size_); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  void swap(CopyOnWriteTiledVector& other)
+  {
+    tiles_.swap(other.tiles_);
+    std::swap(size_, other.size_);
+  }
+
+  /// Tile-level access, for code that processes the container a tile at a
+  /// time. Element index i is element (i % TileSize) of tile (i / TileSize).
+  size_t NumTiles() const { return tiles_.size(); }
+
+  const Tile& GetImmutableTile(const size_t tile_index) const
+  {
+    return *tiles_.at(tile_index);
+  }
+
+  /// Duplicates the tile first if it is shared with another copy.
+  Tile& GetMutableTile(const size_t tile_index)
+  {
+    std::shared_ptr<Tile>& tile = tiles_[tile_index];
+    if (!IsUniquelyOwned(tile))
+    {
+      tile = std::make_shared<Tile>(*tile);
+    }
+    return *tile;
+  }
+
+  bool IsTileShared(const size_t tile_index) const
+  {
+    return tiles_.at(tile_index).use_count() > 1;
+  }
+
+  size_t NumSharedTiles() const
+  {
+    size_t num_shared_tiles = 0;
+    for (const std::shared_ptr<Tile>& tile : tiles_)
+    {
+      if (tile.use_count() > 1)
+      {
+        num_shared_tiles++;
+      }
+    }
+    return num_shared_tiles;
+  }
+
+  /// Duplicates every shared tile, so that elements can be written
+  /// concurrently.
+  void MakeUnique()
+  {
+    for (size_t tile_index = 0; tile_index < tiles_.size(); tile_index++)
+    {
+      GetMutableTile(tile_index);
+    }
+  }
+
+  std::vector<T> ToVector() const
+  {
+    std::vector<T> values;
+    values.reserve(size_);
+    for (const std::shared_ptr<Tile>& tile : tiles_)
+    {
+      values.insert(values.end(), tile->begin(), tile->end());
+    }
+    return values;
+  }
+
+  /// Replaces the contents with values, in new unshared tiles.
+  void Assign(const std::vector<T>& values)
+  {
+    tiles_.clear();
+    tiles_.reserve(NumTilesForSize(values.size()));
+    for (size_t start = 0; start < values.size(); start += TileSize)
+    {
+      const size_t tile_size = std::min(TileSize, values.size() - start);
+      tiles_.push_back(std::make_shared<Tile>(
+          values.begin() + static_cast<difference_type>(start),
+          values.begin() + static_cast<difference_type>(start + tile_size)));
+    }
+    size_ = values.size();
+  }
+
+private:
+  /// use_count() is a relaxed load, so on its own it does not order our
+  /// writes after the reads another copy made before it released the tile.
+  /// The acquire fence pairs with the release in that copy's decrement.
+  static bool IsUniquelyOwned(const std::shared_ptr<Tile>& tile)
+  {
+    if (tile.use_count() == 1)
+    {
+      std::atomic_thread_fence(std::memory_order_acquire);
+      return true;
+    }
+    return false;
+  }
+
+  static size_t NumTilesForSize(const size_t count)
+  {
+    return (count + TileSize - 1) / TileSize;
+  }
+
+  void EnforceIndexInRange(const size_t index) const
+  {
+    if (index >= size_)
+    {
+      throw std::out_of_range("index out of range");
+    }
+  }
+
+  std::vector<std::shared_ptr<Tile>> tiles_;
+  size_t size_ = 0;
+};
+
+/// Prepares a grid backing store for concurrent writes to distinct elements,
+/// for code that works with both dense and copy-on-write backing stores.
+template<typename T, typename Allocator>
+inline void MakeUniqueForConcurrentWrites(std::vector<T, Allocator>&) {}
+
+template<typename T, size_t TileSize>
+inline void MakeUniqueForConcurrentWrites(
+    CopyOnWriteTiledVector<T, TileSize>& values)
+{
+  values.MakeUnique();
+}
+}  // namespace voxelized_geometry_tools
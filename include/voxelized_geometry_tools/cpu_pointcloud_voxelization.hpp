@@ -2,8 +2,10 @@
 
 #include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <Eigen/Geometry>
@@ -69,14 +71,23 @@ class CpuPointCloudVoxelizer : public PointCloudVoxelizationInterface {
 public:
   CpuPointCloudVoxelizer() {}
 
+  /// Supported options: CPU_NUM_THREADS, the number of OpenMP threads to use,
+  /// where 0 (the default) uses the OpenMP default.
+  explicit CpuPointCloudVoxelizer(
+      const std::map<std::string, int32_t>& options);
+
+  int32_t NumThreads() const { return num_threads_; }
+
 private:
+  int32_t EffectiveNumThreads() const;
+
   VoxelizerRuntime DoVoxelizePointClouds(
       const CollisionMap& static_environment, const double step_size_multiplier,
       const PointCloudVoxelizationFilterOptions& filter_options,
       const std::vector<PointCloudWrapperPtr>& pointclouds,
       CollisionMap& output_environment) const override;
 
-  void RaycastPointCloud(
+  VoxelizationCounters RaycastPointCloud(
       const PointCloudWrapper& cloud, const double step_size,
       CpuVoxelizationTrackingGrid& tracking_grid) const;
 
@@ -84,6 +95,8 @@ private:
       const PointCloudVoxelizationFilterOptions& filter_options,
       const VectorCpuVoxelizationTrackingGrid& tracking_grids,
       CollisionMap& output_environment) const;
+
+  int32_t num_threads_ = 0;
 };
 }  // namespace pointcloud_voxelization
 }  // namespace voxelized_geometry_tools
@@ -3,7 +3,6 @@
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <iostream>
 #include <string>
 #include <vector>
 
@@ -40,15 +39,10 @@ inline int32_t RetrieveOptionOrDefault(
   auto found_itr = options.find(option);
   if (found_itr != options.end())
   {
-    const int32_t value = found_itr->second;
-    std::cout << "Option [" << option << "] found with value [" << value << "]"
-              << std::endl;
-    return value;
+    return found_itr->second;
   }
   else
   {
-    std::cout << "Option [" << option << "] not found, default ["
-              << default_value << "]" << std::endl;
     return default_value;
   }
 }
@@ -98,6 +92,19 @@ private:
   int64_t num_cells_ = 0;
 };
 
+// Raycasting counters accumulated on the device for one tracking grid, laid
+// out as four int64_t values after the tracking grids in device memory, so
+// that voxel visits over large clouds do not overflow. They are only
+// accumulated if the COLLECT_COUNTERS option is nonzero, since every ray then
+// adds to the same four device addresses.
+struct DeviceRaycastCounters
+{
+  int64_t num_rays_cast = 0;
+  int64_t num_rays_culled = 0;
+  int64_t num_voxel_visits = 0;
+  int64_t num_contended_updates = 0;
+};
+
 class DeviceVoxelizationHelperInterface
 {
 public:
@@ -108,7 +115,9 @@ public:
   virtual std::unique_ptr<TrackingGridsHandle> PrepareTrackingGrids(
       const int64_t num_cells, const int32_t num_grids) = 0;
 
-  virtual void RaycastPoints(
+  // Uploads the points and launches raycasting, without waiting for it to
+  // complete. Returns the time in seconds spent uploading.
+  virtual double RaycastPoints(
       const std::vector<float>& raw_points, const float max_range,
       const float* const grid_pointcloud_transform,
       const float inverse_step_size, const float inverse_cell_size,
@@ -116,7 +125,15 @@ public:
       const int32_t num_z_cells, TrackingGridsHandle& tracking_grids,
       const size_t tracking_grid_index) = 0;
 
+  // Allocates the filter grid, whose cells are then set with
+  // UploadFilterGridCells().
   virtual std::unique_ptr<FilterGridHandle> PrepareFilterGrid(
+      const int64_t num_cells) = 0;
+
+  // Copies num_cells cells from host_data_ptr into the filter grid, starting
+  // at first_cell, so that grids need not be contiguous on the host.
+  virtual void UploadFilterGridCells(
+      FilterGridHandle& filter_grid, const int64_t first_cell,
       const int64_t num_cells, const void* host_data_ptr) = 0;
 
   virtual void FilterTrackingGrids(
@@ -128,8 +145,18 @@ public:
       const TrackingGridsHandle& tracking_grids,
       const size_t tracking_grid_index, void* host_data_ptr) = 0;
 
-  virtual void RetrieveFilteredGrid(
-      const FilterGridHandle& filter_grid, void* host_data_ptr) = 0;
+  // Copies num_cells cells of the filter grid, starting at first_cell, into
+  // host_data_ptr.
+  virtual void RetrieveFilteredGridCells(
+      const FilterGridHandle& filter_grid, const int64_t first_cell,
+      const int64_t num_cells, void* host_data_ptr) = 0;
+
+  virtual DeviceRaycastCounters RetrieveRaycastCounters(
+      const TrackingGridsHandle& tracking_grids,
+      const size_t tracking_grid_index) = 0;
+
+  // Blocks until all launched work is complete.
+  virtual void Synchronize() = 0;
 };
 }  // namespace pointcloud_voxelization
 }  // namespace voxelized_geometry_tools
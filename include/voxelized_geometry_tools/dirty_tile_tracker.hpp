@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Dirty flags for a dense grid divided into cubic tiles of tile_size cells
+/// per side (tiles on the upper edges of the grid may be smaller). Marking is
+/// thread-safe; fetching and clearing are not safe concurrently with marking.
+/// A default-constructed tracker is disabled and ignores marks.
+class DirtyTileTracker
+{
+public:
+  DirtyTileTracker() {}
+
+  DirtyTileTracker(
+      const int64_t num_x_cells, const int64_t num_y_cells,
+      const int64_t num_z_cells, const int64_t tile_size)
+      : num_x_cells_(num_x_cells), num_y_cells_(num_y_cells),
+        num_z_cells_(num_z_cells), tile_size_(tile_size)
+  {
+    if (num_x_cells_ < 0 || num_y_cells_ < 0 || num_z_cells_ < 0)
+    {
+      throw std::invalid_argument("num_cells < 0");
+    }
+    if (tile_size_ < 1)
+    {
+      throw std::invalid_argument("tile_size < 1");
+    }
+    num_x_tiles_ = NumTiles(num_x_cells_);
+    num_y_tiles_ = NumTiles(num_y_cells_);
+    num_z_tiles_ = NumTiles(num_z_cells_);
+    flags_ = std::vector<std::atomic<uint8_t>>(
+        static_cast<size_t>(num_x_tiles_ * num_y_tiles_ * num_z_tiles_));
+    Clear();
+  }
+
+  /// We need copy constructor since std::atomics do not have copy constructors.
+  DirtyTileTracker(const DirtyTileTracker& other)
+      : num_x_cells_(other.num_x_cells_), num_y_cells_(other.num_y_cells_),
+        num_z_cells_(other.num_z_cells_), tile_size_(other.tile_size_),
+        num_x_tiles_(other.num_x_tiles_), num_y_tiles_(other.num_y_tiles_),
+        num_z_tiles_(other.num_z_tiles_),
+        flags_(other.flags_.size())
+  {
+    CopyFlagsFrom(other);
+  }
+
+  /// We need assignment operator since std::atomics do not have it.
+  DirtyTileTracker& operator=(const DirtyTileTracker& other)
+  {
+    if (this != &other)
+    {
+      num_x_cells_ = other.num_x_cells_;
+      num_y_cells_ = other.num_y_cells_;
+      num_z_cells_ = other.num_z_cells_;
+      tile_size_ = other.tile_size_;
+      num_x_tiles_ = other.num_x_tiles_;
+      num_y_tiles_ = other.num_y_tiles_;
+      num_z_tiles_ = other.num_z_tiles_;
+      flags_ = std::vector<std::atomic<uint8_t>>(other.flags_.size());
+      CopyFlagsFrom(other);
+    }
+    return *this;
+  }
+
+  bool IsEnabled() const { return tile_size_ > 0; }
+
+  int64_t TileSize() const { return tile_size_; }
+
+  /// Marks the tile containing the cell; out-of-bounds cells are ignored.
+  void MarkCell(
+      const int64_t x_index, const int64_t y_index, const int64_t z_index)
+  {
+    if (IsEnabled() && x_index >= 0 && x_index < num_x_cells_
+        && y_index >= 0 && y_index < num_y_cells_
+        && z_index >= 0 && z_index < num_z_cells_)
+    {
+      MarkTile(x_index / tile_size_, y_index / tile_size_,
+               z_index / tile_size_);
+    }
+  }
+
+  /// Marks the tile containing the cell at data_index of the (x-major,
+  /// z-minor) dense backing store.
+  void MarkDataIndex(const int64_t data_index)
+  {
+    if (IsEnabled() && num_y_cells_ > 0 && num_z_cells_ > 0)
+    {
+      const int64_t stride1 = num_y_cells_ * num_z_cells_;
+      const int64_t x_index = data_index / stride1;
+      const int64_t remainder = data_index % stride1;
+      MarkCell(x_index, remainder / num_z_cells_, remainder % num_z_cells_);
+    }
+  }
+
+  /// Marks every tile overlapping the region.
+  void MarkRegion(const GridIndexRegion& region)
+  {
+    const GridIndexRegion clipped = region.Intersected(GridRegion());
+    if (!IsEnabled() || clipped.IsEmpty())
+    {
+      return;
+    }
+    for (int64_t x_tile = clipped.Lower().X() / tile_size_;
+         x_tile <= (clipped.Upper().X() - 1) / tile_size_; x_tile++)
+    {
+      for (int64_t y_tile = clipped.Lower().Y() / tile_size_;
+           y_tile <= (clipped.Upper().Y() - 1) / tile_size_; y_tile++)
+      {
+        for (int64_t z_tile = clipped.Lower().Z() / tile_size_;
+             z_tile <= (clipped.Upper().Z() - 1) / tile_size_; z_tile++)
+        {
+          MarkTile(x_tile, y_tile, z_tile);
+        }
+      }
+    }
+  }
+
+  void MarkAll()
+  {
+    for (std::atomic<uint8_t>& flag : flags_)
+    {
+      flag.store(1, std::memory_order_relaxed);
+    }
+  }
+
+  bool HasDirtyTiles() const
+  {
+    for (const std::atomic<uint8_t>& flag : flags_)
+    {
+      if (flag.load(std::memory_order_relaxed) != 0)
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Cell regions of the dirty tiles, clipped to the grid, in x-major,
+  /// z-minor tile order.
+  std::vector<GridIndexRegion> GetDirtyTiles() const
+  {
+    std::vector<GridIndexRegion> dirty_tiles;
+    for (int64_t x_tile = 0; x_tile < num_x_tiles_; x_tile++)
+    {
+      for (int64_t y_tile = 0; y_tile < num_y_tiles_; y_tile++)
+      {
+        for (int64_t z_tile = 0; z_tile < num_z_tiles_; z_tile++)
+        {
+          const size_t tile_offset = TileOffset(x_tile, y_tile, z_tile);
+          if (flags_[tile_offset].load(std::memory_order_relaxed) != 0)
+          {
+            dirty_tiles.push_back(TileRegion(x_tile, y_tile, z_tile));
+          }
+        }
+      }
+    }
+    return dirty_tiles;
+  }
+
+  void Clear()
+  {
+    for (std::atomic<uint8_t>& flag : flags_)
+    {
+      flag.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  int64_t NumTiles(const int64_t num_cells) const
+  {
+    return (num_cells + tile_size_ - 1) / tile_size_;
+  }
+
+  size_t TileOffset(
+      const int64_t x_tile, const int64_t y_tile, const int64_t z_tile) const
+  {
+    return static_cast<size_t>(
+        (x_tile * num_y_tiles_ * num_z_tiles_) + (y_tile * num_z_tiles_)
+        + z_tile);
+  }
+
+  void MarkTile(
+      const int64_t x_tile, const int64_t y_tile, const int64_t z_tile)
+  {
+    std::atomic<uint8_t>& flag = flags_[TileOffset(x_tile, y_tile, z_tile)];
+    // Check first, so that repeated marks do not keep writing the flag.
+    if (flag.load(std::memory_order_relaxed) == 0)
+    {
+      flag.store(1, std::memory_order_relaxed);
+    }
+  }
+
+  GridIndexRegion GridRegion() const
+  {
+    return GridIndexRegion(
+        common_robotics_utilities::voxel_grid::GridIndex(0, 0, 0),
+        common_robotics_utilities::voxel_grid::GridIndex(
+            num_x_cells_, num_y_cells_, num_z_cells_));
+  }
+
+  GridIndexRegion TileRegion(
+      const int64_t x_tile, const int64_t y_tile, const int64_t z_tile) const
+  {
+    const common_robotics_utilities::voxel_grid::GridIndex lower(
+        x_tile * tile_size_, y_tile * tile_size_, z_tile * tile_size_);
+    const common_robotics_utilities::voxel_grid::GridIndex upper(
+        std::min(lower.X() + tile_size_, num_x_cells_),
+        std::min(lower.Y() + tile_size_, num_y_cells_),
+        std::min(lower.Z() + tile_size_, num_z_cells_));
+    return GridIndexRegion(lower, upper);
+  }
+
+  void CopyFlagsFrom(const DirtyTileTracker& other)
+  {
+    for (size_t idx = 0; idx < flags_.size(); idx++)
+    {
+      flags_[idx].store(other.flags_[idx].load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    }
+  }
+
+  int64_t num_x_cells_ = 0;
+  int64_t num_y_cells_ = 0;
+  int64_t num_z_cells_ = 0;
+  int64_t tile_size_ = 0;
+  int64_t num_x_tiles_ = 0;
+  int64_t num_y_tiles_ = 0;
+  int64_t num_z_tiles_ = 0;
+  std::vector<std::atomic<uint8_t>> flags_;
+};
+}  // namespace voxelized_geometry_tools
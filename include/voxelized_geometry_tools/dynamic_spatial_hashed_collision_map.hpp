@@ -1,36 +1,176 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <Eigen/Geometry>
+#include <common_robotics_utilities/maybe.hpp>
 #include <common_robotics_utilities/serialization.hpp>
 #include <common_robotics_utilities/voxel_grid.hpp>
 #include <common_robotics_utilities/dynamic_spatial_hashed_voxel_grid.hpp>
+#include <voxelized_geometry_tools/chunk_pool_allocator.hpp>
 #include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/dynamic_spatial_hashed_signed_distance_field.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
 
 namespace voxelized_geometry_tools
 {
+/// Chunk storage is drawn from a shared pool, since chunks are frequently
+/// allocated and released, and always have one of two sizes.
+using DSHCollisionCellBackingStore
+    = std::vector<CollisionCell, ChunkPoolAllocator<CollisionCell>>;
+
 class DynamicSpatialHashedCollisionMap final
     : public common_robotics_utilities::voxel_grid
         ::DynamicSpatialHashedVoxelGridBase<
-            CollisionCell, std::vector<CollisionCell>>
+            CollisionCell, DSHCollisionCellBackingStore>
 {
 private:
   using DeserializedDynamicSpatialHashedCollisionMap
       = common_robotics_utilities::serialization
           ::Deserialized<DynamicSpatialHashedCollisionMap>;
 
+  /// Locks used by the Concurrent* methods. The chunk table lock is held
+  /// shared while writing single cells of existing CELL_FILLED chunks, and
+  /// exclusively for anything that changes a chunk as a whole (allocation,
+  /// CHUNK_FILLED to CELL_FILLED expansion, or SET_CHUNK). Single-cell writes
+  /// are serialized only by the shard lock covering their cell. Copies
+  /// receive fresh, unlocked locks.
+  class ConcurrentChunkLocks
+  {
+  public:
+    static constexpr size_t kNumShards = 64;
+
+    ConcurrentChunkLocks() {}
+
+    ConcurrentChunkLocks(const ConcurrentChunkLocks&) {}
+
+    ConcurrentChunkLocks& operator=(const ConcurrentChunkLocks&)
+    {
+      return *this;
+    }
+
+    void LockChunkTableShared()
+    {
+      std::unique_lock<std::mutex> lock(chunk_table_mutex_);
+      chunk_table_cv_.wait(lock, [&] () { return !chunk_table_exclusive_; });
+      chunk_table_shared_count_++;
+      num_chunk_table_holders_++;
+    }
+
+    void UnlockChunkTableShared()
+    {
+      std::lock_guard<std::mutex> lock(chunk_table_mutex_);
+      num_chunk_table_holders_--;
+      chunk_table_shared_count_--;
+      if (chunk_table_shared_count_ == 0)
+      {
+        chunk_table_cv_.notify_all();
+      }
+    }
+
+    void LockChunkTableExclusive()
+    {
+      std::unique_lock<std::mutex> lock(chunk_table_mutex_);
+      chunk_table_cv_.wait(lock, [&] ()
+      {
+        return !chunk_table_exclusive_ && chunk_table_shared_count_ == 0;
+      });
+      chunk_table_exclusive_ = true;
+      num_chunk_table_holders_++;
+    }
+
+    void UnlockChunkTableExclusive()
+    {
+      std::lock_guard<std::mutex> lock(chunk_table_mutex_);
+      num_chunk_table_holders_--;
+      chunk_table_exclusive_ = false;
+      chunk_table_cv_.notify_all();
+    }
+
+    std::mutex& ShardMutex(const size_t shard)
+    {
+      return shard_mutexes_.at(shard);
+    }
+
+    /// Whether the chunk table lock is held, i.e. a Concurrent* method is
+    /// running. Only meaningful to the thread holding it, or when no
+    /// Concurrent* method can be running on another thread.
+    bool ChunkTableLocked() const
+    {
+      return num_chunk_table_holders_.load(std::memory_order_relaxed) > 0;
+    }
+
+  private:
+    // std::shared_timed_mutex is C++14, and ROS 1 builds as C++11.
+    std::mutex chunk_table_mutex_;
+    std::condition_variable chunk_table_cv_;
+    size_t chunk_table_shared_count_ = 0;
+    bool chunk_table_exclusive_ = false;
+    std::atomic<int32_t> num_chunk_table_holders_{0};
+    std::array<std::mutex, kNumShards> shard_mutexes_;
+  };
+
+  using DSHCollisionMapBase = common_robotics_utilities::voxel_grid
+      ::DynamicSpatialHashedVoxelGridBase<
+          CollisionCell, DSHCollisionCellBackingStore>;
+
   std::string frame_;
+  ConcurrentChunkLocks concurrent_locks_;
+  /// Chunks accessed mutably since they were last checked for collapsing.
+  std::unordered_set<common_robotics_utilities::voxel_grid::GridIndex>
+      dirty_chunks_;
+  size_t auto_collapse_batch_size_ = 64;
+  /// Set while the map writes its own chunks, which must not be recorded.
+  bool auto_collapse_suspended_ = false;
+
+  /// Suspends automatic collapsing for the writes made in its scope.
+  class ScopedAutoCollapseSuspension
+  {
+  public:
+    explicit ScopedAutoCollapseSuspension(bool& suspended)
+        : suspended_(suspended), was_suspended_(suspended)
+    {
+      suspended_ = true;
+    }
+
+    ~ScopedAutoCollapseSuspension() { suspended_ = was_suspended_; }
+
+  private:
+    bool& suspended_;
+    const bool was_suspended_;
+  };
+
+  /// Index of the chunk containing a location in grid frame, in the implicit
+  /// chunk indexing of CellIndexToChunkIndex().
+  common_robotics_utilities::voxel_grid::GridIndex
+  GridFrameLocationToChunkIndex(
+      const Eigen::Vector4d& location_in_grid_frame) const;
+
+  /// Collapses uniform chunks (only the dirty chunks, if only_dirty_chunks),
+  /// then releases unused chunk pool slabs.
+  size_t CollapseUniformChunksImpl(const bool only_dirty_chunks);
+
+  /// Shard covering a cell, identified by its storage as resolved by the base
+  /// grid, so the shard can never disagree with the grid's own chunk keying.
+  static size_t ConcurrentLockShard(const CollisionCell& cell);
+
+  common_robotics_utilities::voxel_grid::GridIndex CellIndexToChunkIndex(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const;
 
   /// Implement the DynamicSpatialHashedVoxelGridBase interface.
 
   /// We need to implement cloning.
   std::unique_ptr<common_robotics_utilities::voxel_grid
       ::DynamicSpatialHashedVoxelGridBase<
-          CollisionCell, std::vector<CollisionCell>>>
+          CollisionCell, DSHCollisionCellBackingStore>>
   DoClone() const override;
 
   /// We need to serialize the frame and locked flag.
@@ -43,6 +183,8 @@ private:
       const std::vector<uint8_t>& buffer, const uint64_t starting_offset,
       const CollisionCellDeserializer& value_deserializer) override;
 
+  /// Records the chunk accessed for automatic collapsing, first collapsing
+  /// the chunks recorded so far once there are enough of them.
   bool OnMutableAccess(const Eigen::Vector4d& location) override;
 
 public:
@@ -65,7 +207,7 @@ public:
       const CollisionCell& default_value, const size_t expected_chunks,
       const std::string& frame)
       : DynamicSpatialHashedVoxelGridBase<
-          CollisionCell, std::vector<CollisionCell>>(
+          CollisionCell, DSHCollisionCellBackingStore>(
               Eigen::Isometry3d::Identity(), chunk_sizes, default_value,
               expected_chunks),
         frame_(frame)
@@ -83,7 +225,7 @@ public:
       const CollisionCell& default_value, const size_t expected_chunks,
       const std::string& frame)
       : DynamicSpatialHashedVoxelGridBase<
-          CollisionCell, std::vector<CollisionCell>>(
+          CollisionCell, DSHCollisionCellBackingStore>(
               origin_transform, chunk_sizes, default_value, expected_chunks),
         frame_(frame)
   {
@@ -96,12 +238,101 @@ public:
 
   DynamicSpatialHashedCollisionMap()
       : DynamicSpatialHashedVoxelGridBase<
-          CollisionCell, std::vector<CollisionCell>>() {}
+          CollisionCell, DSHCollisionCellBackingStore>() {}
 
   double GetResolution() const { return GetCellSizes().x(); }
 
   const std::string& GetFrame() const { return frame_; }
 
   void SetFrame(const std::string& frame) { frame_ = frame; }
+
+  /// Location of the center of the provided cell, in the implicit cell
+  /// indexing used by GridFrameBoxToRegion().
+  Eigen::Vector4d GridIndexToLocation(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const;
+
+  /// Returns the region of cells (in the implicit, unbounded cell indexing of
+  /// the map, where cell (0, 0, 0) has its minimum corner at the origin)
+  /// that covers the axis-aligned box [lower, upper] in the grid frame.
+  GridIndexRegion GridFrameBoxToRegion(
+      const Eigen::Vector3d& lower, const Eigen::Vector3d& upper) const;
+
+  /// Copy region into a dense CollisionMap whose origin is the minimum corner
+  /// of region. Allocated chunks are copied a row at a time, and unallocated
+  /// chunks are left as the default value.
+  CollisionMap ExportRegion(const GridIndexRegion& region) const;
+
+  /// Copy a dense CollisionMap (e.g. from ExportRegion()) into region, which
+  /// must have the same number of cells as the map. Chunks fully covered by
+  /// uniform values are stored as CHUNK_FILLED.
+  void ImportRegion(const GridIndexRegion& region, const CollisionMap& map);
+
+  /// Compute a sparse SDF over the allocated chunks (and the chunks within
+  /// truncation_distance of them), without densifying the map. Only chunks
+  /// within truncation_distance of a cell whose filled status differs from
+  /// the default value are computed, in blocks of neighboring chunks (in
+  /// parallel, if use_parallel), each from a dense copy of the block padded
+  /// by a halo of truncation_distance. Distances are exact up to
+  /// truncation_distance and clamped beyond it.
+  DynamicSpatialHashedSignedDistanceField ExtractSignedDistanceField(
+      const double truncation_distance, const bool unknown_is_filled,
+      const bool use_parallel) const;
+
+  /// Convert CELL_FILLED chunks whose cells all have the same value back to
+  /// CHUNK_FILLED, releasing their cell storage to the chunk pool, and return
+  /// unused pool slabs to the system allocator. Returns the number of chunks
+  /// collapsed. This is called automatically on deserialization, and for the
+  /// chunks accessed by SetValue{3d,4d}() or GetMutable{3d,4d}() once auto
+  /// collapse batch size chunks have been accessed. Since collapsing releases
+  /// chunk storage, references returned by GetMutable{3d,4d}() are only valid
+  /// until the next mutable access.
+  size_t CollapseUniformChunks() { return CollapseUniformChunksImpl(false); }
+
+  /// Number of distinct chunks that may be accessed mutably before those
+  /// chunks are checked, at the next mutable access, and collapsed if
+  /// uniform. Since checking scans the chunk table, at least an eighth of the
+  /// allocated chunks must have been accessed. Zero disables automatic
+  /// collapsing.
+  size_t GetAutoCollapseBatchSize() const { return auto_collapse_batch_size_; }
+
+  void SetAutoCollapseBatchSize(const size_t auto_collapse_batch_size)
+  {
+    auto_collapse_batch_size_ = auto_collapse_batch_size;
+  }
+
+  /// Thread-safe variants of SetValue/GetImmutable, which may be called from
+  /// multiple threads at once (e.g. one per sensor). Updates to cells of
+  /// existing CELL_FILLED chunks proceed in parallel, guarded by per-cell
+  /// shard locks; updates that allocate or expand a chunk, and SET_CHUNK
+  /// updates, serialize against all others.
+  /// These must not be mixed with concurrent calls to the non-Concurrent
+  /// methods, and do not collapse chunks automatically.
+  common_robotics_utilities::voxel_grid::DSHVGSetStatus ConcurrentSetValue4d(
+      const Eigen::Vector4d& location,
+      const common_robotics_utilities::voxel_grid::DSHVGSetType set_type,
+      const CollisionCell& value);
+
+  common_robotics_utilities::voxel_grid::DSHVGSetStatus ConcurrentSetValue3d(
+      const Eigen::Vector3d& location,
+      const common_robotics_utilities::voxel_grid::DSHVGSetType set_type,
+      const CollisionCell& value)
+  {
+    const Eigen::Vector4d location4d(
+        location.x(), location.y(), location.z(), 1.0);
+    return ConcurrentSetValue4d(location4d, set_type, value);
+  }
+
+  /// Returns a copy of the cell, since references are not stable while other
+  /// threads may be allocating chunks.
+  common_robotics_utilities::OwningMaybe<CollisionCell>
+  ConcurrentGetValue4d(const Eigen::Vector4d& location);
+
+  common_robotics_utilities::OwningMaybe<CollisionCell>
+  ConcurrentGetValue3d(const Eigen::Vector3d& location)
+  {
+    const Eigen::Vector4d location4d(
+        location.x(), location.y(), location.z(), 1.0);
+    return ConcurrentGetValue4d(location4d);
+  }
 };
 }  // namespace voxelized_geometry_tools
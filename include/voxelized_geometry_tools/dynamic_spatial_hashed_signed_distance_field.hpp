@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/serialization.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <common_robotics_utilities/dynamic_spatial_hashed_voxel_grid.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Sparse, chunked signed distance field, e.g. as produced by
+/// DynamicSpatialHashedCollisionMap::ExtractSignedDistanceField(). Distances
+/// are truncated to [-truncation distance, truncation distance], and cells in
+/// chunks that were never allocated report the unallocated distance (i.e. the
+/// truncated distance of the collision map's default value).
+class DynamicSpatialHashedSignedDistanceField final
+    : public common_robotics_utilities::voxel_grid
+        ::DynamicSpatialHashedVoxelGridBase<float, std::vector<float>>
+{
+private:
+  using DeserializedDynamicSpatialHashedSignedDistanceField
+      = common_robotics_utilities::serialization
+          ::Deserialized<DynamicSpatialHashedSignedDistanceField>;
+
+  std::string frame_;
+  double truncation_distance_ = 0.0;
+
+  /// Implement the DynamicSpatialHashedVoxelGridBase interface.
+
+  /// We need to implement cloning.
+  std::unique_ptr<common_robotics_utilities::voxel_grid
+      ::DynamicSpatialHashedVoxelGridBase<float, std::vector<float>>>
+  DoClone() const override;
+
+  /// We need to serialize the frame and truncation distance.
+  uint64_t DerivedSerializeSelf(
+      std::vector<uint8_t>& buffer,
+      const common_robotics_utilities::serialization::Serializer<float>&
+          value_serializer) const override;
+
+  /// We need to deserialize the frame and truncation distance.
+  uint64_t DerivedDeserializeSelf(
+      const std::vector<uint8_t>& buffer, const uint64_t starting_offset,
+      const common_robotics_utilities::serialization::Deserializer<float>&
+          value_deserializer) override;
+
+  bool OnMutableAccess(const Eigen::Vector4d& location) override;
+
+public:
+  static uint64_t Serialize(
+      const DynamicSpatialHashedSignedDistanceField& sdf,
+      std::vector<uint8_t>& buffer);
+
+  static DeserializedDynamicSpatialHashedSignedDistanceField Deserialize(
+      const std::vector<uint8_t>& buffer, const uint64_t starting_offset);
+
+  static void SaveToFile(const DynamicSpatialHashedSignedDistanceField& sdf,
+                         const std::string& filepath,
+                         const bool compress);
+
+  static DynamicSpatialHashedSignedDistanceField LoadFromFile(
+      const std::string& filepath);
+
+  DynamicSpatialHashedSignedDistanceField(
+      const Eigen::Isometry3d& origin_transform,
+      const common_robotics_utilities::voxel_grid::GridSizes& chunk_sizes,
+      const double truncation_distance, const float unallocated_distance,
+      const size_t expected_chunks, const std::string& frame);
+
+  DynamicSpatialHashedSignedDistanceField()
+      : DynamicSpatialHashedVoxelGridBase<float, std::vector<float>>() {}
+
+  double GetResolution() const { return GetCellSizes().x(); }
+
+  const std::string& GetFrame() const { return frame_; }
+
+  void SetFrame(const std::string& frame) { frame_ = frame; }
+
+  double GetTruncationDistance() const { return truncation_distance_; }
+
+  /// Distance at location, which is a single hashed chunk lookup. Locations
+  /// in unallocated chunks return the unallocated distance.
+  float GetDistance4d(const Eigen::Vector4d& location) const
+  {
+    const auto query = GetImmutable4d(location);
+    if (query)
+    {
+      return query.Value();
+    }
+    else
+    {
+      return GetDefaultValue();
+    }
+  }
+
+  float GetDistance3d(const Eigen::Vector3d& location) const
+  {
+    return GetDistance4d(
+        Eigen::Vector4d(location.x(), location.y(), location.z(), 1.0));
+  }
+
+  /// Store distances for every cell of the chunk whose minimum cell is
+  /// chunk_lower_index (in the implicit cell indexing of the grid).
+  /// Distances are ordered x-major, z-minor. Chunks that are entirely the
+  /// unallocated distance are not allocated, and other uniform chunks are
+  /// stored as CHUNK_FILLED.
+  void SetChunkDistances(
+      const common_robotics_utilities::voxel_grid::GridIndex&
+          chunk_lower_index,
+      const std::vector<float>& distances);
+};
+}  // namespace voxelized_geometry_tools
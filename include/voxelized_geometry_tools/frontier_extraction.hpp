@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace frontier_extraction
+{
+/// Exploration frontiers of a CollisionMap: free cells (occupancy < 0.5) with
+/// at least one face-adjacent unknown cell (occupancy == 0.5). Cells outside
+/// the grid are not unknown, so the grid border is not a frontier by itself.
+///
+/// Frontier cells are returned as sorted CollisionMap data indices. They are
+/// found in a single pass over byte masks of free and unknown cells, one
+/// contiguous z row at a time, rather than with per-cell neighbor lookups,
+/// in parallel if use_parallel is set.
+
+/// Returns the frontier cells of the whole map.
+std::vector<int64_t> ExtractFrontierCells(
+    const CollisionMap& map, const bool use_parallel);
+
+/// Returns the frontier cells within one cell of the provided regions, e.g.
+/// map.GetDirtyTiles() after a voxelization, which covers every cell whose
+/// frontier status can have changed. Regions are clipped to the grid.
+std::vector<int64_t> ExtractFrontierCells(
+    const CollisionMap& map, const std::vector<GridIndexRegion>& regions,
+    const bool use_parallel);
+
+/// Groups frontier cells (data indices, as above) into frontier components,
+/// connected through faces, edges, or corners, since frontiers are surfaces
+/// that are rarely aligned with the grid. Each component is sorted, and
+/// components are ordered by their first cell.
+std::vector<std::vector<int64_t>> ClusterFrontierCells(
+    const CollisionMap& map, const std::vector<int64_t>& frontier_cells);
+}  // namespace frontier_extraction
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+#include <common_robotics_utilities/voxel_grid.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Axis-aligned box of grid indices covering [lower, upper) on each axis.
+class GridIndexRegion
+{
+private:
+  common_robotics_utilities::voxel_grid::GridIndex lower_;
+  common_robotics_utilities::voxel_grid::GridIndex upper_;
+
+public:
+  GridIndexRegion(
+      const common_robotics_utilities::voxel_grid::GridIndex& lower,
+      const common_robotics_utilities::voxel_grid::GridIndex& upper)
+      : lower_(lower), upper_(upper)
+  {
+    if (upper_.X() < lower_.X() || upper_.Y() < lower_.Y()
+        || upper_.Z() < lower_.Z())
+    {
+      throw std::invalid_argument("upper < lower");
+    }
+  }
+
+  GridIndexRegion() : GridIndexRegion(
+      common_robotics_utilities::voxel_grid::GridIndex(0, 0, 0),
+      common_robotics_utilities::voxel_grid::GridIndex(0, 0, 0)) {}
+
+  const common_robotics_utilities::voxel_grid::GridIndex& Lower() const
+  {
+    return lower_;
+  }
+
+  const common_robotics_utilities::voxel_grid::GridIndex& Upper() const
+  {
+    return upper_;
+  }
+
+  int64_t NumXCells() const { return upper_.X() - lower_.X(); }
+
+  int64_t NumYCells() const { return upper_.Y() - lower_.Y(); }
+
+  int64_t NumZCells() const { return upper_.Z() - lower_.Z(); }
+
+  int64_t TotalCells() const { return NumXCells() * NumYCells() * NumZCells(); }
+
+  bool IsEmpty() const { return TotalCells() == 0; }
+
+  bool Contains(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const
+  {
+    return (index.X() >= lower_.X() && index.X() < upper_.X()
+            && index.Y() >= lower_.Y() && index.Y() < upper_.Y()
+            && index.Z() >= lower_.Z() && index.Z() < upper_.Z());
+  }
+
+  /// Grow (or shrink, for negative cells) the region on every side.
+  GridIndexRegion Expanded(const int64_t cells) const
+  {
+    const common_robotics_utilities::voxel_grid::GridIndex lower(
+        lower_.X() - cells, lower_.Y() - cells, lower_.Z() - cells);
+    const common_robotics_utilities::voxel_grid::GridIndex upper(
+        std::max(lower.X(), upper_.X() + cells),
+        std::max(lower.Y(), upper_.Y() + cells),
+        std::max(lower.Z(), upper_.Z() + cells));
+    return GridIndexRegion(lower, upper);
+  }
+
+  /// Intersection with the provided region, empty if they do not overlap.
+  GridIndexRegion Intersected(const GridIndexRegion& other) const
+  {
+    const common_robotics_utilities::voxel_grid::GridIndex lower(
+        std::max(lower_.X(), other.lower_.X()),
+        std::max(lower_.Y(), other.lower_.Y()),
+        std::max(lower_.Z(), other.lower_.Z()));
+    const common_robotics_utilities::voxel_grid::GridIndex upper(
+        std::max(lower.X(), std::min(upper_.X(), other.upper_.X())),
+        std::max(lower.Y(), std::min(upper_.Y(), other.upper_.Y())),
+        std::max(lower.Z(), std::min(upper_.Z(), other.upper_.Z())));
+    return GridIndexRegion(lower, upper);
+  }
+};
+}  // namespace voxelized_geometry_tools
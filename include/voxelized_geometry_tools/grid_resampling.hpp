@@ -0,0 +1,376 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/utility.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/copy_on_write_tiled_vector.hpp>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+#include <voxelized_geometry_tools/tagged_object_collision_map.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace grid_resampling
+{
+/// Makes an empty grid of the same type, frame, default and OOB values as
+/// grid, with the provided origin transform and sizes.
+inline CollisionMap MakeResampledGrid(
+    const CollisionMap& grid, const Eigen::Isometry3d& origin_transform,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes)
+{
+  return CollisionMap(origin_transform, grid.GetFrame(), sizes,
+                      grid.GetDefaultValue(), grid.GetOOBValue());
+}
+
+inline TaggedObjectCollisionMap MakeResampledGrid(
+    const TaggedObjectCollisionMap& grid,
+    const Eigen::Isometry3d& origin_transform,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes)
+{
+  return TaggedObjectCollisionMap(origin_transform, grid.GetFrame(), sizes,
+                                  grid.GetDefaultValue(), grid.GetOOBValue());
+}
+
+template<typename BackingStore>
+SignedDistanceField<BackingStore> MakeResampledGrid(
+    const SignedDistanceField<BackingStore>& grid,
+    const Eigen::Isometry3d& origin_transform,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes)
+{
+  return SignedDistanceField<BackingStore>(
+      origin_transform, grid.GetFrame(), sizes, grid.GetDefaultValue(),
+      grid.GetOOBValue());
+}
+
+/// Carries state other than cell values over from grid once resampled has
+/// been filled in. Only SDFs have such state (their lock).
+inline void FinishResampledGrid(const CollisionMap&, CollisionMap&) {}
+
+inline void FinishResampledGrid(
+    const TaggedObjectCollisionMap&, TaggedObjectCollisionMap&) {}
+
+template<typename BackingStore>
+void FinishResampledGrid(
+    const SignedDistanceField<BackingStore>& grid,
+    SignedDistanceField<BackingStore>& resampled)
+{
+  if (grid.IsLocked())
+  {
+    resampled.Lock();
+  }
+}
+
+/// Offset of a cell in the x-major, z-minor dense backing store.
+inline size_t DataIndex(
+    const int64_t num_y_cells, const int64_t num_z_cells,
+    const int64_t x_index, const int64_t y_index, const int64_t z_index)
+{
+  return static_cast<size_t>(
+      (((x_index * num_y_cells) + y_index) * num_z_cells) + z_index);
+}
+
+/// Downsamples grid by an integer factor, keeping the origin. Each coarse
+/// cell covers factor^3 fine cells (fewer along the upper edges, where the
+/// coarse grid is rounded up), and its value is pooled from them with
+/// pool_fn(pooled, fine_cell), starting from pool_fn(first, first).
+/// Coarse cells are computed in parallel if use_parallel is set.
+template<typename GridType, typename CellType, typename PoolFunction>
+GridType DownsampleGrid(
+    const GridType& grid, const int64_t factor, const PoolFunction& pool_fn,
+    const bool use_parallel)
+{
+  if (factor < 1)
+  {
+    throw std::invalid_argument("factor < 1");
+  }
+  const int64_t num_x_cells = grid.GetNumXCells();
+  const int64_t num_y_cells = grid.GetNumYCells();
+  const int64_t num_z_cells = grid.GetNumZCells();
+  const int64_t num_coarse_x_cells = (num_x_cells + factor - 1) / factor;
+  const int64_t num_coarse_y_cells = (num_y_cells + factor - 1) / factor;
+  const int64_t num_coarse_z_cells = (num_z_cells + factor - 1) / factor;
+  GridType coarse_grid = MakeResampledGrid(
+      grid, grid.GetOriginTransform(),
+      common_robotics_utilities::voxel_grid::GridSizes(
+          grid.GetResolution() * static_cast<double>(factor),
+          num_coarse_x_cells, num_coarse_y_cells, num_coarse_z_cells));
+  const auto& fine_cells = grid.GetImmutableRawData();
+  auto& coarse_cells = coarse_grid.GetMutableRawData();
+  MakeUniqueForConcurrentWrites(coarse_cells);
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t coarse_x = 0; coarse_x < num_coarse_x_cells; coarse_x++)
+  {
+    const int64_t x_start = coarse_x * factor;
+    const int64_t x_end = std::min(x_start + factor, num_x_cells);
+    for (int64_t coarse_y = 0; coarse_y < num_coarse_y_cells; coarse_y++)
+    {
+      const int64_t y_start = coarse_y * factor;
+      const int64_t y_end = std::min(y_start + factor, num_y_cells);
+      for (int64_t coarse_z = 0; coarse_z < num_coarse_z_cells; coarse_z++)
+      {
+        const int64_t z_start = coarse_z * factor;
+        const int64_t z_end = std::min(z_start + factor, num_z_cells);
+        const CellType& first_cell = fine_cells[DataIndex(
+            num_y_cells, num_z_cells, x_start, y_start, z_start)];
+        CellType pooled = pool_fn(first_cell, first_cell);
+        for (int64_t x_index = x_start; x_index < x_end; x_index++)
+        {
+          for (int64_t y_index = y_start; y_index < y_end; y_index++)
+          {
+            const size_t row_start = DataIndex(
+                num_y_cells, num_z_cells, x_index, y_index, 0);
+            for (int64_t z_index = z_start; z_index < z_end; z_index++)
+            {
+              pooled = pool_fn(
+                  pooled, fine_cells[row_start + static_cast<size_t>(z_index)]);
+            }
+          }
+        }
+        coarse_cells[DataIndex(num_coarse_y_cells, num_coarse_z_cells,
+                               coarse_x, coarse_y, coarse_z)] = pooled;
+      }
+    }
+  }
+  FinishResampledGrid(grid, coarse_grid);
+  return coarse_grid;
+}
+
+/// Upsamples grid by an integer factor, keeping the origin. Each fine cell is
+/// refine_fn(coarse_cell, offset), where offset is the vector from the
+/// coarse cell center to the fine cell center. Fine cells are computed in
+/// parallel if use_parallel is set.
+template<typename GridType, typename CellType, typename RefineFunction>
+GridType UpsampleGrid(
+    const GridType& grid, const int64_t factor,
+    const RefineFunction& refine_fn, const bool use_parallel)
+{
+  if (factor < 1)
+  {
+    throw std::invalid_argument("factor < 1");
+  }
+  const int64_t num_x_cells = grid.GetNumXCells();
+  const int64_t num_y_cells = grid.GetNumYCells();
+  const int64_t num_z_cells = grid.GetNumZCells();
+  const int64_t num_fine_x_cells = num_x_cells * factor;
+  const int64_t num_fine_y_cells = num_y_cells * factor;
+  const int64_t num_fine_z_cells = num_z_cells * factor;
+  const double coarse_resolution = grid.GetResolution();
+  const double fine_resolution
+      = coarse_resolution / static_cast<double>(factor);
+  GridType fine_grid = MakeResampledGrid(
+      grid, grid.GetOriginTransform(),
+      common_robotics_utilities::voxel_grid::GridSizes(
+          fine_resolution, num_fine_x_cells, num_fine_y_cells,
+          num_fine_z_cells));
+  const auto& coarse_cells = grid.GetImmutableRawData();
+  auto& fine_cells = fine_grid.GetMutableRawData();
+  MakeUniqueForConcurrentWrites(fine_cells);
+  // Offset along one axis from a coarse cell center to the center of its
+  // idx-th fine cell.
+  const auto axis_offset = [&] (const int64_t idx)
+  {
+    return ((static_cast<double>(idx % factor) + 0.5) * fine_resolution)
+           - (0.5 * coarse_resolution);
+  };
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t fine_x = 0; fine_x < num_fine_x_cells; fine_x++)
+  {
+    for (int64_t fine_y = 0; fine_y < num_fine_y_cells; fine_y++)
+    {
+      const size_t coarse_row_start = DataIndex(
+          num_y_cells, num_z_cells, fine_x / factor, fine_y / factor, 0);
+      const size_t fine_row_start = DataIndex(
+          num_fine_y_cells, num_fine_z_cells, fine_x, fine_y, 0);
+      for (int64_t fine_z = 0; fine_z < num_fine_z_cells; fine_z++)
+      {
+        const Eigen::Vector3d offset(
+            axis_offset(fine_x), axis_offset(fine_y), axis_offset(fine_z));
+        const CellType& coarse_cell = coarse_cells[
+            coarse_row_start + static_cast<size_t>(fine_z / factor)];
+        fine_cells[fine_row_start + static_cast<size_t>(fine_z)]
+            = refine_fn(coarse_cell, offset);
+      }
+    }
+  }
+  FinishResampledGrid(grid, fine_grid);
+  return fine_grid;
+}
+
+/// Re-grids grid into a new grid with arbitrary origin transform (e.g. a
+/// rotated frame) and sizes. Each new cell takes the value of the source cell
+/// containing its center, or the OOB value of grid if there is none.
+///
+/// The new cell centers are stepped incrementally in source cell units: one
+/// transform per row of cells, then a constant step along the row, rather
+/// than a full location-to-index transform per cell. Rows are computed in
+/// parallel if use_parallel is set.
+template<typename GridType>
+GridType Regrid(
+    const GridType& grid, const Eigen::Isometry3d& origin_transform,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+    const bool use_parallel)
+{
+  GridType regridded = MakeResampledGrid(grid, origin_transform, sizes);
+  const int64_t num_x_cells = grid.GetNumXCells();
+  const int64_t num_y_cells = grid.GetNumYCells();
+  const int64_t num_z_cells = grid.GetNumZCells();
+  const int64_t num_new_x_cells = regridded.GetNumXCells();
+  const int64_t num_new_y_cells = regridded.GetNumYCells();
+  const int64_t num_new_z_cells = regridded.GetNumZCells();
+  const double new_resolution = regridded.GetResolution();
+  // Transform from the new grid frame to the source grid frame, scaled to
+  // source cell units, so that source indices are the floor of the result.
+  const Eigen::Isometry3d new_to_source
+      = grid.GetInverseOriginTransform() * origin_transform;
+  const double inv_resolution = 1.0 / grid.GetResolution();
+  const Eigen::Matrix3d step_vectors
+      = new_to_source.linear() * (new_resolution * inv_resolution);
+  const Eigen::Vector3d first_center
+      = (new_to_source * Eigen::Vector3d::Constant(0.5 * new_resolution))
+          * inv_resolution;
+  const auto& source_cells = grid.GetImmutableRawData();
+  auto& new_cells = regridded.GetMutableRawData();
+  MakeUniqueForConcurrentWrites(new_cells);
+  const auto oob_value = grid.GetOOBValue();
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t new_x = 0; new_x < num_new_x_cells; new_x++)
+  {
+    for (int64_t new_y = 0; new_y < num_new_y_cells; new_y++)
+    {
+      Eigen::Vector3d source_location
+          = first_center
+            + (step_vectors.col(0) * static_cast<double>(new_x))
+            + (step_vectors.col(1) * static_cast<double>(new_y));
+      const size_t new_row_start = DataIndex(
+          num_new_y_cells, num_new_z_cells, new_x, new_y, 0);
+      for (int64_t new_z = 0; new_z < num_new_z_cells; new_z++)
+      {
+        const int64_t x_index
+            = static_cast<int64_t>(std::floor(source_location.x()));
+        const int64_t y_index
+            = static_cast<int64_t>(std::floor(source_location.y()));
+        const int64_t z_index
+            = static_cast<int64_t>(std::floor(source_location.z()));
+        const bool in_bounds
+            = x_index >= 0 && x_index < num_x_cells
+              && y_index >= 0 && y_index < num_y_cells
+              && z_index >= 0 && z_index < num_z_cells;
+        new_cells[new_row_start + static_cast<size_t>(new_z)]
+            = in_bounds
+                ? source_cells[DataIndex(num_y_cells, num_z_cells,
+                                         x_index, y_index, z_index)]
+                : oob_value;
+        source_location += step_vectors.col(2);
+      }
+    }
+  }
+  FinishResampledGrid(grid, regridded);
+  return regridded;
+}
+
+/// Conservative downsampling: each coarse cell takes the maximum occupancy of
+/// its fine cells (filled over unknown over free).
+inline CollisionMap Downsample(
+    const CollisionMap& map, const int64_t factor, const bool use_parallel)
+{
+  return DownsampleGrid<CollisionMap, CollisionCell>(
+      map, factor, [] (const CollisionCell& pooled, const CollisionCell& cell)
+  {
+    return CollisionCell(std::max(pooled.Occupancy(), cell.Occupancy()));
+  }, use_parallel);
+}
+
+/// Conservative downsampling: each coarse cell takes the occupancy and object
+/// id of its most occupied fine cell.
+inline TaggedObjectCollisionMap Downsample(
+    const TaggedObjectCollisionMap& map, const int64_t factor,
+    const bool use_parallel)
+{
+  return DownsampleGrid<TaggedObjectCollisionMap, TaggedObjectCollisionCell>(
+      map, factor, [] (const TaggedObjectCollisionCell& pooled,
+                       const TaggedObjectCollisionCell& cell)
+  {
+    const TaggedObjectCollisionCell& most_occupied
+        = (cell.Occupancy() > pooled.Occupancy()) ? cell : pooled;
+    return TaggedObjectCollisionCell(
+        most_occupied.Occupancy(), most_occupied.ObjectId());
+  }, use_parallel);
+}
+
+/// Conservative downsampling: since distance changes by at most the distance
+/// moved, each coarse cell takes the minimum distance of its fine cells minus
+/// the largest distance from its center to one of theirs,
+/// sqrt(3) * (factor - 1) / 2 fine cells, a lower bound on its true distance.
+template<typename BackingStore>
+SignedDistanceField<BackingStore> Downsample(
+    const SignedDistanceField<BackingStore>& sdf, const int64_t factor,
+    const bool use_parallel)
+{
+  const double max_center_offset
+      = std::sqrt(3.0) * (static_cast<double>(factor - 1) * 0.5)
+        * sdf.GetResolution();
+  return DownsampleGrid<SignedDistanceField<BackingStore>, float>(
+      sdf, factor, [&] (const float pooled, const float distance)
+  {
+    return std::min(pooled, static_cast<float>(
+        static_cast<double>(distance) - max_center_offset));
+  }, use_parallel);
+}
+
+/// Each fine cell takes the occupancy of its coarse cell.
+inline CollisionMap Upsample(
+    const CollisionMap& map, const int64_t factor, const bool use_parallel)
+{
+  return UpsampleGrid<CollisionMap, CollisionCell>(
+      map, factor, [] (const CollisionCell& cell, const Eigen::Vector3d&)
+  {
+    return CollisionCell(cell.Occupancy());
+  }, use_parallel);
+}
+
+/// Each fine cell takes the occupancy and object id of its coarse cell.
+inline TaggedObjectCollisionMap Upsample(
+    const TaggedObjectCollisionMap& map, const int64_t factor,
+    const bool use_parallel)
+{
+  return UpsampleGrid<TaggedObjectCollisionMap, TaggedObjectCollisionCell>(
+      map, factor, [] (const TaggedObjectCollisionCell& cell,
+                       const Eigen::Vector3d&)
+  {
+    return TaggedObjectCollisionCell(cell.Occupancy(), cell.ObjectId());
+  }, use_parallel);
+}
+
+/// Conservative upsampling: since distance changes by at most the distance
+/// moved, each fine cell takes its coarse cell's distance minus the distance
+/// between the two cell centers, a lower bound on its true distance.
+template<typename BackingStore>
+SignedDistanceField<BackingStore> Upsample(
+    const SignedDistanceField<BackingStore>& sdf, const int64_t factor,
+    const bool use_parallel)
+{
+  return UpsampleGrid<SignedDistanceField<BackingStore>, float>(
+      sdf, factor, [] (const float distance, const Eigen::Vector3d& offset)
+  {
+    return static_cast<float>(static_cast<double>(distance) - offset.norm());
+  }, use_parallel);
+}
+}  // namespace grid_resampling
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace voxelized_geometry_tools
+{
+/// Phase timers and counters reported by SDF generation, topology
+/// computation, and pointcloud voxelization. Nothing is reported unless a sink
+/// is installed with SetInstrumentationSink().
+namespace instrumentation
+{
+/// Receives reports from instrumented code. Reports may arrive concurrently
+/// from several threads, so implementations must be thread-safe.
+class InstrumentationSink
+{
+public:
+  virtual ~InstrumentationSink() {}
+
+  /// Instrumented code skips all reporting when this is false.
+  virtual bool IsEnabled() const { return true; }
+
+  /// Called once each time the named phase completes.
+  virtual void RecordPhase(
+      const std::string& phase, const double elapsed_seconds) = 0;
+
+  /// Adds value to the named counter, e.g. cells processed.
+  virtual void AddToCounter(
+      const std::string& counter, const int64_t value) = 0;
+
+  /// Records a sample of a quantity whose peak matters, e.g. queue size.
+  virtual void RecordPeak(const std::string& gauge, const int64_t value) = 0;
+};
+
+using InstrumentationSinkPtr = std::shared_ptr<InstrumentationSink>;
+
+/// Default sink, which drops everything.
+class NullInstrumentationSink : public InstrumentationSink
+{
+public:
+  bool IsEnabled() const override { return false; }
+
+  void RecordPhase(const std::string&, const double) override {}
+
+  void AddToCounter(const std::string&, const int64_t) override {}
+
+  void RecordPeak(const std::string&, const int64_t) override {}
+};
+
+class PhaseStatistics
+{
+private:
+  int64_t count_ = 0;
+  double total_seconds_ = 0.0;
+  double min_seconds_ = std::numeric_limits<double>::infinity();
+  double max_seconds_ = 0.0;
+
+public:
+  void AddSample(const double elapsed_seconds)
+  {
+    count_++;
+    total_seconds_ += elapsed_seconds;
+    min_seconds_ = std::min(min_seconds_, elapsed_seconds);
+    max_seconds_ = std::max(max_seconds_, elapsed_seconds);
+  }
+
+  int64_t Count() const { return count_; }
+
+  double TotalSeconds() const { return total_seconds_; }
+
+  double MinSeconds() const { return min_seconds_; }
+
+  double MaxSeconds() const { return max_seconds_; }
+
+  double MeanSeconds() const
+  {
+    return (count_ > 0) ? (total_seconds_ / static_cast<double>(count_)) : 0.0;
+  }
+};
+
+/// Sink that accumulates per-phase statistics, counter totals, and peaks.
+class InstrumentationAggregator : public InstrumentationSink
+{
+public:
+  void RecordPhase(
+      const std::string& phase, const double elapsed_seconds) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    phases_[phase].AddSample(elapsed_seconds);
+  }
+
+  void AddToCounter(const std::string& counter, const int64_t value) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_[counter] += value;
+  }
+
+  void RecordPeak(const std::string& gauge, const int64_t value) override
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found_itr = peaks_.find(gauge);
+    if (found_itr == peaks_.end())
+    {
+      peaks_[gauge] = value;
+    }
+    else
+    {
+      found_itr->second = std::max(found_itr->second, value);
+    }
+  }
+
+  std::map<std::string, PhaseStatistics> GetPhaseStatistics() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return phases_;
+  }
+
+  std::map<std::string, int64_t> GetCounters() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_;
+  }
+
+  std::map<std::string, int64_t> GetPeaks() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return peaks_;
+  }
+
+  void Reset()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    phases_.clear();
+    counters_.clear();
+    peaks_.clear();
+  }
+
+  /// Writes one line per phase, counter, and peak, sorted by name.
+  void Dump(std::ostream& stream) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& phase : phases_)
+    {
+      const PhaseStatistics& statistics = phase.second;
+      stream << "[phase] " << phase.first << " count " << statistics.Count()
+             << " total " << statistics.TotalSeconds() << " s mean "
+             << statistics.MeanSeconds() << " s min "
+             << statistics.MinSeconds() << " s max "
+             << statistics.MaxSeconds() << " s\n";
+    }
+    for (const auto& counter : counters_)
+    {
+      stream << "[counter] " << counter.first << " " << counter.second << "\n";
+    }
+    for (const auto& peak : peaks_)
+    {
+      stream << "[peak] " << peak.first << " " << peak.second << "\n";
+    }
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::map<std::string, PhaseStatistics> phases_;
+  std::map<std::string, int64_t> counters_;
+  std::map<std::string, int64_t> peaks_;
+};
+
+class InstrumentationSinkRegistry
+{
+public:
+  static InstrumentationSinkRegistry& Instance()
+  {
+    static InstrumentationSinkRegistry registry;
+    return registry;
+  }
+
+  /// Instrumented code calls this on every entry, so it uses the atomic
+  /// shared_ptr accessors rather than serializing callers on a mutex.
+  InstrumentationSinkPtr Get() const { return std::atomic_load(&sink_); }
+
+  void Set(const InstrumentationSinkPtr& sink)
+  {
+    std::atomic_store(
+        &sink_, (sink) ? sink : std::make_shared<NullInstrumentationSink>());
+  }
+
+private:
+  InstrumentationSinkRegistry()
+      : sink_(std::make_shared<NullInstrumentationSink>()) {}
+
+  InstrumentationSinkPtr sink_;
+};
+
+/// Returns the process-wide sink; never null.
+inline InstrumentationSinkPtr GetInstrumentationSink()
+{
+  return InstrumentationSinkRegistry::Instance().Get();
+}
+
+/// Installs the process-wide sink; nullptr restores the no-op default.
+inline void SetInstrumentationSink(const InstrumentationSinkPtr& sink)
+{
+  InstrumentationSinkRegistry::Instance().Set(sink);
+}
+
+/// Reports the time between construction and destruction as a phase.
+class ScopedPhaseTimer
+{
+public:
+  ScopedPhaseTimer(InstrumentationSink& sink, const char* phase)
+      : sink_(sink), phase_(phase),
+        start_time_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedPhaseTimer()
+  {
+    if (sink_.IsEnabled())
+    {
+      const std::chrono::duration<double> elapsed
+          = std::chrono::steady_clock::now() - start_time_;
+      sink_.RecordPhase(phase_, elapsed.count());
+    }
+  }
+
+  ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+
+  ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+
+private:
+  InstrumentationSink& sink_;
+  const char* phase_ = nullptr;
+  std::chrono::time_point<std::chrono::steady_clock> start_time_;
+};
+}  // namespace instrumentation
+}  // namespace voxelized_geometry_tools
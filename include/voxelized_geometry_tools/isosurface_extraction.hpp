@@ -0,0 +1,296 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/utility.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace isosurface_extraction
+{
+/// Indexed triangle mesh. Vertices are in the grid frame of the source SDF,
+/// so the mesh carries that grid's origin transform.
+class TriangleMesh
+{
+private:
+  Eigen::Isometry3d origin_transform_ = Eigen::Isometry3d::Identity();
+  std::vector<Eigen::Vector3d> vertices_;
+  std::vector<Eigen::Vector3i> triangles_;
+
+public:
+  TriangleMesh(const Eigen::Isometry3d& origin_transform,
+               std::vector<Eigen::Vector3d> vertices,
+               std::vector<Eigen::Vector3i> triangles)
+      : origin_transform_(origin_transform), vertices_(std::move(vertices)),
+        triangles_(std::move(triangles)) {}
+
+  TriangleMesh() {}
+
+  const Eigen::Isometry3d& GetOriginTransform() const
+  {
+    return origin_transform_;
+  }
+
+  const std::vector<Eigen::Vector3d>& GetVertices() const { return vertices_; }
+
+  /// Triangles index into GetVertices(), wound counter-clockwise when viewed
+  /// from outside (the side above the iso-level).
+  const std::vector<Eigen::Vector3i>& GetTriangles() const
+  {
+    return triangles_;
+  }
+
+  /// Vertices transformed by the origin transform, i.e. in the SDF's frame.
+  std::vector<Eigen::Vector3d> GetVerticesInOriginFrame() const
+  {
+    std::vector<Eigen::Vector3d> transformed_vertices(vertices_.size());
+    for (size_t idx = 0; idx < vertices_.size(); idx++)
+    {
+      transformed_vertices.at(idx) = origin_transform_ * vertices_.at(idx);
+    }
+    return transformed_vertices;
+  }
+};
+
+/// Extracts the @param iso_level isosurface of @param sdf with naive surface
+/// nets. Each dual cube (the eight cell centers around a lattice vertex)
+/// whose corners straddle the iso-level gets exactly one vertex, placed at
+/// the mean of its edge crossings, so vertices are shared by construction;
+/// each lattice edge crossing the iso-level emits one quad (two triangles)
+/// joining the four cubes around it. Both passes are parallel over x-slabs,
+/// with vertices numbered via per-slab counts. The mesh is open where the
+/// surface leaves the grid.
+template<typename BackingStore=std::vector<float>>
+inline TriangleMesh ExtractIsosurfaceMesh(
+    const SignedDistanceField<BackingStore>& sdf, const float iso_level,
+    const bool use_parallel)
+{
+  const int64_t num_x_cells = sdf.GetNumXCells();
+  const int64_t num_y_cells = sdf.GetNumYCells();
+  const int64_t num_z_cells = sdf.GetNumZCells();
+  if (num_x_cells < 2 || num_y_cells < 2 || num_z_cells < 2)
+  {
+    return TriangleMesh(sdf.GetOriginTransform(), {}, {});
+  }
+  const int64_t num_cells[3] = {num_x_cells, num_y_cells, num_z_cells};
+  const Eigen::Vector3d cell_sizes = sdf.GetCellSizes();
+  // Dual cubes are indexed by their lower corner cell.
+  const int64_t num_x_cubes = num_x_cells - 1;
+  const int64_t num_y_cubes = num_y_cells - 1;
+  const int64_t num_z_cubes = num_z_cells - 1;
+  const auto cube_offset = [&] (const int64_t x_index, const int64_t y_index,
+                                const int64_t z_index)
+  {
+    return static_cast<size_t>(
+        (((x_index * num_y_cubes) + y_index) * num_z_cubes) + z_index);
+  };
+  const auto distance = [&] (const int64_t x_index, const int64_t y_index,
+                             const int64_t z_index)
+  {
+    return sdf.GetImmutable(x_index, y_index, z_index).Value();
+  };
+  const auto cube_corner = [] (const int32_t corner)
+  {
+    return Eigen::Vector3i((corner >> 2) & 1, (corner >> 1) & 1, corner & 1);
+  };
+  const auto cube_straddles = [&] (const int64_t x_index, const int64_t y_index,
+                                   const int64_t z_index)
+  {
+    int32_t num_inside = 0;
+    for (int32_t corner = 0; corner < 8; corner++)
+    {
+      const Eigen::Vector3i offset = cube_corner(corner);
+      if (distance(x_index + offset.x(), y_index + offset.y(),
+                   z_index + offset.z()) < iso_level)
+      {
+        num_inside++;
+      }
+    }
+    return (num_inside > 0 && num_inside < 8);
+  };
+  // Count vertices in each x-slab of cubes.
+  std::vector<int32_t> slab_vertex_offsets(
+      static_cast<size_t>(num_x_cubes) + 1, 0);
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t x_index = 0; x_index < num_x_cubes; x_index++)
+  {
+    int32_t slab_count = 0;
+    for (int64_t y_index = 0; y_index < num_y_cubes; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < num_z_cubes; z_index++)
+      {
+        if (cube_straddles(x_index, y_index, z_index))
+        {
+          slab_count++;
+        }
+      }
+    }
+    slab_vertex_offsets.at(static_cast<size_t>(x_index) + 1) = slab_count;
+  }
+  for (size_t idx = 1; idx < slab_vertex_offsets.size(); idx++)
+  {
+    slab_vertex_offsets.at(idx) += slab_vertex_offsets.at(idx - 1);
+  }
+  // Place one vertex per straddling cube.
+  std::vector<Eigen::Vector3d> vertices(
+      static_cast<size_t>(slab_vertex_offsets.back()));
+  std::vector<int32_t> cube_vertices(
+      static_cast<size_t>(num_x_cubes * num_y_cubes * num_z_cubes), -1);
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+  for (int64_t x_index = 0; x_index < num_x_cubes; x_index++)
+  {
+    int32_t vertex_index
+        = slab_vertex_offsets.at(static_cast<size_t>(x_index));
+    for (int64_t y_index = 0; y_index < num_y_cubes; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < num_z_cubes; z_index++)
+      {
+        if (!cube_straddles(x_index, y_index, z_index))
+        {
+          continue;
+        }
+        // Average the crossings on the 12 cube edges (corner pairs that
+        // differ in exactly one bit).
+        Eigen::Vector3d crossing_sum = Eigen::Vector3d::Zero();
+        int32_t num_crossings = 0;
+        for (int32_t corner = 0; corner < 8; corner++)
+        {
+          for (int32_t axis_bit = 1; axis_bit < 8; axis_bit <<= 1)
+          {
+            if ((corner & axis_bit) != 0)
+            {
+              continue;
+            }
+            const Eigen::Vector3i low_offset = cube_corner(corner);
+            const Eigen::Vector3i high_offset = cube_corner(corner | axis_bit);
+            const float low_distance
+                = distance(x_index + low_offset.x(), y_index + low_offset.y(),
+                           z_index + low_offset.z());
+            const float high_distance
+                = distance(x_index + high_offset.x(),
+                           y_index + high_offset.y(),
+                           z_index + high_offset.z());
+            if ((low_distance < iso_level) != (high_distance < iso_level))
+            {
+              const double fraction
+                  = static_cast<double>(iso_level - low_distance)
+                    / static_cast<double>(high_distance - low_distance);
+              crossing_sum += low_offset.cast<double>()
+                              + (fraction * (high_offset - low_offset)
+                                                .cast<double>());
+              num_crossings++;
+            }
+          }
+        }
+        const Eigen::Vector3d cube_position
+            = crossing_sum / static_cast<double>(num_crossings);
+        // Cell centers are offset by half a cell from the grid origin.
+        const Eigen::Vector3d vertex_cells
+            = Eigen::Vector3d(static_cast<double>(x_index),
+                              static_cast<double>(y_index),
+                              static_cast<double>(z_index))
+              + cube_position + Eigen::Vector3d::Constant(0.5);
+        vertices.at(static_cast<size_t>(vertex_index))
+            = vertex_cells.cwiseProduct(cell_sizes);
+        cube_vertices.at(cube_offset(x_index, y_index, z_index))
+            = vertex_index;
+        vertex_index++;
+      }
+    }
+  }
+  // Emit a quad for each lattice edge that crosses the iso-level. For an
+  // edge along axis a, the four cubes around it are visited in
+  // counter-clockwise order about +a, so the quad faces +a; it is flipped
+  // when the inside is on the +a end.
+  std::vector<std::vector<Eigen::Vector3i>> slab_triangles(
+      static_cast<size_t>(num_x_cells));
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+  for (int64_t x_index = 0; x_index < num_x_cells; x_index++)
+  {
+    std::vector<Eigen::Vector3i>& triangles
+        = slab_triangles.at(static_cast<size_t>(x_index));
+    for (int64_t y_index = 0; y_index < num_y_cells; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < num_z_cells; z_index++)
+      {
+        const Eigen::Vector3i cell(static_cast<int32_t>(x_index),
+                                   static_cast<int32_t>(y_index),
+                                   static_cast<int32_t>(z_index));
+        const bool cell_inside
+            = distance(x_index, y_index, z_index) < iso_level;
+        for (int32_t axis = 0; axis < 3; axis++)
+        {
+          const int32_t u_axis = (axis + 1) % 3;
+          const int32_t v_axis = (axis + 2) % 3;
+          Eigen::Vector3i next_cell = cell;
+          next_cell(axis) += 1;
+          // Edges on the grid boundary have fewer than four cubes.
+          if (next_cell(axis) >= num_cells[axis]
+              || cell(u_axis) < 1 || cell(u_axis) >= num_cells[u_axis] - 1
+              || cell(v_axis) < 1 || cell(v_axis) >= num_cells[v_axis] - 1)
+          {
+            continue;
+          }
+          const bool next_inside
+              = distance(next_cell.x(), next_cell.y(), next_cell.z())
+                < iso_level;
+          if (cell_inside == next_inside)
+          {
+            continue;
+          }
+          int32_t quad[4];
+          const int32_t u_offsets[4] = {-1, 0, 0, -1};
+          const int32_t v_offsets[4] = {-1, -1, 0, 0};
+          for (int32_t corner = 0; corner < 4; corner++)
+          {
+            Eigen::Vector3i cube = cell;
+            cube(u_axis) += u_offsets[corner];
+            cube(v_axis) += v_offsets[corner];
+            quad[corner]
+                = cube_vertices.at(cube_offset(cube.x(), cube.y(), cube.z()));
+          }
+          if (cell_inside)
+          {
+            triangles.push_back(Eigen::Vector3i(quad[0], quad[1], quad[2]));
+            triangles.push_back(Eigen::Vector3i(quad[0], quad[2], quad[3]));
+          }
+          else
+          {
+            triangles.push_back(Eigen::Vector3i(quad[0], quad[2], quad[1]));
+            triangles.push_back(Eigen::Vector3i(quad[0], quad[3], quad[2]));
+          }
+        }
+      }
+    }
+  }
+  size_t num_triangles = 0;
+  for (const auto& triangles : slab_triangles)
+  {
+    num_triangles += triangles.size();
+  }
+  std::vector<Eigen::Vector3i> triangles;
+  triangles.reserve(num_triangles);
+  for (const auto& slab : slab_triangles)
+  {
+    triangles.insert(triangles.end(), slab.begin(), slab.end());
+  }
+  return TriangleMesh(
+      sdf.GetOriginTransform(), std::move(vertices), std::move(triangles));
+}
+}  // namespace isosurface_extraction
+}  // namespace voxelized_geometry_tools
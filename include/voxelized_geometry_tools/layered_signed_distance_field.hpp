@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Distance queries against a static SDF combined with a set of posed dynamic
+/// SDFs, e.g. a large precomputed environment plus a few small moving objects.
+/// The combined distance is the minimum over all layers that contain the query
+/// point, so moving an object only requires a new pose, and changing its shape
+/// only requires a new (small) field, rather than regenerating a single SDF of
+/// the whole environment.
+///
+/// Each dynamic layer only contributes inside its own grid; outside it, the
+/// layer is treated as infinitely far away, so dynamic fields should be padded
+/// by the largest distance of interest. Queries first cull layers by their
+/// world-frame axis-aligned bounding box. Layers are held by shared pointer and
+/// must not be modified while queries are running.
+template<typename BackingStore=std::vector<float>>
+class LayeredSignedDistanceField
+{
+public:
+  using DistanceField = SignedDistanceField<BackingStore>;
+  using DistanceFieldPtr = std::shared_ptr<const DistanceField>;
+
+private:
+  class DynamicLayer
+  {
+  private:
+    DistanceFieldPtr field_;
+    Eigen::Isometry3d pose_ = Eigen::Isometry3d::Identity();
+    Eigen::Isometry3d inverse_pose_ = Eigen::Isometry3d::Identity();
+    Eigen::Vector3d aabb_lower_ = Eigen::Vector3d::Zero();
+    Eigen::Vector3d aabb_upper_ = Eigen::Vector3d::Zero();
+
+  public:
+    DynamicLayer(DistanceFieldPtr field, const Eigen::Isometry3d& pose)
+        : field_(std::move(field))
+    {
+      SetPose(pose);
+    }
+
+    const DistanceField& Field() const { return *field_; }
+
+    const Eigen::Isometry3d& Pose() const { return pose_; }
+
+    const Eigen::Isometry3d& InversePose() const { return inverse_pose_; }
+
+    void SetPose(const Eigen::Isometry3d& pose)
+    {
+      pose_ = pose;
+      inverse_pose_ = pose.inverse();
+      // Bound the eight corners of the grid in world frame.
+      const Eigen::Isometry3d grid_to_world
+          = pose_ * field_->GetOriginTransform();
+      const Eigen::Vector3d grid_extents(
+          static_cast<double>(field_->GetNumXCells())
+              * field_->GetCellSizes().x(),
+          static_cast<double>(field_->GetNumYCells())
+              * field_->GetCellSizes().y(),
+          static_cast<double>(field_->GetNumZCells())
+              * field_->GetCellSizes().z());
+      aabb_lower_ = grid_to_world.translation();
+      aabb_upper_ = grid_to_world.translation();
+      for (int32_t corner = 1; corner < 8; corner++)
+      {
+        const Eigen::Vector3d grid_corner(
+            ((corner & 0x01) != 0) ? grid_extents.x() : 0.0,
+            ((corner & 0x02) != 0) ? grid_extents.y() : 0.0,
+            ((corner & 0x04) != 0) ? grid_extents.z() : 0.0);
+        const Eigen::Vector3d world_corner = grid_to_world * grid_corner;
+        aabb_lower_ = aabb_lower_.cwiseMin(world_corner);
+        aabb_upper_ = aabb_upper_.cwiseMax(world_corner);
+      }
+    }
+
+    bool AABBContains(const Eigen::Vector3d& location) const
+    {
+      return (location.array() >= aabb_lower_.array()).all()
+             && (location.array() <= aabb_upper_.array()).all();
+    }
+
+    bool AABBIntersects(
+        const Eigen::Vector3d& lower, const Eigen::Vector3d& upper) const
+    {
+      return (upper.array() >= aabb_lower_.array()).all()
+             && (lower.array() <= aabb_upper_.array()).all();
+    }
+  };
+
+  DistanceFieldPtr static_layer_;
+  std::map<uint32_t, DynamicLayer> dynamic_layers_;
+
+  static void MinimizeDistance(
+      const EstimateDistanceQuery& layer_distance,
+      EstimateDistanceQuery& distance)
+  {
+    if (layer_distance && (!distance
+                           || layer_distance.Value() < distance.Value()))
+    {
+      distance = layer_distance;
+    }
+  }
+
+  static void MinimizeLayerDistance(
+      const DynamicLayer& layer, const Eigen::Vector4d& location,
+      EstimateDistanceQuery& distance)
+  {
+    if (layer.AABBContains(location.head<3>()))
+    {
+      MinimizeDistance(
+          layer.Field().EstimateDistance4d(layer.InversePose() * location),
+          distance);
+    }
+  }
+
+  DynamicLayer& GetDynamicLayer(const uint32_t layer_id)
+  {
+    auto found_itr = dynamic_layers_.find(layer_id);
+    if (found_itr == dynamic_layers_.end())
+    {
+      throw std::invalid_argument("layer_id not found");
+    }
+    return found_itr->second;
+  }
+
+public:
+  explicit LayeredSignedDistanceField(DistanceFieldPtr static_layer)
+  {
+    SetStaticLayer(std::move(static_layer));
+  }
+
+  const DistanceField& StaticLayer() const { return *static_layer_; }
+
+  void SetStaticLayer(DistanceFieldPtr static_layer)
+  {
+    if (!static_layer)
+    {
+      throw std::invalid_argument("static_layer cannot be null");
+    }
+    static_layer_ = std::move(static_layer);
+  }
+
+  /// Adds a dynamic layer, or replaces the layer with the same id. pose is the
+  /// transform from the field's frame to the static layer's frame.
+  void SetDynamicLayer(
+      const uint32_t layer_id, DistanceFieldPtr field,
+      const Eigen::Isometry3d& pose)
+  {
+    if (!field)
+    {
+      throw std::invalid_argument("field cannot be null");
+    }
+    dynamic_layers_.erase(layer_id);
+    dynamic_layers_.emplace(layer_id, DynamicLayer(std::move(field), pose));
+  }
+
+  void SetDynamicLayerPose(
+      const uint32_t layer_id, const Eigen::Isometry3d& pose)
+  {
+    GetDynamicLayer(layer_id).SetPose(pose);
+  }
+
+  const Eigen::Isometry3d& GetDynamicLayerPose(const uint32_t layer_id) const
+  {
+    return dynamic_layers_.at(layer_id).Pose();
+  }
+
+  const DistanceField& GetDynamicLayerField(const uint32_t layer_id) const
+  {
+    return dynamic_layers_.at(layer_id).Field();
+  }
+
+  bool HasDynamicLayer(const uint32_t layer_id) const
+  {
+    return dynamic_layers_.count(layer_id) > 0;
+  }
+
+  void RemoveDynamicLayer(const uint32_t layer_id)
+  {
+    dynamic_layers_.erase(layer_id);
+  }
+
+  size_t NumDynamicLayers() const { return dynamic_layers_.size(); }
+
+  /// Estimated distance (see SignedDistanceField::EstimateDistance) as the
+  /// minimum over the layers containing location. Empty if no layer does.
+  EstimateDistanceQuery EstimateDistance(
+      const double x, const double y, const double z) const
+  {
+    return EstimateDistance4d(Eigen::Vector4d(x, y, z, 1.0));
+  }
+
+  EstimateDistanceQuery EstimateDistance3d(
+      const Eigen::Vector3d& location) const
+  {
+    return EstimateDistance4d(
+        Eigen::Vector4d(location.x(), location.y(), location.z(), 1.0));
+  }
+
+  EstimateDistanceQuery EstimateDistance4d(
+      const Eigen::Vector4d& location) const
+  {
+    EstimateDistanceQuery distance
+        = static_layer_->EstimateDistance4d(location);
+    for (const auto& layer : dynamic_layers_)
+    {
+      MinimizeLayerDistance(layer.second, location, distance);
+    }
+    return distance;
+  }
+
+  /// Batched EstimateDistance for the columns of locations. Dynamic layers
+  /// whose bounding boxes do not overlap the bounds of the batch are culled
+  /// once for the whole batch, so spatially coherent batches (e.g. the points
+  /// of one robot link) skip most layers. Each remaining layer is queried with
+  /// SignedDistanceField::EstimateDistancesAtPose().
+  std::vector<EstimateDistanceQuery> EstimateDistances(
+      const Eigen::Matrix3Xd& locations, const bool use_parallel) const
+  {
+    std::vector<EstimateDistanceQuery> distances
+        = static_layer_->EstimateDistances(locations, use_parallel);
+    if (locations.cols() == 0)
+    {
+      return distances;
+    }
+    const Eigen::Vector3d batch_lower = locations.rowwise().minCoeff();
+    const Eigen::Vector3d batch_upper = locations.rowwise().maxCoeff();
+    for (const auto& layer : dynamic_layers_)
+    {
+      if (layer.second.AABBIntersects(batch_lower, batch_upper))
+      {
+        const std::vector<EstimateDistanceQuery> layer_distances
+            = layer.second.Field().EstimateDistancesAtPose(
+                layer.second.Pose(), locations, use_parallel);
+        for (size_t idx = 0; idx < distances.size(); idx++)
+        {
+          MinimizeDistance(layer_distances[idx], distances[idx]);
+        }
+      }
+    }
+    return distances;
+  }
+};
+}  // namespace voxelized_geometry_tools
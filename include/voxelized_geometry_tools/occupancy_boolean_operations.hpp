@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/tagged_object_collision_map.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace occupancy_boolean_operations
+{
+/// Cell-wise boolean operations between two occupancy grids with the same
+/// origin, resolution, and number of cells, e.g. merging maps from several
+/// robots, or subtracting a known static map from a live one.
+///
+/// Cells are classified as filled (occupancy > 0.5), unknown (occupancy ==
+/// 0.5), or free (occupancy < 0.5), and combined with three-valued logic in
+/// which unknown is "maybe": filled UNION unknown is filled, free UNION unknown
+/// is unknown, filled INTERSECTION unknown is unknown, and so on. DIFFERENCE
+/// is a AND NOT b, SYMMETRIC_DIFFERENCE is a XOR b.
+///
+/// The result is a copy of a in which only cells whose class changes are
+/// written. Such cells take b's cell if it has the resulting class (keeping
+/// e.g. its object id), or else the canonical occupancy of the class (1.0,
+/// 0.5, or 0.0) with no object. The operations run over the raw backing
+/// stores (a storage tile at a time for CollisionMap, so unchanged tiles stay
+/// shared with a), in parallel if use_parallel is set. Components (and
+/// spatial segments) of the result are invalidated, and for CollisionMap,
+/// changed cells are marked dirty.
+enum class BooleanOperation : uint8_t
+{
+  UNION,
+  INTERSECTION,
+  DIFFERENCE,
+  SYMMETRIC_DIFFERENCE
+};
+
+CollisionMap Combine(
+    const CollisionMap& a, const CollisionMap& b,
+    const BooleanOperation operation, const bool use_parallel);
+
+TaggedObjectCollisionMap Combine(
+    const TaggedObjectCollisionMap& a, const TaggedObjectCollisionMap& b,
+    const BooleanOperation operation, const bool use_parallel);
+}  // namespace occupancy_boolean_operations
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Numbers of filled (occupancy > 0.5), unknown (occupancy == 0.5), and free
+/// cells in a region.
+class OccupancyCounts
+{
+private:
+  int64_t filled_ = 0;
+  int64_t unknown_ = 0;
+  int64_t free_ = 0;
+
+public:
+  OccupancyCounts(
+      const int64_t filled, const int64_t unknown, const int64_t free)
+      : filled_(filled), unknown_(unknown), free_(free) {}
+
+  OccupancyCounts() {}
+
+  int64_t Filled() const { return filled_; }
+
+  int64_t Unknown() const { return unknown_; }
+
+  int64_t Free() const { return free_; }
+
+  bool HasFilledOrUnknown() const { return (filled_ + unknown_) > 0; }
+};
+
+/// Summed-volume table of filled and unknown cells in a CollisionMap, so that
+/// the occupancy counts of any axis-aligned box of cells (e.g. a robot base
+/// footprint or a bin) can be queried in constant time rather than by
+/// iterating every cell in the box.
+///
+/// The table does not follow later changes to the map. After changing the
+/// map, call Update() with the changed regions (e.g. from the map's dirty
+/// tiles), which recomputes only the part of the table that depends on them.
+class OccupancyIntegralVolume
+{
+private:
+  class IntegralCell
+  {
+  public:
+    uint32_t filled = 0u;
+    uint32_t unknown = 0u;
+  };
+
+  int64_t num_x_cells_ = 0;
+  int64_t num_y_cells_ = 0;
+  int64_t num_z_cells_ = 0;
+  /// Entry (x, y, z) holds the counts of cells in [0, x) x [0, y) x [0, z).
+  std::vector<IntegralCell> table_;
+
+  int64_t TableIndex(
+      const int64_t x_index, const int64_t y_index, const int64_t z_index) const
+  {
+    return (x_index * (num_y_cells_ + 1) + y_index) * (num_z_cells_ + 1)
+           + z_index;
+  }
+
+  const IntegralCell& TableEntry(
+      const int64_t x_index, const int64_t y_index, const int64_t z_index) const
+  {
+    return table_[static_cast<size_t>(TableIndex(x_index, y_index, z_index))];
+  }
+
+  IntegralCell& MutableTableEntry(
+      const int64_t x_index, const int64_t y_index, const int64_t z_index)
+  {
+    return table_[static_cast<size_t>(TableIndex(x_index, y_index, z_index))];
+  }
+
+  void RecomputeFrom(
+      const CollisionMap& map,
+      const common_robotics_utilities::voxel_grid::GridIndex& lower,
+      const bool use_parallel);
+
+public:
+  OccupancyIntegralVolume(const CollisionMap& map, const bool use_parallel);
+
+  OccupancyIntegralVolume() {}
+
+  int64_t GetNumXCells() const { return num_x_cells_; }
+
+  int64_t GetNumYCells() const { return num_y_cells_; }
+
+  int64_t GetNumZCells() const { return num_z_cells_; }
+
+  /// Updates the table after the cells in changed_regions of map have
+  /// changed. map must have the same number of cells as the one the table was
+  /// built from. Work is proportional to the part of the grid above the
+  /// lowest corner of the changed regions.
+  void Update(
+      const CollisionMap& map,
+      const std::vector<GridIndexRegion>& changed_regions,
+      const bool use_parallel);
+
+  /// Counts the cells in region, clipped to the grid, in constant time.
+  OccupancyCounts CountCells(const GridIndexRegion& region) const;
+};
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace occupancy_raycasting
+{
+/// Visits the cells of a grid with the provided number of cells and
+/// resolution that a ray crosses, in order, using the 3D DDA of Amanatides and
+/// Woo. The ray starts at origin and follows direction (a unit vector), both
+/// in grid frame, for at most max_range; only the portion inside the grid is
+/// traversed. visitor_fn(x_index, y_index, z_index) is called for each cell
+/// and returns false to stop the traversal early.
+template<typename VisitorFunction>
+void TraverseRay(
+    const int64_t num_x_cells, const int64_t num_y_cells,
+    const int64_t num_z_cells, const double resolution,
+    const Eigen::Vector3d& origin, const Eigen::Vector3d& direction,
+    const double max_range, const VisitorFunction& visitor_fn)
+{
+  const Eigen::Vector3d num_cells(static_cast<double>(num_x_cells),
+                                  static_cast<double>(num_y_cells),
+                                  static_cast<double>(num_z_cells));
+  // Work in cell units, so cell boundaries are at integers.
+  const Eigen::Vector3d start = origin / resolution;
+  const double max_cells_range = max_range / resolution;
+  // Clip the ray against the grid bounds (slab test).
+  double t_enter = 0.0;
+  double t_exit = max_cells_range;
+  for (int axis = 0; axis < 3; axis++)
+  {
+    if (direction(axis) == 0.0)
+    {
+      if (start(axis) < 0.0 || start(axis) >= num_cells(axis))
+      {
+        return;
+      }
+      continue;
+    }
+    const double t_lower = (0.0 - start(axis)) / direction(axis);
+    const double t_upper = (num_cells(axis) - start(axis)) / direction(axis);
+    t_enter = std::max(t_enter, std::min(t_lower, t_upper));
+    t_exit = std::min(t_exit, std::max(t_lower, t_upper));
+  }
+  if (!(t_enter < t_exit))
+  {
+    return;
+  }
+  const Eigen::Vector3d entry = start + (direction * t_enter);
+  int64_t index[3];
+  int64_t steps[3];
+  double t_next[3];
+  double t_deltas[3];
+  const int64_t max_indices[3] = {num_x_cells - 1, num_y_cells - 1,
+                                  num_z_cells - 1};
+  for (int axis = 0; axis < 3; axis++)
+  {
+    index[axis] = std::min(
+        std::max(static_cast<int64_t>(std::floor(entry(axis))),
+                 static_cast<int64_t>(0)),
+        max_indices[axis]);
+    if (direction(axis) > 0.0)
+    {
+      steps[axis] = 1;
+      t_deltas[axis] = 1.0 / direction(axis);
+      t_next[axis] = t_enter + ((static_cast<double>(index[axis] + 1)
+                                 - entry(axis)) * t_deltas[axis]);
+    }
+    else if (direction(axis) < 0.0)
+    {
+      steps[axis] = -1;
+      t_deltas[axis] = -1.0 / direction(axis);
+      t_next[axis] = t_enter + ((entry(axis)
+                                 - static_cast<double>(index[axis]))
+                                * t_deltas[axis]);
+    }
+    else
+    {
+      steps[axis] = 0;
+      t_deltas[axis] = std::numeric_limits<double>::infinity();
+      t_next[axis] = std::numeric_limits<double>::infinity();
+    }
+  }
+  while (visitor_fn(index[0], index[1], index[2]))
+  {
+    int axis = (t_next[0] < t_next[1]) ? 0 : 1;
+    axis = (t_next[2] < t_next[axis]) ? 2 : axis;
+    if (t_next[axis] >= t_exit)
+    {
+      return;
+    }
+    index[axis] += steps[axis];
+    if (index[axis] < 0 || index[axis] > max_indices[axis])
+    {
+      return;
+    }
+    t_next[axis] += t_deltas[axis];
+  }
+}
+
+/// Unit ray directions of a pinhole sensor with the provided fields of view
+/// (in radians) sampled on a num_horizontal_rays x num_vertical_rays grid, in
+/// the optical frame convention (z forward, x right, y down).
+Eigen::Matrix3Xd MakePinholeRayDirections(
+    const double horizontal_fov, const double vertical_fov,
+    const int64_t num_horizontal_rays, const int64_t num_vertical_rays);
+
+using Isometry3dAllocator = Eigen::aligned_allocator<Eigen::Isometry3d>;
+using VectorIsometry3d = std::vector<Eigen::Isometry3d, Isometry3dAllocator>;
+
+/// Information gain of a candidate view.
+class ViewInformationGain
+{
+private:
+  int64_t num_unknown_cell_visits_ = 0;
+  int64_t num_unique_unknown_cells_ = 0;
+  int64_t num_rays_hit_filled_ = 0;
+
+public:
+  ViewInformationGain() {}
+
+  ViewInformationGain(
+      const int64_t num_unknown_cell_visits,
+      const int64_t num_unique_unknown_cells,
+      const int64_t num_rays_hit_filled)
+      : num_unknown_cell_visits_(num_unknown_cell_visits),
+        num_unique_unknown_cells_(num_unique_unknown_cells),
+        num_rays_hit_filled_(num_rays_hit_filled) {}
+
+  /// Unknown cells crossed, summed over rays.
+  int64_t NumUnknownCellVisits() const { return num_unknown_cell_visits_; }
+
+  /// Distinct unknown cells crossed by any ray.
+  int64_t NumUniqueUnknownCells() const { return num_unique_unknown_cells_; }
+
+  int64_t NumRaysHitFilled() const { return num_rays_hit_filled_; }
+};
+
+/// Evaluates candidate views for next-best-view planning. For each view pose
+/// (of the sensor in world frame), rays are cast from the sensor origin along
+/// ray_directions (unit vectors in sensor frame, e.g. from
+/// MakePinholeRayDirections) through map, for at most max_range. Each ray
+/// counts the unknown cells (occupancy == 0.5) it crosses and stops at the
+/// first filled cell (occupancy > 0.5), which the sensor cannot see past.
+///
+/// Views are evaluated in parallel if use_parallel is set.
+std::vector<ViewInformationGain> EvaluateViews(
+    const CollisionMap& map, const VectorIsometry3d& view_poses,
+    const Eigen::Matrix3Xd& ray_directions, const double max_range,
+    const bool use_parallel);
+}  // namespace occupancy_raycasting
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <common_robotics_utilities/maybe.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization_interface.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace pointcloud_voxelization
+{
+/// Options for voxelizer calibration. Each candidate configuration is run
+/// num_warmup_trials times untimed, then num_timed_trials times, and ranked by
+/// its median wall time. An empty cpu_thread_counts sweeps powers of two up to
+/// the OpenMP maximum; an empty device_work_group_sizes only tries the device
+/// defaults.
+class VoxelizerCalibrationOptions
+{
+public:
+  VoxelizerCalibrationOptions(
+      const int32_t num_warmup_trials, const int32_t num_timed_trials,
+      const std::vector<int32_t>& cpu_thread_counts,
+      const std::vector<int32_t>& device_work_group_sizes)
+      : num_warmup_trials_(num_warmup_trials),
+        num_timed_trials_(num_timed_trials),
+        cpu_thread_counts_(cpu_thread_counts),
+        device_work_group_sizes_(device_work_group_sizes)
+  {
+    if (num_warmup_trials_ < 0)
+    {
+      throw std::invalid_argument("num_warmup_trials < 0");
+    }
+    if (num_timed_trials_ < 1)
+    {
+      throw std::invalid_argument("num_timed_trials < 1");
+    }
+    for (const int32_t cpu_thread_count : cpu_thread_counts_)
+    {
+      if (cpu_thread_count < 1)
+      {
+        throw std::invalid_argument("cpu_thread_count < 1");
+      }
+    }
+    for (const int32_t device_work_group_size : device_work_group_sizes_)
+    {
+      if (device_work_group_size < 1)
+      {
+        throw std::invalid_argument("device_work_group_size < 1");
+      }
+    }
+  }
+
+  VoxelizerCalibrationOptions()
+      : VoxelizerCalibrationOptions(1, 5, {}, {64, 128, 256, 512}) {}
+
+  int32_t NumWarmupTrials() const { return num_warmup_trials_; }
+
+  int32_t NumTimedTrials() const { return num_timed_trials_; }
+
+  const std::vector<int32_t>& CpuThreadCounts() const
+  {
+    return cpu_thread_counts_;
+  }
+
+  const std::vector<int32_t>& DeviceWorkGroupSizes() const
+  {
+    return device_work_group_sizes_;
+  }
+
+private:
+  int32_t num_warmup_trials_ = 1;
+  int32_t num_timed_trials_ = 5;
+  std::vector<int32_t> cpu_thread_counts_;
+  std::vector<int32_t> device_work_group_sizes_;
+};
+
+/// Measured performance of one candidate configuration.
+class VoxelizerCalibrationTrial
+{
+public:
+  VoxelizerCalibrationTrial(
+      const AvailableBackend& backend, const double median_time)
+      : backend_(backend), median_time_(median_time) {}
+
+  const AvailableBackend& Backend() const { return backend_; }
+
+  double MedianTime() const { return median_time_; }
+
+private:
+  AvailableBackend backend_;
+  double median_time_ = 0.0;
+};
+
+/// Expands GetAvailableBackends() into the configurations to calibrate: one
+/// per CPU thread count, and one per CUDA block size or OpenCL work-group size
+/// in addition to the device defaults.
+std::vector<AvailableBackend> GetCalibrationCandidates(
+    const VoxelizerCalibrationOptions& options);
+
+/// Times every candidate on the given workload. Candidates that cannot be
+/// constructed or fail to run are skipped; the rest are returned fastest
+/// first.
+std::vector<VoxelizerCalibrationTrial> RunVoxelizerCalibrationTrials(
+    const CollisionMap& static_environment, const double step_size_multiplier,
+    const PointCloudVoxelizationFilterOptions& filter_options,
+    const std::vector<PointCloudWrapperPtr>& pointclouds,
+    const VoxelizerCalibrationOptions& options);
+
+/// Key for a workload in the calibration cache. Grid cell counts, numbers of
+/// clouds, and total points are rounded up to powers of two, so similar
+/// workloads share a key; the set of available devices is also part of the
+/// key, so that hardware changes trigger recalibration.
+std::string MakeVoxelizerCalibrationKey(
+    const CollisionMap& static_environment,
+    const std::vector<PointCloudWrapperPtr>& pointclouds);
+
+/// Loads the configuration cached for key in cache_file, if any. A missing
+/// cache file is treated as empty.
+common_robotics_utilities::OwningMaybe<AvailableBackend>
+LoadCalibratedBackend(const std::string& cache_file, const std::string& key);
+
+/// Stores backend for key in cache_file, replacing any existing entry for key
+/// and keeping the rest.
+void SaveCalibratedBackend(
+    const std::string& cache_file, const std::string& key,
+    const AvailableBackend& backend);
+
+/// Makes a voxelizer using the configuration cached in cache_file for this
+/// workload. If there is none, or it can no longer be constructed, calibrates
+/// on the workload, caches the fastest configuration, and uses it.
+std::unique_ptr<PointCloudVoxelizationInterface>
+MakeCalibratedPointCloudVoxelizer(
+    const std::string& cache_file, const CollisionMap& static_environment,
+    const double step_size_multiplier,
+    const PointCloudVoxelizationFilterOptions& filter_options,
+    const std::vector<PointCloudWrapperPtr>& pointclouds,
+    const VoxelizerCalibrationOptions& options);
+
+/// As above, with a representative workload: a 320x240 depth camera looking
+/// into random clutter, voxelized into a 4m cube grid at 0.04m resolution.
+std::unique_ptr<PointCloudVoxelizationInterface>
+MakeCalibratedPointCloudVoxelizer(
+    const std::string& cache_file, const VoxelizerCalibrationOptions& options);
+}  // namespace pointcloud_voxelization
+}  // namespace voxelized_geometry_tools
@@ -8,6 +8,7 @@
 
 #include <Eigen/Geometry>
 #include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/instrumentation.hpp>
 
 namespace voxelized_geometry_tools
 {
@@ -163,6 +164,33 @@ public:
     CopyPointLocationIntoFloatPtrImpl(point_index, destination);
   }
 
+  /// Copy num_points consecutive points, starting at first_point_index, into
+  /// destination as packed xyz triples. Wrappers can override the
+  /// implementation to read their native layout in a single pass.
+  void CopyPointLocationsIntoFloatPtr(
+      const int64_t first_point_index, const int64_t num_points,
+      float* destination) const
+  {
+    if (num_points < 0)
+    {
+      throw std::invalid_argument("num_points < 0");
+    }
+    if (num_points > 0)
+    {
+      EnforcePointIndexInRange(first_point_index);
+      EnforcePointIndexInRange(first_point_index + num_points - 1);
+      CopyPointLocationsIntoFloatPtrImpl(
+          first_point_index, num_points, destination);
+    }
+  }
+
+  /// Copy all points into vector as packed xyz triples.
+  void CopyPointLocationsIntoVectorFloat(std::vector<float>& vector) const
+  {
+    vector.resize(static_cast<size_t>(Size() * 3));
+    CopyPointLocationsIntoFloatPtr(0, Size(), vector.data());
+  }
+
   void EnforcePointIndexInRange(const int64_t point_index) const
   {
     if (point_index < 0 || point_index >= Size())
@@ -188,16 +216,65 @@ protected:
 
   virtual void CopyPointLocationIntoFloatPtrImpl(
       const int64_t point_index, float* destination) const = 0;
+
+  virtual void CopyPointLocationsIntoFloatPtrImpl(
+      const int64_t first_point_index, const int64_t num_points,
+      float* destination) const
+  {
+    for (int64_t idx = 0; idx < num_points; idx++)
+    {
+      CopyPointLocationIntoFloatPtrImpl(
+          first_point_index + idx, destination + (idx * 3));
+    }
+  }
 };
 
 using PointCloudWrapperPtr = std::shared_ptr<PointCloudWrapper>;
 
+/// Work done by one voxelization call, summed over all clouds. Contended
+/// updates count tracking-cell increments that found the cell already
+/// touched by another ray, which is a proxy for atomic contention.
+struct VoxelizationCounters
+{
+  int64_t num_rays_cast = 0;
+  int64_t num_rays_culled = 0;
+  int64_t num_voxel_visits = 0;
+  int64_t num_contended_updates = 0;
+
+  VoxelizationCounters& operator+=(const VoxelizationCounters& other)
+  {
+    num_rays_cast += other.num_rays_cast;
+    num_rays_culled += other.num_rays_culled;
+    num_voxel_visits += other.num_voxel_visits;
+    num_contended_updates += other.num_contended_updates;
+    return *this;
+  }
+};
+
+/// Runtime breakdown of one voxelization call. Setup covers tracking grid
+/// allocation; raycasting and filtering cover the rest of the call, and
+/// include the host-to-device and device-to-host transfers reported
+/// separately (both zero for the CPU voxelizer).
 class VoxelizerRuntime
 {
 public:
-  VoxelizerRuntime(const double raycasting_time, const double filtering_time)
-      : raycasting_time_(raycasting_time), filtering_time_(filtering_time)
+  VoxelizerRuntime(
+      const double setup_time, const double raycasting_time,
+      const double filtering_time, const double host_to_device_time,
+      const double device_to_host_time,
+      const std::vector<double>& per_cloud_raycasting_times,
+      const VoxelizationCounters& counters)
+      : setup_time_(setup_time), raycasting_time_(raycasting_time),
+        filtering_time_(filtering_time),
+        host_to_device_time_(host_to_device_time),
+        device_to_host_time_(device_to_host_time),
+        per_cloud_raycasting_times_(per_cloud_raycasting_times),
+        counters_(counters)
   {
+    if (setup_time_ < 0.0)
+    {
+      throw std::invalid_argument("setup_time < 0.0");
+    }
     if (raycasting_time_ < 0.0)
     {
       throw std::invalid_argument("raycasting_time < 0.0");
@@ -206,15 +283,54 @@ public:
     {
       throw std::invalid_argument("filtering_time < 0.0");
     }
+    if (host_to_device_time_ < 0.0)
+    {
+      throw std::invalid_argument("host_to_device_time < 0.0");
+    }
+    if (device_to_host_time_ < 0.0)
+    {
+      throw std::invalid_argument("device_to_host_time < 0.0");
+    }
   }
 
+  VoxelizerRuntime(const double raycasting_time, const double filtering_time)
+      : VoxelizerRuntime(
+          0.0, raycasting_time, filtering_time, 0.0, 0.0, {},
+          VoxelizationCounters()) {}
+
+  double SetupTime() const { return setup_time_; }
+
   double RaycastingTime() const { return raycasting_time_; }
 
   double FilteringTime() const { return filtering_time_; }
 
+  double HostToDeviceTime() const { return host_to_device_time_; }
+
+  double DeviceToHostTime() const { return device_to_host_time_; }
+
+  double TotalTime() const
+  {
+    return setup_time_ + raycasting_time_ + filtering_time_;
+  }
+
+  /// Time to raycast each cloud, in input order. For device voxelizers this
+  /// is the time to upload the cloud and launch its kernel, since kernels
+  /// run asynchronously.
+  const std::vector<double>& PerCloudRaycastingTimes() const
+  {
+    return per_cloud_raycasting_times_;
+  }
+
+  const VoxelizationCounters& Counters() const { return counters_; }
+
 private:
+  double setup_time_ = 0.0;
   double raycasting_time_ = 0.0;
   double filtering_time_ = 0.0;
+  double host_to_device_time_ = 0.0;
+  double device_to_host_time_ = 0.0;
+  std::vector<double> per_cloud_raycasting_times_;
+  VoxelizationCounters counters_;
 };
 
 class PointCloudVoxelizationInterface
@@ -227,16 +343,7 @@ public:
       const PointCloudVoxelizationFilterOptions& filter_options,
       const std::vector<PointCloudWrapperPtr>& pointclouds,
       const std::function<void(const VoxelizerRuntime&)>&
-          runtime_log_fn = [] (const VoxelizerRuntime& voxelizer_runtime)
-          {
-            const double raycasting_time = voxelizer_runtime.RaycastingTime();
-            const double filtering_time = voxelizer_runtime.FilteringTime();
-            std::cout
-                << "Raycasting time " << raycasting_time
-                << ", filtering time " << filtering_time
-                << ", total time " << raycasting_time + filtering_time
-                << std::endl;
-          }) const {
+          runtime_log_fn = [] (const VoxelizerRuntime&) {}) const {
     CollisionMap output_environment = static_environment;
     const auto voxelizer_runtime = VoxelizePointClouds(
         static_environment, step_size_multiplier, filter_options, pointclouds,
@@ -277,9 +384,41 @@ public:
             "pointclouds[" + std::to_string(idx) + "] is null");
       }
     }
-    return DoVoxelizePointClouds(
+    const VoxelizerRuntime voxelizer_runtime = DoVoxelizePointClouds(
         static_environment, step_size_multiplier, filter_options, pointclouds,
         output_environment);
+    const auto sink = instrumentation::GetInstrumentationSink();
+    if (sink->IsEnabled())
+    {
+      sink->RecordPhase(
+          "VoxelizePointClouds.setup", voxelizer_runtime.SetupTime());
+      sink->RecordPhase(
+          "VoxelizePointClouds.raycasting", voxelizer_runtime.RaycastingTime());
+      sink->RecordPhase(
+          "VoxelizePointClouds.filtering", voxelizer_runtime.FilteringTime());
+      sink->RecordPhase("VoxelizePointClouds.host_to_device",
+                        voxelizer_runtime.HostToDeviceTime());
+      sink->RecordPhase("VoxelizePointClouds.device_to_host",
+                        voxelizer_runtime.DeviceToHostTime());
+      int64_t num_points = 0;
+      for (const PointCloudWrapperPtr& cloud_ptr : pointclouds)
+      {
+        num_points += cloud_ptr->Size();
+      }
+      const VoxelizationCounters& counters = voxelizer_runtime.Counters();
+      sink->AddToCounter("voxelization.clouds",
+                         static_cast<int64_t>(pointclouds.size()));
+      sink->AddToCounter("voxelization.points", num_points);
+      sink->AddToCounter(
+          "voxelization.cells", static_environment.GetTotalCells());
+      sink->AddToCounter("voxelization.rays_cast", counters.num_rays_cast);
+      sink->AddToCounter("voxelization.rays_culled", counters.num_rays_culled);
+      sink->AddToCounter(
+          "voxelization.voxel_visits", counters.num_voxel_visits);
+      sink->AddToCounter(
+          "voxelization.contended_updates", counters.num_contended_updates);
+    }
+    return voxelizer_runtime;
   }
 
 protected:
@@ -30,6 +30,11 @@ using PointCloud2 = sensor_msgs::PointCloud2;
 using PointCloud2ConstSharedPtr = sensor_msgs::PointCloud2ConstPtr;
 #endif
 
+/// Wraps a PointCloud2 without copying it. The x, y, and z fields may be at
+/// any offsets in the point (e.g. interleaved with other fields), rows may be
+/// padded, and fields may be FLOAT32, FLOAT64, or integer types. Integer
+/// fields (e.g. packed depth in millimeters) are multiplied by
+/// integer_field_scale to get meters. All three fields must share a type.
 class PointCloud2Wrapper : public PointCloudWrapper
 {
 public:
@@ -56,36 +61,42 @@ public:
 protected:
   PointCloud2Wrapper(
       const PointCloud2* const cloud_ptr,
-      const Eigen::Isometry3d& origin_transform, const double max_range);
+      const Eigen::Isometry3d& origin_transform, const double max_range,
+      const double integer_field_scale);
 
 private:
   void CopyPointLocationIntoDoublePtrImpl(
-      const int64_t point_index, double* destination) const override
-  {
-    const Eigen::Vector4d point =
-        GetPointLocationVector4f(point_index).cast<double>();
-    std::memcpy(destination, point.data(), sizeof(double) * 3);
-  }
+      const int64_t point_index, double* destination) const override;
 
   void CopyPointLocationIntoFloatPtrImpl(
-      const int64_t point_index, float* destination) const override
-  {
-    const size_t starting_offset = GetStartingOffsetForPointXYZ(point_index);
-    std::memcpy(destination, &(cloud_ptr_->data.at(starting_offset)),
-                sizeof(float) * 3);
-  }
+      const int64_t point_index, float* destination) const override;
+
+  void CopyPointLocationsIntoFloatPtrImpl(
+      const int64_t first_point_index, const int64_t num_points,
+      float* destination) const override;
 
-  size_t GetStartingOffsetForPointXYZ(const int64_t point_index) const
+  size_t GetStartingOffsetForPoint(const int64_t point_index) const
   {
-    const size_t starting_offset =
-        (static_cast<size_t>(point_index)
-         * static_cast<size_t>(cloud_ptr_->point_step))
-        + xyz_offset_from_point_start_;
-    return starting_offset;
+    if (rows_are_packed_)
+    {
+      return static_cast<size_t>(point_index)
+             * static_cast<size_t>(cloud_ptr_->point_step);
+    }
+    const size_t width = static_cast<size_t>(cloud_ptr_->width);
+    const size_t row = static_cast<size_t>(point_index) / width;
+    const size_t column = static_cast<size_t>(point_index) % width;
+    return (row * static_cast<size_t>(cloud_ptr_->row_step))
+           + (column * static_cast<size_t>(cloud_ptr_->point_step));
   }
 
   const PointCloud2* const cloud_ptr_ = nullptr;
-  size_t xyz_offset_from_point_start_ = 0;
+  size_t x_offset_from_point_start_ = 0;
+  size_t y_offset_from_point_start_ = 0;
+  size_t z_offset_from_point_start_ = 0;
+  uint8_t xyz_datatype_ = 0;
+  bool xyz_are_sequential_float32_ = false;
+  bool rows_are_packed_ = true;
+  double integer_field_scale_ = 1.0;
   Eigen::Isometry3d origin_transform_ = Eigen::Isometry3d::Identity();
   double max_range_ = std::numeric_limits<double>::infinity();
 };
@@ -98,8 +109,10 @@ public:
   NonOwningPointCloud2Wrapper(
       const PointCloud2* const cloud_ptr,
       const Eigen::Isometry3d& origin_transform,
-      const double max_range = std::numeric_limits<double>::infinity())
-      : PointCloud2Wrapper(cloud_ptr, origin_transform, max_range) {}
+      const double max_range = std::numeric_limits<double>::infinity(),
+      const double integer_field_scale = 1.0)
+      : PointCloud2Wrapper(
+          cloud_ptr, origin_transform, max_range, integer_field_scale) {}
 };
 
 class OwningPointCloud2Wrapper : public PointCloud2Wrapper
@@ -110,8 +123,10 @@ public:
   OwningPointCloud2Wrapper(
       const PointCloud2ConstSharedPtr& cloud_ptr,
       const Eigen::Isometry3d& origin_transform,
-      const double max_range = std::numeric_limits<double>::infinity())
-      : PointCloud2Wrapper(cloud_ptr.get(), origin_transform, max_range),
+      const double max_range = std::numeric_limits<double>::infinity(),
+      const double integer_field_scale = 1.0)
+      : PointCloud2Wrapper(
+          cloud_ptr.get(), origin_transform, max_range, integer_field_scale),
         owned_cloud_ptr_(cloud_ptr) {}
 
 private:
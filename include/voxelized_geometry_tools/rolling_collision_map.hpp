@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/rolling_voxel_grid.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Robot-centered CollisionMap that moves with the robot rather than being
+/// rebuilt. After Shift()/RecenterOn*(), only the returned exposed regions
+/// need new data: extract each with ExtractRegion(), voxelize into it (e.g.
+/// using it as the static environment for a PointCloudVoxelizationInterface),
+/// and write the result back with ImportRegion().
+class RollingCollisionMap final : public RollingVoxelGrid<CollisionCell>
+{
+private:
+  std::string frame_;
+
+public:
+  RollingCollisionMap(
+      const Eigen::Isometry3d& origin_transform, const std::string& frame,
+      const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+      const CollisionCell& default_value)
+      : RollingCollisionMap(
+          origin_transform, frame, sizes, default_value, default_value) {}
+
+  RollingCollisionMap(
+      const Eigen::Isometry3d& origin_transform, const std::string& frame,
+      const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+      const CollisionCell& default_value, const CollisionCell& oob_value);
+
+  RollingCollisionMap() : RollingVoxelGrid<CollisionCell>() {}
+
+  double GetResolution() const { return GetCellSizes().x(); }
+
+  const std::string& GetFrame() const { return frame_; }
+
+  void SetFrame(const std::string& frame) { frame_ = frame; }
+
+  /// Copy the provided window region into a dense CollisionMap whose origin
+  /// is the minimum corner of the region.
+  CollisionMap ExtractRegion(const GridIndexRegion& region) const;
+
+  /// Copy the entire current window into a dense CollisionMap.
+  CollisionMap ExtractWindow() const
+  {
+    return ExtractRegion(GetWindowRegion());
+  }
+
+  /// Copy a dense CollisionMap (e.g. from ExtractRegion()) back into region.
+  /// The map must have the same number of cells as region.
+  void ImportRegion(const GridIndexRegion& region, const CollisionMap& map);
+};
+}  // namespace voxelized_geometry_tools
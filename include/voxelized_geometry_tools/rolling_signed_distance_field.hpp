@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/maybe.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/rolling_collision_map.hpp>
+#include <voxelized_geometry_tools/rolling_voxel_grid.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Signed distance field that rolls along with a RollingCollisionMap of the
+/// same size. Shift both by the same amount, then call UpdateRegions() with
+/// the regions returned by Shift() to recompute distances only near the cells
+/// that entered view.
+///
+/// Distances are recomputed in a region padded by margin_cells, so after a
+/// partial update distances are exact up to margin_cells * resolution. Cells
+/// that were not recomputed keep their stored distances, which an obstacle
+/// entering view may have made too large, though it can be no closer to them
+/// than the margin. Rather than clamping every cell after each update, the
+/// grid keeps a single window-wide bound, GetDistanceBound(), which is the
+/// smallest margin distance used since the window was last fully recomputed.
+/// GetDistance() applies the bound, so its distances are never larger than
+/// the true distances. Raw cell access (GetValue(), ForEachCellInRegion())
+/// returns stored distances, which must be limited by GetDistanceBound().
+class RollingSignedDistanceField final : public RollingVoxelGrid<float>
+{
+private:
+  std::string frame_;
+  float distance_bound_ = std::numeric_limits<float>::infinity();
+
+  void CheckMatchingCollisionMap(
+      const RollingCollisionMap& collision_map,
+      const int64_t margin_cells) const;
+
+  /// Recompute distances in updated_region from collision_map in
+  /// updated_region padded by margin_cells.
+  void RecomputeRegion(
+      const RollingCollisionMap& collision_map,
+      const GridIndexRegion& updated_region, const int64_t margin_cells,
+      const bool use_parallel);
+
+  /// Limit the window-wide distance bound after recomputing updated_region.
+  void UpdateDistanceBound(
+      const GridIndexRegion& updated_region, const int64_t margin_cells);
+
+public:
+  RollingSignedDistanceField(
+      const Eigen::Isometry3d& origin_transform, const std::string& frame,
+      const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+      const float oob_value);
+
+  RollingSignedDistanceField() : RollingVoxelGrid<float>() {}
+
+  double GetResolution() const { return GetCellSizes().x(); }
+
+  const std::string& GetFrame() const { return frame_; }
+
+  void SetFrame(const std::string& frame) { frame_ = frame; }
+
+  /// Upper bound on the true distance of every free cell in the window.
+  float GetDistanceBound() const { return distance_bound_; }
+
+  /// Stored distance of the cell at window index, limited by
+  /// GetDistanceBound(), or no value if index is outside the window.
+  common_robotics_utilities::OwningMaybe<float> GetDistance(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const
+  {
+    const auto stored_distance = GetValue(index);
+    if (stored_distance)
+    {
+      return common_robotics_utilities::OwningMaybe<float>(
+          std::min(stored_distance.Value(), distance_bound_));
+    }
+    else
+    {
+      return stored_distance;
+    }
+  }
+
+  /// Recompute distances for region (and margin_cells around it) from
+  /// collision_map, which must have the same sizes and window offset.
+  /// Returns the region of cells that were recomputed.
+  GridIndexRegion UpdateRegion(
+      const RollingCollisionMap& collision_map, const GridIndexRegion& region,
+      const int64_t margin_cells, const bool use_parallel);
+
+  /// As UpdateRegion() for each of regions, except that overlapping padded
+  /// regions are merged where that saves work.
+  void UpdateRegions(
+      const RollingCollisionMap& collision_map,
+      const std::vector<GridIndexRegion>& regions, const int64_t margin_cells,
+      const bool use_parallel);
+
+  /// Recompute the entire window, leaving distances exact and resetting
+  /// GetDistanceBound() to infinity.
+  void UpdateWindow(
+      const RollingCollisionMap& collision_map, const bool use_parallel)
+  {
+    UpdateRegion(collision_map, GetWindowRegion(), 0, use_parallel);
+  }
+};
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,469 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/maybe.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Fixed-size voxel grid window that can be moved through space by whole
+/// cells without moving its contents. Cells are stored in a toroidal buffer:
+/// the window's global cell offset is added to each window index and wrapped
+/// into the backing store, so shifting the window only touches the cells that
+/// enter view, O(cells entering view) rather than O(total cells).
+///
+/// All indices in the public interface are window indices, i.e. (0, 0, 0) is
+/// always the minimum corner of the current window, and
+/// GetOriginTransform() is the pose of that corner.
+template<typename T>
+class RollingVoxelGrid
+{
+private:
+  Eigen::Isometry3d base_origin_transform_ = Eigen::Isometry3d::Identity();
+  Eigen::Isometry3d origin_transform_ = Eigen::Isometry3d::Identity();
+  Eigen::Isometry3d inverse_origin_transform_ = Eigen::Isometry3d::Identity();
+  common_robotics_utilities::voxel_grid::GridSizes sizes_;
+  common_robotics_utilities::voxel_grid::GridIndex window_offset_;
+  T default_value_;
+  T oob_value_;
+  std::vector<T> data_;
+  bool initialized_ = false;
+
+  static int64_t WrapIndex(const int64_t index, const int64_t num_cells)
+  {
+    const int64_t wrapped = index % num_cells;
+    return (wrapped < 0) ? (wrapped + num_cells) : wrapped;
+  }
+
+  void UpdateOriginTransforms()
+  {
+    const Eigen::Translation3d window_translation(
+        static_cast<double>(window_offset_.X()) * sizes_.CellXSize(),
+        static_cast<double>(window_offset_.Y()) * sizes_.CellYSize(),
+        static_cast<double>(window_offset_.Z()) * sizes_.CellZSize());
+    origin_transform_ = base_origin_transform_ * window_translation;
+    inverse_origin_transform_ = origin_transform_.inverse();
+  }
+
+  int64_t WindowIndexToDataIndex(
+      const int64_t x_index, const int64_t y_index,
+      const int64_t z_index) const
+  {
+    const int64_t storage_x
+        = WrapIndex(x_index + window_offset_.X(), sizes_.NumXCells());
+    const int64_t storage_y
+        = WrapIndex(y_index + window_offset_.Y(), sizes_.NumYCells());
+    const int64_t storage_z
+        = WrapIndex(z_index + window_offset_.Z(), sizes_.NumZCells());
+    return (storage_x * sizes_.NumYCells() * sizes_.NumZCells())
+        + (storage_y * sizes_.NumZCells()) + storage_z;
+  }
+
+  template<typename GridType, typename Function>
+  static void ForEachCellInRegionImpl(
+      GridType& grid, const GridIndexRegion& region,
+      const Function& cell_fn)
+  {
+    if (!grid.IsRegionInBounds(region))
+    {
+      throw std::invalid_argument("region is out of bounds");
+    }
+    const int64_t num_x_cells = grid.sizes_.NumXCells();
+    const int64_t num_y_cells = grid.sizes_.NumYCells();
+    const int64_t num_z_cells = grid.sizes_.NumZCells();
+    for (int64_t x_index = region.Lower().X(); x_index < region.Upper().X();
+         x_index++)
+    {
+      const int64_t storage_x
+          = WrapIndex(x_index + grid.window_offset_.X(), num_x_cells);
+      for (int64_t y_index = region.Lower().Y(); y_index < region.Upper().Y();
+           y_index++)
+      {
+        const int64_t storage_y
+            = WrapIndex(y_index + grid.window_offset_.Y(), num_y_cells);
+        const int64_t row_start
+            = (storage_x * num_y_cells * num_z_cells)
+                + (storage_y * num_z_cells);
+        // Step the wrapped z index incrementally to avoid a modulo per cell.
+        int64_t storage_z = WrapIndex(
+            region.Lower().Z() + grid.window_offset_.Z(), num_z_cells);
+        for (int64_t z_index = region.Lower().Z();
+             z_index < region.Upper().Z(); z_index++)
+        {
+          cell_fn(common_robotics_utilities::voxel_grid::GridIndex(
+                      x_index, y_index, z_index),
+                  grid.data_[static_cast<size_t>(row_start + storage_z)]);
+          storage_z++;
+          if (storage_z == num_z_cells)
+          {
+            storage_z = 0;
+          }
+        }
+      }
+    }
+  }
+
+public:
+  RollingVoxelGrid(
+      const Eigen::Isometry3d& origin_transform,
+      const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+      const T& default_value, const T& oob_value)
+      : base_origin_transform_(origin_transform), sizes_(sizes),
+        window_offset_(0, 0, 0), default_value_(default_value),
+        oob_value_(oob_value)
+  {
+    if (!sizes_.Valid())
+    {
+      throw std::invalid_argument("sizes is not valid");
+    }
+    data_ = std::vector<T>(
+        static_cast<size_t>(sizes_.TotalCells()), default_value_);
+    UpdateOriginTransforms();
+    initialized_ = true;
+  }
+
+  RollingVoxelGrid() : window_offset_(0, 0, 0) {}
+
+  bool IsInitialized() const { return initialized_; }
+
+  const common_robotics_utilities::voxel_grid::GridSizes& GetGridSizes() const
+  {
+    return sizes_;
+  }
+
+  int64_t GetNumXCells() const { return sizes_.NumXCells(); }
+
+  int64_t GetNumYCells() const { return sizes_.NumYCells(); }
+
+  int64_t GetNumZCells() const { return sizes_.NumZCells(); }
+
+  int64_t GetTotalCells() const { return sizes_.TotalCells(); }
+
+  Eigen::Vector3d GetCellSizes() const
+  {
+    return Eigen::Vector3d(
+        sizes_.CellXSize(), sizes_.CellYSize(), sizes_.CellZSize());
+  }
+
+  const T& GetDefaultValue() const { return default_value_; }
+
+  const T& GetOOBValue() const { return oob_value_; }
+
+  /// Offset, in whole cells, of the current window from its initial position.
+  const common_robotics_utilities::voxel_grid::GridIndex&
+  GetWindowOffset() const
+  {
+    return window_offset_;
+  }
+
+  /// Pose of the minimum corner of the current window.
+  const Eigen::Isometry3d& GetOriginTransform() const
+  {
+    return origin_transform_;
+  }
+
+  const Eigen::Isometry3d& GetInverseOriginTransform() const
+  {
+    return inverse_origin_transform_;
+  }
+
+  GridIndexRegion GetWindowRegion() const
+  {
+    return GridIndexRegion(
+        common_robotics_utilities::voxel_grid::GridIndex(0, 0, 0),
+        common_robotics_utilities::voxel_grid::GridIndex(
+            GetNumXCells(), GetNumYCells(), GetNumZCells()));
+  }
+
+  bool IndexInBounds(
+      const int64_t x_index, const int64_t y_index,
+      const int64_t z_index) const
+  {
+    return (x_index >= 0 && y_index >= 0 && z_index >= 0
+            && x_index < GetNumXCells() && y_index < GetNumYCells()
+            && z_index < GetNumZCells());
+  }
+
+  bool IndexInBounds(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const
+  {
+    return IndexInBounds(index.X(), index.Y(), index.Z());
+  }
+
+  bool IsRegionInBounds(const GridIndexRegion& region) const
+  {
+    return (region.Lower().X() >= 0 && region.Lower().Y() >= 0
+            && region.Lower().Z() >= 0
+            && region.Upper().X() <= GetNumXCells()
+            && region.Upper().Y() <= GetNumYCells()
+            && region.Upper().Z() <= GetNumZCells());
+  }
+
+  common_robotics_utilities::voxel_grid::GridIndex
+  LocationInGridFrameToGridIndex4d(const Eigen::Vector4d& location) const
+  {
+    return common_robotics_utilities::voxel_grid::GridIndex(
+        static_cast<int64_t>(std::floor(location(0) * sizes_.InvCellXSize())),
+        static_cast<int64_t>(std::floor(location(1) * sizes_.InvCellYSize())),
+        static_cast<int64_t>(std::floor(location(2) * sizes_.InvCellZSize())));
+  }
+
+  common_robotics_utilities::voxel_grid::GridIndex LocationToGridIndex4d(
+      const Eigen::Vector4d& location) const
+  {
+    return LocationInGridFrameToGridIndex4d(
+        GetInverseOriginTransform() * location);
+  }
+
+  common_robotics_utilities::voxel_grid::GridIndex LocationToGridIndex3d(
+      const Eigen::Vector3d& location) const
+  {
+    return LocationToGridIndex4d(
+        Eigen::Vector4d(location.x(), location.y(), location.z(), 1.0));
+  }
+
+  Eigen::Vector4d GridIndexToLocationInGridFrame(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const
+  {
+    return Eigen::Vector4d(
+        (static_cast<double>(index.X()) + 0.5) * sizes_.CellXSize(),
+        (static_cast<double>(index.Y()) + 0.5) * sizes_.CellYSize(),
+        (static_cast<double>(index.Z()) + 0.5) * sizes_.CellZSize(), 1.0);
+  }
+
+  Eigen::Vector4d GridIndexToLocation(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const
+  {
+    return GetOriginTransform() * GridIndexToLocationInGridFrame(index);
+  }
+
+  common_robotics_utilities::OwningMaybe<T> GetValue(
+      const int64_t x_index, const int64_t y_index,
+      const int64_t z_index) const
+  {
+    if (IndexInBounds(x_index, y_index, z_index))
+    {
+      return common_robotics_utilities::OwningMaybe<T>(
+          data_[static_cast<size_t>(
+              WindowIndexToDataIndex(x_index, y_index, z_index))]);
+    }
+    else
+    {
+      return common_robotics_utilities::OwningMaybe<T>();
+    }
+  }
+
+  common_robotics_utilities::OwningMaybe<T> GetValue(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const
+  {
+    return GetValue(index.X(), index.Y(), index.Z());
+  }
+
+  common_robotics_utilities::OwningMaybe<T> GetValue4d(
+      const Eigen::Vector4d& location) const
+  {
+    return GetValue(LocationToGridIndex4d(location));
+  }
+
+  common_robotics_utilities::OwningMaybe<T> GetValue3d(
+      const Eigen::Vector3d& location) const
+  {
+    return GetValue(LocationToGridIndex3d(location));
+  }
+
+  /// Like GetValue(), but returns the out-of-bounds value for cells outside
+  /// the current window.
+  const T& GetValueOrOOB(
+      const common_robotics_utilities::voxel_grid::GridIndex& index) const
+  {
+    if (IndexInBounds(index))
+    {
+      return data_[static_cast<size_t>(
+          WindowIndexToDataIndex(index.X(), index.Y(), index.Z()))];
+    }
+    else
+    {
+      return oob_value_;
+    }
+  }
+
+  bool SetValue(
+      const int64_t x_index, const int64_t y_index, const int64_t z_index,
+      const T& value)
+  {
+    if (IndexInBounds(x_index, y_index, z_index))
+    {
+      data_[static_cast<size_t>(
+          WindowIndexToDataIndex(x_index, y_index, z_index))] = value;
+      return true;
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  bool SetValue(
+      const common_robotics_utilities::voxel_grid::GridIndex& index,
+      const T& value)
+  {
+    return SetValue(index.X(), index.Y(), index.Z(), value);
+  }
+
+  bool SetValue4d(const Eigen::Vector4d& location, const T& value)
+  {
+    return SetValue(LocationToGridIndex4d(location), value);
+  }
+
+  bool SetValue3d(const Eigen::Vector3d& location, const T& value)
+  {
+    return SetValue(LocationToGridIndex3d(location), value);
+  }
+
+  /// Call cell_fn(const GridIndex& window_index, T& cell) for every cell in
+  /// region, in x-major, z-minor order.
+  template<typename Function>
+  void ForEachCellInRegion(
+      const GridIndexRegion& region, const Function& cell_fn)
+  {
+    ForEachCellInRegionImpl(*this, region, cell_fn);
+  }
+
+  /// Call cell_fn(const GridIndex& window_index, const T& cell) for every cell
+  /// in region, in x-major, z-minor order.
+  template<typename Function>
+  void ForEachCellInRegion(
+      const GridIndexRegion& region, const Function& cell_fn) const
+  {
+    ForEachCellInRegionImpl(*this, region, cell_fn);
+  }
+
+  /// Set every cell in region to the default value.
+  void ResetRegion(const GridIndexRegion& region)
+  {
+    const T& default_value = default_value_;
+    ForEachCellInRegion(region, [&] (
+        const common_robotics_utilities::voxel_grid::GridIndex&, T& cell)
+    {
+      cell = default_value;
+    });
+  }
+
+  /// Move the window by whole cells. Cells that remain in view keep their
+  /// values (at window index - shift), and cells entering view are reset to
+  /// the default value. Returns the (disjoint) window regions that entered
+  /// view, which are the only regions that need to be voxelized or have
+  /// distances recomputed.
+  std::vector<GridIndexRegion> Shift(
+      const common_robotics_utilities::voxel_grid::GridIndex& shift)
+  {
+    if (!IsInitialized())
+    {
+      throw std::runtime_error("RollingVoxelGrid is not initialized");
+    }
+    const int64_t num_x_cells = GetNumXCells();
+    const int64_t num_y_cells = GetNumYCells();
+    const int64_t num_z_cells = GetNumZCells();
+    window_offset_ = common_robotics_utilities::voxel_grid::GridIndex(
+        window_offset_.X() + shift.X(), window_offset_.Y() + shift.Y(),
+        window_offset_.Z() + shift.Z());
+    UpdateOriginTransforms();
+    std::vector<GridIndexRegion> exposed_regions;
+    if (std::abs(shift.X()) >= num_x_cells
+        || std::abs(shift.Y()) >= num_y_cells
+        || std::abs(shift.Z()) >= num_z_cells)
+    {
+      std::fill(data_.begin(), data_.end(), default_value_);
+      exposed_regions.push_back(GetWindowRegion());
+      return exposed_regions;
+    }
+    // The x slab spans all y and z, the y slab excludes the x slab, and the z
+    // slab excludes both, so the exposed regions do not overlap.
+    int64_t x_lower = 0;
+    int64_t x_upper = num_x_cells;
+    if (shift.X() > 0)
+    {
+      x_upper = num_x_cells - shift.X();
+      exposed_regions.push_back(GridIndexRegion(
+          common_robotics_utilities::voxel_grid::GridIndex(x_upper, 0, 0),
+          common_robotics_utilities::voxel_grid::GridIndex(
+              num_x_cells, num_y_cells, num_z_cells)));
+    }
+    else if (shift.X() < 0)
+    {
+      x_lower = -shift.X();
+      exposed_regions.push_back(GridIndexRegion(
+          common_robotics_utilities::voxel_grid::GridIndex(0, 0, 0),
+          common_robotics_utilities::voxel_grid::GridIndex(
+              x_lower, num_y_cells, num_z_cells)));
+    }
+    int64_t y_lower = 0;
+    int64_t y_upper = num_y_cells;
+    if (shift.Y() > 0)
+    {
+      y_upper = num_y_cells - shift.Y();
+      exposed_regions.push_back(GridIndexRegion(
+          common_robotics_utilities::voxel_grid::GridIndex(
+              x_lower, y_upper, 0),
+          common_robotics_utilities::voxel_grid::GridIndex(
+              x_upper, num_y_cells, num_z_cells)));
+    }
+    else if (shift.Y() < 0)
+    {
+      y_lower = -shift.Y();
+      exposed_regions.push_back(GridIndexRegion(
+          common_robotics_utilities::voxel_grid::GridIndex(x_lower, 0, 0),
+          common_robotics_utilities::voxel_grid::GridIndex(
+              x_upper, y_lower, num_z_cells)));
+    }
+    if (shift.Z() > 0)
+    {
+      exposed_regions.push_back(GridIndexRegion(
+          common_robotics_utilities::voxel_grid::GridIndex(
+              x_lower, y_lower, num_z_cells - shift.Z()),
+          common_robotics_utilities::voxel_grid::GridIndex(
+              x_upper, y_upper, num_z_cells)));
+    }
+    else if (shift.Z() < 0)
+    {
+      exposed_regions.push_back(GridIndexRegion(
+          common_robotics_utilities::voxel_grid::GridIndex(
+              x_lower, y_lower, 0),
+          common_robotics_utilities::voxel_grid::GridIndex(
+              x_upper, y_upper, -shift.Z())));
+    }
+    for (const GridIndexRegion& exposed_region : exposed_regions)
+    {
+      ResetRegion(exposed_region);
+    }
+    return exposed_regions;
+  }
+
+  /// Shift the window by whole cells so that location is (as near as
+  /// possible) at its center. See Shift().
+  std::vector<GridIndexRegion> RecenterOn4d(const Eigen::Vector4d& location)
+  {
+    const common_robotics_utilities::voxel_grid::GridIndex location_index
+        = LocationToGridIndex4d(location);
+    const common_robotics_utilities::voxel_grid::GridIndex shift(
+        location_index.X() - (GetNumXCells() / 2),
+        location_index.Y() - (GetNumYCells() / 2),
+        location_index.Z() - (GetNumZCells() / 2));
+    return Shift(shift);
+  }
+
+  std::vector<GridIndexRegion> RecenterOn3d(const Eigen::Vector3d& location)
+  {
+    return RecenterOn4d(
+        Eigen::Vector4d(location.x(), location.y(), location.z(), 1.0));
+  }
+};
+}  // namespace voxelized_geometry_tools
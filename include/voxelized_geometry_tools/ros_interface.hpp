@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -31,6 +35,7 @@
 #include <common_robotics_utilities/zlib_helpers.hpp>
 #include <voxelized_geometry_tools/collision_map.hpp>
 #include <voxelized_geometry_tools/dynamic_spatial_hashed_collision_map.hpp>
+#include <voxelized_geometry_tools/isosurface_extraction.hpp>
 #include <voxelized_geometry_tools/signed_distance_field.hpp>
 #include <voxelized_geometry_tools/tagged_object_collision_map.hpp>
 
@@ -133,6 +138,417 @@ inline Marker ExportVoxelGridToRViz(
   return display_rep;
 }
 
+/// Parallel version of ExportVoxelGridToRViz. Visible cells are collected per
+/// x-slab first, then copied in parallel to their offsets in points and
+/// colors, which are allocated once; output order matches the serial version.
+/// @param voxel_color_fn is called once per cell and must be thread-safe.
+template<typename T, typename BackingStore, typename ColorFn>
+inline Marker ExportVoxelGridToRVizParallel(
+    const common_robotics_utilities::voxel_grid
+        ::VoxelGridBase<T, BackingStore>& voxel_grid,
+    const std::string& frame, const ColorFn& voxel_color_fn,
+    const bool use_parallel)
+{
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  Marker display_rep;
+  // Populate the header
+  display_rep.header.frame_id = frame;
+  // Populate the options
+  display_rep.ns = "";
+  display_rep.id = 0;
+  display_rep.type = Marker::CUBE_LIST;
+  display_rep.action = Marker::ADD;
+#if VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 2
+  display_rep.lifetime = rclcpp::Duration(0, 0);
+#elif VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 1
+  display_rep.lifetime = ros::Duration(0.0);
+#endif
+  display_rep.frame_locked = false;
+  display_rep.pose
+      = common_robotics_utilities::ros_conversions
+          ::EigenIsometry3dToGeometryPose(voxel_grid.GetOriginTransform());
+  display_rep.scale
+      = common_robotics_utilities::ros_conversions
+          ::EigenVector3dToGeometryVector3(voxel_grid.GetCellSizes());
+  const int64_t num_x_cells = voxel_grid.GetNumXCells();
+  const int64_t num_y_cells = voxel_grid.GetNumYCells();
+  const int64_t num_z_cells = voxel_grid.GetNumZCells();
+  // Collect the points and colors of the visible cells in each x-slab.
+  std::vector<std::vector<Point>> slab_points(
+      static_cast<size_t>(num_x_cells));
+  std::vector<std::vector<ColorRGBA>> slab_colors(
+      static_cast<size_t>(num_x_cells));
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t x_index = 0; x_index < num_x_cells; x_index++)
+  {
+    std::vector<Point>& points = slab_points.at(static_cast<size_t>(x_index));
+    std::vector<ColorRGBA>& colors
+        = slab_colors.at(static_cast<size_t>(x_index));
+    for (int64_t y_index = 0; y_index < num_y_cells; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < num_z_cells; z_index++)
+      {
+        const GridIndex index(x_index, y_index, z_index);
+        const ColorRGBA cell_color
+            = voxel_color_fn(voxel_grid.GetImmutable(index).Value(), index);
+        if (cell_color.a > 0.0f)
+        {
+          // Convert indices into a real-world location
+          const Eigen::Vector4d location
+              = voxel_grid.GridIndexToLocationInGridFrame(index);
+          points.push_back(
+              common_robotics_utilities::ros_conversions
+                  ::EigenVector4dToGeometryPoint(location));
+          colors.push_back(cell_color);
+        }
+      }
+    }
+  }
+  std::vector<size_t> slab_offsets(static_cast<size_t>(num_x_cells) + 1, 0);
+  for (size_t idx = 1; idx < slab_offsets.size(); idx++)
+  {
+    slab_offsets.at(idx)
+        = slab_offsets.at(idx - 1) + slab_points.at(idx - 1).size();
+  }
+  display_rep.points.resize(slab_offsets.back());
+  display_rep.colors.resize(slab_offsets.back());
+  // Copy each x-slab to its offset.
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+  for (int64_t x_index = 0; x_index < num_x_cells; x_index++)
+  {
+    const size_t slab = static_cast<size_t>(x_index);
+    const auto offset = static_cast<std::ptrdiff_t>(slab_offsets.at(slab));
+    std::copy(slab_points.at(slab).begin(), slab_points.at(slab).end(),
+              display_rep.points.begin() + offset);
+    std::copy(slab_colors.at(slab).begin(), slab_colors.at(slab).end(),
+              display_rep.colors.begin() + offset);
+  }
+  return display_rep;
+}
+
+/// Level-of-detail export of a voxel grid to RViz, so that the display size
+/// stays bounded regardless of grid size. Cells are visible if
+/// @param voxel_color_fn gives them a non-zero alpha.
+/// With @param surface_only, only visible cells with a non-visible (or
+/// out-of-bounds) face neighbor are exported.
+/// With @param merge_uniform_regions, aligned octree blocks of 2^k cells per
+/// side whose exported cells all share one color are merged into a single
+/// larger cube.
+/// If more than @param max_voxels cubes would still be produced, the finest
+/// level is coarsened until the budget is met; a coarsened block takes the
+/// color of its first exported cell, and is clipped to the grid at its upper
+/// edge.
+/// One CUBE_LIST marker is returned per cube size, in order of increasing
+/// octree level, with ids numbered from zero.
+template<typename T, typename BackingStore, typename ColorFn>
+inline MarkerArray ExportVoxelGridToRVizWithLOD(
+    const common_robotics_utilities::voxel_grid
+        ::VoxelGridBase<T, BackingStore>& voxel_grid,
+    const std::string& frame, const ColorFn& voxel_color_fn,
+    const bool surface_only, const bool merge_uniform_regions,
+    const size_t max_voxels, const bool use_parallel)
+{
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  if (max_voxels < 1)
+  {
+    throw std::invalid_argument("max_voxels < 1");
+  }
+  // Node of the implicit octree over the grid; level 0 nodes are cells.
+  struct LODNode
+  {
+    ColorRGBA color;
+    bool any_exported = false;
+    bool uniform = false;
+  };
+  const int64_t num_x_cells = voxel_grid.GetNumXCells();
+  const int64_t num_y_cells = voxel_grid.GetNumYCells();
+  const int64_t num_z_cells = voxel_grid.GetNumZCells();
+  MarkerArray display_reps;
+  if (num_x_cells < 1 || num_y_cells < 1 || num_z_cells < 1)
+  {
+    return display_reps;
+  }
+  // Mark visible cells, which surface checks need for neighbors.
+  std::vector<uint8_t> visible(
+      static_cast<size_t>(num_x_cells * num_y_cells * num_z_cells), 0);
+  const auto cell_offset = [&] (const int64_t x_index, const int64_t y_index,
+                                const int64_t z_index)
+  {
+    return static_cast<size_t>(
+        (((x_index * num_y_cells) + y_index) * num_z_cells) + z_index);
+  };
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t x_index = 0; x_index < num_x_cells; x_index++)
+  {
+    for (int64_t y_index = 0; y_index < num_y_cells; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < num_z_cells; z_index++)
+      {
+        const GridIndex index(x_index, y_index, z_index);
+        const ColorRGBA cell_color
+            = voxel_color_fn(voxel_grid.GetImmutable(index).Value(), index);
+        visible.at(cell_offset(x_index, y_index, z_index))
+            = (cell_color.a > 0.0f) ? 1 : 0;
+      }
+    }
+  }
+  const auto is_visible = [&] (const int64_t x_index, const int64_t y_index,
+                               const int64_t z_index)
+  {
+    if (x_index < 0 || y_index < 0 || z_index < 0 || x_index >= num_x_cells
+        || y_index >= num_y_cells || z_index >= num_z_cells)
+    {
+      return false;
+    }
+    return visible.at(cell_offset(x_index, y_index, z_index)) > 0;
+  };
+  const auto is_exported = [&] (const int64_t x_index, const int64_t y_index,
+                                const int64_t z_index)
+  {
+    if (!is_visible(x_index, y_index, z_index))
+    {
+      return false;
+    }
+    else if (!surface_only)
+    {
+      return true;
+    }
+    return (!is_visible(x_index - 1, y_index, z_index)
+            || !is_visible(x_index + 1, y_index, z_index)
+            || !is_visible(x_index, y_index - 1, z_index)
+            || !is_visible(x_index, y_index + 1, z_index)
+            || !is_visible(x_index, y_index, z_index - 1)
+            || !is_visible(x_index, y_index, z_index + 1));
+  };
+  // Octree level sizes, from cells (level 0) up to a single root node.
+  std::vector<GridIndex> level_sizes;
+  level_sizes.push_back(GridIndex(num_x_cells, num_y_cells, num_z_cells));
+  while (level_sizes.back().X() > 1 || level_sizes.back().Y() > 1
+         || level_sizes.back().Z() > 1)
+  {
+    const GridIndex& child_sizes = level_sizes.back();
+    level_sizes.push_back(GridIndex((child_sizes.X() + 1) / 2,
+                                    (child_sizes.Y() + 1) / 2,
+                                    (child_sizes.Z() + 1) / 2));
+  }
+  // Octree nodes for levels 1 and up; level 0 is evaluated on demand.
+  std::vector<std::vector<LODNode>> levels(level_sizes.size());
+  const auto node_offset = [&] (const size_t level, const GridIndex& index)
+  {
+    const GridIndex& sizes = level_sizes.at(level);
+    return static_cast<size_t>(
+        (((index.X() * sizes.Y()) + index.Y()) * sizes.Z()) + index.Z());
+  };
+  const auto get_node = [&] (const size_t level, const GridIndex& index)
+  {
+    if (level > 0)
+    {
+      return levels.at(level).at(node_offset(level, index));
+    }
+    LODNode node;
+    node.uniform = true;
+    if (is_exported(index.X(), index.Y(), index.Z()))
+    {
+      node.any_exported = true;
+      node.color
+          = voxel_color_fn(voxel_grid.GetImmutable(index).Value(), index);
+    }
+    return node;
+  };
+  const auto same_color = [] (const ColorRGBA& first, const ColorRGBA& second)
+  {
+    return (first.r == second.r && first.g == second.g
+            && first.b == second.b && first.a == second.a);
+  };
+  for (size_t level = 1; level < level_sizes.size(); level++)
+  {
+    const GridIndex& sizes = level_sizes.at(level);
+    const GridIndex& child_sizes = level_sizes.at(level - 1);
+    levels.at(level).resize(
+        static_cast<size_t>(sizes.X() * sizes.Y() * sizes.Z()));
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+    for (int64_t x_index = 0; x_index < sizes.X(); x_index++)
+    {
+      for (int64_t y_index = 0; y_index < sizes.Y(); y_index++)
+      {
+        for (int64_t z_index = 0; z_index < sizes.Z(); z_index++)
+        {
+          LODNode node;
+          bool complete = true;
+          bool all_uniform = true;
+          bool all_exported = true;
+          bool same_colors = true;
+          for (int64_t child = 0; child < 8; child++)
+          {
+            const GridIndex child_index((x_index * 2) + ((child >> 2) & 1),
+                                        (y_index * 2) + ((child >> 1) & 1),
+                                        (z_index * 2) + (child & 1));
+            if (child_index.X() >= child_sizes.X()
+                || child_index.Y() >= child_sizes.Y()
+                || child_index.Z() >= child_sizes.Z())
+            {
+              complete = false;
+              continue;
+            }
+            const LODNode child_node = get_node(level - 1, child_index);
+            all_uniform = all_uniform && child_node.uniform;
+            all_exported = all_exported && child_node.any_exported;
+            if (child_node.any_exported)
+            {
+              if (!node.any_exported)
+              {
+                node.any_exported = true;
+                node.color = child_node.color;
+              }
+              else if (!same_color(node.color, child_node.color))
+              {
+                same_colors = false;
+              }
+            }
+          }
+          // Blocks are uniform if fully in the grid and either entirely
+          // unexported or entirely exported with a single color.
+          node.uniform = complete && all_uniform
+                         && (!node.any_exported
+                             || (all_exported && same_colors));
+          levels.at(level).at(node_offset(level, GridIndex(
+              x_index, y_index, z_index))) = node;
+        }
+      }
+    }
+  }
+  // Walk the octree from the root, stopping at uniform blocks (if merging)
+  // or at min_level. Returns the number of cubes, and collects them into
+  // per-level lists if @param cubes is provided.
+  using LODCube = std::pair<GridIndex, ColorRGBA>;
+  const size_t root_level = level_sizes.size() - 1;
+  const auto walk_octree = [&] (const size_t min_level,
+                                std::vector<std::vector<LODCube>>* cubes)
+  {
+    size_t num_cubes = 0;
+    std::vector<std::pair<size_t, GridIndex>> stack;
+    stack.push_back(std::make_pair(root_level, GridIndex(0, 0, 0)));
+    while (stack.size() > 0)
+    {
+      const size_t level = stack.back().first;
+      const GridIndex index = stack.back().second;
+      stack.pop_back();
+      const LODNode node = get_node(level, index);
+      if (!node.any_exported)
+      {
+        continue;
+      }
+      else if (level <= min_level || (merge_uniform_regions && node.uniform))
+      {
+        num_cubes++;
+        if (cubes != nullptr)
+        {
+          cubes->at(level).push_back(std::make_pair(index, node.color));
+        }
+        continue;
+      }
+      const GridIndex& child_sizes = level_sizes.at(level - 1);
+      for (int64_t child = 7; child >= 0; child--)
+      {
+        const GridIndex child_index((index.X() * 2) + ((child >> 2) & 1),
+                                    (index.Y() * 2) + ((child >> 1) & 1),
+                                    (index.Z() * 2) + (child & 1));
+        if (child_index.X() < child_sizes.X()
+            && child_index.Y() < child_sizes.Y()
+            && child_index.Z() < child_sizes.Z())
+        {
+          stack.push_back(std::make_pair(level - 1, child_index));
+        }
+      }
+    }
+    return num_cubes;
+  };
+  size_t min_level = 0;
+  while (min_level < root_level && walk_octree(min_level, nullptr) > max_voxels)
+  {
+    min_level++;
+  }
+  std::vector<std::vector<LODCube>> cubes(level_sizes.size());
+  walk_octree(min_level, &cubes);
+  // Make one CUBE_LIST per cube size. Coarsened blocks at the upper edge of
+  // the grid are clipped to it, so they need their own, smaller, cube size.
+  for (size_t level = 0; level < cubes.size(); level++)
+  {
+    const int64_t block_cells = static_cast<int64_t>(1) << level;
+    std::map<std::vector<int64_t>, Marker> level_display_reps;
+    for (const LODCube& cube : cubes.at(level))
+    {
+      const GridIndex first_cell(cube.first.X() * block_cells,
+                                 cube.first.Y() * block_cells,
+                                 cube.first.Z() * block_cells);
+      const std::vector<int64_t> cube_cells = {
+          std::min(block_cells, num_x_cells - first_cell.X()),
+          std::min(block_cells, num_y_cells - first_cell.Y()),
+          std::min(block_cells, num_z_cells - first_cell.Z())};
+      const Eigen::Vector3d cube_cells_vector(
+          static_cast<double>(cube_cells.at(0)),
+          static_cast<double>(cube_cells.at(1)),
+          static_cast<double>(cube_cells.at(2)));
+      Marker& display_rep = level_display_reps[cube_cells];
+      if (display_rep.points.empty())
+      {
+        // Populate the header
+        display_rep.header.frame_id = frame;
+        // Populate the options
+        display_rep.ns = "";
+        display_rep.type = Marker::CUBE_LIST;
+        display_rep.action = Marker::ADD;
+#if VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 2
+        display_rep.lifetime = rclcpp::Duration(0, 0);
+#elif VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 1
+        display_rep.lifetime = ros::Duration(0.0);
+#endif
+        display_rep.frame_locked = false;
+        display_rep.pose
+            = common_robotics_utilities::ros_conversions
+                ::EigenIsometry3dToGeometryPose(
+                    voxel_grid.GetOriginTransform());
+        display_rep.scale
+            = common_robotics_utilities::ros_conversions
+                ::EigenVector3dToGeometryVector3(
+                    voxel_grid.GetCellSizes().cwiseProduct(
+                        cube_cells_vector));
+      }
+      // Offset from the center of the cube's first cell to the cube center.
+      Eigen::Vector4d center_offset = Eigen::Vector4d::Zero();
+      center_offset.head<3>()
+          = voxel_grid.GetCellSizes().cwiseProduct(
+              cube_cells_vector - Eigen::Vector3d::Ones()) * 0.5;
+      const Eigen::Vector4d location
+          = voxel_grid.GridIndexToLocationInGridFrame(first_cell)
+            + center_offset;
+      display_rep.points.push_back(
+          common_robotics_utilities::ros_conversions
+              ::EigenVector4dToGeometryPoint(location));
+      display_rep.colors.push_back(cube.second);
+    }
+    for (auto& level_display_rep : level_display_reps)
+    {
+      level_display_rep.second.id
+          = static_cast<int32_t>(display_reps.markers.size());
+      display_reps.markers.push_back(level_display_rep.second);
+    }
+  }
+  return display_reps;
+}
+
 template<typename T, typename BackingStore=std::vector<T>>
 inline Marker ExportVoxelGridIndexMapToRViz(
     const common_robotics_utilities::voxel_grid
@@ -356,33 +772,14 @@ ExportDynamicSpatialHashedVoxelGridToRViz(
 
 /// Export SDF to RViz display.
 
+/// Export SDF to RViz display, coloring by distance relative to the provided
+/// @param min_distance and @param max_distance.
 template<typename BackingStore=std::vector<float>>
 inline Marker ExportSDFForDisplay(
     const SignedDistanceField<BackingStore>& sdf,
-    const float alpha = 0.01f)
+    const float min_distance, const float max_distance,
+    const float alpha, const bool use_parallel)
 {
-  float min_distance = 0.0;
-  float max_distance = 0.0;
-  for (int64_t x_index = 0; x_index < sdf.GetNumXCells(); x_index++)
-  {
-    for (int64_t y_index = 0; y_index < sdf.GetNumYCells(); y_index++)
-    {
-      for (int64_t z_index = 0; z_index < sdf.GetNumZCells(); z_index++)
-      {
-        // Update minimum/maximum distance variables
-        const float distance
-            = sdf.GetImmutable(x_index, y_index, z_index).Value();
-        if (distance < min_distance)
-        {
-          min_distance = distance;
-        }
-        if (distance > max_distance)
-        {
-          max_distance = distance;
-        }
-      }
-    }
-  }
   const auto color_fn
       = [&] (const float& distance,
              const common_robotics_utilities::voxel_grid::GridIndex&)
@@ -412,17 +809,71 @@ inline Marker ExportSDFForDisplay(
     }
     return new_color;
   };
-  auto display_rep = ExportVoxelGridToRViz<float, BackingStore>(
-      sdf, sdf.GetFrame(), color_fn);
+  auto display_rep = ExportVoxelGridToRVizParallel<float, BackingStore>(
+      sdf, sdf.GetFrame(), color_fn, use_parallel);
   display_rep.ns = "sdf_distance";
   display_rep.id = 1;
   return display_rep;
 }
 
+/// Export SDF to RViz display, computing the distance range first.
+template<typename BackingStore=std::vector<float>>
+inline Marker ExportSDFForDisplay(
+    const SignedDistanceField<BackingStore>& sdf,
+    const float alpha = 0.01f, const bool use_parallel = false)
+{
+  float min_distance = 0.0;
+  float max_distance = 0.0;
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel) \
+    reduction(min:min_distance) reduction(max:max_distance)
+#endif
+  for (int64_t x_index = 0; x_index < sdf.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < sdf.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < sdf.GetNumZCells(); z_index++)
+      {
+        // Update minimum/maximum distance variables
+        const float distance
+            = sdf.GetImmutable(x_index, y_index, z_index).Value();
+        if (distance < min_distance)
+        {
+          min_distance = distance;
+        }
+        if (distance > max_distance)
+        {
+          max_distance = distance;
+        }
+      }
+    }
+  }
+  return ExportSDFForDisplay<BackingStore>(
+      sdf, min_distance, max_distance, alpha, use_parallel);
+}
+
+/// Export SDF to RViz display, reusing the distance range already computed
+/// during SDF generation.
+template<typename BackingStore=std::vector<float>>
+inline Marker ExportSDFForDisplay(
+    const signed_distance_field_generation
+        ::SignedDistanceFieldResult<BackingStore>& sdf_result,
+    const float alpha = 0.01f, const bool use_parallel = false)
+{
+  // Match the range of the full scan, which always includes zero.
+  const float min_distance
+      = static_cast<float>(std::min(sdf_result.Minimum(), 0.0));
+  const float max_distance
+      = static_cast<float>(std::max(sdf_result.Maximum(), 0.0));
+  return ExportSDFForDisplay<BackingStore>(
+      sdf_result.DistanceField(), min_distance, max_distance, alpha,
+      use_parallel);
+}
+
 template<typename BackingStore=std::vector<float>>
 inline Marker ExportSDFForDisplayCollisionOnly(
     const SignedDistanceField<BackingStore>& sdf,
-    const float alpha = 0.01f)
+    const float alpha = 0.01f, const bool use_parallel = false)
 {
   const ColorRGBA filled_color
       = common_robotics_utilities::color_builder
@@ -443,26 +894,164 @@ inline Marker ExportSDFForDisplayCollisionOnly(
       return free_color;
     }
   };
-  auto display_rep = ExportVoxelGridToRViz<float, BackingStore>(
-      sdf, sdf.GetFrame(), color_fn);
+  auto display_rep = ExportVoxelGridToRVizParallel<float, BackingStore>(
+      sdf, sdf.GetFrame(), color_fn, use_parallel);
   display_rep.ns = "sdf_collision";
   display_rep.id = 1;
   return display_rep;
 }
 
+/// Export a triangle mesh to RViz as a TRIANGLE_LIST, which takes three
+/// points per triangle.
+inline Marker ExportTriangleMeshForDisplay(
+    const isosurface_extraction::TriangleMesh& mesh,
+    const std::string& frame, const ColorRGBA& color)
+{
+  Marker display_rep;
+  // Populate the header
+  display_rep.header.frame_id = frame;
+  // Populate the options
+  display_rep.ns = "";
+  display_rep.id = 0;
+  display_rep.type = Marker::TRIANGLE_LIST;
+  display_rep.action = Marker::ADD;
+#if VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 2
+  display_rep.lifetime = rclcpp::Duration(0, 0);
+#elif VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 1
+  display_rep.lifetime = ros::Duration(0.0);
+#endif
+  display_rep.frame_locked = false;
+  display_rep.pose
+      = common_robotics_utilities::ros_conversions
+          ::EigenIsometry3dToGeometryPose(mesh.GetOriginTransform());
+  display_rep.scale.x = 1.0;
+  display_rep.scale.y = 1.0;
+  display_rep.scale.z = 1.0;
+  display_rep.color = color;
+  const std::vector<Eigen::Vector3d>& vertices = mesh.GetVertices();
+  const std::vector<Eigen::Vector3i>& triangles = mesh.GetTriangles();
+  display_rep.points.resize(triangles.size() * 3);
+  for (size_t idx = 0; idx < triangles.size(); idx++)
+  {
+    for (int32_t corner = 0; corner < 3; corner++)
+    {
+      display_rep.points.at((idx * 3) + static_cast<size_t>(corner))
+          = common_robotics_utilities::ros_conversions
+              ::EigenVector3dToGeometryPoint(
+                  vertices.at(static_cast<size_t>(triangles.at(idx)(corner))));
+    }
+  }
+  return display_rep;
+}
+
+/// Export the @param iso_level isosurface of an SDF to RViz as a mesh.
+template<typename BackingStore=std::vector<float>>
+inline Marker ExportSDFIsosurfaceForDisplay(
+    const SignedDistanceField<BackingStore>& sdf, const float iso_level,
+    const ColorRGBA& color, const bool use_parallel = false)
+{
+  const isosurface_extraction::TriangleMesh mesh
+      = isosurface_extraction::ExtractIsosurfaceMesh<BackingStore>(
+          sdf, iso_level, use_parallel);
+  auto display_rep = ExportTriangleMeshForDisplay(mesh, sdf.GetFrame(), color);
+  display_rep.ns = "sdf_isosurface";
+  display_rep.id = 1;
+  return display_rep;
+}
+
+/// Helpers for moving serialized grids in and out of message byte fields.
+
+/// Compresses @param raw_bytes straight into @param compressed_bytes, which is
+/// sized to zlib's worst-case bound up front and trimmed afterwards. Buffers
+/// larger than zlib's 32-bit counts are compressed in pieces.
+void CompressBytesInto(
+    const std::vector<uint8_t>& raw_bytes,
+    std::vector<uint8_t>& compressed_bytes);
+
+/// Decompresses @param compressed_bytes straight into the storage of
+/// @param decompressed_bytes, growing it geometrically if needed.
+void DecompressBytesInto(
+    const std::vector<uint8_t>& compressed_bytes,
+    std::vector<uint8_t>& decompressed_bytes);
+
+/// Upper bound on the serialized size of a dense voxel grid, used to pre-size
+/// buffers so that serialization never reallocates.
+template<typename T, typename BackingStore=std::vector<T>>
+inline size_t EstimateSerializedSize(
+    const common_robotics_utilities::voxel_grid
+        ::VoxelGridBase<T, BackingStore>& voxel_grid,
+    const std::string& frame)
+{
+  // Fixed-size header fields (sizes, transforms, default & OOB values) are
+  // well under 1KiB.
+  const size_t header_bytes = 1024 + frame.size();
+  const size_t num_cells
+      = static_cast<size_t>(voxel_grid.GetNumXCells())
+        * static_cast<size_t>(voxel_grid.GetNumYCells())
+        * static_cast<size_t>(voxel_grid.GetNumZCells());
+  return header_bytes + (num_cells * sizeof(T));
+}
+
+/// Serializes @param grid into @param message_bytes, writing directly into
+/// the message field when uncompressed. When compressed, the grid is
+/// serialized into a temporary buffer, which is then deflated into the
+/// message field, so the peak is one serialized copy plus the compressed
+/// output. Streaming cells through deflate would need a serializer that
+/// writes to a sink; the common_robotics_utilities serializers only append
+/// to a contiguous std::vector<uint8_t>.
+template<typename GridType>
+inline void SerializeIntoMessageBytes(
+    const GridType& grid, const size_t serialized_size_hint,
+    const bool compress, std::vector<uint8_t>& message_bytes)
+{
+  message_bytes.clear();
+  if (compress)
+  {
+    std::vector<uint8_t> buffer;
+    buffer.reserve(serialized_size_hint);
+    GridType::Serialize(grid, buffer);
+    CompressBytesInto(buffer, message_bytes);
+  }
+  else
+  {
+    message_bytes.reserve(serialized_size_hint);
+    GridType::Serialize(grid, message_bytes);
+  }
+}
+
+/// Deserializes a grid from @param message_bytes, decompressing into a
+/// temporary buffer first if @param is_compressed. Deserialize() then copies
+/// the cells from that buffer into the backing store; it reads from a
+/// contiguous std::vector<uint8_t>, so the cells cannot be inflated straight
+/// into the grid.
+template<typename GridType>
+inline GridType DeserializeFromMessageBytes(
+    const std::vector<uint8_t>& message_bytes, const bool is_compressed)
+{
+  if (is_compressed)
+  {
+    std::vector<uint8_t> decompressed_bytes;
+    DecompressBytesInto(message_bytes, decompressed_bytes);
+    return GridType::Deserialize(decompressed_bytes, 0).Value();
+  }
+  else
+  {
+    return GridType::Deserialize(message_bytes, 0).Value();
+  }
+}
+
 /// Convert SDF to and from ROS messages.
 
 template<typename BackingStore=std::vector<float>>
 inline SignedDistanceFieldMessage GetMessageRepresentation(
-    const SignedDistanceField<BackingStore>& sdf)
+    const SignedDistanceField<BackingStore>& sdf, const bool compress=true)
 {
   SignedDistanceFieldMessage sdf_message;
   sdf_message.header.frame_id = sdf.GetFrame();
-  std::vector<uint8_t> buffer;
-  SignedDistanceField<BackingStore>::Serialize(sdf, buffer);
-  sdf_message.serialized_sdf
-      = common_robotics_utilities::zlib_helpers::CompressBytes(buffer);
-  sdf_message.is_compressed = true;
+  SerializeIntoMessageBytes<SignedDistanceField<BackingStore>>(
+      sdf, EstimateSerializedSize<float, BackingStore>(sdf, sdf.GetFrame()),
+      compress, sdf_message.serialized_sdf);
+  sdf_message.is_compressed = compress;
   return sdf_message;
 }
 
@@ -470,19 +1059,8 @@ template<typename BackingStore=std::vector<float>>
 inline SignedDistanceField<BackingStore> LoadFromMessageRepresentation(
     const SignedDistanceFieldMessage& message)
 {
-  if (message.is_compressed)
-  {
-    const std::vector<uint8_t> decompressed_sdf
-        = common_robotics_utilities::zlib_helpers::DecompressBytes(
-            message.serialized_sdf);
-    return SignedDistanceField<BackingStore>::Deserialize(
-        decompressed_sdf, 0).Value();
-  }
-  else
-  {
-    return SignedDistanceField<BackingStore>::Deserialize(
-        message.serialized_sdf, 0).Value();
-  }
+  return DeserializeFromMessageBytes<SignedDistanceField<BackingStore>>(
+      message.serialized_sdf, message.is_compressed);
 }
 
 /// Export CollisionMap to RViz for display.
@@ -499,6 +1077,18 @@ MarkerArray ExportForSeparateDisplay(
     const ColorRGBA& free_color,
     const ColorRGBA& unknown_color);
 
+/// Export CollisionMap to RViz with bounded size; see
+/// ExportVoxelGridToRVizWithLOD for the meaning of the LOD options.
+MarkerArray ExportForLODDisplay(
+    const CollisionMap& collision_map,
+    const ColorRGBA& collision_color,
+    const ColorRGBA& free_color,
+    const ColorRGBA& unknown_color,
+    const bool surface_only,
+    const bool merge_uniform_regions,
+    const size_t max_voxels,
+    const bool use_parallel);
+
 Marker ExportSurfacesForDisplay(
     const CollisionMap& collision_map,
     const ColorRGBA& collision_color,
@@ -529,7 +1119,8 @@ Marker ExportIndicesForDisplay(
 
 /// Convert CollisionMap to and from ROS messages.
 
-CollisionMapMessage GetMessageRepresentation(const CollisionMap& map);
+CollisionMapMessage GetMessageRepresentation(
+    const CollisionMap& map, const bool compress=true);
 
 CollisionMap LoadFromMessageRepresentation(const CollisionMapMessage& message);
 
@@ -548,7 +1139,7 @@ MarkerArray ExportForSeparateDisplay(
     const ColorRGBA& unknown_color);
 
 DynamicSpatialHashedCollisionMapMessage GetMessageRepresentation(
-    const DynamicSpatialHashedCollisionMap& map);
+    const DynamicSpatialHashedCollisionMap& map, const bool compress=true);
 
 DynamicSpatialHashedCollisionMap LoadFromMessageRepresentation(
     const DynamicSpatialHashedCollisionMapMessage& message);
@@ -612,7 +1203,7 @@ Marker ExportIndicesForDisplay(
 /// Convert TaggedObjectCollisionMap to and from ROS messages.
 
 TaggedObjectCollisionMapMessage GetMessageRepresentation(
-    const TaggedObjectCollisionMap& map);
+    const TaggedObjectCollisionMap& map, const bool compress=true);
 
 TaggedObjectCollisionMap LoadFromMessageRepresentation(
     const TaggedObjectCollisionMapMessage& message);
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization_interface.hpp>
+#include <voxelized_geometry_tools/tagged_object_collision_map.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// Seeded procedural scenes for benchmarks and scaling tests. A Scene is a
+/// set of analytic primitives that can be rasterized into any grid and
+/// raycast by simulated depth cameras; the same seed always produces the same
+/// scene, map, and cloud.
+namespace scene_generation
+{
+/// Box centered on the origin of pose, with the given half extents.
+class Box
+{
+public:
+  Box(const Eigen::Isometry3d& pose, const Eigen::Vector3d& half_extents,
+      const uint32_t object_id)
+      : pose_(pose), inverse_pose_(pose.inverse()),
+        half_extents_(half_extents), object_id_(object_id)
+  {
+    if ((half_extents_.array() < 0.0).any())
+    {
+      throw std::invalid_argument("half_extents < 0.0");
+    }
+  }
+
+  const Eigen::Isometry3d& Pose() const { return pose_; }
+
+  const Eigen::Vector3d& HalfExtents() const { return half_extents_; }
+
+  uint32_t ObjectId() const { return object_id_; }
+
+  /// Half extents of the bounding box in the primitive's own frame.
+  const Eigen::Vector3d& LocalHalfBounds() const { return half_extents_; }
+
+  /// True if point is inside the box grown by inflation on every side.
+  bool Contains(const Eigen::Vector3d& point, const double inflation) const;
+
+  /// Distance along the unit direction to the first intersection with the
+  /// box surface, or infinity if there is none.
+  double Raycast(const Eigen::Vector3d& origin,
+                 const Eigen::Vector3d& direction) const;
+
+private:
+  Eigen::Isometry3d pose_ = Eigen::Isometry3d::Identity();
+  Eigen::Isometry3d inverse_pose_ = Eigen::Isometry3d::Identity();
+  Eigen::Vector3d half_extents_ = Eigen::Vector3d::Zero();
+  uint32_t object_id_ = 0u;
+};
+
+/// Cylinder whose axis is the z axis of pose, centered on its origin.
+class Cylinder
+{
+public:
+  Cylinder(const Eigen::Isometry3d& pose, const double radius,
+           const double half_height, const uint32_t object_id)
+      : pose_(pose), inverse_pose_(pose.inverse()), radius_(radius),
+        half_height_(half_height), object_id_(object_id)
+  {
+    if (radius_ < 0.0)
+    {
+      throw std::invalid_argument("radius < 0.0");
+    }
+    if (half_height_ < 0.0)
+    {
+      throw std::invalid_argument("half_height < 0.0");
+    }
+  }
+
+  const Eigen::Isometry3d& Pose() const { return pose_; }
+
+  double Radius() const { return radius_; }
+
+  double HalfHeight() const { return half_height_; }
+
+  uint32_t ObjectId() const { return object_id_; }
+
+  Eigen::Vector3d LocalHalfBounds() const
+  {
+    return Eigen::Vector3d(radius_, radius_, half_height_);
+  }
+
+  bool Contains(const Eigen::Vector3d& point, const double inflation) const;
+
+  double Raycast(const Eigen::Vector3d& origin,
+                 const Eigen::Vector3d& direction) const;
+
+private:
+  Eigen::Isometry3d pose_ = Eigen::Isometry3d::Identity();
+  Eigen::Isometry3d inverse_pose_ = Eigen::Isometry3d::Identity();
+  double radius_ = 0.0;
+  double half_height_ = 0.0;
+  uint32_t object_id_ = 0u;
+};
+
+/// Collection of primitives, in world frame. Object ids start at 1, so that
+/// 0 is left for empty space.
+class Scene
+{
+public:
+  Scene() {}
+
+  uint32_t AddBox(const Eigen::Isometry3d& pose,
+                  const Eigen::Vector3d& half_extents)
+  {
+    const uint32_t object_id = NextObjectId();
+    boxes_.push_back(Box(pose, half_extents, object_id));
+    return object_id;
+  }
+
+  uint32_t AddCylinder(const Eigen::Isometry3d& pose, const double radius,
+                       const double half_height)
+  {
+    const uint32_t object_id = NextObjectId();
+    cylinders_.push_back(Cylinder(pose, radius, half_height, object_id));
+    return object_id;
+  }
+
+  const std::vector<Box>& Boxes() const { return boxes_; }
+
+  const std::vector<Cylinder>& Cylinders() const { return cylinders_; }
+
+  size_t NumObjects() const { return boxes_.size() + cylinders_.size(); }
+
+  /// Distance along the unit direction to the nearest surface, or infinity.
+  double Raycast(const Eigen::Vector3d& origin,
+                 const Eigen::Vector3d& direction) const;
+
+private:
+  uint32_t NextObjectId() const
+  {
+    return static_cast<uint32_t>(NumObjects() + 1);
+  }
+
+  std::vector<Box> boxes_;
+  std::vector<Cylinder> cylinders_;
+};
+
+/// Random boxes and upright cylinders, with random yaw, scattered on the
+/// floor of a workspace spanning [0, workspace_size] in world frame. Object
+/// sizes (full extents, and cylinder diameters/heights) are drawn uniformly
+/// from [min_object_size, max_object_size].
+Scene MakeRandomClutterScene(
+    const Eigen::Vector3d& workspace_size, const int32_t num_boxes,
+    const int32_t num_cylinders, const double min_object_size,
+    const double max_object_size, const uint64_t seed);
+
+/// Single-story building spanning [0, building_size] in world frame, with a
+/// floor slab and a grid of rooms of roughly room_size each. Outer walls are
+/// closed; every interior wall segment between two rooms gets one door of
+/// door_width at a random position.
+Scene MakeFloorplanScene(
+    const Eigen::Vector3d& building_size, const double room_size,
+    const double wall_thickness, const double door_width, const uint64_t seed);
+
+/// Axis-aligned walls of wall_thickness (typically less than a voxel) at
+/// random positions and orientations in a workspace spanning
+/// [0, workspace_size], to stress thin-obstacle handling in voxelization and
+/// SDF generation.
+Scene MakeThinWallScene(
+    const Eigen::Vector3d& workspace_size, const int32_t num_walls,
+    const double wall_thickness, const uint64_t seed);
+
+/// Rasterizes a scene into a new CollisionMap: cells are filled (1.0) if
+/// their center is inside a primitive, and free (0.0) otherwise. With
+/// conservative, primitives are grown by half a cell diagonal, so that
+/// obstacles thinner than a cell are never lost.
+CollisionMap MakeCollisionMap(
+    const Scene& scene, const Eigen::Isometry3d& origin_transform,
+    const std::string& frame,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+    const bool conservative, const bool use_parallel);
+
+/// Like MakeCollisionMap, also tagging each filled cell with the id of the
+/// last primitive that covers it.
+TaggedObjectCollisionMap MakeTaggedObjectCollisionMap(
+    const Scene& scene, const Eigen::Isometry3d& origin_transform,
+    const std::string& frame,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+    const bool conservative, const bool use_parallel);
+
+/// Owning pointcloud of packed float xyz points.
+class VectorPointCloudWrapper
+    : public pointcloud_voxelization::PointCloudWrapper
+{
+public:
+  VectorPointCloudWrapper(
+      const Eigen::Isometry3d& origin_transform, const double max_range)
+      : origin_transform_(origin_transform), max_range_(max_range) {}
+
+  void PushBack(const Eigen::Vector3f& point)
+  {
+    points_.insert(points_.end(), point.data(), point.data() + 3);
+  }
+
+  double MaxRange() const override { return max_range_; }
+
+  int64_t Size() const override
+  {
+    return static_cast<int64_t>(points_.size() / 3);
+  }
+
+  const Eigen::Isometry3d& GetPointCloudOriginTransform() const override
+  {
+    return origin_transform_;
+  }
+
+  void SetPointCloudOriginTransform(
+      const Eigen::Isometry3d& origin_transform) override
+  {
+    origin_transform_ = origin_transform;
+  }
+
+private:
+  void CopyPointLocationIntoDoublePtrImpl(
+      const int64_t point_index, double* destination) const override
+  {
+    const size_t offset = static_cast<size_t>(point_index) * 3;
+    destination[0] = static_cast<double>(points_[offset]);
+    destination[1] = static_cast<double>(points_[offset + 1]);
+    destination[2] = static_cast<double>(points_[offset + 2]);
+  }
+
+  void CopyPointLocationIntoFloatPtrImpl(
+      const int64_t point_index, float* destination) const override
+  {
+    const size_t offset = static_cast<size_t>(point_index) * 3;
+    std::memcpy(destination, points_.data() + offset, sizeof(float) * 3);
+  }
+
+  void CopyPointLocationsIntoFloatPtrImpl(
+      const int64_t first_point_index, const int64_t num_points,
+      float* destination) const override
+  {
+    const size_t offset = static_cast<size_t>(first_point_index) * 3;
+    std::memcpy(destination, points_.data() + offset,
+                sizeof(float) * 3 * static_cast<size_t>(num_points));
+  }
+
+  std::vector<float> points_;
+  Eigen::Isometry3d origin_transform_ = Eigen::Isometry3d::Identity();
+  double max_range_ = std::numeric_limits<double>::infinity();
+};
+
+/// Simulates a pinhole depth camera of width x height pixels at camera_pose
+/// (world frame, optical convention: +z forward, +x right, +y down) against
+/// the scene. Returns hits within max_range, in the camera frame, with
+/// zero-mean Gaussian depth noise of depth_noise_stddev; rays that miss
+/// produce no point.
+pointcloud_voxelization::PointCloudWrapperPtr SimulateDepthCamera(
+    const Scene& scene, const Eigen::Isometry3d& camera_pose,
+    const int32_t width, const int32_t height,
+    const double horizontal_field_of_view, const double max_range,
+    const double depth_noise_stddev, const uint64_t seed,
+    const bool use_parallel);
+}  // namespace scene_generation
+}  // namespace voxelized_geometry_tools
@@ -18,6 +18,7 @@
 #include <common_robotics_utilities/voxel_grid.hpp>
 #include <common_robotics_utilities/zlib_helpers.hpp>
 #include <unsupported/Eigen/AutoDiff>
+#include <voxelized_geometry_tools/copy_on_write_tiled_vector.hpp>
 
 namespace voxelized_geometry_tools
 {
@@ -317,6 +318,16 @@ private:
     // Get the query location in grid frame
     const Eigen::Matrix<T, 4, 1> grid_frame_query_location
         = this->GetInverseOriginTransform() * query_location;
+    return EstimateDistanceInterpolateFromNeighborsInGridFrame<T>(
+        grid_frame_query_location, x_idx, y_idx, z_idx);
+  }
+
+  /// As above, for a query location already in grid frame.
+  template<typename T>
+  inline T EstimateDistanceInterpolateFromNeighborsInGridFrame(
+      const Eigen::Matrix<T, 4, 1>& grid_frame_query_location,
+      const int64_t x_idx, const int64_t y_idx, const int64_t z_idx) const
+  {
     // Switch between all the possible options of where we are
     const Eigen::Vector4d cell_center_location
         = this->GridIndexToLocationInGridFrame(x_idx, y_idx, z_idx);
@@ -812,6 +823,53 @@ public:
     }
   }
 
+  /// Batched EstimateDistance for the columns of locations, which are given in
+  /// a frame where this SDF's frame is at object_pose, e.g. to query an object
+  /// SDF from TaggedObjectCollisionMap::MakeSeparateObjectSDFs() at a new pose
+  /// of the object. object_pose and the inverse origin transform are fused
+  /// into one transform, which is applied to the whole batch at once before
+  /// the cells are looked up and interpolated.
+  std::vector<EstimateDistanceQuery> EstimateDistancesAtPose(
+      const Eigen::Isometry3d& object_pose, const Eigen::Matrix3Xd& locations,
+      const bool use_parallel) const
+  {
+    const Eigen::Isometry3d locations_to_grid_frame
+        = this->GetInverseOriginTransform() * object_pose.inverse();
+    const Eigen::Matrix3Xd grid_frame_locations
+        = (locations_to_grid_frame.linear() * locations).colwise()
+            + locations_to_grid_frame.translation();
+    std::vector<EstimateDistanceQuery> distances(
+        static_cast<size_t>(locations.cols()));
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+    UNUSED(use_parallel);
+#endif
+    for (int64_t idx = 0; idx < grid_frame_locations.cols(); idx++)
+    {
+      const Eigen::Vector4d grid_frame_location(
+          grid_frame_locations(0, idx), grid_frame_locations(1, idx),
+          grid_frame_locations(2, idx), 1.0);
+      const common_robotics_utilities::voxel_grid::GridIndex index
+          = this->LocationInGridFrameToGridIndex4d(grid_frame_location);
+      if (this->IndexInBounds(index))
+      {
+        distances[static_cast<size_t>(idx)] = EstimateDistanceQuery(
+            EstimateDistanceInterpolateFromNeighborsInGridFrame<double>(
+                grid_frame_location, index.X(), index.Y(), index.Z()));
+      }
+    }
+    return distances;
+  }
+
+  /// Batched EstimateDistance for the columns of locations.
+  std::vector<EstimateDistanceQuery> EstimateDistances(
+      const Eigen::Matrix3Xd& locations, const bool use_parallel) const
+  {
+    return EstimateDistancesAtPose(
+        Eigen::Isometry3d::Identity(), locations, use_parallel);
+  }
+
   /// "Coarse" gradient is computed by retrieving the distance from the
   /// surrounding size cells (+/-x, +/-y, +/-z) and differencing. This is the
   /// fastest method to compute a gradient, and also has the most potential
@@ -1276,4 +1334,10 @@ public:
     return watershed_map;
   }
 };
+
+/// SDF whose copies (including clones) share storage until written, a tile at
+/// a time. To generate one, pass CopyOnWriteTiledVector<float> as the SDF
+/// backing store of e.g. CollisionMap::ExtractSignedDistanceField<>().
+using CopyOnWriteSignedDistanceField
+    = SignedDistanceField<CopyOnWriteTiledVector<float>>;
 }  // namespace voxelized_geometry_tools
@@ -4,7 +4,7 @@
 #include <omp.h>
 #endif
 
-#include <chrono>
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <functional>
@@ -20,6 +20,7 @@
 #include <common_robotics_utilities/maybe.hpp>
 #include <common_robotics_utilities/openmp_helpers.hpp>
 #include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/instrumentation.hpp>
 #include <voxelized_geometry_tools/signed_distance_field.hpp>
 
 namespace voxelized_geometry_tools
@@ -194,8 +195,9 @@ inline DistanceField BuildDistanceFieldSerial(
     throw std::invalid_argument(
         "Cannot build distance field from grid with non-uniform cells");
   }
-  const std::chrono::time_point<std::chrono::steady_clock> start_time
-      = std::chrono::steady_clock::now();
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(
+      *sink, "BuildDistanceFieldSerial");
   // Make the DistanceField container
   BucketCell default_cell;
   default_cell.distance_square = std::numeric_limits<double>::infinity();
@@ -237,8 +239,19 @@ inline DistanceField BuildDistanceFieldSerial(
   // Process the bucket queue
   const std::vector<std::vector<std::vector<std::vector<int>>>> neighborhoods =
       MakeNeighborhoods();
+  int64_t cells_processed = 0;
+  int64_t bucket_levels = 0;
+  int64_t bucket_peak = 0;
   for (size_t bq_idx = 0; bq_idx < bucket_queue.size(); bq_idx++)
   {
+    const int64_t bucket_size
+        = static_cast<int64_t>(bucket_queue[bq_idx].size());
+    if (bucket_size > 0)
+    {
+      cells_processed += bucket_size;
+      bucket_levels++;
+      bucket_peak = std::max(bucket_peak, bucket_size);
+    }
     for (const auto& cur_cell : bucket_queue[bq_idx])
     {
       // Get the current location
@@ -308,11 +321,14 @@ inline DistanceField BuildDistanceFieldSerial(
     // Clear the current queue now that we're done with it
     bucket_queue[bq_idx].clear();
   }
-  const std::chrono::time_point<std::chrono::steady_clock> end_time
-      = std::chrono::steady_clock::now();
-  const std::chrono::duration<double> elapsed = end_time - start_time;
-  std::cout << "Computed DistanceField in " << elapsed.count() << " seconds"
-            << std::endl;
+  if (sink->IsEnabled())
+  {
+    sink->AddToCounter("distance_field.seed_cells",
+                       static_cast<int64_t>(points.size()));
+    sink->AddToCounter("distance_field.cells_processed", cells_processed);
+    sink->AddToCounter("distance_field.bucket_levels", bucket_levels);
+    sink->RecordPeak("distance_field.bucket_peak", bucket_peak);
+  }
   return distance_field;
 }
 
@@ -326,8 +342,9 @@ inline DistanceField BuildDistanceFieldParallel(
     throw std::invalid_argument(
         "Cannot build distance field from grid with non-uniform cells");
   }
-  const std::chrono::time_point<std::chrono::steady_clock> start_time
-      = std::chrono::steady_clock::now();
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(
+      *sink, "BuildDistanceFieldParallel");
   // Make the DistanceField container
   BucketCell default_cell;
   default_cell.distance_square = std::numeric_limits<double>::infinity();
@@ -374,11 +391,22 @@ inline DistanceField BuildDistanceFieldParallel(
   // Process the bucket queue
   const std::vector<std::vector<std::vector<std::vector<int>>>> neighborhoods =
       MakeNeighborhoods();
+  int64_t cells_processed = 0;
+  int64_t bucket_levels = 0;
+  int64_t bucket_peak = 0;
   for (int32_t current_distance_square = 0;
        current_distance_square
            < static_cast<int32_t>(bucket_queues.NumQueues());
        current_distance_square++)
   {
+    const int64_t bucket_size
+        = static_cast<int64_t>(bucket_queues.Size(current_distance_square));
+    if (bucket_size > 0)
+    {
+      cells_processed += bucket_size;
+      bucket_levels++;
+      bucket_peak = std::max(bucket_peak, bucket_size);
+    }
 #if defined(_OPENMP)
 #pragma omp parallel for
 #endif
@@ -456,11 +484,14 @@ inline DistanceField BuildDistanceFieldParallel(
     // Clear the current queues now that we're done with it
     bucket_queues.ClearCompletedQueues(current_distance_square);
   }
-  const std::chrono::time_point<std::chrono::steady_clock> end_time
-      = std::chrono::steady_clock::now();
-  const std::chrono::duration<double> elapsed = end_time - start_time;
-  std::cout << "Computed DistanceField in " << elapsed.count() << " seconds"
-            << std::endl;
+  if (sink->IsEnabled())
+  {
+    sink->AddToCounter("distance_field.seed_cells",
+                       static_cast<int64_t>(points.size()));
+    sink->AddToCounter("distance_field.cells_processed", cells_processed);
+    sink->AddToCounter("distance_field.bucket_levels", bucket_levels);
+    sink->RecordPeak("distance_field.bucket_peak", bucket_peak);
+  }
   return distance_field;
 }
 
@@ -533,8 +564,9 @@ inline SignedDistanceFieldResult<SDFBackingStore> ExtractSignedDistanceField(
     const std::function<bool(const GridIndex&)>& is_filled_fn,
     const float oob_value, const std::string& frame, const bool use_parallel)
 {
-  const std::chrono::time_point<std::chrono::steady_clock> start_time
-      = std::chrono::steady_clock::now();
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(
+      *sink, "ExtractSignedDistanceField");
   std::vector<GridIndex> filled;
   std::vector<GridIndex> free;
   for (int64_t x_index = 0; x_index < grid_sizes.NumXCells(); x_index++)
@@ -599,11 +631,11 @@ inline SignedDistanceFieldResult<SDFBackingStore> ExtractSignedDistanceField(
       }
     }
   }
-  const std::chrono::time_point<std::chrono::steady_clock> end_time
-      = std::chrono::steady_clock::now();
-  const std::chrono::duration<double> elapsed = end_time - start_time;
-  std::cout << "Computed SDF for grid size in " << elapsed.count() << " seconds"
-            << std::endl;
+  if (sink->IsEnabled())
+  {
+    sink->AddToCounter("sdf.cells", new_sdf.GetTotalCells());
+    sink->AddToCounter("sdf.filled_cells", static_cast<int64_t>(filled.size()));
+  }
   return MakeSignedDistanceFieldResult<SDFBackingStore>(
       new_sdf, max_distance, min_distance);
 }
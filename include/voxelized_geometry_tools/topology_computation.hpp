@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <functional>
@@ -13,6 +14,7 @@
 #include <vector>
 
 #include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/instrumentation.hpp>
 
 namespace voxelized_geometry_tools
 {
@@ -82,8 +84,10 @@ int64_t MarkConnectedComponent(
   queued_hashtable[start_index] = 1;
   // Work
   int64_t marked_cells = 0;
+  size_t queue_peak = working_queue.size();
   while (working_queue.size() > 0)
   {
+    queue_peak = std::max(queue_peak, working_queue.size());
     // Get an item off the queue to work with
     const GridIndex current_index = working_queue.front();
     working_queue.pop_front();
@@ -122,6 +126,12 @@ int64_t MarkConnectedComponent(
       }
     }
   }
+  const auto sink = instrumentation::GetInstrumentationSink();
+  if (sink->IsEnabled())
+  {
+    sink->RecordPeak("topology.component_queue_peak",
+                     static_cast<int64_t>(queue_peak));
+  }
   return marked_cells;
 }
 
@@ -135,6 +145,9 @@ uint32_t ComputeConnectedComponents(
     const std::function<void(const GridIndex&,
                              const uint32_t)>& mark_component_fn)
 {
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(
+      *sink, "ComputeConnectedComponents");
   // Reset components first
   for (int64_t x_index = 0; x_index < source_grid.GetNumXCells(); x_index++)
   {
@@ -153,6 +166,15 @@ uint32_t ComputeConnectedComponents(
                         * source_grid.GetNumZCells();
   int64_t marked_cells = 0;
   uint32_t connected_components = 0;
+  const auto report_fn = [&] ()
+  {
+    if (sink->IsEnabled())
+    {
+      sink->AddToCounter("topology.cells", total_cells);
+      sink->AddToCounter("topology.connected_components",
+                         static_cast<int64_t>(connected_components));
+    }
+  };
   // Sweep through the grid
   for (int64_t x_index = 0; x_index < source_grid.GetNumXCells(); x_index++)
   {
@@ -176,12 +198,14 @@ uint32_t ComputeConnectedComponents(
           // Short-circuit if we've marked everything
           if (marked_cells == total_cells)
           {
+            report_fn();
             return connected_components;
           }
         }
       }
     }
   }
+  report_fn();
   return connected_components;
 }
 
@@ -683,6 +707,9 @@ TopologicalInvariants ComputeComponentTopology(
     const std::function<bool(const GridIndex&)>& is_surface_index_fn,
     const bool verbose)
 {
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(
+      *sink, "ComputeComponentTopology");
   // Extract the surfaces of each connected component
   const std::map<uint32_t, std::unordered_map<GridIndex, uint8_t>>
       component_surfaces = ExtractComponentSurfaces(source_grid,
@@ -701,6 +728,11 @@ TopologicalInvariants ComputeComponentTopology(
         = ComputeHolesAndVoidsInSurface(
             component_number, component_surface, get_component_fn, verbose);
     component_holes_and_voids[component_number] = number_of_holes_and_voids;
+    if (sink->IsEnabled())
+    {
+      sink->AddToCounter("topology.surface_cells",
+                         static_cast<int64_t>(component_surface.size()));
+    }
   }
   return component_holes_and_voids;
 }
@@ -22,7 +22,7 @@ namespace voxelized_geometry_tools
 {
 /// We need to implement cloning.
 std::unique_ptr<common_robotics_utilities::voxel_grid
-    ::VoxelGridBase<CollisionCell, std::vector<CollisionCell>>>
+    ::VoxelGridBase<CollisionCell, CollisionMapBackingStore>>
 CollisionMap::DoClone() const
 {
   return std::unique_ptr<CollisionMap>(new CollisionMap(*this));
@@ -66,23 +66,34 @@ uint64_t CollisionMap::DerivedDeserializeSelf(
           ::DeserializeMemcpyable<uint8_t>(buffer, current_position);
   components_valid_ = static_cast<bool>(components_valid_deserialized.Value());
   current_position += components_valid_deserialized.BytesRead();
+  // Grid sizes may have changed, and every cell may differ.
+  if (dirty_tiles_.IsEnabled())
+  {
+    EnableDirtyTileTracking(dirty_tiles_.TileSize());
+    MarkAllDirty();
+  }
   // Figure out how many bytes were read
   const uint64_t bytes_read = current_position - starting_offset;
   return bytes_read;
 }
 
-/// Invalidate connected components on mutable access.
+/// Invalidate connected components and mark the cell's tile dirty on
+/// mutable access.
 bool CollisionMap::OnMutableAccess(const int64_t x_index,
                                        const int64_t y_index,
                                        const int64_t z_index)
 {
-  UNUSED(x_index);
-  UNUSED(y_index);
-  UNUSED(z_index);
   components_valid_ = false;
+  dirty_tiles_.MarkCell(x_index, y_index, z_index);
   return true;
 }
 
+void CollisionMap::EnableDirtyTileTracking(const int64_t tile_size)
+{
+  dirty_tiles_ = DirtyTileTracker(
+      GetNumXCells(), GetNumYCells(), GetNumZCells(), tile_size);
+}
+
 uint64_t CollisionMap::Serialize(
     const CollisionMap& map, std::vector<uint8_t>& buffer)
 {
@@ -0,0 +1,314 @@
+#include <voxelized_geometry_tools/collision_map_morphology.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <common_robotics_utilities/utility.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/instrumentation.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace collision_map_morphology
+{
+namespace
+{
+const int64_t kInfiniteDistance = std::numeric_limits<int64_t>::max();
+
+/// Scratch space for one line of the distance transform.
+class LineScratch
+{
+public:
+  explicit LineScratch(const int64_t length)
+      : values(static_cast<size_t>(length)),
+        parabola_centers(static_cast<size_t>(length)),
+        parabola_bounds(static_cast<size_t>(length) + 1) {}
+
+  std::vector<int64_t> values;
+  std::vector<int64_t> parabola_centers;
+  std::vector<double> parabola_bounds;
+};
+
+/// 1D squared distance transform of one (strided) line, in place, as the
+/// lower envelope of parabolas rooted at the finite entries (Felzenszwalb and
+/// Huttenlocher). Lines without finite entries are left infinite.
+void TransformLine(
+    const int64_t start, const int64_t stride, const int64_t length,
+    std::vector<int64_t>& squared_distances, LineScratch& scratch)
+{
+  std::vector<int64_t>& f = scratch.values;
+  std::vector<int64_t>& v = scratch.parabola_centers;
+  std::vector<double>& z = scratch.parabola_bounds;
+  for (int64_t q = 0; q < length; q++)
+  {
+    f[static_cast<size_t>(q)]
+        = squared_distances[static_cast<size_t>(start + q * stride)];
+  }
+  // Build the lower envelope.
+  int64_t k = -1;
+  for (int64_t q = 0; q < length; q++)
+  {
+    const int64_t f_q = f[static_cast<size_t>(q)];
+    if (f_q == kInfiniteDistance)
+    {
+      continue;
+    }
+    double s = -std::numeric_limits<double>::infinity();
+    while (k >= 0)
+    {
+      const int64_t v_k = v[static_cast<size_t>(k)];
+      s = static_cast<double>((f_q + q * q)
+                              - (f[static_cast<size_t>(v_k)] + v_k * v_k))
+          / static_cast<double>(2 * (q - v_k));
+      if (s <= z[static_cast<size_t>(k)])
+      {
+        k--;
+        s = -std::numeric_limits<double>::infinity();
+      }
+      else
+      {
+        break;
+      }
+    }
+    k++;
+    v[static_cast<size_t>(k)] = q;
+    z[static_cast<size_t>(k)] = s;
+    z[static_cast<size_t>(k) + 1] = std::numeric_limits<double>::infinity();
+  }
+  if (k < 0)
+  {
+    return;
+  }
+  // Sample the lower envelope.
+  size_t j = 0;
+  for (int64_t q = 0; q < length; q++)
+  {
+    while (z[j + 1] < static_cast<double>(q))
+    {
+      j++;
+    }
+    const int64_t offset = q - v[j];
+    squared_distances[static_cast<size_t>(start + q * stride)]
+        = (offset * offset) + f[static_cast<size_t>(v[j])];
+  }
+}
+
+CollisionMap ApplyMask(
+    const CollisionMap& map, const std::vector<uint8_t>& original_mask,
+    const std::vector<uint8_t>& mask, const bool use_parallel)
+{
+  CollisionMap output_map = map;
+  if (mask == original_mask)
+  {
+    return output_map;
+  }
+  // Work is split by storage tile, and a tile is only written (and so
+  // unshared from other copies of the map) if one of its cells changes.
+  CollisionMapBackingStore& cells = output_map.GetMutableRawData();
+  const size_t tile_capacity = CollisionMapBackingStore::TileCapacity();
+  const int64_t num_tiles = static_cast<int64_t>(cells.NumTiles());
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t tile_index = 0; tile_index < num_tiles; tile_index++)
+  {
+    const size_t tile = static_cast<size_t>(tile_index);
+    const size_t tile_size = cells.GetImmutableTile(tile).size();
+    CollisionMapBackingStore::Tile* mutable_tile = nullptr;
+    for (size_t tile_offset = 0; tile_offset < tile_size; tile_offset++)
+    {
+      const size_t data_index = (tile * tile_capacity) + tile_offset;
+      if (mask[data_index] == original_mask[data_index])
+      {
+        continue;
+      }
+      const bool joined = (mask[data_index] != 0);
+      // Unknown cells that leave the obstacle set stay unknown, since nothing
+      // has been observed there.
+      if (!joined
+          && !(cells.GetImmutableTile(tile)[tile_offset].Occupancy() > 0.5f))
+      {
+        continue;
+      }
+      if (mutable_tile == nullptr)
+      {
+        mutable_tile = &(cells.GetMutableTile(tile));
+      }
+      (*mutable_tile)[tile_offset].Occupancy() = joined ? 1.0f : 0.0f;
+      output_map.MarkDataIndexDirty(static_cast<int64_t>(data_index));
+    }
+  }
+  output_map.ForceComponentsToBeInvalid();
+  return output_map;
+}
+
+double RadiusInCells(const CollisionMap& map, const double radius)
+{
+  if (!(radius >= 0.0))
+  {
+    throw std::invalid_argument("radius < 0");
+  }
+  return radius / map.GetResolution();
+}
+}  // namespace
+
+std::vector<uint8_t> MakeObstacleMask(
+    const CollisionMap& map, const bool unknown_is_filled,
+    const bool use_parallel)
+{
+  const CollisionMapBackingStore& cells = map.GetImmutableRawData();
+  std::vector<uint8_t> mask(cells.size(), 0u);
+  const int64_t num_cells = static_cast<int64_t>(cells.size());
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t data_index = 0; data_index < num_cells; data_index++)
+  {
+    const float occupancy
+        = cells[static_cast<size_t>(data_index)].Occupancy();
+    if (occupancy > 0.5f || (unknown_is_filled && occupancy == 0.5f))
+    {
+      mask[static_cast<size_t>(data_index)] = 1u;
+    }
+  }
+  return mask;
+}
+
+void GrowMask(
+    const int64_t num_x_cells, const int64_t num_y_cells,
+    const int64_t num_z_cells, const double radius_in_cells,
+    const uint8_t feature_value, const bool use_parallel,
+    std::vector<uint8_t>& mask)
+{
+  if (static_cast<int64_t>(mask.size())
+      != num_x_cells * num_y_cells * num_z_cells)
+  {
+    throw std::invalid_argument("mask size does not match grid");
+  }
+  const int64_t radius_squared = static_cast<int64_t>(
+      std::floor(radius_in_cells * radius_in_cells + 1e-9));
+  // Nothing but the cell itself is within a radius of less than one cell.
+  if (radius_squared < 1 || mask.empty())
+  {
+    return;
+  }
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(*sink, "GrowMask");
+  std::vector<int64_t> squared_distances(mask.size());
+  for (size_t data_index = 0; data_index < mask.size(); data_index++)
+  {
+    squared_distances[data_index]
+        = (mask[data_index] == feature_value) ? 0 : kInfiniteDistance;
+  }
+  const int64_t x_stride = num_y_cells * num_z_cells;
+  const int64_t y_stride = num_z_cells;
+  // Transform along z, then y, then x.
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t x_index = 0; x_index < num_x_cells; x_index++)
+  {
+    LineScratch scratch(num_z_cells);
+    for (int64_t y_index = 0; y_index < num_y_cells; y_index++)
+    {
+      TransformLine((x_index * x_stride) + (y_index * y_stride), 1,
+                    num_z_cells, squared_distances, scratch);
+    }
+  }
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+  for (int64_t x_index = 0; x_index < num_x_cells; x_index++)
+  {
+    LineScratch scratch(num_y_cells);
+    for (int64_t z_index = 0; z_index < num_z_cells; z_index++)
+    {
+      TransformLine((x_index * x_stride) + z_index, y_stride, num_y_cells,
+                    squared_distances, scratch);
+    }
+  }
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+  for (int64_t y_index = 0; y_index < num_y_cells; y_index++)
+  {
+    LineScratch scratch(num_x_cells);
+    for (int64_t z_index = 0; z_index < num_z_cells; z_index++)
+    {
+      TransformLine((y_index * y_stride) + z_index, x_stride, num_x_cells,
+                    squared_distances, scratch);
+    }
+  }
+  for (size_t data_index = 0; data_index < mask.size(); data_index++)
+  {
+    if (squared_distances[data_index] <= radius_squared)
+    {
+      mask[data_index] = feature_value;
+    }
+  }
+}
+
+CollisionMap Dilate(
+    const CollisionMap& map, const double radius,
+    const bool unknown_is_filled, const bool use_parallel)
+{
+  const std::vector<uint8_t> original_mask
+      = MakeObstacleMask(map, unknown_is_filled, use_parallel);
+  std::vector<uint8_t> mask = original_mask;
+  GrowMask(map.GetNumXCells(), map.GetNumYCells(), map.GetNumZCells(),
+           RadiusInCells(map, radius), 1u, use_parallel, mask);
+  return ApplyMask(map, original_mask, mask, use_parallel);
+}
+
+CollisionMap Erode(
+    const CollisionMap& map, const double radius,
+    const bool unknown_is_filled, const bool use_parallel)
+{
+  const std::vector<uint8_t> original_mask
+      = MakeObstacleMask(map, unknown_is_filled, use_parallel);
+  std::vector<uint8_t> mask = original_mask;
+  GrowMask(map.GetNumXCells(), map.GetNumYCells(), map.GetNumZCells(),
+           RadiusInCells(map, radius), 0u, use_parallel, mask);
+  return ApplyMask(map, original_mask, mask, use_parallel);
+}
+
+CollisionMap Open(
+    const CollisionMap& map, const double radius,
+    const bool unknown_is_filled, const bool use_parallel)
+{
+  const std::vector<uint8_t> original_mask
+      = MakeObstacleMask(map, unknown_is_filled, use_parallel);
+  const double radius_in_cells = RadiusInCells(map, radius);
+  std::vector<uint8_t> mask = original_mask;
+  GrowMask(map.GetNumXCells(), map.GetNumYCells(), map.GetNumZCells(),
+           radius_in_cells, 0u, use_parallel, mask);
+  GrowMask(map.GetNumXCells(), map.GetNumYCells(), map.GetNumZCells(),
+           radius_in_cells, 1u, use_parallel, mask);
+  return ApplyMask(map, original_mask, mask, use_parallel);
+}
+
+CollisionMap Close(
+    const CollisionMap& map, const double radius,
+    const bool unknown_is_filled, const bool use_parallel)
+{
+  const std::vector<uint8_t> original_mask
+      = MakeObstacleMask(map, unknown_is_filled, use_parallel);
+  const double radius_in_cells = RadiusInCells(map, radius);
+  std::vector<uint8_t> mask = original_mask;
+  GrowMask(map.GetNumXCells(), map.GetNumYCells(), map.GetNumZCells(),
+           radius_in_cells, 1u, use_parallel, mask);
+  GrowMask(map.GetNumXCells(), map.GetNumYCells(), map.GetNumZCells(),
+           radius_in_cells, 0u, use_parallel, mask);
+  return ApplyMask(map, original_mask, mask, use_parallel);
+}
+}  // namespace collision_map_morphology
+}  // namespace voxelized_geometry_tools
@@ -5,22 +5,46 @@
 #endif
 
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include <Eigen/Geometry>
+#include <common_robotics_utilities/utility.hpp>
 #include <common_robotics_utilities/voxel_grid.hpp>
 #include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/device_voxelization_interface.hpp>
 #include <voxelized_geometry_tools/pointcloud_voxelization_interface.hpp>
 
 namespace voxelized_geometry_tools
 {
 namespace pointcloud_voxelization
 {
+CpuPointCloudVoxelizer::CpuPointCloudVoxelizer(
+    const std::map<std::string, int32_t>& options)
+    : num_threads_(RetrieveOptionOrDefault(options, "CPU_NUM_THREADS", 0))
+{
+  if (num_threads_ < 0)
+  {
+    throw std::invalid_argument("CPU_NUM_THREADS < 0");
+  }
+}
+
+int32_t CpuPointCloudVoxelizer::EffectiveNumThreads() const
+{
+#if defined(_OPENMP)
+  return (num_threads_ > 0) ? num_threads_ : omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
 VoxelizerRuntime CpuPointCloudVoxelizer::DoVoxelizePointClouds(
     const CollisionMap& static_environment, const double step_size_multiplier,
     const PointCloudVoxelizationFilterOptions& filter_options,
@@ -40,11 +64,19 @@ VoxelizerRuntime CpuPointCloudVoxelizer::DoVoxelizePointClouds(
           pointclouds.size(),
           CpuVoxelizationTrackingGrid(
               X_WG, grid_size, CpuVoxelizationTrackingCell()));
+  const std::chrono::time_point<std::chrono::steady_clock> setup_time =
+      std::chrono::steady_clock::now();
+  std::vector<double> per_cloud_raycasting_times(pointclouds.size(), 0.0);
+  VoxelizationCounters counters;
   for (size_t idx = 0; idx < pointclouds.size(); idx++)
   {
+    const std::chrono::time_point<std::chrono::steady_clock> cloud_start_time =
+        std::chrono::steady_clock::now();
     const PointCloudWrapperPtr& cloud_ptr = pointclouds.at(idx);
     CpuVoxelizationTrackingGrid& tracking_grid = tracking_grids.at(idx);
-    RaycastPointCloud(*cloud_ptr, step_size, tracking_grid);
+    counters += RaycastPointCloud(*cloud_ptr, step_size, tracking_grid);
+    per_cloud_raycasting_times.at(idx) = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - cloud_start_time).count();
   }
   const std::chrono::time_point<std::chrono::steady_clock> raycasted_time =
       std::chrono::steady_clock::now();
@@ -53,11 +85,13 @@ VoxelizerRuntime CpuPointCloudVoxelizer::DoVoxelizePointClouds(
   const std::chrono::time_point<std::chrono::steady_clock> done_time =
       std::chrono::steady_clock::now();
   return VoxelizerRuntime(
-      std::chrono::duration<double>(raycasted_time - start_time).count(),
-      std::chrono::duration<double>(done_time - raycasted_time).count());
+      std::chrono::duration<double>(setup_time - start_time).count(),
+      std::chrono::duration<double>(raycasted_time - setup_time).count(),
+      std::chrono::duration<double>(done_time - raycasted_time).count(),
+      0.0, 0.0, per_cloud_raycasting_times, counters);
 }
 
-void CpuPointCloudVoxelizer::RaycastPointCloud(
+VoxelizationCounters CpuPointCloudVoxelizer::RaycastPointCloud(
     const PointCloudWrapper& cloud, const double step_size,
     CpuVoxelizationTrackingGrid& tracking_grid) const
 {
@@ -71,8 +105,17 @@ void CpuPointCloudVoxelizer::RaycastPointCloud(
   const Eigen::Vector4d p_GCo = X_GC * Eigen::Vector4d(0.0, 0.0, 0.0, 1.0);
   // Get the max range
   const double max_range = cloud.MaxRange();
+  int64_t num_rays_cast = 0;
+  int64_t num_rays_culled = 0;
+  int64_t num_voxel_visits = 0;
+  int64_t num_contended_updates = 0;
+  const int32_t num_threads = EffectiveNumThreads();
 #if defined(_OPENMP)
-#pragma omp parallel for
+#pragma omp parallel for num_threads(num_threads) \
+    reduction(+:num_rays_cast, num_rays_culled, num_voxel_visits, \
+              num_contended_updates)
+#else
+  UNUSED(num_threads);
 #endif
   for (int64_t idx = 0; idx < cloud.Size(); idx++)
   {
@@ -82,6 +125,7 @@ void CpuPointCloudVoxelizer::RaycastPointCloud(
     if (std::isfinite(p_CP(0)) && std::isfinite(p_CP(1)) &&
         std::isfinite(p_CP(2)))
     {
+      num_rays_cast++;
       // Location of point P in grid G
       const Eigen::Vector4d p_GP = X_GC * p_CP;
       // Ray from camera to point
@@ -112,7 +156,11 @@ void CpuPointCloudVoxelizer::RaycastPointCloud(
           if (query)
           {
             ray_crossed_grid = true;
-            query.Value().seen_free_count.fetch_add(1);
+            num_voxel_visits++;
+            if (query.Value().seen_free_count.fetch_add(1) > 0)
+            {
+              num_contended_updates++;
+            }
           }
           else if (ray_crossed_grid)
           {
@@ -131,11 +179,25 @@ void CpuPointCloudVoxelizer::RaycastPointCloud(
         // We must check to see if the query is within bounds.
         if (query)
         {
-          query.Value().seen_filled_count.fetch_add(1);
+          num_voxel_visits++;
+          if (query.Value().seen_filled_count.fetch_add(1) > 0)
+          {
+            num_contended_updates++;
+          }
         }
       }
     }
+    else
+    {
+      num_rays_culled++;
+    }
   }
+  VoxelizationCounters counters;
+  counters.num_rays_cast = num_rays_cast;
+  counters.num_rays_culled = num_rays_culled;
+  counters.num_voxel_visits = num_voxel_visits;
+  counters.num_contended_updates = num_contended_updates;
+  return counters;
 }
 
 void CpuPointCloudVoxelizer::CombineAndFilterGrids(
@@ -144,52 +206,77 @@ void CpuPointCloudVoxelizer::CombineAndFilterGrids(
     CollisionMap& filtered_grid) const
 {
   // Because we want to improve performance and don't need to know where in the
-  // grid we are, we can take advantage of the dense backing vector to iterate
-  // through the grid data, rather than the grid cells.
-  auto& filtered_grid_backing_store = filtered_grid.GetMutableRawData();
+  // grid we are, we can take advantage of the dense backing store to iterate
+  // through the grid data, rather than the grid cells. Work is split by tile,
+  // and a tile is only written (and so unshared from other copies of the map)
+  // if one of its cells changes. Changed cells are marked dirty, since writes
+  // to raw data bypass mutable access.
+  CollisionMapBackingStore& filtered_grid_backing_store =
+      filtered_grid.GetMutableRawData();
+  const size_t tile_capacity = CollisionMapBackingStore::TileCapacity();
+  const int64_t num_tiles =
+      static_cast<int64_t>(filtered_grid_backing_store.NumTiles());
+  const int32_t num_threads = EffectiveNumThreads();
 #if defined(_OPENMP)
-#pragma omp parallel for
+#pragma omp parallel for num_threads(num_threads)
+#else
+  UNUSED(num_threads);
 #endif
-  for (size_t voxel = 0; voxel < filtered_grid_backing_store.size(); voxel++)
+  for (int64_t tile_index = 0; tile_index < num_tiles; tile_index++)
   {
-    auto& current_cell = filtered_grid_backing_store.at(voxel);
-    // Filled cells stay filled, we don't work with them.
-    // We only change cells that are unknown or empty.
-    if (current_cell.Occupancy() <= 0.5)
+    const size_t tile = static_cast<size_t>(tile_index);
+    const CollisionMapBackingStore::Tile& current_tile =
+        filtered_grid_backing_store.GetImmutableTile(tile);
+    CollisionMapBackingStore::Tile* mutable_tile = nullptr;
+    for (size_t tile_offset = 0; tile_offset < current_tile.size();
+         tile_offset++)
     {
-      int32_t seen_filled = 0;
-      int32_t seen_free = 0;
-      for (size_t idx = 0; idx < tracking_grids.size(); idx++)
+      const size_t voxel = (tile * tile_capacity) + tile_offset;
+      const CollisionCell& current_cell = current_tile[tile_offset];
+      // Filled cells stay filled, we don't work with them.
+      // We only change cells that are unknown or empty.
+      if (current_cell.Occupancy() <= 0.5)
       {
-        const CpuVoxelizationTrackingCell& grid_cell =
-            tracking_grids.at(idx).GetImmutableRawData().at(voxel);
-        const int32_t free_count = grid_cell.seen_free_count.load();
-        const int32_t filled_count = grid_cell.seen_filled_count.load();
-        const SeenAs seen_as =
-            filter_options.CountsSeenAs(free_count, filled_count);
-        if (seen_as == SeenAs::FREE)
+        int32_t seen_filled = 0;
+        int32_t seen_free = 0;
+        for (size_t idx = 0; idx < tracking_grids.size(); idx++)
         {
-          seen_free += 1;
+          const CpuVoxelizationTrackingCell& grid_cell =
+              tracking_grids.at(idx).GetImmutableRawData().at(voxel);
+          const int32_t free_count = grid_cell.seen_free_count.load();
+          const int32_t filled_count = grid_cell.seen_filled_count.load();
+          const SeenAs seen_as =
+              filter_options.CountsSeenAs(free_count, filled_count);
+          if (seen_as == SeenAs::FREE)
+          {
+            seen_free += 1;
+          }
+          else if (seen_as == SeenAs::FILLED)
+          {
+            seen_filled += 1;
+          }
         }
-        else if (seen_as == SeenAs::FILLED)
+        float occupancy = 0.5f;
+        if (seen_filled > 0)
         {
-          seen_filled += 1;
+          // If any camera saw something here, it is filled.
+          occupancy = 1.0f;
+        }
+        else if (seen_free >= filter_options.NumCamerasSeenFree())
+        {
+          // Did enough cameras see this empty?
+          occupancy = 0.0f;
         }
-      }
-      if (seen_filled > 0)
-      {
-        // If any camera saw something here, it is filled.
-        current_cell.Occupancy() = 1.0;
-      }
-      else if (seen_free >= filter_options.NumCamerasSeenFree())
-      {
-        // Did enough cameras see this empty?
-        current_cell.Occupancy() = 0.0;
-      }
-      else
-      {
         // Otherwise, it is unknown.
-        current_cell.Occupancy() = 0.5;
+        if (current_cell.Occupancy() != occupancy)
+        {
+          if (mutable_tile == nullptr)
+          {
+            mutable_tile = &(filtered_grid_backing_store.GetMutableTile(tile));
+          }
+          (*mutable_tile)[tile_offset].Occupancy() = occupancy;
+          filtered_grid.MarkDataIndexDirty(static_cast<int64_t>(voxel));
+        }
       }
     }
   }
@@ -4,10 +4,12 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <map>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -35,7 +37,9 @@ void RaycastPoint(
     const float inverse_step_size, const float inverse_cell_size,
     const int32_t num_x_cells, const int32_t num_y_cells,
     const int32_t num_z_cells, const int32_t stride1, const int32_t stride2,
-    int32_t* const device_tracking_grid_ptr)
+    int32_t* const device_tracking_grid_ptr,
+    unsigned long long* const device_counters_ptr,
+    const bool collect_counters)
 {
   const int32_t point_index = blockIdx.x * blockDim.x + threadIdx.x;
   if (point_index < num_points)
@@ -47,6 +51,8 @@ void RaycastPoint(
     // Skip invalid points marked with NaN or infinity
     if (isfinite(px) && isfinite(py) && isfinite(pz))
     {
+      int32_t voxel_visits = 0;
+      int32_t contended_updates = 0;
       // Pointcloud origin in grid frame
       const float ox = device_grid_pointcloud_transform_ptr[12];
       const float oy = device_grid_pointcloud_transform_ptr[13];
@@ -100,7 +106,10 @@ void RaycastPoint(
             const int32_t cell_index =
                 (x_cell * stride1) + (y_cell * stride2) + z_cell;
             // Increase free count
-            atomicAdd(&(device_tracking_grid_ptr[cell_index * 2]), 1);
+            const int32_t previous_count =
+                atomicAdd(&(device_tracking_grid_ptr[cell_index * 2]), 1);
+            voxel_visits++;
+            contended_updates += (previous_count > 0) ? 1 : 0;
           }
           else if (ray_crossed_grid)
           {
@@ -127,9 +136,24 @@ void RaycastPoint(
           const int32_t cell_index =
               (x_cell * stride1) + (y_cell * stride2) + z_cell;
           // Increase filled count
-          atomicAdd(&(device_tracking_grid_ptr[(cell_index * 2) + 1]), 1);
+          const int32_t previous_count =
+              atomicAdd(&(device_tracking_grid_ptr[(cell_index * 2) + 1]), 1);
+          voxel_visits++;
+          contended_updates += (previous_count > 0) ? 1 : 0;
         }
       }
+      if (collect_counters)
+      {
+        atomicAdd(&(device_counters_ptr[0]), 1ull);
+        atomicAdd(&(device_counters_ptr[2]),
+                  static_cast<unsigned long long>(voxel_visits));
+        atomicAdd(&(device_counters_ptr[3]),
+                  static_cast<unsigned long long>(contended_updates));
+      }
+    }
+    else if (collect_counters)
+    {
+      atomicAdd(&(device_counters_ptr[1]), 1ull);
     }
   }
 }
@@ -267,6 +291,13 @@ public:
   {
     const int32_t cuda_device =
         RetrieveOptionOrDefault(options, "CUDA_DEVICE", 0);
+    collect_counters_ =
+        (RetrieveOptionOrDefault(options, "COLLECT_COUNTERS", 0) != 0);
+    block_size_ = RetrieveOptionOrDefault(options, "CUDA_BLOCK_SIZE", 256);
+    if (block_size_ < 1 || block_size_ > 1024)
+    {
+      throw std::invalid_argument("CUDA_BLOCK_SIZE is not in [1, 1024]");
+    }
     try
     {
       int32_t device_count = 0;
@@ -306,8 +337,10 @@ public:
   std::unique_ptr<TrackingGridsHandle> PrepareTrackingGrids(
       const int64_t num_cells, const int32_t num_grids) override
   {
+    // Raycast counters for each grid follow the tracking grids.
     const size_t tracking_grids_size =
-        sizeof(int32_t) * 2 * num_cells * num_grids;
+        (sizeof(int32_t) * 2 * num_cells * num_grids)
+        + (sizeof(DeviceRaycastCounters) * num_grids);
     int32_t* tracking_grids_buffer = nullptr;
     cudaMalloc(&tracking_grids_buffer, tracking_grids_size);
     CudaCheckErrors("Failed to allocate device tracking grids");
@@ -325,7 +358,7 @@ public:
             tracking_grids_buffer, tracking_grid_offsets, num_cells));
   }
 
-  void RaycastPoints(
+  double RaycastPoints(
       const std::vector<float>& raw_points, const float max_range,
       const float* const grid_pointcloud_transform,
       const float inverse_step_size, const float inverse_cell_size,
@@ -337,6 +370,8 @@ public:
         dynamic_cast<CudaTrackingGridsHandle&>(tracking_grids);
 
     SetCudaDevice();
+    const std::chrono::time_point<std::chrono::steady_clock> start_time =
+        std::chrono::steady_clock::now();
     const int32_t num_points = raw_points.size() / 3;
     // Copy the points
     const size_t points_size = sizeof(float) * raw_points.size();
@@ -356,45 +391,63 @@ public:
         device_grid_pointcloud_transform_ptr, grid_pointcloud_transform,
         transform_size, cudaMemcpyHostToDevice);
     CudaCheckErrors("Failed to memcpy the grid pointcloud transform");
+    const std::chrono::time_point<std::chrono::steady_clock> uploaded_time =
+        std::chrono::steady_clock::now();
 
     // Prepare for raycasting
     const int32_t stride1 = num_y_cells * num_z_cells;
     const int32_t stride2 = num_z_cells;
     // Call the CUDA kernel
-    const int32_t num_threads = 256;
+    const int32_t num_threads = block_size_;
     const int32_t num_blocks = (num_points + (num_threads - 1)) / num_threads;
     const size_t starting_index =
         real_tracking_grids.GetTrackingGridStartingOffset(tracking_grid_index);
     int32_t* const device_tracking_grid_ptr =
         real_tracking_grids.GetBuffer() + starting_index;
+    unsigned long long* const device_counters_ptr =
+        reinterpret_cast<unsigned long long*>(
+            real_tracking_grids.GetBuffer()
+            + CountersOffset(real_tracking_grids, tracking_grid_index));
     RaycastPoint<<<num_blocks, num_threads>>>(
         device_points_ptr, num_points, max_range,
         device_grid_pointcloud_transform_ptr, inverse_step_size,
         inverse_cell_size, num_x_cells, num_y_cells, num_z_cells, stride1,
-        stride2, device_tracking_grid_ptr);
+        stride2, device_tracking_grid_ptr, device_counters_ptr,
+        collect_counters_);
 
     // Free the device memory
     cudaFree(device_points_ptr);
     CudaCheckErrors("Failed to free device points");
     cudaFree(device_grid_pointcloud_transform_ptr);
     CudaCheckErrors("Failed to free device grid pointcloud transform");
+    return std::chrono::duration<double>(uploaded_time - start_time).count();
   }
 
   std::unique_ptr<FilterGridHandle> PrepareFilterGrid(
-       const int64_t num_cells, const void* host_data_ptr) override
+       const int64_t num_cells) override
   {
     const size_t filter_grid_size = sizeof(float) * num_cells * 2;
     float* filter_grid_buffer = nullptr;
     cudaMalloc(&filter_grid_buffer, filter_grid_size);
     CudaCheckErrors("Failed to allocate device filter grid");
-    cudaMemcpy(filter_grid_buffer, host_data_ptr, filter_grid_size,
-               cudaMemcpyHostToDevice);
-    CudaCheckErrors("Failed to memcpy the static environment to the device");
 
     return std::unique_ptr<FilterGridHandle>(new CudaFilterGridHandle(
         filter_grid_buffer, num_cells));
   }
 
+  void UploadFilterGridCells(
+      FilterGridHandle& filter_grid, const int64_t first_cell,
+      const int64_t num_cells, const void* host_data_ptr) override
+  {
+    CudaFilterGridHandle& real_filter_grid =
+        dynamic_cast<CudaFilterGridHandle&>(filter_grid);
+    EnforceCellsInRange(real_filter_grid, first_cell, num_cells);
+
+    cudaMemcpy(real_filter_grid.GetBuffer() + (first_cell * 2), host_data_ptr,
+               sizeof(float) * num_cells * 2, cudaMemcpyHostToDevice);
+    CudaCheckErrors("Failed to memcpy the static environment to the device");
+  }
+
   void FilterTrackingGrids(
       const TrackingGridsHandle& tracking_grids, const float percent_seen_free,
       const int32_t outlier_points_threshold,
@@ -407,7 +460,7 @@ public:
         dynamic_cast<CudaFilterGridHandle&>(filter_grid);
 
     // Call the CUDA kernel
-    const int32_t num_threads = 256;
+    const int32_t num_threads = block_size_;
     const int32_t num_blocks =
         (real_tracking_grids.NumCellsPerGrid() + (num_threads - 1))
         / num_threads;
@@ -438,21 +491,45 @@ public:
     CudaCheckErrors("Failed to memcpy the tracking grid back to the host");
   }
 
-  void RetrieveFilteredGrid(
-      const FilterGridHandle& filter_grid, void* host_data_ptr) override
+  void RetrieveFilteredGridCells(
+      const FilterGridHandle& filter_grid, const int64_t first_cell,
+      const int64_t num_cells, void* host_data_ptr) override
   {
     const CudaFilterGridHandle& real_filter_grid =
         dynamic_cast<const CudaFilterGridHandle&>(filter_grid);
+    EnforceCellsInRange(real_filter_grid, first_cell, num_cells);
 
     // Wait for GPU to finish before accessing on host
     cudaDeviceSynchronize();
-    const size_t item_size = sizeof(float) * 2;
-    const size_t buffer_size = real_filter_grid.NumCells() * item_size;
-    cudaMemcpy(host_data_ptr, real_filter_grid.GetBuffer(), buffer_size,
-               cudaMemcpyDeviceToHost);
+    cudaMemcpy(host_data_ptr, real_filter_grid.GetBuffer() + (first_cell * 2),
+               sizeof(float) * num_cells * 2, cudaMemcpyDeviceToHost);
     CudaCheckErrors("Failed to memcpy the filter grid back to the host");
   }
 
+  DeviceRaycastCounters RetrieveRaycastCounters(
+      const TrackingGridsHandle& tracking_grids,
+      const size_t tracking_grid_index) override
+  {
+    const CudaTrackingGridsHandle& real_tracking_grids =
+        dynamic_cast<const CudaTrackingGridsHandle&>(tracking_grids);
+
+    // Wait for GPU to finish before accessing on host
+    cudaDeviceSynchronize();
+    DeviceRaycastCounters counters;
+    cudaMemcpy(&counters,
+               real_tracking_grids.GetBuffer()
+                   + CountersOffset(real_tracking_grids, tracking_grid_index),
+               sizeof(counters), cudaMemcpyDeviceToHost);
+    CudaCheckErrors("Failed to memcpy the raycast counters back to the host");
+    return counters;
+  }
+
+  void Synchronize() override
+  {
+    cudaDeviceSynchronize();
+    CudaCheckErrors("Failed to synchronize device");
+  }
+
   void SetCudaDevice()
   {
     cudaSetDevice(cuda_device_num_);
@@ -460,7 +537,30 @@ public:
   }
 
 private:
+  static void EnforceCellsInRange(
+      const FilterGridHandle& filter_grid, const int64_t first_cell,
+      const int64_t num_cells)
+  {
+    if (first_cell < 0 || num_cells < 0
+        || (first_cell + num_cells) > filter_grid.NumCells())
+    {
+      throw std::out_of_range("Filter grid cells out of range");
+    }
+  }
+
+  static size_t CountersOffset(
+      const TrackingGridsHandle& tracking_grids,
+      const size_t tracking_grid_index)
+  {
+    return static_cast<size_t>(
+        (2 * tracking_grids.NumCellsPerGrid()
+         * static_cast<int64_t>(tracking_grids.GetNumTrackingGrids()))
+        + (8 * static_cast<int64_t>(tracking_grid_index)));
+  }
+
   int32_t cuda_device_num_ = -1;
+  bool collect_counters_ = false;
+  int32_t block_size_ = 256;
 };
 
 std::vector<AvailableDevice> GetAvailableDevices()
@@ -6,8 +6,10 @@
 
 #include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <memory>
 #include <stdexcept>
@@ -49,6 +51,9 @@ VoxelizerRuntime DevicePointCloudVoxelizer::DoVoxelizePointClouds(
     throw std::runtime_error("Failed to allocate device tracking grid");
   }
 
+  const std::chrono::time_point<std::chrono::steady_clock> setup_time =
+      std::chrono::steady_clock::now();
+
   // Get X_GW, the transform from grid origin to world
   const Eigen::Isometry3d& X_GW =
       static_environment.GetInverseOriginTransform();
@@ -67,11 +72,15 @@ VoxelizerRuntime DevicePointCloudVoxelizer::DoVoxelizePointClouds(
       static_cast<int32_t>(static_environment.GetNumZCells());
 
   // Do raycasting of the pointclouds
+  std::vector<double> per_cloud_raycasting_times(pointclouds.size(), 0.0);
+  std::vector<double> per_cloud_upload_times(pointclouds.size(), 0.0);
 #if defined(_OPENMP)
 #pragma omp parallel for
 #endif
   for (size_t idx = 0; idx < pointclouds.size(); idx++)
   {
+    const std::chrono::time_point<std::chrono::steady_clock> cloud_start_time =
+        std::chrono::steady_clock::now();
     const PointCloudWrapperPtr& pointcloud = pointclouds.at(idx);
 
     // Only do work if the pointcloud is non-empty, to avoid passing empty
@@ -88,20 +97,19 @@ VoxelizerRuntime DevicePointCloudVoxelizer::DoVoxelizePointClouds(
       const float max_range = static_cast<float>(pointcloud->MaxRange());
 
       // Copy pointcloud
-      std::vector<float> raw_points(pointcloud->Size() * 3, 0.0);
-      for (int64_t point = 0; point < pointcloud->Size(); point++)
-      {
-        pointcloud->CopyPointLocationIntoVectorFloat(
-            point, raw_points, point * 3);
-      }
+      std::vector<float> raw_points;
+      pointcloud->CopyPointLocationsIntoVectorFloat(raw_points);
 
       // Raycast
-      helper_interface_->RaycastPoints(
+      per_cloud_upload_times.at(idx) = helper_interface_->RaycastPoints(
           raw_points, max_range, grid_pointcloud_transform_float.data(),
           inverse_step_size, inverse_cell_size, num_x_cells, num_y_cells,
           num_z_cells, *tracking_grids, idx);
     }
+    per_cloud_raycasting_times.at(idx) = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - cloud_start_time).count();
   }
+  helper_interface_->Synchronize();
 
   const std::chrono::time_point<std::chrono::steady_clock> raycasted_time =
       std::chrono::steady_clock::now();
@@ -114,25 +122,96 @@ VoxelizerRuntime DevicePointCloudVoxelizer::DoVoxelizePointClouds(
   const int32_t num_cameras_seen_free =
       filter_options.NumCamerasSeenFree();
 
+  // Map storage is tiled, so upload the grid a tile at a time.
   std::unique_ptr<FilterGridHandle> filter_grid =
-      helper_interface_->PrepareFilterGrid(
-          static_environment.GetTotalCells(),
-          static_environment.GetImmutableRawData().data());
+      helper_interface_->PrepareFilterGrid(static_environment.GetTotalCells());
+  const CollisionMapBackingStore& static_data =
+      static_environment.GetImmutableRawData();
+  const int64_t tile_capacity =
+      static_cast<int64_t>(CollisionMapBackingStore::TileCapacity());
+  for (size_t tile = 0; tile < static_data.NumTiles(); tile++)
+  {
+    const auto& static_tile = static_data.GetImmutableTile(tile);
+    helper_interface_->UploadFilterGridCells(
+        *filter_grid, static_cast<int64_t>(tile) * tile_capacity,
+        static_cast<int64_t>(static_tile.size()), static_tile.data());
+  }
+
+  const std::chrono::time_point<std::chrono::steady_clock> uploaded_time =
+      std::chrono::steady_clock::now();
 
   helper_interface_->FilterTrackingGrids(
       *tracking_grids, percent_seen_free, outlier_points_threshold,
       num_cameras_seen_free, *filter_grid);
+  helper_interface_->Synchronize();
+
+  const std::chrono::time_point<std::chrono::steady_clock> filtered_time =
+      std::chrono::steady_clock::now();
 
   // Retrieve & return
-  helper_interface_->RetrieveFilteredGrid(
-      *filter_grid, output_environment.GetMutableRawData().data());
+  // Only write tiles that changed, so that tiles shared with other copies of
+  // the map stay shared, and mark their changed cells dirty.
+  const CollisionMapBackingStore& output_data =
+      output_environment.GetImmutableRawData();
+  std::vector<CollisionCell> filtered_tile(
+      CollisionMapBackingStore::TileCapacity());
+  for (size_t tile = 0; tile < output_data.NumTiles(); tile++)
+  {
+    const auto& output_tile = output_data.GetImmutableTile(tile);
+    const size_t tile_size = output_tile.size();
+    const int64_t first_cell = static_cast<int64_t>(tile) * tile_capacity;
+    helper_interface_->RetrieveFilteredGridCells(
+        *filter_grid, first_cell, static_cast<int64_t>(tile_size),
+        filtered_tile.data());
+    if (std::memcmp(filtered_tile.data(), output_tile.data(),
+                    tile_size * sizeof(CollisionCell)) == 0)
+    {
+      continue;
+    }
+    auto& mutable_tile =
+        output_environment.GetMutableRawData().GetMutableTile(tile);
+    for (size_t offset = 0; offset < tile_size; offset++)
+    {
+      const CollisionCell& filtered_cell = filtered_tile[offset];
+      CollisionCell& output_cell = mutable_tile[offset];
+      if (filtered_cell.Occupancy() != output_cell.Occupancy()
+          || filtered_cell.Component() != output_cell.Component())
+      {
+        output_cell = filtered_cell;
+        output_environment.MarkDataIndexDirty(
+            first_cell + static_cast<int64_t>(offset));
+      }
+    }
+  }
+
+  VoxelizationCounters counters;
+  for (size_t idx = 0; idx < pointclouds.size(); idx++)
+  {
+    const DeviceRaycastCounters device_counters =
+        helper_interface_->RetrieveRaycastCounters(*tracking_grids, idx);
+    counters.num_rays_cast += device_counters.num_rays_cast;
+    counters.num_rays_culled += device_counters.num_rays_culled;
+    counters.num_voxel_visits += device_counters.num_voxel_visits;
+    counters.num_contended_updates += device_counters.num_contended_updates;
+  }
 
   const std::chrono::time_point<std::chrono::steady_clock> done_time =
       std::chrono::steady_clock::now();
 
+  double host_to_device_time =
+      std::chrono::duration<double>(uploaded_time - raycasted_time).count();
+  for (const double upload_time : per_cloud_upload_times)
+  {
+    host_to_device_time += upload_time;
+  }
+
   return VoxelizerRuntime(
-      std::chrono::duration<double>(raycasted_time - start_time).count(),
-      std::chrono::duration<double>(done_time - raycasted_time).count());
+      std::chrono::duration<double>(setup_time - start_time).count(),
+      std::chrono::duration<double>(raycasted_time - setup_time).count(),
+      std::chrono::duration<double>(done_time - raycasted_time).count(),
+      host_to_device_time,
+      std::chrono::duration<double>(done_time - filtered_time).count(),
+      per_cloud_raycasting_times, counters);
 }
 
 CudaPointCloudVoxelizer::CudaPointCloudVoxelizer(
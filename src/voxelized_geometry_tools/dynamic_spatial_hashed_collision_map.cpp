@@ -1,27 +1,116 @@
 #include <voxelized_geometry_tools/dynamic_spatial_hashed_collision_map.hpp>
 
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <Eigen/Geometry>
 #include <common_robotics_utilities/dynamic_spatial_hashed_voxel_grid.hpp>
+#include <common_robotics_utilities/maybe.hpp>
 #include <common_robotics_utilities/serialization.hpp>
 #include <common_robotics_utilities/voxel_grid.hpp>
 #include <common_robotics_utilities/zlib_helpers.hpp>
 #include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/dynamic_spatial_hashed_signed_distance_field.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
 
 namespace voxelized_geometry_tools
 {
+namespace
+{
+template<typename ChunkLocks>
+class SharedChunkTableLock
+{
+public:
+  explicit SharedChunkTableLock(ChunkLocks& locks) : locks_(locks)
+  {
+    locks_.LockChunkTableShared();
+  }
+
+  ~SharedChunkTableLock() { locks_.UnlockChunkTableShared(); }
+
+private:
+  ChunkLocks& locks_;
+};
+
+template<typename ChunkLocks>
+class ExclusiveChunkTableLock
+{
+public:
+  explicit ExclusiveChunkTableLock(ChunkLocks& locks) : locks_(locks)
+  {
+    locks_.LockChunkTableExclusive();
+  }
+
+  ~ExclusiveChunkTableLock() { locks_.UnlockChunkTableExclusive(); }
+
+private:
+  ChunkLocks& locks_;
+};
+
+/// Calls span_fn(span, span_size, row_offset) for each tile-contiguous piece
+/// of the num_cells cells of cells starting at data index start, so that rows
+/// can be copied in and out of tiles without gathering them first.
+template<typename SpanFunction>
+void ForEachImmutableSpan(
+    const CollisionMapBackingStore& cells, const size_t start,
+    const size_t num_cells, const SpanFunction& span_fn)
+{
+  const size_t tile_capacity = CollisionMapBackingStore::TileCapacity();
+  size_t row_offset = 0;
+  while (row_offset < num_cells)
+  {
+    const size_t index = start + row_offset;
+    const size_t tile_offset = index % tile_capacity;
+    const size_t span_size
+        = std::min(num_cells - row_offset, tile_capacity - tile_offset);
+    span_fn(cells.GetImmutableTile(index / tile_capacity).data() + tile_offset,
+            span_size, row_offset);
+    row_offset += span_size;
+  }
+}
+
+template<typename SpanFunction>
+void ForEachMutableSpan(
+    CollisionMapBackingStore& cells, const size_t start,
+    const size_t num_cells, const SpanFunction& span_fn)
+{
+  const size_t tile_capacity = CollisionMapBackingStore::TileCapacity();
+  size_t row_offset = 0;
+  while (row_offset < num_cells)
+  {
+    const size_t index = start + row_offset;
+    const size_t tile_offset = index % tile_capacity;
+    const size_t span_size
+        = std::min(num_cells - row_offset, tile_capacity - tile_offset);
+    span_fn(cells.GetMutableTile(index / tile_capacity).data() + tile_offset,
+            span_size, row_offset);
+    row_offset += span_size;
+  }
+}
+}  // namespace
+
 /// We need to implement cloning.
 std::unique_ptr<common_robotics_utilities::voxel_grid
     ::DynamicSpatialHashedVoxelGridBase<
-        CollisionCell, std::vector<CollisionCell>>>
+        CollisionCell, DSHCollisionCellBackingStore>>
 DynamicSpatialHashedCollisionMap::DoClone() const
 {
   return std::unique_ptr<DynamicSpatialHashedCollisionMap>(
@@ -60,10 +149,662 @@ uint64_t DynamicSpatialHashedCollisionMap::DerivedDeserializeSelf(
 bool DynamicSpatialHashedCollisionMap::OnMutableAccess(
     const Eigen::Vector4d& location)
 {
-  UNUSED(location);
+  // Concurrent* methods hold the chunk table lock, and do not collapse.
+  if (auto_collapse_batch_size_ == 0 || auto_collapse_suspended_
+      || concurrent_locks_.ChunkTableLocked())
+  {
+    return true;
+  }
+  // A location on a chunk boundary may be recorded against the neighboring
+  // chunk, which only delays collapsing its own chunk.
+  const common_robotics_utilities::voxel_grid::GridIndex chunk_index
+      = GridFrameLocationToChunkIndex(GetInverseOriginTransform() * location);
+  // Collapsing scans the chunk table, so wait for enough dirty chunks to
+  // keep the amortized cost per dirty chunk constant. The chunk accessed now
+  // is about to change, so it is left for the next batch.
+  const size_t collapse_threshold = std::max(
+      auto_collapse_batch_size_, GetImmutableInternalChunks().size() / 8);
+  if (dirty_chunks_.size() >= collapse_threshold)
+  {
+    dirty_chunks_.erase(chunk_index);
+    CollapseUniformChunksImpl(true);
+  }
+  dirty_chunks_.insert(chunk_index);
   return true;
 }
 
+Eigen::Vector4d DynamicSpatialHashedCollisionMap::GridIndexToLocation(
+    const common_robotics_utilities::voxel_grid::GridIndex& index) const
+{
+  const Eigen::Vector3d cell_sizes = GetCellSizes();
+  const Eigen::Vector4d location_in_grid_frame(
+      (static_cast<double>(index.X()) + 0.5) * cell_sizes.x(),
+      (static_cast<double>(index.Y()) + 0.5) * cell_sizes.y(),
+      (static_cast<double>(index.Z()) + 0.5) * cell_sizes.z(), 1.0);
+  return GetOriginTransform() * location_in_grid_frame;
+}
+
+common_robotics_utilities::voxel_grid::GridIndex
+DynamicSpatialHashedCollisionMap::CellIndexToChunkIndex(
+    const common_robotics_utilities::voxel_grid::GridIndex& index) const
+{
+  // Floor division, since cell indices may be negative.
+  const auto floor_divide = [] (const int64_t value, const int64_t divisor)
+  {
+    const int64_t quotient = value / divisor;
+    return ((value % divisor) < 0) ? (quotient - 1) : quotient;
+  };
+  const common_robotics_utilities::voxel_grid::GridSizes& chunk_grid_sizes
+      = GetChunkGridSizes();
+  return common_robotics_utilities::voxel_grid::GridIndex(
+      floor_divide(index.X(), chunk_grid_sizes.NumXCells()),
+      floor_divide(index.Y(), chunk_grid_sizes.NumYCells()),
+      floor_divide(index.Z(), chunk_grid_sizes.NumZCells()));
+}
+
+GridIndexRegion DynamicSpatialHashedCollisionMap::GridFrameBoxToRegion(
+    const Eigen::Vector3d& lower, const Eigen::Vector3d& upper) const
+{
+  if (upper.x() < lower.x() || upper.y() < lower.y() || upper.z() < lower.z())
+  {
+    throw std::invalid_argument("upper < lower");
+  }
+  const double inv_resolution = 1.0 / GetResolution();
+  const common_robotics_utilities::voxel_grid::GridIndex lower_index(
+      static_cast<int64_t>(std::floor(lower.x() * inv_resolution)),
+      static_cast<int64_t>(std::floor(lower.y() * inv_resolution)),
+      static_cast<int64_t>(std::floor(lower.z() * inv_resolution)));
+  const common_robotics_utilities::voxel_grid::GridIndex upper_index(
+      static_cast<int64_t>(std::floor(upper.x() * inv_resolution)) + 1,
+      static_cast<int64_t>(std::floor(upper.y() * inv_resolution)) + 1,
+      static_cast<int64_t>(std::floor(upper.z() * inv_resolution)) + 1);
+  return GridIndexRegion(lower_index, upper_index);
+}
+
+CollisionMap DynamicSpatialHashedCollisionMap::ExportRegion(
+    const GridIndexRegion& region) const
+{
+  using common_robotics_utilities::voxel_grid::DSHVGFoundStatus;
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  const double resolution = GetResolution();
+  const Eigen::Isometry3d region_origin_transform
+      = GetOriginTransform() * Eigen::Translation3d(
+          static_cast<double>(region.Lower().X()) * resolution,
+          static_cast<double>(region.Lower().Y()) * resolution,
+          static_cast<double>(region.Lower().Z()) * resolution);
+  const common_robotics_utilities::voxel_grid::GridSizes region_sizes(
+      resolution, region.NumXCells(), region.NumYCells(), region.NumZCells());
+  // Constructing the map fills it with the default value, so cells in
+  // unallocated chunks need no further work.
+  CollisionMap region_map(
+      region_origin_transform, frame_, region_sizes, GetDefaultValue());
+  if (region.IsEmpty())
+  {
+    return region_map;
+  }
+  // Rows are copied straight into the map's tiles.
+  CollisionMapBackingStore& region_cells = region_map.GetMutableRawData();
+  const int64_t region_stride1 = region.NumYCells() * region.NumZCells();
+  const int64_t region_stride2 = region.NumZCells();
+  const common_robotics_utilities::voxel_grid::GridSizes& chunk_grid_sizes
+      = GetChunkGridSizes();
+  const GridIndex chunk_num_cells(
+      chunk_grid_sizes.NumXCells(), chunk_grid_sizes.NumYCells(),
+      chunk_grid_sizes.NumZCells());
+  const GridIndex lower_chunk = CellIndexToChunkIndex(region.Lower());
+  const GridIndex upper_chunk = CellIndexToChunkIndex(GridIndex(
+      region.Upper().X() - 1, region.Upper().Y() - 1, region.Upper().Z() - 1));
+  for (int64_t chunk_x = lower_chunk.X(); chunk_x <= upper_chunk.X();
+       chunk_x++)
+  {
+    for (int64_t chunk_y = lower_chunk.Y(); chunk_y <= upper_chunk.Y();
+         chunk_y++)
+    {
+      for (int64_t chunk_z = lower_chunk.Z(); chunk_z <= upper_chunk.Z();
+           chunk_z++)
+      {
+        const GridIndex chunk_lower(
+            chunk_x * chunk_num_cells.X(), chunk_y * chunk_num_cells.Y(),
+            chunk_z * chunk_num_cells.Z());
+        const GridIndex chunk_upper(
+            chunk_lower.X() + chunk_num_cells.X(),
+            chunk_lower.Y() + chunk_num_cells.Y(),
+            chunk_lower.Z() + chunk_num_cells.Z());
+        const GridIndexRegion overlap
+            = GridIndexRegion(chunk_lower, chunk_upper).Intersected(region);
+        const auto first_query
+            = GetImmutable4d(GridIndexToLocation(overlap.Lower()));
+        const DSHVGFoundStatus found_status = first_query.FoundStatus();
+        if (found_status == DSHVGFoundStatus::NOT_FOUND)
+        {
+          continue;
+        }
+        const CollisionCell chunk_value = first_query.Value();
+        for (int64_t x_index = overlap.Lower().X();
+             x_index < overlap.Upper().X(); x_index++)
+        {
+          for (int64_t y_index = overlap.Lower().Y();
+               y_index < overlap.Upper().Y(); y_index++)
+          {
+            const size_t region_row_start = static_cast<size_t>(
+                ((x_index - region.Lower().X()) * region_stride1)
+                + ((y_index - region.Lower().Y()) * region_stride2)
+                + (overlap.Lower().Z() - region.Lower().Z()));
+            const size_t row_size = static_cast<size_t>(overlap.NumZCells());
+            if (found_status == DSHVGFoundStatus::FOUND_IN_CHUNK)
+            {
+              ForEachMutableSpan(
+                  region_cells, region_row_start, row_size,
+                  [&] (CollisionCell* span, const size_t span_size,
+                       const size_t)
+              {
+                std::fill_n(span, span_size, chunk_value);
+              });
+            }
+            else
+            {
+              // Cells are stored z-minor inside a chunk, so each chunk row
+              // overlapping the region is contiguous.
+              const auto row_query = GetImmutable4d(GridIndexToLocation(
+                  GridIndex(x_index, y_index, overlap.Lower().Z())));
+              const CollisionCell* chunk_row = &(row_query.Value());
+              ForEachMutableSpan(
+                  region_cells, region_row_start, row_size,
+                  [&] (CollisionCell* span, const size_t span_size,
+                       const size_t row_offset)
+              {
+                std::memcpy(span, chunk_row + row_offset,
+                            sizeof(CollisionCell) * span_size);
+              });
+            }
+          }
+        }
+      }
+    }
+  }
+  return region_map;
+}
+
+void DynamicSpatialHashedCollisionMap::ImportRegion(
+    const GridIndexRegion& region, const CollisionMap& map)
+{
+  using common_robotics_utilities::voxel_grid::DSHVGSetType;
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  if (map.GetNumXCells() != region.NumXCells()
+      || map.GetNumYCells() != region.NumYCells()
+      || map.GetNumZCells() != region.NumZCells())
+  {
+    throw std::invalid_argument("map size does not match region");
+  }
+  if (region.IsEmpty())
+  {
+    return;
+  }
+  // Uniform chunks are stored as such below, and automatic collapsing could
+  // collapse a chunk again before it is filled, so it is suspended here.
+  const ScopedAutoCollapseSuspension suspension(auto_collapse_suspended_);
+  // Rows are read straight from the map's tiles.
+  const CollisionMapBackingStore& map_cells = map.GetImmutableRawData();
+  const int64_t map_stride1 = region.NumYCells() * region.NumZCells();
+  const int64_t map_stride2 = region.NumZCells();
+  const auto map_row_start = [&] (const int64_t x_index,
+                                  const int64_t y_index,
+                                  const int64_t z_index)
+  {
+    return static_cast<size_t>(
+        ((x_index - region.Lower().X()) * map_stride1)
+        + ((y_index - region.Lower().Y()) * map_stride2)
+        + (z_index - region.Lower().Z()));
+  };
+  const common_robotics_utilities::voxel_grid::GridSizes& chunk_grid_sizes
+      = GetChunkGridSizes();
+  const GridIndex chunk_num_cells(
+      chunk_grid_sizes.NumXCells(), chunk_grid_sizes.NumYCells(),
+      chunk_grid_sizes.NumZCells());
+  const GridIndex lower_chunk = CellIndexToChunkIndex(region.Lower());
+  const GridIndex upper_chunk = CellIndexToChunkIndex(GridIndex(
+      region.Upper().X() - 1, region.Upper().Y() - 1, region.Upper().Z() - 1));
+  for (int64_t chunk_x = lower_chunk.X(); chunk_x <= upper_chunk.X();
+       chunk_x++)
+  {
+    for (int64_t chunk_y = lower_chunk.Y(); chunk_y <= upper_chunk.Y();
+         chunk_y++)
+    {
+      for (int64_t chunk_z = lower_chunk.Z(); chunk_z <= upper_chunk.Z();
+           chunk_z++)
+      {
+        const GridIndex chunk_lower(
+            chunk_x * chunk_num_cells.X(), chunk_y * chunk_num_cells.Y(),
+            chunk_z * chunk_num_cells.Z());
+        const GridIndex chunk_upper(
+            chunk_lower.X() + chunk_num_cells.X(),
+            chunk_lower.Y() + chunk_num_cells.Y(),
+            chunk_lower.Z() + chunk_num_cells.Z());
+        const GridIndexRegion chunk_region(chunk_lower, chunk_upper);
+        const GridIndexRegion overlap = chunk_region.Intersected(region);
+        const size_t row_size = static_cast<size_t>(overlap.NumZCells());
+        const CollisionCell first_value = map_cells[map_row_start(
+            overlap.Lower().X(), overlap.Lower().Y(), overlap.Lower().Z())];
+        // If the entire chunk is covered by a single value, store it as such.
+        bool uniform = (overlap.TotalCells() == chunk_region.TotalCells());
+        for (int64_t x_index = overlap.Lower().X();
+             uniform && x_index < overlap.Upper().X(); x_index++)
+        {
+          for (int64_t y_index = overlap.Lower().Y();
+               uniform && y_index < overlap.Upper().Y(); y_index++)
+          {
+            ForEachImmutableSpan(
+                map_cells, map_row_start(x_index, y_index, overlap.Lower().Z()),
+                row_size,
+                [&] (const CollisionCell* span, const size_t span_size,
+                     const size_t)
+            {
+              for (size_t idx = 0; uniform && idx < span_size; idx++)
+              {
+                uniform = (span[idx].Occupancy() == first_value.Occupancy()
+                           && span[idx].Component()
+                               == first_value.Component());
+              }
+            });
+          }
+        }
+        if (uniform)
+        {
+          DSHCollisionMapBase::SetValue4d(
+              GridIndexToLocation(overlap.Lower()), DSHVGSetType::SET_CHUNK,
+              first_value);
+          continue;
+        }
+        // Make sure the chunk is allocated with individual cells, then copy
+        // in a row at a time.
+        DSHCollisionMapBase::SetValue4d(
+            GridIndexToLocation(overlap.Lower()), DSHVGSetType::SET_CELL,
+            first_value);
+        for (int64_t x_index = overlap.Lower().X();
+             x_index < overlap.Upper().X(); x_index++)
+        {
+          for (int64_t y_index = overlap.Lower().Y();
+               y_index < overlap.Upper().Y(); y_index++)
+          {
+            auto row_query = GetMutable4d(GridIndexToLocation(
+                GridIndex(x_index, y_index, overlap.Lower().Z())));
+            CollisionCell* chunk_row = &(row_query.Value());
+            ForEachImmutableSpan(
+                map_cells, map_row_start(x_index, y_index, overlap.Lower().Z()),
+                row_size,
+                [&] (const CollisionCell* span, const size_t span_size,
+                     const size_t row_offset)
+            {
+              std::memcpy(chunk_row + row_offset, span,
+                          sizeof(CollisionCell) * span_size);
+            });
+          }
+        }
+      }
+    }
+  }
+}
+
+DynamicSpatialHashedSignedDistanceField
+DynamicSpatialHashedCollisionMap::ExtractSignedDistanceField(
+    const double truncation_distance, const bool unknown_is_filled,
+    const bool use_parallel) const
+{
+  using common_robotics_utilities::voxel_grid::DSHVGFillStatus;
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  if (truncation_distance <= 0.0)
+  {
+    throw std::invalid_argument("truncation_distance <= 0.0");
+  }
+  const double resolution = GetResolution();
+  const int64_t halo_cells
+      = static_cast<int64_t>(std::ceil(truncation_distance / resolution));
+  const auto is_filled = [&] (const CollisionCell& cell)
+  {
+    return (cell.Occupancy() > 0.5)
+           || (unknown_is_filled && (cell.Occupancy() == 0.5));
+  };
+  const bool default_is_filled = is_filled(GetDefaultValue());
+  const float truncation = static_cast<float>(truncation_distance);
+  const float unallocated_distance
+      = (default_is_filled) ? -truncation : truncation;
+  const auto& internal_chunks = GetImmutableInternalChunks();
+  DynamicSpatialHashedSignedDistanceField sparse_sdf(
+      GetOriginTransform(), GetChunkGridSizes(), truncation_distance,
+      unallocated_distance, internal_chunks.size(), frame_);
+  const common_robotics_utilities::voxel_grid::GridSizes& chunk_grid_sizes
+      = GetChunkGridSizes();
+  const GridIndex chunk_num_cells(
+      chunk_grid_sizes.NumXCells(), chunk_grid_sizes.NumYCells(),
+      chunk_grid_sizes.NumZCells());
+  const int64_t min_chunk_num_cells = std::min(
+      {chunk_num_cells.X(), chunk_num_cells.Y(), chunk_num_cells.Z()});
+  const int64_t halo_chunks
+      = (halo_cells + min_chunk_num_cells - 1) / min_chunk_num_cells;
+  // Only chunks within the halo of a cell whose filled status differs from
+  // the default value can have distances other than the unallocated
+  // distance, so every other chunk (allocated or not) is skipped.
+  std::unordered_set<GridIndex> chunk_index_set;
+  for (auto internal_chunks_itr = internal_chunks.begin();
+       internal_chunks_itr != internal_chunks.end();
+       ++internal_chunks_itr)
+  {
+    const auto& current_chunk = internal_chunks_itr->second;
+    bool differs_from_default = false;
+    if (current_chunk.FillStatus() == DSHVGFillStatus::CHUNK_FILLED)
+    {
+      differs_from_default = (is_filled(current_chunk.GetImmutableInternal(
+          GridIndex(0, 0, 0)).Value()) != default_is_filled);
+    }
+    else
+    {
+      for (int64_t x_index = 0;
+           !differs_from_default && x_index < chunk_num_cells.X(); x_index++)
+      {
+        for (int64_t y_index = 0;
+             !differs_from_default && y_index < chunk_num_cells.Y();
+             y_index++)
+        {
+          // Cells are stored z-minor, so each row is contiguous.
+          const CollisionCell* row = &(current_chunk.GetImmutableInternal(
+              GridIndex(x_index, y_index, 0)).Value());
+          for (int64_t z_index = 0; z_index < chunk_num_cells.Z(); z_index++)
+          {
+            if (is_filled(row[z_index]) != default_is_filled)
+            {
+              differs_from_default = true;
+              break;
+            }
+          }
+        }
+      }
+    }
+    if (!differs_from_default)
+    {
+      continue;
+    }
+    const Eigen::Vector4d chunk_center
+        = current_chunk.GetChunkCenterInGridFrame();
+    const GridIndex chunk_index = CellIndexToChunkIndex(GridIndex(
+        static_cast<int64_t>(std::floor(chunk_center(0) / resolution)),
+        static_cast<int64_t>(std::floor(chunk_center(1) / resolution)),
+        static_cast<int64_t>(std::floor(chunk_center(2) / resolution))));
+    for (int64_t dx = -halo_chunks; dx <= halo_chunks; dx++)
+    {
+      for (int64_t dy = -halo_chunks; dy <= halo_chunks; dy++)
+      {
+        for (int64_t dz = -halo_chunks; dz <= halo_chunks; dz++)
+        {
+          chunk_index_set.insert(GridIndex(
+              chunk_index.X() + dx, chunk_index.Y() + dy,
+              chunk_index.Z() + dz));
+        }
+      }
+    }
+  }
+  // Neighboring chunks share most of their halos, so rather than computing
+  // each chunk from its own padded region, chunks are grouped into blocks of
+  // block_chunks^3 chunks, and each block is computed once from the padded
+  // bounding region of its chunks.
+  const int64_t block_chunks = 2 * halo_chunks;
+  const auto floor_divide = [] (const int64_t value, const int64_t divisor)
+  {
+    const int64_t quotient = value / divisor;
+    return ((value % divisor) < 0) ? (quotient - 1) : quotient;
+  };
+  std::unordered_map<GridIndex, std::vector<GridIndex>> block_chunk_indices;
+  for (const GridIndex& chunk_index : chunk_index_set)
+  {
+    const GridIndex block_index(
+        floor_divide(chunk_index.X(), block_chunks),
+        floor_divide(chunk_index.Y(), block_chunks),
+        floor_divide(chunk_index.Z(), block_chunks));
+    block_chunk_indices[block_index].push_back(chunk_index);
+  }
+  std::vector<std::vector<GridIndex>> blocks;
+  blocks.reserve(block_chunk_indices.size());
+  for (auto& block : block_chunk_indices)
+  {
+    blocks.push_back(std::move(block.second));
+  }
+  const auto chunk_region = [&] (const GridIndex& chunk_index)
+  {
+    const GridIndex chunk_lower(
+        chunk_index.X() * chunk_num_cells.X(),
+        chunk_index.Y() * chunk_num_cells.Y(),
+        chunk_index.Z() * chunk_num_cells.Z());
+    return GridIndexRegion(chunk_lower, GridIndex(
+        chunk_lower.X() + chunk_num_cells.X(),
+        chunk_lower.Y() + chunk_num_cells.Y(),
+        chunk_lower.Z() + chunk_num_cells.Z()));
+  };
+  std::vector<std::vector<std::vector<float>>> block_chunk_distances(
+      blocks.size());
+  const int64_t num_blocks = static_cast<int64_t>(blocks.size());
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t block_index = 0; block_index < num_blocks; block_index++)
+  {
+    const std::vector<GridIndex>& block
+        = blocks.at(static_cast<size_t>(block_index));
+    GridIndex block_lower = chunk_region(block.front()).Lower();
+    GridIndex block_upper = chunk_region(block.front()).Upper();
+    for (const GridIndex& chunk_index : block)
+    {
+      const GridIndexRegion region = chunk_region(chunk_index);
+      block_lower = GridIndex(
+          std::min(block_lower.X(), region.Lower().X()),
+          std::min(block_lower.Y(), region.Lower().Y()),
+          std::min(block_lower.Z(), region.Lower().Z()));
+      block_upper = GridIndex(
+          std::max(block_upper.X(), region.Upper().X()),
+          std::max(block_upper.Y(), region.Upper().Y()),
+          std::max(block_upper.Z(), region.Upper().Z()));
+    }
+    const GridIndexRegion padded_region
+        = GridIndexRegion(block_lower, block_upper).Expanded(halo_cells);
+    const CollisionMap padded_map = ExportRegion(padded_region);
+    const auto padded_sdf_result = padded_map.ExtractSignedDistanceField(
+        std::numeric_limits<float>::infinity(), unknown_is_filled, false,
+        false);
+    const auto& padded_sdf = padded_sdf_result.DistanceField();
+    std::vector<std::vector<float>>& chunk_distances
+        = block_chunk_distances.at(static_cast<size_t>(block_index));
+    chunk_distances.resize(block.size());
+    for (size_t idx = 0; idx < block.size(); idx++)
+    {
+      const GridIndex chunk_lower = chunk_region(block.at(idx)).Lower();
+      std::vector<float>& distances = chunk_distances.at(idx);
+      distances.reserve(static_cast<size_t>(
+          chunk_num_cells.X() * chunk_num_cells.Y() * chunk_num_cells.Z()));
+      for (int64_t x_index = 0; x_index < chunk_num_cells.X(); x_index++)
+      {
+        for (int64_t y_index = 0; y_index < chunk_num_cells.Y(); y_index++)
+        {
+          for (int64_t z_index = 0; z_index < chunk_num_cells.Z(); z_index++)
+          {
+            const float distance = padded_sdf.GetImmutable(
+                chunk_lower.X() + x_index - padded_region.Lower().X(),
+                chunk_lower.Y() + y_index - padded_region.Lower().Y(),
+                chunk_lower.Z() + z_index - padded_region.Lower().Z())
+                    .Value();
+            distances.push_back(
+                std::max(-truncation, std::min(truncation, distance)));
+          }
+        }
+      }
+    }
+  }
+  for (size_t block_index = 0; block_index < blocks.size(); block_index++)
+  {
+    const std::vector<GridIndex>& block = blocks.at(block_index);
+    for (size_t idx = 0; idx < block.size(); idx++)
+    {
+      sparse_sdf.SetChunkDistances(
+          chunk_region(block.at(idx)).Lower(),
+          block_chunk_distances.at(block_index).at(idx));
+    }
+  }
+  return sparse_sdf;
+}
+
+common_robotics_utilities::voxel_grid::GridIndex
+DynamicSpatialHashedCollisionMap::GridFrameLocationToChunkIndex(
+    const Eigen::Vector4d& location_in_grid_frame) const
+{
+  const double resolution = GetResolution();
+  return CellIndexToChunkIndex(common_robotics_utilities::voxel_grid::GridIndex(
+      static_cast<int64_t>(std::floor(location_in_grid_frame(0) / resolution)),
+      static_cast<int64_t>(std::floor(location_in_grid_frame(1) / resolution)),
+      static_cast<int64_t>(
+          std::floor(location_in_grid_frame(2) / resolution))));
+}
+
+size_t DynamicSpatialHashedCollisionMap::CollapseUniformChunksImpl(
+    const bool only_dirty_chunks)
+{
+  using common_robotics_utilities::voxel_grid::DSHVGFillStatus;
+  using common_robotics_utilities::voxel_grid::DSHVGSetType;
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  const common_robotics_utilities::voxel_grid::GridSizes& chunk_grid_sizes
+      = GetChunkGridSizes();
+  const ScopedAutoCollapseSuspension suspension(auto_collapse_suspended_);
+  size_t num_collapsed_chunks = 0;
+  // Collapsing existing chunks does not insert into the chunk table, so it
+  // can be modified while iterating.
+  auto& internal_chunks = GetMutableInternalChunks();
+  for (auto internal_chunks_itr = internal_chunks.begin();
+       internal_chunks_itr != internal_chunks.end();
+       ++internal_chunks_itr)
+  {
+    auto& current_chunk = internal_chunks_itr->second;
+    if (current_chunk.FillStatus() != DSHVGFillStatus::CELL_FILLED)
+    {
+      continue;
+    }
+    const Eigen::Vector4d chunk_center
+        = current_chunk.GetChunkCenterInGridFrame();
+    if (only_dirty_chunks
+        && dirty_chunks_.count(GridFrameLocationToChunkIndex(chunk_center))
+            == 0)
+    {
+      continue;
+    }
+    const CollisionCell first_value
+        = current_chunk.GetImmutableInternal(GridIndex(0, 0, 0)).Value();
+    bool uniform = true;
+    for (int64_t x_index = 0;
+         uniform && x_index < chunk_grid_sizes.NumXCells(); x_index++)
+    {
+      for (int64_t y_index = 0;
+           uniform && y_index < chunk_grid_sizes.NumYCells(); y_index++)
+      {
+        // Cells are stored z-minor, so each row is contiguous.
+        const CollisionCell* row = &(current_chunk.GetImmutableInternal(
+            GridIndex(x_index, y_index, 0)).Value());
+        for (int64_t z_index = 0; z_index < chunk_grid_sizes.NumZCells();
+             z_index++)
+        {
+          if (row[z_index].Occupancy() != first_value.Occupancy()
+              || row[z_index].Component() != first_value.Component())
+          {
+            uniform = false;
+            break;
+          }
+        }
+      }
+    }
+    if (uniform)
+    {
+      DSHCollisionMapBase::SetValue4d(
+          GetOriginTransform() * chunk_center, DSHVGSetType::SET_CHUNK,
+          first_value);
+      // Setting the chunk value shrinks the chunk storage without releasing
+      // its capacity, so replace it with a copy, which only holds the single
+      // chunk value, and return the full-size storage to the pool.
+      using ChunkType
+          = std::remove_reference<decltype(current_chunk)>::type;
+      current_chunk = ChunkType(current_chunk);
+      num_collapsed_chunks++;
+    }
+  }
+  dirty_chunks_.clear();
+  ChunkMemoryPool::Instance().ReleaseUnusedSlabs();
+  return num_collapsed_chunks;
+}
+
+size_t DynamicSpatialHashedCollisionMap::ConcurrentLockShard(
+    const CollisionCell& cell)
+{
+  // Cells of CELL_FILLED chunks do not move while the chunk table lock is
+  // held shared, so the address identifies the cell.
+  const uint64_t address = static_cast<uint64_t>(
+      reinterpret_cast<uintptr_t>(&cell) / sizeof(CollisionCell));
+  const uint64_t hash = address * UINT64_C(0x9E3779B97F4A7C15);
+  return static_cast<size_t>(
+      (hash >> 32) % ConcurrentChunkLocks::kNumShards);
+}
+
+common_robotics_utilities::voxel_grid::DSHVGSetStatus
+DynamicSpatialHashedCollisionMap::ConcurrentSetValue4d(
+    const Eigen::Vector4d& location,
+    const common_robotics_utilities::voxel_grid::DSHVGSetType set_type,
+    const CollisionCell& value)
+{
+  using common_robotics_utilities::voxel_grid::DSHVGFoundStatus;
+  using common_robotics_utilities::voxel_grid::DSHVGSetType;
+  if (set_type == DSHVGSetType::SET_CELL)
+  {
+    // Fast path, the containing chunk already holds individual cells, so the
+    // write touches only this cell and neither the chunk table nor the chunk
+    // will change while we hold the shared lock.
+    const SharedChunkTableLock<ConcurrentChunkLocks> table_lock(
+        concurrent_locks_);
+    const auto query = GetImmutable4d(location);
+    if (query.FoundStatus() == DSHVGFoundStatus::FOUND_IN_CELL)
+    {
+      std::lock_guard<std::mutex> shard_lock(
+          concurrent_locks_.ShardMutex(ConcurrentLockShard(query.Value())));
+      return DSHCollisionMapBase::SetValue4d(location, set_type, value);
+    }
+  }
+  // Slow path, the chunk must be allocated or expanded, or is set as a whole,
+  // which may rehash the chunk table or reallocate chunk storage.
+  const ExclusiveChunkTableLock<ConcurrentChunkLocks> table_lock(
+      concurrent_locks_);
+  return DSHCollisionMapBase::SetValue4d(location, set_type, value);
+}
+
+common_robotics_utilities::OwningMaybe<CollisionCell>
+DynamicSpatialHashedCollisionMap::ConcurrentGetValue4d(
+    const Eigen::Vector4d& location)
+{
+  using common_robotics_utilities::voxel_grid::DSHVGFoundStatus;
+  const SharedChunkTableLock<ConcurrentChunkLocks> table_lock(
+      concurrent_locks_);
+  const auto query = GetImmutable4d(location);
+  if (query.FoundStatus() == DSHVGFoundStatus::FOUND_IN_CELL)
+  {
+    std::lock_guard<std::mutex> shard_lock(
+        concurrent_locks_.ShardMutex(ConcurrentLockShard(query.Value())));
+    return common_robotics_utilities::OwningMaybe<CollisionCell>(
+        query.Value());
+  }
+  else if (query)
+  {
+    // Whole-chunk values only change under the exclusive lock.
+    return common_robotics_utilities::OwningMaybe<CollisionCell>(
+        query.Value());
+  }
+  else
+  {
+    return common_robotics_utilities::OwningMaybe<CollisionCell>();
+  }
+}
+
 uint64_t DynamicSpatialHashedCollisionMap::Serialize(
     const DynamicSpatialHashedCollisionMap& map, std::vector<uint8_t>& buffer)
 {
@@ -81,6 +822,7 @@ DynamicSpatialHashedCollisionMap::Deserialize(
           buffer, starting_offset,
           common_robotics_utilities::serialization
               ::DeserializeMemcpyable<CollisionCell>);
+  temp_map.CollapseUniformChunks();
   return common_robotics_utilities::serialization::MakeDeserialized(
       temp_map, bytes_read);
 }
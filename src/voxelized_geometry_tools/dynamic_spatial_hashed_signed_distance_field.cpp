@@ -0,0 +1,264 @@
+#include <voxelized_geometry_tools/dynamic_spatial_hashed_signed_distance_field.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/dynamic_spatial_hashed_voxel_grid.hpp>
+#include <common_robotics_utilities/serialization.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <common_robotics_utilities/zlib_helpers.hpp>
+
+namespace voxelized_geometry_tools
+{
+/// We need to implement cloning.
+std::unique_ptr<common_robotics_utilities::voxel_grid
+    ::DynamicSpatialHashedVoxelGridBase<float, std::vector<float>>>
+DynamicSpatialHashedSignedDistanceField::DoClone() const
+{
+  return std::unique_ptr<DynamicSpatialHashedSignedDistanceField>(
+      new DynamicSpatialHashedSignedDistanceField(*this));
+}
+
+/// We need to serialize the frame and truncation distance.
+uint64_t DynamicSpatialHashedSignedDistanceField::DerivedSerializeSelf(
+    std::vector<uint8_t>& buffer,
+    const common_robotics_utilities::serialization::Serializer<float>&
+        value_serializer) const
+{
+  UNUSED(value_serializer);
+  const uint64_t start_size = buffer.size();
+  common_robotics_utilities::serialization::SerializeString(frame_, buffer);
+  common_robotics_utilities::serialization::SerializeMemcpyable<double>(
+      truncation_distance_, buffer);
+  const uint64_t bytes_written = buffer.size() - start_size;
+  return bytes_written;
+}
+
+/// We need to deserialize the frame and truncation distance.
+uint64_t DynamicSpatialHashedSignedDistanceField::DerivedDeserializeSelf(
+    const std::vector<uint8_t>& buffer, const uint64_t starting_offset,
+    const common_robotics_utilities::serialization::Deserializer<float>&
+        value_deserializer)
+{
+  UNUSED(value_deserializer);
+  uint64_t current_position = starting_offset;
+  const auto frame_deserialized
+      = common_robotics_utilities::serialization::DeserializeString<char>(
+          buffer, current_position);
+  frame_ = frame_deserialized.Value();
+  current_position += frame_deserialized.BytesRead();
+  const auto truncation_distance_deserialized
+      = common_robotics_utilities::serialization
+          ::DeserializeMemcpyable<double>(buffer, current_position);
+  truncation_distance_ = truncation_distance_deserialized.Value();
+  current_position += truncation_distance_deserialized.BytesRead();
+  // Figure out how many bytes were read
+  const uint64_t bytes_read = current_position - starting_offset;
+  return bytes_read;
+}
+
+bool DynamicSpatialHashedSignedDistanceField::OnMutableAccess(
+    const Eigen::Vector4d& location)
+{
+  UNUSED(location);
+  return true;
+}
+
+uint64_t DynamicSpatialHashedSignedDistanceField::Serialize(
+    const DynamicSpatialHashedSignedDistanceField& sdf,
+    std::vector<uint8_t>& buffer)
+{
+  return sdf.SerializeSelf(buffer, common_robotics_utilities::serialization
+                                       ::SerializeMemcpyable<float>);
+}
+
+DynamicSpatialHashedSignedDistanceField
+    ::DeserializedDynamicSpatialHashedSignedDistanceField
+DynamicSpatialHashedSignedDistanceField::Deserialize(
+    const std::vector<uint8_t>& buffer, const uint64_t starting_offset)
+{
+  DynamicSpatialHashedSignedDistanceField temp_sdf;
+  const uint64_t bytes_read
+      = temp_sdf.DeserializeSelf(
+          buffer, starting_offset,
+          common_robotics_utilities::serialization
+              ::DeserializeMemcpyable<float>);
+  return common_robotics_utilities::serialization::MakeDeserialized(
+      temp_sdf, bytes_read);
+}
+
+void DynamicSpatialHashedSignedDistanceField::SaveToFile(
+    const DynamicSpatialHashedSignedDistanceField& sdf,
+    const std::string& filepath,
+    const bool compress)
+{
+  std::vector<uint8_t> buffer;
+  DynamicSpatialHashedSignedDistanceField::Serialize(sdf, buffer);
+  std::ofstream output_file(filepath, std::ios::out|std::ios::binary);
+  if (compress)
+  {
+    output_file.write("DSDZ", 4);
+    const std::vector<uint8_t> compressed
+        = common_robotics_utilities::zlib_helpers::CompressBytes(buffer);
+    const size_t serialized_size = compressed.size();
+    output_file.write(
+        reinterpret_cast<const char*>(compressed.data()),
+        static_cast<std::streamsize>(serialized_size));
+  }
+  else
+  {
+    output_file.write("DSDR", 4);
+    const size_t serialized_size = buffer.size();
+    output_file.write(
+        reinterpret_cast<const char*>(buffer.data()),
+        static_cast<std::streamsize>(serialized_size));
+  }
+  output_file.close();
+}
+
+DynamicSpatialHashedSignedDistanceField
+DynamicSpatialHashedSignedDistanceField::LoadFromFile(
+    const std::string& filepath)
+{
+  std::ifstream input_file(
+      filepath, std::ios::in | std::ios::binary | std::ios::ate);
+  if (input_file.good() == false)
+  {
+    throw std::invalid_argument("File does not exist");
+  }
+  const std::streampos end = input_file.tellg();
+  input_file.seekg(0, std::ios::beg);
+  const std::streampos begin = input_file.tellg();
+  const std::streamsize serialized_size = end - begin;
+  const std::streamsize header_size = 4;
+  if (serialized_size >= header_size)
+  {
+    // Load the header
+    std::vector<uint8_t> file_header(header_size + 1, 0x00);
+    input_file.read(reinterpret_cast<char*>(file_header.data()),
+                    header_size);
+    const std::string header_string(
+          reinterpret_cast<const char*>(file_header.data()));
+    // Load the rest of the file
+    std::vector<uint8_t> file_buffer(
+          static_cast<size_t>(serialized_size - header_size), 0x00);
+    input_file.read(reinterpret_cast<char*>(file_buffer.data()),
+                    serialized_size - header_size);
+    // Deserialize
+    if (header_string == "DSDZ")
+    {
+      const std::vector<uint8_t> decompressed
+          = common_robotics_utilities::zlib_helpers
+              ::DecompressBytes(file_buffer);
+      return DynamicSpatialHashedSignedDistanceField::Deserialize(
+          decompressed, 0).Value();
+    }
+    else if (header_string == "DSDR")
+    {
+      return DynamicSpatialHashedSignedDistanceField::Deserialize(
+          file_buffer, 0).Value();
+    }
+    else
+    {
+      throw std::invalid_argument(
+            "File has invalid header [" + header_string + "]");
+    }
+  }
+  else
+  {
+    throw std::invalid_argument("File is too small");
+  }
+}
+
+DynamicSpatialHashedSignedDistanceField
+    ::DynamicSpatialHashedSignedDistanceField(
+    const Eigen::Isometry3d& origin_transform,
+    const common_robotics_utilities::voxel_grid::GridSizes& chunk_sizes,
+    const double truncation_distance, const float unallocated_distance,
+    const size_t expected_chunks, const std::string& frame)
+    : DynamicSpatialHashedVoxelGridBase<float, std::vector<float>>(
+        origin_transform, chunk_sizes, unallocated_distance, expected_chunks),
+      frame_(frame), truncation_distance_(truncation_distance)
+{
+  if (!HasUniformCellSize())
+  {
+    throw std::invalid_argument(
+        "DSH SDF cannot have non-uniform cell sizes");
+  }
+  if (truncation_distance_ <= 0.0)
+  {
+    throw std::invalid_argument("truncation_distance <= 0.0");
+  }
+}
+
+void DynamicSpatialHashedSignedDistanceField::SetChunkDistances(
+    const common_robotics_utilities::voxel_grid::GridIndex& chunk_lower_index,
+    const std::vector<float>& distances)
+{
+  using common_robotics_utilities::voxel_grid::DSHVGSetType;
+  const common_robotics_utilities::voxel_grid::GridSizes& chunk_grid_sizes
+      = GetChunkGridSizes();
+  const int64_t num_x_cells = chunk_grid_sizes.NumXCells();
+  const int64_t num_y_cells = chunk_grid_sizes.NumYCells();
+  const int64_t num_z_cells = chunk_grid_sizes.NumZCells();
+  if (static_cast<int64_t>(distances.size())
+      != (num_x_cells * num_y_cells * num_z_cells))
+  {
+    throw std::invalid_argument("distances.size() != chunk cells");
+  }
+  const double resolution = GetResolution();
+  const auto cell_location = [&] (const int64_t x_offset,
+                                  const int64_t y_offset,
+                                  const int64_t z_offset)
+  {
+    const Eigen::Vector4d location_in_grid_frame(
+        (static_cast<double>(chunk_lower_index.X() + x_offset) + 0.5)
+            * resolution,
+        (static_cast<double>(chunk_lower_index.Y() + y_offset) + 0.5)
+            * resolution,
+        (static_cast<double>(chunk_lower_index.Z() + z_offset) + 0.5)
+            * resolution, 1.0);
+    return Eigen::Vector4d(GetOriginTransform() * location_in_grid_frame);
+  };
+  const float first_distance = distances.front();
+  bool uniform = true;
+  for (const float distance : distances)
+  {
+    if (distance != first_distance)
+    {
+      uniform = false;
+      break;
+    }
+  }
+  if (uniform)
+  {
+    // Don't allocate chunks that match the unallocated distance.
+    if (first_distance != GetDefaultValue()
+        || GetImmutable4d(cell_location(0, 0, 0)))
+    {
+      SetValue4d(cell_location(0, 0, 0), DSHVGSetType::SET_CHUNK,
+                 first_distance);
+    }
+    return;
+  }
+  SetValue4d(cell_location(0, 0, 0), DSHVGSetType::SET_CELL, first_distance);
+  for (int64_t x_offset = 0; x_offset < num_x_cells; x_offset++)
+  {
+    for (int64_t y_offset = 0; y_offset < num_y_cells; y_offset++)
+    {
+      auto row_query = GetMutable4d(cell_location(x_offset, y_offset, 0));
+      const size_t row_start = static_cast<size_t>(
+          (x_offset * num_y_cells * num_z_cells) + (y_offset * num_z_cells));
+      std::memcpy(&(row_query.Value()), distances.data() + row_start,
+                  sizeof(float) * static_cast<size_t>(num_z_cells));
+    }
+  }
+}
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,265 @@
+#include <voxelized_geometry_tools/frontier_extraction.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <common_robotics_utilities/utility.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+#include <voxelized_geometry_tools/instrumentation.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace frontier_extraction
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+
+GridIndexRegion WholeGrid(const CollisionMap& map)
+{
+  return GridIndexRegion(
+      GridIndex(0, 0, 0),
+      GridIndex(map.GetNumXCells(), map.GetNumYCells(), map.GetNumZCells()));
+}
+
+/// Appends the frontier cells of region (which must be within the grid) to
+/// frontier_cells, in data index order.
+void ExtractFrontierCellsInRegion(
+    const CollisionMap& map, const GridIndexRegion& region,
+    const bool use_parallel, std::vector<int64_t>& frontier_cells)
+{
+  if (region.IsEmpty())
+  {
+    return;
+  }
+  const int64_t num_y_cells = map.GetNumYCells();
+  const int64_t num_z_cells = map.GetNumZCells();
+  // The masks cover region padded by one cell on every side. Padding cells
+  // outside the grid are left neither free nor unknown.
+  const GridIndexRegion padded_region = region.Expanded(1);
+  const GridIndexRegion sampled_region
+      = padded_region.Intersected(WholeGrid(map));
+  const GridIndex& mask_lower = padded_region.Lower();
+  const int64_t mask_y_stride = padded_region.NumZCells();
+  const int64_t mask_x_stride = padded_region.NumYCells() * mask_y_stride;
+  const auto mask_index = [&] (const int64_t x_index, const int64_t y_index,
+                               const int64_t z_index)
+  {
+    return ((x_index - mask_lower.X()) * mask_x_stride)
+           + ((y_index - mask_lower.Y()) * mask_y_stride)
+           + (z_index - mask_lower.Z());
+  };
+  std::vector<uint8_t> free_mask(
+      static_cast<size_t>(padded_region.TotalCells()), 0u);
+  std::vector<uint8_t> unknown_mask(free_mask.size(), 0u);
+  const CollisionMapBackingStore& cells = map.GetImmutableRawData();
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t x_index = sampled_region.Lower().X();
+       x_index < sampled_region.Upper().X(); x_index++)
+  {
+    for (int64_t y_index = sampled_region.Lower().Y();
+         y_index < sampled_region.Upper().Y(); y_index++)
+    {
+      const int64_t row_start
+          = (x_index * num_y_cells * num_z_cells) + (y_index * num_z_cells);
+      const int64_t mask_row_start = mask_index(x_index, y_index, 0);
+      for (int64_t z_index = sampled_region.Lower().Z();
+           z_index < sampled_region.Upper().Z(); z_index++)
+      {
+        const float occupancy
+            = cells[static_cast<size_t>(row_start + z_index)].Occupancy();
+        const size_t mask_offset
+            = static_cast<size_t>(mask_row_start + z_index);
+        free_mask[mask_offset] = static_cast<uint8_t>(occupancy < 0.5f);
+        unknown_mask[mask_offset] = static_cast<uint8_t>(occupancy == 0.5f);
+      }
+    }
+  }
+  // Thanks to the padding, the six neighbors of every cell in region are at
+  // fixed offsets in the masks, so each row is a branch-free pass.
+  const int64_t region_num_z_cells = region.NumZCells();
+  std::vector<std::vector<int64_t>> x_slice_frontier_cells(
+      static_cast<size_t>(region.NumXCells()));
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+  for (int64_t x_offset = 0; x_offset < region.NumXCells(); x_offset++)
+  {
+    const int64_t x_index = region.Lower().X() + x_offset;
+    std::vector<int64_t>& slice_frontier_cells
+        = x_slice_frontier_cells[static_cast<size_t>(x_offset)];
+    std::vector<uint8_t> row_is_frontier(
+        static_cast<size_t>(region_num_z_cells));
+    for (int64_t y_index = region.Lower().Y(); y_index < region.Upper().Y();
+         y_index++)
+    {
+      const int64_t row_start
+          = mask_index(x_index, y_index, region.Lower().Z());
+      const uint8_t* const free_row = free_mask.data() + row_start;
+      const uint8_t* const unknown_row = unknown_mask.data() + row_start;
+      for (int64_t z_offset = 0; z_offset < region_num_z_cells; z_offset++)
+      {
+        row_is_frontier[static_cast<size_t>(z_offset)] = static_cast<uint8_t>(
+            free_row[z_offset]
+            & (unknown_row[z_offset - 1] | unknown_row[z_offset + 1]
+               | unknown_row[z_offset - mask_y_stride]
+               | unknown_row[z_offset + mask_y_stride]
+               | unknown_row[z_offset - mask_x_stride]
+               | unknown_row[z_offset + mask_x_stride]));
+      }
+      const int64_t data_row_start = (x_index * num_y_cells * num_z_cells)
+                                     + (y_index * num_z_cells)
+                                     + region.Lower().Z();
+      for (int64_t z_offset = 0; z_offset < region_num_z_cells; z_offset++)
+      {
+        if (row_is_frontier[static_cast<size_t>(z_offset)] != 0u)
+        {
+          slice_frontier_cells.push_back(data_row_start + z_offset);
+        }
+      }
+    }
+  }
+  for (const auto& slice_frontier_cells : x_slice_frontier_cells)
+  {
+    frontier_cells.insert(frontier_cells.end(), slice_frontier_cells.begin(),
+                          slice_frontier_cells.end());
+  }
+}
+
+size_t FindRoot(std::vector<size_t>& parents, size_t element)
+{
+  while (parents[element] != element)
+  {
+    parents[element] = parents[parents[element]];
+    element = parents[element];
+  }
+  return element;
+}
+}  // namespace
+
+std::vector<int64_t> ExtractFrontierCells(
+    const CollisionMap& map, const bool use_parallel)
+{
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(*sink, "ExtractFrontierCells");
+  std::vector<int64_t> frontier_cells;
+  ExtractFrontierCellsInRegion(
+      map, WholeGrid(map), use_parallel, frontier_cells);
+  return frontier_cells;
+}
+
+std::vector<int64_t> ExtractFrontierCells(
+    const CollisionMap& map, const std::vector<GridIndexRegion>& regions,
+    const bool use_parallel)
+{
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(*sink, "ExtractFrontierCells");
+  const GridIndexRegion whole_grid = WholeGrid(map);
+  // Regions such as dirty tiles are small and numerous, so work is split by
+  // region rather than within each one.
+  std::vector<std::vector<int64_t>> region_frontier_cells(regions.size());
+  const int64_t num_regions = static_cast<int64_t>(regions.size());
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t region_index = 0; region_index < num_regions; region_index++)
+  {
+    const size_t region = static_cast<size_t>(region_index);
+    ExtractFrontierCellsInRegion(
+        map, regions[region].Expanded(1).Intersected(whole_grid), false,
+        region_frontier_cells[region]);
+  }
+  std::vector<int64_t> frontier_cells;
+  for (const auto& cells : region_frontier_cells)
+  {
+    frontier_cells.insert(frontier_cells.end(), cells.begin(), cells.end());
+  }
+  // Expanded regions overlap their neighbors.
+  std::sort(frontier_cells.begin(), frontier_cells.end());
+  frontier_cells.erase(
+      std::unique(frontier_cells.begin(), frontier_cells.end()),
+      frontier_cells.end());
+  return frontier_cells;
+}
+
+std::vector<std::vector<int64_t>> ClusterFrontierCells(
+    const CollisionMap& map, const std::vector<int64_t>& frontier_cells)
+{
+  const int64_t num_y_cells = map.GetNumYCells();
+  const int64_t num_z_cells = map.GetNumZCells();
+  const int64_t x_stride = num_y_cells * num_z_cells;
+  std::vector<int64_t> cells = frontier_cells;
+  std::sort(cells.begin(), cells.end());
+  cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+  if (!cells.empty()
+      && (cells.front() < 0 || cells.back() >= map.GetTotalCells()))
+  {
+    throw std::invalid_argument("frontier cell out of bounds");
+  }
+  // Union-find over positions in cells. Each cell is joined to its neighbors
+  // with larger data indices, found by binary search in the sorted cells.
+  std::vector<size_t> parents(cells.size());
+  std::iota(parents.begin(), parents.end(), static_cast<size_t>(0));
+  for (size_t cell = 0; cell < cells.size(); cell++)
+  {
+    const int64_t data_index = cells[cell];
+    const int64_t x_index = data_index / x_stride;
+    const int64_t y_index = (data_index / num_z_cells) % num_y_cells;
+    const int64_t z_index = data_index % num_z_cells;
+    for (int64_t x_offset = 0; x_offset <= 1; x_offset++)
+    {
+      for (int64_t y_offset = -1; y_offset <= 1; y_offset++)
+      {
+        for (int64_t z_offset = -1; z_offset <= 1; z_offset++)
+        {
+          const int64_t offset
+              = (x_offset * x_stride) + (y_offset * num_z_cells) + z_offset;
+          const int64_t neighbor_y_index = y_index + y_offset;
+          const int64_t neighbor_z_index = z_index + z_offset;
+          if (offset <= 0 || x_index + x_offset >= map.GetNumXCells()
+              || neighbor_y_index < 0 || neighbor_y_index >= num_y_cells
+              || neighbor_z_index < 0 || neighbor_z_index >= num_z_cells)
+          {
+            continue;
+          }
+          const auto found = std::lower_bound(
+              cells.begin() + static_cast<std::ptrdiff_t>(cell) + 1,
+              cells.end(), data_index + offset);
+          if (found != cells.end() && *found == data_index + offset)
+          {
+            const size_t neighbor
+                = static_cast<size_t>(found - cells.begin());
+            parents[FindRoot(parents, neighbor)] = FindRoot(parents, cell);
+          }
+        }
+      }
+    }
+  }
+  std::vector<std::vector<int64_t>> components;
+  std::vector<int64_t> root_components(cells.size(), -1);
+  for (size_t cell = 0; cell < cells.size(); cell++)
+  {
+    const size_t root = FindRoot(parents, cell);
+    if (root_components[root] < 0)
+    {
+      root_components[root] = static_cast<int64_t>(components.size());
+      components.emplace_back();
+    }
+    components[static_cast<size_t>(root_components[root])].push_back(
+        cells[cell]);
+  }
+  return components;
+}
+}  // namespace frontier_extraction
+}  // namespace voxelized_geometry_tools
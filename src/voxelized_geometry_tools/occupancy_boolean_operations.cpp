@@ -0,0 +1,175 @@
+#include <voxelized_geometry_tools/occupancy_boolean_operations.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <common_robotics_utilities/utility.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/tagged_object_collision_map.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace occupancy_boolean_operations
+{
+namespace
+{
+/// Occupancy classes, ordered so that three-valued AND is min, OR is max,
+/// and NOT is (FILLED - class).
+const uint8_t kFree = 0u;
+const uint8_t kUnknown = 1u;
+const uint8_t kFilled = 2u;
+
+inline uint8_t ClassifyOccupancy(const float occupancy)
+{
+  return static_cast<uint8_t>(static_cast<uint8_t>(occupancy >= 0.5f)
+                              + static_cast<uint8_t>(occupancy > 0.5f));
+}
+
+inline uint8_t CombineClasses(
+    const BooleanOperation operation, const uint8_t a_class,
+    const uint8_t b_class)
+{
+  const uint8_t not_a_class = static_cast<uint8_t>(kFilled - a_class);
+  const uint8_t not_b_class = static_cast<uint8_t>(kFilled - b_class);
+  switch (operation)
+  {
+    case BooleanOperation::UNION:
+      return std::max(a_class, b_class);
+    case BooleanOperation::INTERSECTION:
+      return std::min(a_class, b_class);
+    case BooleanOperation::DIFFERENCE:
+      return std::min(a_class, not_b_class);
+    case BooleanOperation::SYMMETRIC_DIFFERENCE:
+      return std::max(std::min(a_class, not_b_class),
+                      std::min(not_a_class, b_class));
+  }
+  throw std::invalid_argument("Invalid BooleanOperation");
+}
+
+/// Returns true, and sets result_cell, if the combined class differs from the
+/// class of a_cell.
+template<typename CellType>
+inline bool CombineCells(
+    const BooleanOperation operation, const CellType& a_cell,
+    const CellType& b_cell, CellType& result_cell)
+{
+  const uint8_t a_class = ClassifyOccupancy(a_cell.Occupancy());
+  const uint8_t b_class = ClassifyOccupancy(b_cell.Occupancy());
+  const uint8_t result_class = CombineClasses(operation, a_class, b_class);
+  if (result_class == a_class)
+  {
+    return false;
+  }
+  if (result_class == b_class)
+  {
+    result_cell = b_cell;
+  }
+  else if (result_class == kFilled)
+  {
+    result_cell = CellType(1.0f);
+  }
+  else if (result_class == kUnknown)
+  {
+    result_cell = CellType(0.5f);
+  }
+  else
+  {
+    result_cell = CellType(0.0f);
+  }
+  return true;
+}
+
+template<typename GridType>
+void CheckGridsMatch(const GridType& a, const GridType& b)
+{
+  if (a.GetNumXCells() != b.GetNumXCells()
+      || a.GetNumYCells() != b.GetNumYCells()
+      || a.GetNumZCells() != b.GetNumZCells()
+      || a.GetResolution() != b.GetResolution()
+      || !a.GetOriginTransform().isApprox(b.GetOriginTransform()))
+  {
+    throw std::invalid_argument("Grids must have the same origin and size");
+  }
+}
+}  // namespace
+
+CollisionMap Combine(
+    const CollisionMap& a, const CollisionMap& b,
+    const BooleanOperation operation, const bool use_parallel)
+{
+  CheckGridsMatch(a, b);
+  CollisionMap result = a;
+  CollisionMapBackingStore& result_cells = result.GetMutableRawData();
+  const CollisionMapBackingStore& b_cells = b.GetImmutableRawData();
+  const size_t tile_capacity = CollisionMapBackingStore::TileCapacity();
+  const int64_t num_tiles = static_cast<int64_t>(result_cells.NumTiles());
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t tile_index = 0; tile_index < num_tiles; tile_index++)
+  {
+    const size_t tile = static_cast<size_t>(tile_index);
+    // Both maps have the same number of cells, so their tiles line up. The
+    // tile of a stays alive (owned by a) even if result's copy is detached.
+    const CollisionMapBackingStore::Tile& a_tile
+        = a.GetImmutableRawData().GetImmutableTile(tile);
+    const CollisionMapBackingStore::Tile& b_tile
+        = b_cells.GetImmutableTile(tile);
+    CollisionMapBackingStore::Tile* mutable_tile = nullptr;
+    CollisionCell result_cell;
+    for (size_t tile_offset = 0; tile_offset < a_tile.size(); tile_offset++)
+    {
+      if (CombineCells(operation, a_tile[tile_offset], b_tile[tile_offset],
+                       result_cell))
+      {
+        if (mutable_tile == nullptr)
+        {
+          mutable_tile = &(result_cells.GetMutableTile(tile));
+        }
+        (*mutable_tile)[tile_offset] = result_cell;
+        result.MarkDataIndexDirty(
+            static_cast<int64_t>((tile * tile_capacity) + tile_offset));
+      }
+    }
+  }
+  result.ForceComponentsToBeInvalid();
+  return result;
+}
+
+TaggedObjectCollisionMap Combine(
+    const TaggedObjectCollisionMap& a, const TaggedObjectCollisionMap& b,
+    const BooleanOperation operation, const bool use_parallel)
+{
+  CheckGridsMatch(a, b);
+  TaggedObjectCollisionMap result = a;
+  std::vector<TaggedObjectCollisionCell>& result_cells
+      = result.GetMutableRawData();
+  const std::vector<TaggedObjectCollisionCell>& b_cells
+      = b.GetImmutableRawData();
+  const int64_t num_cells = static_cast<int64_t>(result_cells.size());
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t data_index = 0; data_index < num_cells; data_index++)
+  {
+    TaggedObjectCollisionCell& cell
+        = result_cells[static_cast<size_t>(data_index)];
+    TaggedObjectCollisionCell result_cell;
+    if (CombineCells(operation, cell, b_cells[static_cast<size_t>(data_index)],
+                     result_cell))
+    {
+      cell = result_cell;
+    }
+  }
+  result.ForceComponentsToBeInvalid();
+  result.ForceSpatialSegmentsToBeInvalid();
+  return result;
+}
+}  // namespace occupancy_boolean_operations
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,181 @@
+#include <voxelized_geometry_tools/occupancy_integral_volume.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <common_robotics_utilities/utility.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+
+namespace voxelized_geometry_tools
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+
+OccupancyIntegralVolume::OccupancyIntegralVolume(
+    const CollisionMap& map, const bool use_parallel)
+    : num_x_cells_(map.GetNumXCells()), num_y_cells_(map.GetNumYCells()),
+      num_z_cells_(map.GetNumZCells())
+{
+  if (map.GetTotalCells()
+      > static_cast<int64_t>(std::numeric_limits<uint32_t>::max()))
+  {
+    throw std::invalid_argument("map has too many cells");
+  }
+  table_.resize(static_cast<size_t>(
+      (num_x_cells_ + 1) * (num_y_cells_ + 1) * (num_z_cells_ + 1)));
+  RecomputeFrom(map, GridIndex(0, 0, 0), use_parallel);
+}
+
+void OccupancyIntegralVolume::Update(
+    const CollisionMap& map,
+    const std::vector<GridIndexRegion>& changed_regions,
+    const bool use_parallel)
+{
+  if (map.GetNumXCells() != num_x_cells_ || map.GetNumYCells() != num_y_cells_
+      || map.GetNumZCells() != num_z_cells_)
+  {
+    throw std::invalid_argument("map does not match integral volume");
+  }
+  const GridIndexRegion grid_region(
+      GridIndex(0, 0, 0), GridIndex(num_x_cells_, num_y_cells_, num_z_cells_));
+  bool any_changed = false;
+  GridIndex lower(num_x_cells_, num_y_cells_, num_z_cells_);
+  for (const GridIndexRegion& changed_region : changed_regions)
+  {
+    const GridIndexRegion clipped = changed_region.Intersected(grid_region);
+    if (!clipped.IsEmpty())
+    {
+      any_changed = true;
+      lower = GridIndex(std::min(lower.X(), clipped.Lower().X()),
+                        std::min(lower.Y(), clipped.Lower().Y()),
+                        std::min(lower.Z(), clipped.Lower().Z()));
+    }
+  }
+  if (any_changed)
+  {
+    RecomputeFrom(map, lower, use_parallel);
+  }
+}
+
+/// Recomputes the table entries that depend on cells at or above lower, i.e.
+/// entries (x, y, z) with x > lower.X(), y > lower.Y(), and z > lower.Z(). The
+/// three separable prefix-sum passes run in place, starting each row, slab,
+/// and column from entries on the boundary of that region, which are still
+/// valid.
+void OccupancyIntegralVolume::RecomputeFrom(
+    const CollisionMap& map, const GridIndex& lower, const bool use_parallel)
+{
+  const CollisionMapBackingStore& cells = map.GetImmutableRawData();
+  const int64_t lx = lower.X();
+  const int64_t ly = lower.Y();
+  const int64_t lz = lower.Z();
+  // Pass 1: prefix sums of each row of cells along z.
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t x_index = lx + 1; x_index <= num_x_cells_; x_index++)
+  {
+    for (int64_t y_index = ly + 1; y_index <= num_y_cells_; y_index++)
+    {
+      const IntegralCell& pp = TableEntry(x_index, y_index, lz);
+      const IntegralCell& mp = TableEntry(x_index - 1, y_index, lz);
+      const IntegralCell& pm = TableEntry(x_index, y_index - 1, lz);
+      const IntegralCell& mm = TableEntry(x_index - 1, y_index - 1, lz);
+      IntegralCell running;
+      running.filled = pp.filled - mp.filled - pm.filled + mm.filled;
+      running.unknown = pp.unknown - mp.unknown - pm.unknown + mm.unknown;
+      const int64_t row_start
+          = ((x_index - 1) * num_y_cells_ + (y_index - 1)) * num_z_cells_;
+      for (int64_t z_index = lz + 1; z_index <= num_z_cells_; z_index++)
+      {
+        const float occupancy = cells[static_cast<size_t>(
+            row_start + z_index - 1)].Occupancy();
+        if (occupancy > 0.5f)
+        {
+          running.filled++;
+        }
+        else if (occupancy == 0.5f)
+        {
+          running.unknown++;
+        }
+        MutableTableEntry(x_index, y_index, z_index) = running;
+      }
+    }
+  }
+  // Pass 2: accumulate rows along y into per-slab prefix sums.
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+  for (int64_t x_index = lx + 1; x_index <= num_x_cells_; x_index++)
+  {
+    for (int64_t z_index = lz + 1; z_index <= num_z_cells_; z_index++)
+    {
+      const IntegralCell& p = TableEntry(x_index, ly, z_index);
+      const IntegralCell& m = TableEntry(x_index - 1, ly, z_index);
+      IntegralCell running;
+      running.filled = p.filled - m.filled;
+      running.unknown = p.unknown - m.unknown;
+      for (int64_t y_index = ly + 1; y_index <= num_y_cells_; y_index++)
+      {
+        IntegralCell& entry = MutableTableEntry(x_index, y_index, z_index);
+        running.filled += entry.filled;
+        running.unknown += entry.unknown;
+        entry = running;
+      }
+    }
+  }
+  // Pass 3: accumulate slabs along x.
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#endif
+  for (int64_t y_index = ly + 1; y_index <= num_y_cells_; y_index++)
+  {
+    for (int64_t z_index = lz + 1; z_index <= num_z_cells_; z_index++)
+    {
+      IntegralCell running = TableEntry(lx, y_index, z_index);
+      for (int64_t x_index = lx + 1; x_index <= num_x_cells_; x_index++)
+      {
+        IntegralCell& entry = MutableTableEntry(x_index, y_index, z_index);
+        running.filled += entry.filled;
+        running.unknown += entry.unknown;
+        entry = running;
+      }
+    }
+  }
+}
+
+OccupancyCounts OccupancyIntegralVolume::CountCells(
+    const GridIndexRegion& region) const
+{
+  const GridIndexRegion clipped = region.Intersected(GridIndexRegion(
+      GridIndex(0, 0, 0), GridIndex(num_x_cells_, num_y_cells_, num_z_cells_)));
+  if (clipped.IsEmpty())
+  {
+    return OccupancyCounts();
+  }
+  const GridIndex& l = clipped.Lower();
+  const GridIndex& u = clipped.Upper();
+  // Inclusion-exclusion over the eight corners of the box.
+  const IntegralCell* corners[8] = {
+      &TableEntry(u.X(), u.Y(), u.Z()), &TableEntry(l.X(), u.Y(), u.Z()),
+      &TableEntry(u.X(), l.Y(), u.Z()), &TableEntry(u.X(), u.Y(), l.Z()),
+      &TableEntry(l.X(), l.Y(), u.Z()), &TableEntry(l.X(), u.Y(), l.Z()),
+      &TableEntry(u.X(), l.Y(), l.Z()), &TableEntry(l.X(), l.Y(), l.Z())};
+  const int64_t signs[8] = {1, -1, -1, -1, 1, 1, 1, -1};
+  int64_t filled = 0;
+  int64_t unknown = 0;
+  for (size_t corner = 0; corner < 8; corner++)
+  {
+    filled += signs[corner] * static_cast<int64_t>(corners[corner]->filled);
+    unknown += signs[corner] * static_cast<int64_t>(corners[corner]->unknown);
+  }
+  return OccupancyCounts(
+      filled, unknown, clipped.TotalCells() - filled - unknown);
+}
+}  // namespace voxelized_geometry_tools
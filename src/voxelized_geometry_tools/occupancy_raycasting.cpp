@@ -0,0 +1,143 @@
+#include <voxelized_geometry_tools/occupancy_raycasting.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/utility.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/instrumentation.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace occupancy_raycasting
+{
+namespace
+{
+/// Angle of the sample_index-th of num_samples rays spread evenly over fov,
+/// centered on the optical axis.
+double SampleAngle(
+    const double fov, const int64_t sample_index, const int64_t num_samples)
+{
+  if (num_samples == 1)
+  {
+    return 0.0;
+  }
+  return (fov * (static_cast<double>(sample_index)
+                 / static_cast<double>(num_samples - 1)))
+         - (0.5 * fov);
+}
+}  // namespace
+
+Eigen::Matrix3Xd MakePinholeRayDirections(
+    const double horizontal_fov, const double vertical_fov,
+    const int64_t num_horizontal_rays, const int64_t num_vertical_rays)
+{
+  if (!(horizontal_fov > 0.0 && horizontal_fov < M_PI))
+  {
+    throw std::invalid_argument("horizontal_fov must be in (0, pi)");
+  }
+  if (!(vertical_fov > 0.0 && vertical_fov < M_PI))
+  {
+    throw std::invalid_argument("vertical_fov must be in (0, pi)");
+  }
+  if (num_horizontal_rays < 1)
+  {
+    throw std::invalid_argument("num_horizontal_rays < 1");
+  }
+  if (num_vertical_rays < 1)
+  {
+    throw std::invalid_argument("num_vertical_rays < 1");
+  }
+  Eigen::Matrix3Xd ray_directions(3, num_horizontal_rays * num_vertical_rays);
+  for (int64_t v_index = 0; v_index < num_vertical_rays; v_index++)
+  {
+    const double y = std::tan(
+        SampleAngle(vertical_fov, v_index, num_vertical_rays));
+    for (int64_t h_index = 0; h_index < num_horizontal_rays; h_index++)
+    {
+      const double x = std::tan(
+          SampleAngle(horizontal_fov, h_index, num_horizontal_rays));
+      ray_directions.col((v_index * num_horizontal_rays) + h_index)
+          = Eigen::Vector3d(x, y, 1.0).normalized();
+    }
+  }
+  return ray_directions;
+}
+
+std::vector<ViewInformationGain> EvaluateViews(
+    const CollisionMap& map, const VectorIsometry3d& view_poses,
+    const Eigen::Matrix3Xd& ray_directions, const double max_range,
+    const bool use_parallel)
+{
+  if (!(max_range >= 0.0))
+  {
+    throw std::invalid_argument("max_range < 0");
+  }
+  const auto sink = instrumentation::GetInstrumentationSink();
+  const instrumentation::ScopedPhaseTimer timer(*sink, "EvaluateViews");
+  const int64_t num_x_cells = map.GetNumXCells();
+  const int64_t num_y_cells = map.GetNumYCells();
+  const int64_t num_z_cells = map.GetNumZCells();
+  const double resolution = map.GetResolution();
+  // Get X_GW, the transform from grid origin to world
+  const Eigen::Isometry3d& X_GW = map.GetInverseOriginTransform();
+  const CollisionMapBackingStore& cells = map.GetImmutableRawData();
+  std::vector<ViewInformationGain> information_gains(view_poses.size());
+  const int64_t num_views = static_cast<int64_t>(view_poses.size());
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int64_t view_index = 0; view_index < num_views; view_index++)
+  {
+    const size_t view = static_cast<size_t>(view_index);
+    // Transform X_GS, from grid origin to the sensor
+    const Eigen::Isometry3d X_GS = X_GW * view_poses[view];
+    const Eigen::Vector3d p_GSo = X_GS.translation();
+    int64_t num_unknown_cell_visits = 0;
+    int64_t num_rays_hit_filled = 0;
+    std::vector<int64_t> unknown_cells;
+    const auto visit_cell = [&] (const int64_t x_index, const int64_t y_index,
+                                 const int64_t z_index)
+    {
+      const int64_t data_index
+          = (((x_index * num_y_cells) + y_index) * num_z_cells) + z_index;
+      const float occupancy
+          = cells[static_cast<size_t>(data_index)].Occupancy();
+      if (occupancy > 0.5f)
+      {
+        // The sensor cannot see past filled cells.
+        num_rays_hit_filled++;
+        return false;
+      }
+      if (occupancy == 0.5f)
+      {
+        num_unknown_cell_visits++;
+        unknown_cells.push_back(data_index);
+      }
+      return true;
+    };
+    for (int64_t ray = 0; ray < ray_directions.cols(); ray++)
+    {
+      const Eigen::Vector3d direction_G
+          = (X_GS.linear() * ray_directions.col(ray)).normalized();
+      TraverseRay(num_x_cells, num_y_cells, num_z_cells, resolution, p_GSo,
+                  direction_G, max_range, visit_cell);
+    }
+    std::sort(unknown_cells.begin(), unknown_cells.end());
+    const int64_t num_unique_unknown_cells = static_cast<int64_t>(
+        std::unique(unknown_cells.begin(), unknown_cells.end())
+        - unknown_cells.begin());
+    information_gains[view] = ViewInformationGain(
+        num_unknown_cell_visits, num_unique_unknown_cells,
+        num_rays_hit_filled);
+  }
+  return information_gains;
+}
+}  // namespace occupancy_raycasting
+}  // namespace voxelized_geometry_tools
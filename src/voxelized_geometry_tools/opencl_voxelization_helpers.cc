@@ -1,10 +1,12 @@
 #include <voxelized_geometry_tools/opencl_voxelization_helpers.h>
 
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -18,15 +20,41 @@ namespace pointcloud_voxelization
 namespace opencl_helpers
 {
 const char* kRaycastPointKernelCode = R"(
+#ifdef cl_khr_int64_base_atomics
+#pragma OPENCL EXTENSION cl_khr_int64_base_atomics : enable
+#endif
+
+// Adds value to the 64-bit counter stored in counter[0] (low) and counter[1]
+// (high). Without 64-bit atomics, the carry out of the low word is added to
+// the high word separately, so the total is exact once the kernel completes.
+void AddToCounter(global int* counter, const int value)
+{
+#ifdef cl_khr_int64_base_atomics
+  atom_add((global long*)counter, (long)value);
+#else
+  const uint previous_low = (uint)atomic_add(counter, value);
+  if (previous_low + (uint)value < previous_low)
+  {
+    atomic_add(counter + 1, 1);
+  }
+#endif
+}
+
 void kernel RaycastPoint(
     global const float* points, const float max_range,
     global const float* grid_pointcloud_transform,
     const float inverse_step_size, const float inverse_cell_size,
     const int stride1, const int stride2, const int num_x_cells,
     const int num_y_cells, const int num_z_cells, global int* tracking_grid,
-    const int tracking_grid_starting_offset)
+    const int tracking_grid_starting_offset, const int counters_offset,
+    const int collect_counters, const int num_points)
 {
   const int point_index = get_global_id(0);
+  // The global size is rounded up to a multiple of the work-group size.
+  if (point_index >= num_points)
+  {
+    return;
+  }
   // Point in pointcloud frame
   const float px = points[(point_index * 3) + 0];
   const float py = points[(point_index * 3) + 1];
@@ -34,6 +62,8 @@ void kernel RaycastPoint(
   // Skip invalid points marked with NaN or infinity
   if (isfinite(px) && isfinite(py) && isfinite(pz))
   {
+    int voxel_visits = 0;
+    int contended_updates = 0;
     // Pointcloud origin in grid frame
     const float ox = grid_pointcloud_transform[12];
     const float oy = grid_pointcloud_transform[13];
@@ -85,7 +115,10 @@ void kernel RaycastPoint(
               (x_cell * stride1) + (y_cell * stride2) + z_cell;
           const int tracking_grid_index =
               tracking_grid_starting_offset + (cell_index * 2);
-          atomic_add(&(tracking_grid[tracking_grid_index]), 1);
+          const int previous_count =
+              atomic_add(&(tracking_grid[tracking_grid_index]), 1);
+          voxel_visits++;
+          contended_updates += (previous_count > 0) ? 1 : 0;
         }
         else if (ray_crossed_grid)
         {
@@ -108,9 +141,22 @@ void kernel RaycastPoint(
         const int cell_index = (x_cell * stride1) + (y_cell * stride2) + z_cell;
         const int tracking_grid_index =
             tracking_grid_starting_offset + (cell_index * 2);
-        atomic_add(&(tracking_grid[tracking_grid_index + 1]), 1);
+        const int previous_count =
+            atomic_add(&(tracking_grid[tracking_grid_index + 1]), 1);
+        voxel_visits++;
+        contended_updates += (previous_count > 0) ? 1 : 0;
       }
     }
+    if (collect_counters != 0)
+    {
+      AddToCounter(tracking_grid + counters_offset + 0, 1);
+      AddToCounter(tracking_grid + counters_offset + 4, voxel_visits);
+      AddToCounter(tracking_grid + counters_offset + 6, contended_updates);
+    }
+  }
+  else if (collect_counters != 0)
+  {
+    AddToCounter(tracking_grid + counters_offset + 2, 1);
   }
 }
 )";
@@ -122,6 +168,10 @@ void kernel FilterGrids(
     const int outlier_points_threshold, const int num_cameras_seen_free)
 {
   const int voxel_index = get_global_id(0);
+  if (voxel_index >= num_cells)
+  {
+    return;
+  }
   const int filter_grid_index = voxel_index * 2;
   const float current_occupancy = filter_grid[filter_grid_index];
   if (current_occupancy <= 0.5)
@@ -246,6 +296,15 @@ public:
 
     const int32_t platform_index =
         RetrieveOptionOrDefault(options, "OPENCL_PLATFORM_INDEX", 0);
+    collect_counters_ =
+        (RetrieveOptionOrDefault(options, "COLLECT_COUNTERS", 0) != 0);
+    // 0 leaves the work-group size to the OpenCL implementation.
+    work_group_size_ =
+        RetrieveOptionOrDefault(options, "OPENCL_WORK_GROUP_SIZE", 0);
+    if (work_group_size_ < 0)
+    {
+      throw std::invalid_argument("OPENCL_WORK_GROUP_SIZE < 0");
+    }
     if (all_platforms.size() > 0 && platform_index >= 0
         && platform_index < static_cast<int32_t>(all_platforms.size()))
     {
@@ -345,7 +404,10 @@ public:
   std::unique_ptr<TrackingGridsHandle> PrepareTrackingGrids(
       const int64_t num_cells, const int32_t num_grids) override
   {
-    const size_t buffer_size = sizeof(int32_t) * 2 * num_cells * num_grids;
+    // Raycast counters for each grid follow the tracking grids.
+    const size_t buffer_size =
+        (sizeof(int32_t) * 2 * num_cells * num_grids)
+        + (sizeof(DeviceRaycastCounters) * num_grids);
     cl_int err = 0;
     std::unique_ptr<cl::Buffer> tracking_grids_buffer(new cl::Buffer(
         *context_, CL_MEM_READ_WRITE, buffer_size, nullptr, &err));
@@ -386,7 +448,7 @@ public:
     }
   }
 
-  void RaycastPoints(
+  double RaycastPoints(
       const std::vector<float>& raw_points, const float max_range,
       const float* const grid_pointcloud_transform,
       const float inverse_step_size, const float inverse_cell_size,
@@ -397,6 +459,8 @@ public:
     OpenCLTrackingGridsHandle& real_tracking_grids =
         dynamic_cast<OpenCLTrackingGridsHandle&>(tracking_grids);
 
+    const std::chrono::time_point<std::chrono::steady_clock> start_time =
+        std::chrono::steady_clock::now();
     cl_int err = 0;
 
     cl::Buffer device_points_buffer(
@@ -419,6 +483,8 @@ public:
       throw std::runtime_error(
           "Failed to allocate and copy grid pointcloud transform");
     }
+    const std::chrono::time_point<std::chrono::steady_clock> uploaded_time =
+        std::chrono::steady_clock::now();
 
     const int32_t stride1 = num_y_cells * num_z_cells;
     const int32_t stride2 = num_z_cells;
@@ -438,31 +504,56 @@ public:
     raycasting_kernel.setArg(9, num_z_cells);
     raycasting_kernel.setArg(10, real_tracking_grids.GetBuffer());
     raycasting_kernel.setArg(11, starting_index);
+    raycasting_kernel.setArg(12, static_cast<int32_t>(
+        CountersOffset(real_tracking_grids, tracking_grid_index)));
+    raycasting_kernel.setArg(13, collect_counters_ ? 1 : 0);
+    const size_t num_points = raw_points.size() / 3;
+    raycasting_kernel.setArg(14, static_cast<int32_t>(num_points));
     err = queue_->enqueueNDRangeKernel(
-        raycasting_kernel, cl::NullRange, cl::NDRange(raw_points.size() / 3),
-        cl::NullRange);
+        raycasting_kernel, cl::NullRange, GlobalRange(num_points),
+        LocalRange());
     if (err != CL_SUCCESS)
     {
       throw std::runtime_error("Failed to enqueue raycasting kernel");
     }
+    return std::chrono::duration<double>(uploaded_time - start_time).count();
   }
 
   std::unique_ptr<FilterGridHandle> PrepareFilterGrid(
-      const int64_t num_cells, const void* host_data_ptr) override
+      const int64_t num_cells) override
   {
     cl_int err = 0;
     std::unique_ptr<cl::Buffer> filter_grid_buffer(new cl::Buffer(
-        *context_, CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR,
-        sizeof(float) * num_cells * 2, const_cast<void*>(host_data_ptr), &err));
+        *context_, CL_MEM_READ_WRITE, sizeof(float) * num_cells * 2, nullptr,
+        &err));
     if (err != CL_SUCCESS)
     {
-      throw std::runtime_error("Failed to allocate and copy filtered buffer");
+      throw std::runtime_error("Failed to allocate filtered buffer");
     }
 
     return std::unique_ptr<FilterGridHandle>(new OpenCLFilterGridHandle(
         std::move(filter_grid_buffer), num_cells));
   }
 
+  void UploadFilterGridCells(
+      FilterGridHandle& filter_grid, const int64_t first_cell,
+      const int64_t num_cells, const void* host_data_ptr) override
+  {
+    OpenCLFilterGridHandle& real_filter_grid =
+        dynamic_cast<OpenCLFilterGridHandle&>(filter_grid);
+    EnforceCellsInRange(real_filter_grid, first_cell, num_cells);
+
+    const size_t item_size = sizeof(float) * 2;
+    const cl_int err = queue_->enqueueWriteBuffer(
+        real_filter_grid.GetBuffer(), CL_TRUE,
+        static_cast<size_t>(first_cell) * item_size,
+        static_cast<size_t>(num_cells) * item_size, host_data_ptr);
+    if (err != CL_SUCCESS)
+    {
+      throw std::runtime_error("Filtered buffer enqueueWriteBuffer failed");
+    }
+  }
+
   void FilterTrackingGrids(
       const TrackingGridsHandle& tracking_grids, const float percent_seen_free,
       const int32_t outlier_points_threshold,
@@ -487,7 +578,8 @@ public:
     filter_kernel.setArg(6, num_cameras_seen_free);
     const cl_int err = queue_->enqueueNDRangeKernel(
         filter_kernel, cl::NullRange,
-        cl::NDRange(real_tracking_grids.NumCellsPerGrid()), cl::NullRange);
+        GlobalRange(static_cast<size_t>(real_tracking_grids.NumCellsPerGrid())),
+        LocalRange());
     if (err != CL_SUCCESS)
     {
       throw std::runtime_error(
@@ -518,28 +610,114 @@ public:
     }
   }
 
-  void RetrieveFilteredGrid(
-      const FilterGridHandle& filter_grid, void* host_data_ptr) override
+  void RetrieveFilteredGridCells(
+      const FilterGridHandle& filter_grid, const int64_t first_cell,
+      const int64_t num_cells, void* host_data_ptr) override
   {
     const OpenCLFilterGridHandle& real_filter_grid =
         dynamic_cast<const OpenCLFilterGridHandle&>(filter_grid);
+    EnforceCellsInRange(real_filter_grid, first_cell, num_cells);
 
     queue_->finish();
     const size_t item_size = sizeof(float) * 2;
-    const size_t buffer_size = real_filter_grid.NumCells() * item_size;
     const cl_int err = queue_->enqueueReadBuffer(
-        real_filter_grid.GetBuffer(), CL_TRUE, 0, buffer_size, host_data_ptr);
+        real_filter_grid.GetBuffer(), CL_TRUE,
+        static_cast<size_t>(first_cell) * item_size,
+        static_cast<size_t>(num_cells) * item_size, host_data_ptr);
     if (err != CL_SUCCESS)
     {
       throw std::runtime_error("Filtered buffer enqueueReadBuffer failed");
     }
   }
 
+  DeviceRaycastCounters RetrieveRaycastCounters(
+      const TrackingGridsHandle& tracking_grids,
+      const size_t tracking_grid_index) override
+  {
+    const OpenCLTrackingGridsHandle& real_tracking_grids =
+        dynamic_cast<const OpenCLTrackingGridsHandle&>(tracking_grids);
+
+    queue_->finish();
+    DeviceRaycastCounters counters;
+    const size_t starting_offset =
+        CountersOffset(real_tracking_grids, tracking_grid_index)
+        * sizeof(int32_t);
+    const cl_int err = queue_->enqueueReadBuffer(
+        real_tracking_grids.GetBuffer(), CL_TRUE, starting_offset,
+        sizeof(counters), &counters);
+    if (err != CL_SUCCESS)
+    {
+      throw std::runtime_error("Counters enqueueReadBuffer failed");
+    }
+    return counters;
+  }
+
+  void Synchronize() override
+  {
+    const cl_int err = queue_->finish();
+    if (err != CL_SUCCESS)
+    {
+      throw std::runtime_error("Failed to finish command queue");
+    }
+  }
+
 private:
+  static void EnforceCellsInRange(
+      const FilterGridHandle& filter_grid, const int64_t first_cell,
+      const int64_t num_cells)
+  {
+    if (first_cell < 0 || num_cells < 0
+        || (first_cell + num_cells) > filter_grid.NumCells())
+    {
+      throw std::out_of_range("Filter grid cells out of range");
+    }
+  }
+
+  static size_t CountersOffset(
+      const TrackingGridsHandle& tracking_grids,
+      const size_t tracking_grid_index)
+  {
+    return static_cast<size_t>(
+        (2 * tracking_grids.NumCellsPerGrid()
+         * static_cast<int64_t>(tracking_grids.GetNumTrackingGrids()))
+        + (8 * static_cast<int64_t>(tracking_grid_index)));
+  }
+
+  // Global range covering num_items, rounded up to a whole number of
+  // work-groups if a work-group size is set.
+  cl::NDRange GlobalRange(const size_t num_items) const
+  {
+    if (work_group_size_ > 0)
+    {
+      const size_t work_group_size = static_cast<size_t>(work_group_size_);
+      return cl::NDRange(
+          ((num_items + work_group_size - 1) / work_group_size)
+          * work_group_size);
+    }
+    else
+    {
+      return cl::NDRange(num_items);
+    }
+  }
+
+  cl::NDRange LocalRange() const
+  {
+    if (work_group_size_ > 0)
+    {
+      return cl::NDRange(static_cast<size_t>(work_group_size_));
+    }
+    else
+    {
+      return cl::NullRange;
+    }
+  }
+
   std::unique_ptr<cl::Context> context_;
   std::unique_ptr<cl::CommandQueue> queue_;
   std::unique_ptr<cl::Program> raycasting_program_;
   std::unique_ptr<cl::Program> filter_program_;
+  bool collect_counters_ = false;
+  int32_t work_group_size_ = 0;
 };
 
 std::vector<AvailableDevice> GetAvailableDevices()
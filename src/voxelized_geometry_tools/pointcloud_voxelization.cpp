@@ -50,7 +50,7 @@ MakePointCloudVoxelizer(
   else if (backend_option == BackendOptions::CPU)
   {
     return std::unique_ptr<PointCloudVoxelizationInterface>(
-        new CpuPointCloudVoxelizer());
+        new CpuPointCloudVoxelizer(device_options));
   }
   else if (backend_option == BackendOptions::OPENCL)
   {
@@ -108,7 +108,7 @@ MakeBestAvailablePointCloudVoxelizer(
   {
     std::cout << "Trying CPU PointCloud Voxelizer..." << std::endl;
     return std::unique_ptr<PointCloudVoxelizationInterface>(
-        new CpuPointCloudVoxelizer());
+        new CpuPointCloudVoxelizer(device_options));
   }
   catch (std::runtime_error&)
   {
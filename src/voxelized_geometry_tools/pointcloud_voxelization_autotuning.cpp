@@ -0,0 +1,406 @@
+#include <voxelized_geometry_tools/pointcloud_voxelization_autotuning.hpp>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/maybe.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/instrumentation.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization_interface.hpp>
+#include <voxelized_geometry_tools/scene_generation.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace pointcloud_voxelization
+{
+namespace
+{
+int32_t MaxCpuThreads()
+{
+#if defined(_OPENMP)
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+std::vector<int32_t> GetCpuThreadCounts(
+    const VoxelizerCalibrationOptions& options)
+{
+  if (options.CpuThreadCounts().size() > 0)
+  {
+    return options.CpuThreadCounts();
+  }
+  const int32_t max_threads = MaxCpuThreads();
+  std::vector<int32_t> thread_counts;
+  for (int32_t num_threads = 1; num_threads < max_threads; num_threads *= 2)
+  {
+    thread_counts.push_back(num_threads);
+  }
+  thread_counts.push_back(max_threads);
+  return thread_counts;
+}
+
+AvailableBackend WithOption(
+    const AvailableBackend& backend, const std::string& option,
+    const int32_t value)
+{
+  std::map<std::string, int32_t> device_options = backend.DeviceOptions();
+  device_options[option] = value;
+  return AvailableBackend(
+      backend.DeviceName(), device_options, backend.BackendOption());
+}
+
+// Rounds value up to a power of two, so that similar workloads share a key.
+int64_t RoundUpToPowerOfTwo(const int64_t value)
+{
+  int64_t rounded = 1;
+  while (rounded < value)
+  {
+    rounded *= 2;
+  }
+  return rounded;
+}
+
+// FNV-1a, which unlike std::hash is stable across builds.
+uint64_t HashString(const std::string& str)
+{
+  uint64_t hash = UINT64_C(14695981039346656037);
+  for (const char character : str)
+  {
+    hash ^= static_cast<uint64_t>(static_cast<unsigned char>(character));
+    hash *= UINT64_C(1099511628211);
+  }
+  return hash;
+}
+
+// Cache entries are one line each, of the form
+//   <key> <backend option> <num options> [<option> <value>]... <device name>
+// where the device name, which may contain spaces, is the rest of the line.
+std::string SerializeCacheEntry(
+    const std::string& key, const AvailableBackend& backend)
+{
+  std::ostringstream entry;
+  entry << key << " " << static_cast<int32_t>(backend.BackendOption()) << " "
+        << backend.DeviceOptions().size();
+  for (const auto& device_option : backend.DeviceOptions())
+  {
+    entry << " " << device_option.first << " " << device_option.second;
+  }
+  entry << " " << backend.DeviceName();
+  return entry.str();
+}
+
+common_robotics_utilities::OwningMaybe<AvailableBackend> DeserializeCacheEntry(
+    const std::string& entry, const std::string& key)
+{
+  std::istringstream entry_stream(entry);
+  std::string entry_key;
+  int32_t backend_option = 0;
+  size_t num_options = 0;
+  if (!(entry_stream >> entry_key >> backend_option >> num_options)
+      || entry_key != key)
+  {
+    return common_robotics_utilities::OwningMaybe<AvailableBackend>();
+  }
+  if (backend_option < static_cast<int32_t>(BackendOptions::CPU)
+      || backend_option > static_cast<int32_t>(BackendOptions::CUDA))
+  {
+    return common_robotics_utilities::OwningMaybe<AvailableBackend>();
+  }
+  std::map<std::string, int32_t> device_options;
+  for (size_t idx = 0; idx < num_options; idx++)
+  {
+    std::string option;
+    int32_t value = 0;
+    if (!(entry_stream >> option >> value))
+    {
+      return common_robotics_utilities::OwningMaybe<AvailableBackend>();
+    }
+    device_options[option] = value;
+  }
+  std::string device_name;
+  std::getline(entry_stream >> std::ws, device_name);
+  return common_robotics_utilities::OwningMaybe<AvailableBackend>(
+      AvailableBackend(device_name, device_options,
+                       static_cast<BackendOptions>(backend_option)));
+}
+
+std::vector<std::string> ReadCacheEntries(const std::string& cache_file)
+{
+  std::vector<std::string> entries;
+  std::ifstream input_file(cache_file);
+  std::string line;
+  while (std::getline(input_file, line))
+  {
+    if (line.size() > 0 && line.front() != '#')
+    {
+      entries.push_back(line);
+    }
+  }
+  return entries;
+}
+
+std::string EntryKey(const std::string& entry)
+{
+  return entry.substr(0, entry.find(' '));
+}
+
+double Median(std::vector<double> values)
+{
+  std::sort(values.begin(), values.end());
+  const size_t middle = values.size() / 2;
+  if ((values.size() % 2) == 0)
+  {
+    return (values.at(middle - 1) + values.at(middle)) * 0.5;
+  }
+  else
+  {
+    return values.at(middle);
+  }
+}
+}  // namespace
+
+std::vector<AvailableBackend> GetCalibrationCandidates(
+    const VoxelizerCalibrationOptions& options)
+{
+  std::vector<AvailableBackend> candidates;
+  for (const AvailableBackend& backend : GetAvailableBackends())
+  {
+    if (backend.BackendOption() == BackendOptions::CPU)
+    {
+      for (const int32_t num_threads : GetCpuThreadCounts(options))
+      {
+        candidates.push_back(
+            WithOption(backend, "CPU_NUM_THREADS", num_threads));
+      }
+    }
+    else
+    {
+      const std::string work_group_size_option =
+          (backend.BackendOption() == BackendOptions::CUDA)
+              ? "CUDA_BLOCK_SIZE" : "OPENCL_WORK_GROUP_SIZE";
+      candidates.push_back(backend);
+      for (const int32_t work_group_size : options.DeviceWorkGroupSizes())
+      {
+        candidates.push_back(
+            WithOption(backend, work_group_size_option, work_group_size));
+      }
+    }
+  }
+  return candidates;
+}
+
+std::vector<VoxelizerCalibrationTrial> RunVoxelizerCalibrationTrials(
+    const CollisionMap& static_environment, const double step_size_multiplier,
+    const PointCloudVoxelizationFilterOptions& filter_options,
+    const std::vector<PointCloudWrapperPtr>& pointclouds,
+    const VoxelizerCalibrationOptions& options)
+{
+  const auto sink = instrumentation::GetInstrumentationSink();
+  instrumentation::ScopedPhaseTimer timer(
+      *sink, "RunVoxelizerCalibrationTrials");
+  std::vector<VoxelizerCalibrationTrial> trials;
+  CollisionMap output_environment = static_environment;
+  for (const AvailableBackend& candidate : GetCalibrationCandidates(options))
+  {
+    // Backends may be listed but unusable (e.g. a work-group size larger than
+    // the device supports), which only shows up when they are used.
+    try
+    {
+      const auto voxelizer = MakePointCloudVoxelizer(candidate);
+      for (int32_t trial = 0; trial < options.NumWarmupTrials(); trial++)
+      {
+        voxelizer->VoxelizePointClouds(
+            static_environment, step_size_multiplier, filter_options,
+            pointclouds, output_environment);
+      }
+      std::vector<double> trial_times;
+      for (int32_t trial = 0; trial < options.NumTimedTrials(); trial++)
+      {
+        const std::chrono::time_point<std::chrono::steady_clock> start_time =
+            std::chrono::steady_clock::now();
+        voxelizer->VoxelizePointClouds(
+            static_environment, step_size_multiplier, filter_options,
+            pointclouds, output_environment);
+        trial_times.push_back(std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start_time).count());
+      }
+      trials.push_back(
+          VoxelizerCalibrationTrial(candidate, Median(trial_times)));
+    }
+    catch (const std::exception&)
+    {
+      if (sink->IsEnabled())
+      {
+        sink->AddToCounter("voxelizer_calibration.failed_candidates", 1);
+      }
+    }
+  }
+  std::stable_sort(
+      trials.begin(), trials.end(),
+      [] (const VoxelizerCalibrationTrial& a,
+          const VoxelizerCalibrationTrial& b)
+  {
+    return a.MedianTime() < b.MedianTime();
+  });
+  if (sink->IsEnabled())
+  {
+    sink->AddToCounter(
+        "voxelizer_calibration.trials", static_cast<int64_t>(trials.size()));
+  }
+  return trials;
+}
+
+std::string MakeVoxelizerCalibrationKey(
+    const CollisionMap& static_environment,
+    const std::vector<PointCloudWrapperPtr>& pointclouds)
+{
+  const auto& grid_sizes = static_environment.GetGridSizes();
+  const int64_t num_cells = grid_sizes.NumXCells() * grid_sizes.NumYCells()
+                            * grid_sizes.NumZCells();
+  int64_t num_points = 0;
+  for (const PointCloudWrapperPtr& cloud_ptr : pointclouds)
+  {
+    num_points += (cloud_ptr) ? cloud_ptr->Size() : 0;
+  }
+  std::string device_names;
+  for (const AvailableBackend& backend : GetAvailableBackends())
+  {
+    device_names += backend.DeviceName() + "\n";
+  }
+  std::ostringstream key;
+  key << "cells" << RoundUpToPowerOfTwo(num_cells) << "_clouds"
+      << RoundUpToPowerOfTwo(static_cast<int64_t>(pointclouds.size()))
+      << "_points" << RoundUpToPowerOfTwo(num_points) << "_devices"
+      << std::hex << std::setw(16) << std::setfill('0')
+      << HashString(device_names);
+  return key.str();
+}
+
+common_robotics_utilities::OwningMaybe<AvailableBackend>
+LoadCalibratedBackend(const std::string& cache_file, const std::string& key)
+{
+  for (const std::string& entry : ReadCacheEntries(cache_file))
+  {
+    const auto backend = DeserializeCacheEntry(entry, key);
+    if (backend)
+    {
+      return backend;
+    }
+  }
+  return common_robotics_utilities::OwningMaybe<AvailableBackend>();
+}
+
+void SaveCalibratedBackend(
+    const std::string& cache_file, const std::string& key,
+    const AvailableBackend& backend)
+{
+  if (key.empty() || key.find_first_of(" \n") != std::string::npos)
+  {
+    throw std::invalid_argument("key must be non-empty and without spaces");
+  }
+  std::vector<std::string> entries = ReadCacheEntries(cache_file);
+  entries.erase(
+      std::remove_if(entries.begin(), entries.end(),
+                     [&] (const std::string& entry)
+  {
+    return EntryKey(entry) == key;
+  }), entries.end());
+  entries.push_back(SerializeCacheEntry(key, backend));
+  std::ofstream output_file(cache_file, std::ios::out | std::ios::trunc);
+  if (!output_file.good())
+  {
+    throw std::runtime_error("Failed to open calibration cache for writing");
+  }
+  output_file << "# voxelized_geometry_tools voxelizer calibration cache\n";
+  for (const std::string& entry : entries)
+  {
+    output_file << entry << "\n";
+  }
+  output_file.close();
+}
+
+std::unique_ptr<PointCloudVoxelizationInterface>
+MakeCalibratedPointCloudVoxelizer(
+    const std::string& cache_file, const CollisionMap& static_environment,
+    const double step_size_multiplier,
+    const PointCloudVoxelizationFilterOptions& filter_options,
+    const std::vector<PointCloudWrapperPtr>& pointclouds,
+    const VoxelizerCalibrationOptions& options)
+{
+  const std::string key =
+      MakeVoxelizerCalibrationKey(static_environment, pointclouds);
+  const auto cached_backend = LoadCalibratedBackend(cache_file, key);
+  if (cached_backend)
+  {
+    try
+    {
+      return MakePointCloudVoxelizer(cached_backend.Value());
+    }
+    catch (const std::exception&)
+    {
+      // The cached device is gone or its options are no longer valid, so
+      // recalibrate below.
+    }
+  }
+  const auto trials = RunVoxelizerCalibrationTrials(
+      static_environment, step_size_multiplier, filter_options, pointclouds,
+      options);
+  if (trials.empty())
+  {
+    throw std::runtime_error("No PointCloud Voxelizers available");
+  }
+  const AvailableBackend& fastest_backend = trials.front().Backend();
+  SaveCalibratedBackend(cache_file, key, fastest_backend);
+  return MakePointCloudVoxelizer(fastest_backend);
+}
+
+std::unique_ptr<PointCloudVoxelizationInterface>
+MakeCalibratedPointCloudVoxelizer(
+    const std::string& cache_file, const VoxelizerCalibrationOptions& options)
+{
+  const double size = 4.0;
+  const double resolution = 0.04;
+  const uint64_t seed = 42;
+  const scene_generation::Scene scene =
+      scene_generation::MakeRandomClutterScene(
+          Eigen::Vector3d::Constant(size), 20, 20, size * 0.05, size * 0.25,
+          seed);
+  const CollisionMap static_environment(
+      Eigen::Isometry3d::Identity(), "world",
+      common_robotics_utilities::voxel_grid::GridSizes(
+          resolution, size, size, size),
+      CollisionCell(0.5f));
+  // Camera looks along +x (the optical z axis) from just outside the grid.
+  const Eigen::Isometry3d X_WC
+      = Eigen::Translation3d(-0.5, size * 0.5, size * 0.5)
+        * Eigen::Quaterniond(
+            Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitZ())
+            * Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitX()));
+  const PointCloudWrapperPtr cloud = scene_generation::SimulateDepthCamera(
+      scene, X_WC, 320, 240, M_PI_2, size * 2.0, 0.005, seed, true);
+  return MakeCalibratedPointCloudVoxelizer(
+      cache_file, static_environment, 0.5,
+      PointCloudVoxelizationFilterOptions(), {cloud}, options);
+}
+}  // namespace pointcloud_voxelization
+}  // namespace voxelized_geometry_tools
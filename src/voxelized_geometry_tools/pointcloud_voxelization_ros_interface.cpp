@@ -1,5 +1,6 @@
 #include <voxelized_geometry_tools/pointcloud_voxelization_ros_interface.hpp>
 
+#include <cstdint>
 #include <cstring>
 #include <map>
 #include <stdexcept>
@@ -26,11 +27,103 @@ using PointField = sensor_msgs::msg::PointField;
 using PointField = sensor_msgs::PointField;
 #endif
 
+namespace
+{
+bool HostIsBigEndian()
+{
+  const uint16_t value = 0x0102;
+  uint8_t first_byte = 0;
+  std::memcpy(&first_byte, &value, sizeof(first_byte));
+  return first_byte == 0x01;
+}
+}  // namespace
+
+/// Read the xyz fields of a point stored as FieldType, converting to
+/// OutputType and applying scale.
+template<typename FieldType, typename OutputType>
+inline void ReadPointXYZ(
+    const uint8_t* point_start, const size_t x_offset, const size_t y_offset,
+    const size_t z_offset, const double scale, OutputType* destination)
+{
+  FieldType x = 0;
+  FieldType y = 0;
+  FieldType z = 0;
+  std::memcpy(&x, point_start + x_offset, sizeof(FieldType));
+  std::memcpy(&y, point_start + y_offset, sizeof(FieldType));
+  std::memcpy(&z, point_start + z_offset, sizeof(FieldType));
+  destination[0] = static_cast<OutputType>(static_cast<double>(x) * scale);
+  destination[1] = static_cast<OutputType>(static_cast<double>(y) * scale);
+  destination[2] = static_cast<OutputType>(static_cast<double>(z) * scale);
+}
+
+template<typename OutputType>
+inline void ReadPointXYZOfType(
+    const uint8_t datatype, const uint8_t* point_start, const size_t x_offset,
+    const size_t y_offset, const size_t z_offset, const double scale,
+    OutputType* destination)
+{
+  switch (datatype)
+  {
+    case PointField::FLOAT32:
+      ReadPointXYZ<float, OutputType>(
+          point_start, x_offset, y_offset, z_offset, 1.0, destination);
+      break;
+    case PointField::FLOAT64:
+      ReadPointXYZ<double, OutputType>(
+          point_start, x_offset, y_offset, z_offset, 1.0, destination);
+      break;
+    case PointField::INT8:
+      ReadPointXYZ<int8_t, OutputType>(
+          point_start, x_offset, y_offset, z_offset, scale, destination);
+      break;
+    case PointField::UINT8:
+      ReadPointXYZ<uint8_t, OutputType>(
+          point_start, x_offset, y_offset, z_offset, scale, destination);
+      break;
+    case PointField::INT16:
+      ReadPointXYZ<int16_t, OutputType>(
+          point_start, x_offset, y_offset, z_offset, scale, destination);
+      break;
+    case PointField::UINT16:
+      ReadPointXYZ<uint16_t, OutputType>(
+          point_start, x_offset, y_offset, z_offset, scale, destination);
+      break;
+    case PointField::INT32:
+      ReadPointXYZ<int32_t, OutputType>(
+          point_start, x_offset, y_offset, z_offset, scale, destination);
+      break;
+    case PointField::UINT32:
+      ReadPointXYZ<uint32_t, OutputType>(
+          point_start, x_offset, y_offset, z_offset, scale, destination);
+      break;
+    default:
+      throw std::invalid_argument("Unsupported PointCloud xyz field type");
+  }
+}
+
+/// Read num_points points, with the field type resolved once for the whole
+/// range rather than per point.
+template<typename FieldType, typename PointOffsetFunction>
+inline void ReadPointsXYZ(
+    const PointOffsetFunction& point_offset_fn,
+    const uint8_t* data, const int64_t first_point_index,
+    const int64_t num_points, const size_t x_offset, const size_t y_offset,
+    const size_t z_offset, const double scale, float* destination)
+{
+  for (int64_t idx = 0; idx < num_points; idx++)
+  {
+    ReadPointXYZ<FieldType, float>(
+        data + point_offset_fn(first_point_index + idx), x_offset, y_offset,
+        z_offset, scale, destination + (idx * 3));
+  }
+}
+
 PointCloud2Wrapper::PointCloud2Wrapper(
     const PointCloud2* const cloud_ptr,
-    const Eigen::Isometry3d& origin_transform, const double max_range)
-    : cloud_ptr_(cloud_ptr), origin_transform_(origin_transform),
-      max_range_(max_range)
+    const Eigen::Isometry3d& origin_transform, const double max_range,
+    const double integer_field_scale)
+    : cloud_ptr_(cloud_ptr), integer_field_scale_(integer_field_scale),
+      origin_transform_(origin_transform), max_range_(max_range)
 {
   if (cloud_ptr_ == nullptr)
   {
@@ -40,6 +133,10 @@ PointCloud2Wrapper::PointCloud2Wrapper(
   {
     throw std::runtime_error("max_range_ <= 0.0");
   }
+  if (integer_field_scale_ <= 0.0)
+  {
+    throw std::invalid_argument("integer_field_scale_ <= 0.0");
+  }
   // Figure out what the size and offset for XYZ fields in the pointcloud are.
   std::map<std::string, uint8_t> field_type_map;
   std::map<std::string, size_t> field_offset_map;
@@ -49,31 +146,188 @@ PointCloud2Wrapper::PointCloud2Wrapper(
     field_offset_map[field.name] = static_cast<size_t>(field.offset);
   }
   // Check field types
-  if (field_type_map.at("x") != PointField::FLOAT32)
+  xyz_datatype_ = field_type_map.at("x");
+  if (field_type_map.at("y") != xyz_datatype_
+      || field_type_map.at("z") != xyz_datatype_)
+  {
+    throw std::invalid_argument(
+        "PointCloud x, y, and z fields do not have the same type");
+  }
+  size_t field_size = 0;
+  switch (xyz_datatype_)
+  {
+    case PointField::INT8:
+    case PointField::UINT8:
+      field_size = 1;
+      break;
+    case PointField::INT16:
+    case PointField::UINT16:
+      field_size = 2;
+      break;
+    case PointField::INT32:
+    case PointField::UINT32:
+    case PointField::FLOAT32:
+      field_size = 4;
+      break;
+    case PointField::FLOAT64:
+      field_size = 8;
+      break;
+    default:
+      throw std::invalid_argument("Unsupported PointCloud xyz field type");
+  }
+  if (field_size > 1 && static_cast<bool>(cloud_ptr_->is_bigendian)
+                            != HostIsBigEndian())
   {
-    throw std::invalid_argument("PointCloud x field is not FLOAT32");
+    throw std::invalid_argument(
+        "PointCloud endianness does not match the host");
   }
-  if (field_type_map.at("y") != PointField::FLOAT32)
+  // Check that the fields fit within each point.
+  x_offset_from_point_start_ = field_offset_map.at("x");
+  y_offset_from_point_start_ = field_offset_map.at("y");
+  z_offset_from_point_start_ = field_offset_map.at("z");
+  const size_t point_step = static_cast<size_t>(cloud_ptr_->point_step);
+  if ((x_offset_from_point_start_ + field_size) > point_step
+      || (y_offset_from_point_start_ + field_size) > point_step
+      || (z_offset_from_point_start_ + field_size) > point_step)
   {
-    throw std::invalid_argument("PointCloud y field is not FLOAT32");
+    throw std::invalid_argument("PointCloud xyz fields exceed point_step");
   }
-  if (field_type_map.at("z") != PointField::FLOAT32)
+  const size_t packed_row_step
+      = static_cast<size_t>(cloud_ptr_->width) * point_step;
+  if (cloud_ptr_->height > 1
+      && static_cast<size_t>(cloud_ptr_->row_step) < packed_row_step)
   {
-    throw std::invalid_argument("PointCloud z field is not FLOAT32");
+    throw std::invalid_argument("PointCloud row_step < width * point_step");
   }
-  // Check that x, y, and z are sequential.
-  const size_t x_offset = field_offset_map.at("x");
-  const size_t y_offset = field_offset_map.at("y");
-  const size_t z_offset = field_offset_map.at("z");
-  if ((z_offset - y_offset) == sizeof(float) &&
-      (y_offset - x_offset) == sizeof(float))
+  rows_are_packed_ = (cloud_ptr_->height <= 1)
+                     || (static_cast<size_t>(cloud_ptr_->row_step)
+                         == packed_row_step);
+  // Check that every point is within data, so points can be read without
+  // further bounds checks.
+  const size_t height = static_cast<size_t>(cloud_ptr_->height);
+  if (cloud_ptr_->width > 0 && height > 0)
   {
-    xyz_offset_from_point_start_ = x_offset;
+    const size_t required_data_size
+        = rows_are_packed_
+            ? (height * packed_row_step)
+            : (((height - 1) * static_cast<size_t>(cloud_ptr_->row_step))
+               + packed_row_step);
+    if (cloud_ptr_->data.size() < required_data_size)
+    {
+      throw std::invalid_argument("PointCloud data is smaller than its points");
+    }
+  }
+  // Sequential FLOAT32 xyz can be copied directly.
+  xyz_are_sequential_float32_
+      = (xyz_datatype_ == PointField::FLOAT32)
+        && (y_offset_from_point_start_
+            == (x_offset_from_point_start_ + sizeof(float)))
+        && (z_offset_from_point_start_
+            == (y_offset_from_point_start_ + sizeof(float)));
+}
+
+void PointCloud2Wrapper::CopyPointLocationIntoDoublePtrImpl(
+    const int64_t point_index, double* destination) const
+{
+  // Point index has been checked by the caller, and the data size on
+  // construction, so read directly from the buffer.
+  ReadPointXYZOfType<double>(
+      xyz_datatype_,
+      cloud_ptr_->data.data() + GetStartingOffsetForPoint(point_index),
+      x_offset_from_point_start_, y_offset_from_point_start_,
+      z_offset_from_point_start_, integer_field_scale_, destination);
+}
+
+void PointCloud2Wrapper::CopyPointLocationIntoFloatPtrImpl(
+    const int64_t point_index, float* destination) const
+{
+  // As above, read directly from the buffer.
+  const uint8_t* point_start
+      = cloud_ptr_->data.data() + GetStartingOffsetForPoint(point_index);
+  if (xyz_are_sequential_float32_)
+  {
+    std::memcpy(destination, point_start + x_offset_from_point_start_,
+                sizeof(float) * 3);
   }
   else
   {
-    throw std::invalid_argument(
-        "PointCloud does not have sequential xyz fields");
+    ReadPointXYZOfType<float>(
+        xyz_datatype_, point_start,
+        x_offset_from_point_start_, y_offset_from_point_start_,
+        z_offset_from_point_start_, integer_field_scale_, destination);
+  }
+}
+
+void PointCloud2Wrapper::CopyPointLocationsIntoFloatPtrImpl(
+    const int64_t first_point_index, const int64_t num_points,
+    float* destination) const
+{
+  // Range has been checked by the caller, so read directly from the buffer.
+  const uint8_t* data = cloud_ptr_->data.data();
+  if (xyz_are_sequential_float32_)
+  {
+    for (int64_t idx = 0; idx < num_points; idx++)
+    {
+      std::memcpy(
+          destination + (idx * 3),
+          data + GetStartingOffsetForPoint(first_point_index + idx)
+              + x_offset_from_point_start_,
+          sizeof(float) * 3);
+    }
+    return;
+  }
+  const auto point_offset_fn = [&] (const int64_t point_index)
+  {
+    return GetStartingOffsetForPoint(point_index);
+  };
+  const size_t x_offset = x_offset_from_point_start_;
+  const size_t y_offset = y_offset_from_point_start_;
+  const size_t z_offset = z_offset_from_point_start_;
+  const double scale = integer_field_scale_;
+  switch (xyz_datatype_)
+  {
+    case PointField::FLOAT32:
+      ReadPointsXYZ<float>(
+          point_offset_fn, data, first_point_index, num_points, x_offset,
+          y_offset, z_offset, 1.0, destination);
+      break;
+    case PointField::FLOAT64:
+      ReadPointsXYZ<double>(
+          point_offset_fn, data, first_point_index, num_points, x_offset,
+          y_offset, z_offset, 1.0, destination);
+      break;
+    case PointField::INT8:
+      ReadPointsXYZ<int8_t>(
+          point_offset_fn, data, first_point_index, num_points, x_offset,
+          y_offset, z_offset, scale, destination);
+      break;
+    case PointField::UINT8:
+      ReadPointsXYZ<uint8_t>(
+          point_offset_fn, data, first_point_index, num_points, x_offset,
+          y_offset, z_offset, scale, destination);
+      break;
+    case PointField::INT16:
+      ReadPointsXYZ<int16_t>(
+          point_offset_fn, data, first_point_index, num_points, x_offset,
+          y_offset, z_offset, scale, destination);
+      break;
+    case PointField::UINT16:
+      ReadPointsXYZ<uint16_t>(
+          point_offset_fn, data, first_point_index, num_points, x_offset,
+          y_offset, z_offset, scale, destination);
+      break;
+    case PointField::INT32:
+      ReadPointsXYZ<int32_t>(
+          point_offset_fn, data, first_point_index, num_points, x_offset,
+          y_offset, z_offset, scale, destination);
+      break;
+    case PointField::UINT32:
+      ReadPointsXYZ<uint32_t>(
+          point_offset_fn, data, first_point_index, num_points, x_offset,
+          y_offset, z_offset, scale, destination);
+      break;
+    default:
+      throw std::invalid_argument("Unsupported PointCloud xyz field type");
   }
 }
 }  // namespace pointcloud_voxelization
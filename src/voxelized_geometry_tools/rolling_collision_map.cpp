@@ -0,0 +1,82 @@
+#include <voxelized_geometry_tools/rolling_collision_map.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/rolling_voxel_grid.hpp>
+
+namespace voxelized_geometry_tools
+{
+RollingCollisionMap::RollingCollisionMap(
+    const Eigen::Isometry3d& origin_transform, const std::string& frame,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+    const CollisionCell& default_value, const CollisionCell& oob_value)
+    : RollingVoxelGrid<CollisionCell>(
+        origin_transform, sizes, default_value, oob_value), frame_(frame)
+{
+  const Eigen::Vector3d cell_sizes = GetCellSizes();
+  if (cell_sizes.x() != cell_sizes.y() || cell_sizes.x() != cell_sizes.z())
+  {
+    throw std::invalid_argument(
+        "Rolling collision map cannot have non-uniform cell sizes");
+  }
+}
+
+CollisionMap RollingCollisionMap::ExtractRegion(
+    const GridIndexRegion& region) const
+{
+  if (!IsRegionInBounds(region))
+  {
+    throw std::invalid_argument("region is out of bounds");
+  }
+  const double resolution = GetResolution();
+  const Eigen::Isometry3d region_origin_transform
+      = GetOriginTransform() * Eigen::Translation3d(
+          static_cast<double>(region.Lower().X()) * resolution,
+          static_cast<double>(region.Lower().Y()) * resolution,
+          static_cast<double>(region.Lower().Z()) * resolution);
+  const common_robotics_utilities::voxel_grid::GridSizes region_sizes(
+      resolution, region.NumXCells(), region.NumYCells(),
+      region.NumZCells());
+  CollisionMap region_map(
+      region_origin_transform, frame_, region_sizes, GetDefaultValue(),
+      GetOOBValue());
+  // Region cells are visited in x-major, z-minor order, which matches the
+  // layout of the dense backing store.
+  CollisionMapBackingStore& region_data = region_map.GetMutableRawData();
+  size_t data_index = 0;
+  ForEachCellInRegion(region, [&] (
+      const common_robotics_utilities::voxel_grid::GridIndex&,
+      const CollisionCell& cell)
+  {
+    region_data[data_index] = cell;
+    data_index++;
+  });
+  return region_map;
+}
+
+void RollingCollisionMap::ImportRegion(
+    const GridIndexRegion& region, const CollisionMap& map)
+{
+  if (map.GetNumXCells() != region.NumXCells()
+      || map.GetNumYCells() != region.NumYCells()
+      || map.GetNumZCells() != region.NumZCells())
+  {
+    throw std::invalid_argument("map size does not match region");
+  }
+  const CollisionMapBackingStore& map_data = map.GetImmutableRawData();
+  size_t data_index = 0;
+  ForEachCellInRegion(region, [&] (
+      const common_robotics_utilities::voxel_grid::GridIndex&,
+      CollisionCell& cell)
+  {
+    cell = map_data[data_index];
+    data_index++;
+  });
+}
+}  // namespace voxelized_geometry_tools
@@ -0,0 +1,225 @@
+#include <voxelized_geometry_tools/rolling_signed_distance_field.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/rolling_collision_map.hpp>
+#include <voxelized_geometry_tools/rolling_voxel_grid.hpp>
+#include <voxelized_geometry_tools/signed_distance_field_generation.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+GridIndexRegion BoundingRegion(
+    const GridIndexRegion& first, const GridIndexRegion& second)
+{
+  return GridIndexRegion(
+      common_robotics_utilities::voxel_grid::GridIndex(
+          std::min(first.Lower().X(), second.Lower().X()),
+          std::min(first.Lower().Y(), second.Lower().Y()),
+          std::min(first.Lower().Z(), second.Lower().Z())),
+      common_robotics_utilities::voxel_grid::GridIndex(
+          std::max(first.Upper().X(), second.Upper().X()),
+          std::max(first.Upper().Y(), second.Upper().Y()),
+          std::max(first.Upper().Z(), second.Upper().Z())));
+}
+}  // namespace
+
+RollingSignedDistanceField::RollingSignedDistanceField(
+    const Eigen::Isometry3d& origin_transform, const std::string& frame,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+    const float oob_value)
+    : RollingVoxelGrid<float>(origin_transform, sizes, oob_value, oob_value),
+      frame_(frame)
+{
+  const Eigen::Vector3d cell_sizes = GetCellSizes();
+  if (cell_sizes.x() != cell_sizes.y() || cell_sizes.x() != cell_sizes.z())
+  {
+    throw std::invalid_argument("SDF cannot have non-uniform cell sizes");
+  }
+}
+
+void RollingSignedDistanceField::CheckMatchingCollisionMap(
+    const RollingCollisionMap& collision_map, const int64_t margin_cells) const
+{
+  if (margin_cells < 0)
+  {
+    throw std::invalid_argument("margin_cells < 0");
+  }
+  if (collision_map.GetGridSizes() != GetGridSizes())
+  {
+    throw std::invalid_argument(
+        "collision_map.GetGridSizes() != GetGridSizes()");
+  }
+  if (!(collision_map.GetWindowOffset() == GetWindowOffset()))
+  {
+    throw std::invalid_argument(
+        "collision_map.GetWindowOffset() != GetWindowOffset()");
+  }
+}
+
+void RollingSignedDistanceField::RecomputeRegion(
+    const RollingCollisionMap& collision_map,
+    const GridIndexRegion& updated_region, const int64_t margin_cells,
+    const bool use_parallel)
+{
+  // Any obstacle within margin_cells of an updated cell is inside the
+  // computed region.
+  const GridIndexRegion window_region = GetWindowRegion();
+  const GridIndexRegion computed_region
+      = updated_region.Expanded(margin_cells).Intersected(window_region);
+  const bool computed_whole_window
+      = (computed_region.TotalCells() == window_region.TotalCells());
+  const double resolution = GetResolution();
+  const Eigen::Isometry3d computed_origin_transform
+      = GetOriginTransform() * Eigen::Translation3d(
+          static_cast<double>(computed_region.Lower().X()) * resolution,
+          static_cast<double>(computed_region.Lower().Y()) * resolution,
+          static_cast<double>(computed_region.Lower().Z()) * resolution);
+  const common_robotics_utilities::voxel_grid::GridSizes computed_sizes(
+      resolution, computed_region.NumXCells(), computed_region.NumYCells(),
+      computed_region.NumZCells());
+  const std::function<bool(
+      const common_robotics_utilities::voxel_grid::GridIndex&)> is_filled_fn
+          = [&] (const common_robotics_utilities::voxel_grid::GridIndex& index)
+  {
+    const common_robotics_utilities::voxel_grid::GridIndex window_index(
+        index.X() + computed_region.Lower().X(),
+        index.Y() + computed_region.Lower().Y(),
+        index.Z() + computed_region.Lower().Z());
+    return (collision_map.GetValueOrOOB(window_index).Occupancy() > 0.5);
+  };
+  const auto computed_sdf
+      = signed_distance_field_generation::ExtractSignedDistanceField<
+          CollisionCell>(
+              computed_origin_transform, computed_sizes, is_filled_fn,
+              GetOOBValue(), frame_, use_parallel);
+  const auto& computed_distance_field = computed_sdf.DistanceField();
+  // Distances beyond the margin may come from obstacles outside the computed
+  // region, so they are only known to be at least the margin.
+  const float max_distance = (computed_whole_window)
+      ? std::numeric_limits<float>::infinity()
+      : static_cast<float>(static_cast<double>(margin_cells) * resolution);
+  ForEachCellInRegion(updated_region, [&] (
+      const common_robotics_utilities::voxel_grid::GridIndex& window_index,
+      float& distance)
+  {
+    distance = std::min(max_distance, computed_distance_field.GetImmutable(
+        window_index.X() - computed_region.Lower().X(),
+        window_index.Y() - computed_region.Lower().Y(),
+        window_index.Z() - computed_region.Lower().Z()).Value());
+  });
+}
+
+void RollingSignedDistanceField::UpdateDistanceBound(
+    const GridIndexRegion& updated_region, const int64_t margin_cells)
+{
+  // Cells farther than the margin from every updated cell were not
+  // recomputed, and an obstacle that entered view may now be closer to them
+  // than their stored distance, though no closer than the margin.
+  if (updated_region.TotalCells() == GetWindowRegion().TotalCells())
+  {
+    distance_bound_ = std::numeric_limits<float>::infinity();
+  }
+  else
+  {
+    distance_bound_ = std::min(distance_bound_, static_cast<float>(
+        static_cast<double>(margin_cells) * GetResolution()));
+  }
+}
+
+GridIndexRegion RollingSignedDistanceField::UpdateRegion(
+    const RollingCollisionMap& collision_map, const GridIndexRegion& region,
+    const int64_t margin_cells, const bool use_parallel)
+{
+  CheckMatchingCollisionMap(collision_map, margin_cells);
+  if (region.IsEmpty())
+  {
+    return region;
+  }
+  const GridIndexRegion window_region = GetWindowRegion();
+  const GridIndexRegion updated_region
+      = region.Expanded(margin_cells).Intersected(window_region);
+  RecomputeRegion(collision_map, updated_region, margin_cells, use_parallel);
+  UpdateDistanceBound(updated_region, margin_cells);
+  return updated_region;
+}
+
+void RollingSignedDistanceField::UpdateRegions(
+    const RollingCollisionMap& collision_map,
+    const std::vector<GridIndexRegion>& regions, const int64_t margin_cells,
+    const bool use_parallel)
+{
+  CheckMatchingCollisionMap(collision_map, margin_cells);
+  const GridIndexRegion window_region = GetWindowRegion();
+  std::vector<GridIndexRegion> updated_regions;
+  for (const GridIndexRegion& region : regions)
+  {
+    if (!region.IsEmpty())
+    {
+      updated_regions.push_back(
+          region.Expanded(margin_cells).Intersected(window_region));
+    }
+  }
+  if (updated_regions.empty())
+  {
+    return;
+  }
+  // Merge overlapping updated regions into their bounding region whenever
+  // computing it costs no more than computing both separately, e.g. for
+  // adjacent dirty tiles, but not for the crossing slabs of a diagonal shift.
+  const auto computed_cells = [&] (const GridIndexRegion& updated_region)
+  {
+    return updated_region.Expanded(margin_cells).Intersected(window_region)
+        .TotalCells();
+  };
+  bool merged = true;
+  while (merged)
+  {
+    merged = false;
+    for (size_t first = 0; !merged && first < updated_regions.size(); first++)
+    {
+      for (size_t second = first + 1;
+           !merged && second < updated_regions.size(); second++)
+      {
+        const GridIndexRegion& first_region = updated_regions.at(first);
+        const GridIndexRegion& second_region = updated_regions.at(second);
+        if (first_region.Intersected(second_region).IsEmpty())
+        {
+          continue;
+        }
+        const GridIndexRegion bounding_region
+            = BoundingRegion(first_region, second_region);
+        if (computed_cells(bounding_region)
+                <= computed_cells(first_region)
+                   + computed_cells(second_region))
+        {
+          updated_regions.at(first) = bounding_region;
+          updated_regions.erase(
+              updated_regions.begin() + static_cast<std::ptrdiff_t>(second));
+          merged = true;
+        }
+      }
+    }
+  }
+  for (const GridIndexRegion& updated_region : updated_regions)
+  {
+    RecomputeRegion(collision_map, updated_region, margin_cells, use_parallel);
+  }
+  // A whole-window region, if any, was merged with every other region.
+  for (const GridIndexRegion& updated_region : updated_regions)
+  {
+    UpdateDistanceBound(updated_region, margin_cells);
+  }
+}
+}  // namespace voxelized_geometry_tools
@@ -1,7 +1,11 @@
 #include <voxelized_geometry_tools/ros_interface.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
+#include <zlib.h>
 #include <Eigen/Geometry>
 #if VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 1
 #include <ros/ros.h>
@@ -27,6 +31,110 @@ namespace voxelized_geometry_tools
 {
 namespace ros_interface
 {
+namespace
+{
+/// zlib counts bytes in uInt, so buffers larger than that are passed to
+/// deflate/inflate in pieces.
+uInt ZlibChunkSize(const size_t remaining_bytes)
+{
+  return static_cast<uInt>(std::min(
+      remaining_bytes,
+      static_cast<size_t>(std::numeric_limits<uInt>::max())));
+}
+}  // namespace
+
+void CompressBytesInto(
+    const std::vector<uint8_t>& raw_bytes,
+    std::vector<uint8_t>& compressed_bytes)
+{
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK)
+  {
+    throw std::runtime_error("deflateInit failed");
+  }
+  // Size to the worst-case bound up front, so the output never moves. The
+  // bound is per call, so add one block overhead per piece of input.
+  const size_t max_chunk_size
+      = static_cast<size_t>(std::numeric_limits<uInt>::max());
+  const size_t num_input_chunks = (raw_bytes.size() / max_chunk_size) + 1;
+  compressed_bytes.resize(
+      static_cast<size_t>(deflateBound(
+          &stream, ZlibChunkSize(raw_bytes.size())))
+      * num_input_chunks);
+  size_t consumed_bytes = 0;
+  size_t produced_bytes = 0;
+  int result = Z_OK;
+  while (result == Z_OK)
+  {
+    stream.next_in = const_cast<Bytef*>(raw_bytes.data() + consumed_bytes);
+    stream.avail_in = ZlibChunkSize(raw_bytes.size() - consumed_bytes);
+    stream.next_out = compressed_bytes.data() + produced_bytes;
+    stream.avail_out = ZlibChunkSize(compressed_bytes.size() - produced_bytes);
+    const uInt provided_in = stream.avail_in;
+    const uInt provided_out = stream.avail_out;
+    const bool last_input = (consumed_bytes + provided_in) == raw_bytes.size();
+    result = deflate(&stream, last_input ? Z_FINISH : Z_NO_FLUSH);
+    consumed_bytes += static_cast<size_t>(provided_in - stream.avail_in);
+    produced_bytes += static_cast<size_t>(provided_out - stream.avail_out);
+  }
+  deflateEnd(&stream);
+  if (result != Z_STREAM_END)
+  {
+    throw std::runtime_error("deflate failed");
+  }
+  compressed_bytes.resize(produced_bytes);
+}
+
+void DecompressBytesInto(
+    const std::vector<uint8_t>& compressed_bytes,
+    std::vector<uint8_t>& decompressed_bytes)
+{
+  z_stream stream;
+  stream.zalloc = Z_NULL;
+  stream.zfree = Z_NULL;
+  stream.opaque = Z_NULL;
+  stream.next_in = Z_NULL;
+  stream.avail_in = 0;
+  if (inflateInit(&stream) != Z_OK)
+  {
+    throw std::runtime_error("inflateInit failed");
+  }
+  // Voxel grids usually compress well, so start from a generous multiple of
+  // the compressed size and double as needed; output is inflated in place.
+  decompressed_bytes.resize(
+      std::max(compressed_bytes.size() * 8, static_cast<size_t>(4096)));
+  size_t consumed_bytes = 0;
+  size_t produced_bytes = 0;
+  int result = Z_OK;
+  while (result == Z_OK)
+  {
+    if (produced_bytes == decompressed_bytes.size())
+    {
+      decompressed_bytes.resize(decompressed_bytes.size() * 2);
+    }
+    stream.next_in
+        = const_cast<Bytef*>(compressed_bytes.data() + consumed_bytes);
+    stream.avail_in = ZlibChunkSize(compressed_bytes.size() - consumed_bytes);
+    stream.next_out = decompressed_bytes.data() + produced_bytes;
+    stream.avail_out
+        = ZlibChunkSize(decompressed_bytes.size() - produced_bytes);
+    const uInt provided_in = stream.avail_in;
+    const uInt provided_out = stream.avail_out;
+    result = inflate(&stream, Z_NO_FLUSH);
+    consumed_bytes += static_cast<size_t>(provided_in - stream.avail_in);
+    produced_bytes += static_cast<size_t>(provided_out - stream.avail_out);
+  }
+  inflateEnd(&stream);
+  if (result != Z_STREAM_END)
+  {
+    throw std::runtime_error("inflate failed");
+  }
+  decompressed_bytes.resize(produced_bytes);
+}
+
 Marker ExportForDisplay(
     const CollisionMap& collision_map,
     const ColorRGBA& collision_color,
@@ -51,7 +159,7 @@ Marker ExportForDisplay(
     }
   };
   auto display_rep
-      = ExportVoxelGridToRViz<CollisionCell>(
+      = ExportVoxelGridToRViz<CollisionCell, CollisionMapBackingStore>(
           collision_map, collision_map.GetFrame(), color_fn);
   display_rep.ns = "collision_map";
   display_rep.id = 1;
@@ -83,6 +191,44 @@ MarkerArray ExportForSeparateDisplay(
   return display_messages;
 }
 
+MarkerArray ExportForLODDisplay(
+    const CollisionMap& collision_map,
+    const ColorRGBA& collision_color,
+    const ColorRGBA& free_color,
+    const ColorRGBA& unknown_color,
+    const bool surface_only,
+    const bool merge_uniform_regions,
+    const size_t max_voxels,
+    const bool use_parallel)
+{
+  const auto color_fn
+      = [&] (const CollisionCell& cell,
+             const common_robotics_utilities::voxel_grid::GridIndex&)
+  {
+    if (cell.Occupancy() > 0.5)
+    {
+      return collision_color;
+    }
+    else if (cell.Occupancy() < 0.5)
+    {
+      return free_color;
+    }
+    else
+    {
+      return unknown_color;
+    }
+  };
+  MarkerArray display_reps
+      = ExportVoxelGridToRVizWithLOD<CollisionCell, CollisionMapBackingStore>(
+          collision_map, collision_map.GetFrame(), color_fn, surface_only,
+          merge_uniform_regions, max_voxels, use_parallel);
+  for (auto& display_rep : display_reps.markers)
+  {
+    display_rep.ns = "collision_map_lod";
+  }
+  return display_reps;
+}
+
 Marker ExportSurfacesForDisplay(
     const CollisionMap& collision_map,
     const ColorRGBA& collision_color,
@@ -117,7 +263,7 @@ Marker ExportSurfacesForDisplay(
     }
   };
   auto display_rep
-      = ExportVoxelGridToRViz<CollisionCell>(
+      = ExportVoxelGridToRViz<CollisionCell, CollisionMapBackingStore>(
           collision_map, collision_map.GetFrame(), color_fn);
   display_rep.ns = "collision_surfaces";
   display_rep.id = 1;
@@ -180,7 +326,7 @@ Marker ExportConnectedComponentsForDisplay(
     }
   };
   auto display_rep
-      = ExportVoxelGridToRViz<CollisionCell>(
+      = ExportVoxelGridToRViz<CollisionCell, CollisionMapBackingStore>(
           collision_map, collision_map.GetFrame(), color_fn);
   display_rep.ns = "connected_components";
   display_rep.id = 1;
@@ -225,31 +371,22 @@ Marker ExportIndicesForDisplay(
   return display_rep;
 }
 
-CollisionMapMessage GetMessageRepresentation(const CollisionMap& map)
+CollisionMapMessage GetMessageRepresentation(
+    const CollisionMap& map, const bool compress)
 {
   CollisionMapMessage map_message;
   map_message.header.frame_id = map.GetFrame();
-  std::vector<uint8_t> buffer;
-  CollisionMap::Serialize(map, buffer);
-  map_message.serialized_map
-      = common_robotics_utilities::zlib_helpers::CompressBytes(buffer);
-  map_message.is_compressed = true;
+  SerializeIntoMessageBytes<CollisionMap>(
+      map, EstimateSerializedSize<CollisionCell>(map, map.GetFrame()),
+      compress, map_message.serialized_map);
+  map_message.is_compressed = compress;
   return map_message;
 }
 
 CollisionMap LoadFromMessageRepresentation(const CollisionMapMessage& message)
 {
-  if (message.is_compressed)
-  {
-    const std::vector<uint8_t> decompressed_map
-        = common_robotics_utilities::zlib_helpers::DecompressBytes(
-            message.serialized_map);
-    return CollisionMap::Deserialize(decompressed_map, 0).Value();
-  }
-  else
-  {
-    return CollisionMap::Deserialize(message.serialized_map, 0).Value();
-  }
+  return DeserializeFromMessageBytes<CollisionMap>(
+      message.serialized_map, message.is_compressed);
 }
 
 MarkerArray ExportForDisplay(
@@ -276,8 +413,9 @@ MarkerArray ExportForDisplay(
     }
   };
   auto display_rep
-      = ExportDynamicSpatialHashedVoxelGridToRViz<CollisionCell>(
-          collision_map, collision_map.GetFrame(), color_fn, color_fn);
+      = ExportDynamicSpatialHashedVoxelGridToRViz<
+          CollisionCell, DSHCollisionCellBackingStore>(
+              collision_map, collision_map.GetFrame(), color_fn, color_fn);
   display_rep.first.ns = "dsh_collision_map_chunks";
   display_rep.first.id = 1;
   display_rep.second.ns = "dsh_collision_map_cells";
@@ -328,34 +466,28 @@ MarkerArray ExportForSeparateDisplay(
 }
 
 DynamicSpatialHashedCollisionMapMessage GetMessageRepresentation(
-    const DynamicSpatialHashedCollisionMap& map)
+    const DynamicSpatialHashedCollisionMap& map, const bool compress)
 {
   DynamicSpatialHashedCollisionMapMessage map_message;
   map_message.header.frame_id = map.GetFrame();
-  std::vector<uint8_t> buffer;
-  DynamicSpatialHashedCollisionMap::Serialize(map, buffer);
-  map_message.serialized_map
-      = common_robotics_utilities::zlib_helpers::CompressBytes(buffer);
-  map_message.is_compressed = true;
+  // Each chunk serializes its cells plus a small fixed-size header.
+  const size_t chunk_bytes
+      = 256 + (static_cast<size_t>(map.GetChunkGridSizes().TotalCells())
+               * sizeof(CollisionCell));
+  const size_t serialized_size_hint
+      = 1024 + map.GetFrame().size()
+        + (map.GetImmutableInternalChunks().size() * chunk_bytes);
+  SerializeIntoMessageBytes<DynamicSpatialHashedCollisionMap>(
+      map, serialized_size_hint, compress, map_message.serialized_map);
+  map_message.is_compressed = compress;
   return map_message;
 }
 
 DynamicSpatialHashedCollisionMap LoadFromMessageRepresentation(
     const DynamicSpatialHashedCollisionMapMessage& message)
 {
-  if (message.is_compressed)
-  {
-    const std::vector<uint8_t> decompressed_map
-        = common_robotics_utilities::zlib_helpers::DecompressBytes(
-            message.serialized_map);
-    return DynamicSpatialHashedCollisionMap::Deserialize(
-        decompressed_map, 0).Value();
-  }
-  else
-  {
-    return DynamicSpatialHashedCollisionMap::Deserialize(
-        message.serialized_map, 0).Value();
-  }
+  return DeserializeFromMessageBytes<DynamicSpatialHashedCollisionMap>(
+      message.serialized_map, message.is_compressed);
 }
 
 Marker ExportForDisplay(
@@ -685,33 +817,23 @@ Marker ExportIndicesForDisplay(
 }
 
 TaggedObjectCollisionMapMessage GetMessageRepresentation(
-    const TaggedObjectCollisionMap& map)
+    const TaggedObjectCollisionMap& map, const bool compress)
 {
   TaggedObjectCollisionMapMessage map_message;
   map_message.header.frame_id = map.GetFrame();
-  std::vector<uint8_t> buffer;
-  TaggedObjectCollisionMap::Serialize(map, buffer);
-  map_message.serialized_map
-      = common_robotics_utilities::zlib_helpers::CompressBytes(buffer);
-  map_message.is_compressed = true;
+  SerializeIntoMessageBytes<TaggedObjectCollisionMap>(
+      map,
+      EstimateSerializedSize<TaggedObjectCollisionCell>(map, map.GetFrame()),
+      compress, map_message.serialized_map);
+  map_message.is_compressed = compress;
   return map_message;
 }
 
 TaggedObjectCollisionMap LoadFromMessageRepresentation(
     const TaggedObjectCollisionMapMessage& message)
 {
-  if (message.is_compressed)
-  {
-    const std::vector<uint8_t> decompressed_map
-        = common_robotics_utilities::zlib_helpers::DecompressBytes(
-            message.serialized_map);
-    return TaggedObjectCollisionMap::Deserialize(decompressed_map, 0).Value();
-  }
-  else
-  {
-    return TaggedObjectCollisionMap::Deserialize(
-        message.serialized_map, 0).Value();
-  }
+  return DeserializeFromMessageBytes<TaggedObjectCollisionMap>(
+      message.serialized_map, message.is_compressed);
 }
 }  // namespace ros_interface
 }  // namespace voxelized_geometry_tools
@@ -0,0 +1,510 @@
+#include <voxelized_geometry_tools/scene_generation.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/utility.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization_interface.hpp>
+#include <voxelized_geometry_tools/tagged_object_collision_map.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace scene_generation
+{
+bool Box::Contains(const Eigen::Vector3d& point, const double inflation) const
+{
+  const Eigen::Vector3d local_point = inverse_pose_ * point;
+  return (local_point.cwiseAbs().array()
+          <= (half_extents_.array() + inflation)).all();
+}
+
+double Box::Raycast(const Eigen::Vector3d& origin,
+                    const Eigen::Vector3d& direction) const
+{
+  // Slab test in the box frame.
+  const Eigen::Vector3d local_origin = inverse_pose_ * origin;
+  const Eigen::Vector3d local_direction = inverse_pose_.linear() * direction;
+  double entry = 0.0;
+  double exit = std::numeric_limits<double>::infinity();
+  for (int32_t axis = 0; axis < 3; axis++)
+  {
+    if (local_direction(axis) == 0.0)
+    {
+      if (std::abs(local_origin(axis)) > half_extents_(axis))
+      {
+        return std::numeric_limits<double>::infinity();
+      }
+      continue;
+    }
+    const double inv_direction = 1.0 / local_direction(axis);
+    double near = (-half_extents_(axis) - local_origin(axis)) * inv_direction;
+    double far = (half_extents_(axis) - local_origin(axis)) * inv_direction;
+    if (near > far)
+    {
+      std::swap(near, far);
+    }
+    entry = std::max(entry, near);
+    exit = std::min(exit, far);
+    if (entry > exit)
+    {
+      return std::numeric_limits<double>::infinity();
+    }
+  }
+  return entry;
+}
+
+bool Cylinder::Contains(
+    const Eigen::Vector3d& point, const double inflation) const
+{
+  const Eigen::Vector3d local_point = inverse_pose_ * point;
+  const double radius = radius_ + inflation;
+  return (std::abs(local_point.z()) <= (half_height_ + inflation))
+         && (local_point.head<2>().squaredNorm() <= (radius * radius));
+}
+
+double Cylinder::Raycast(const Eigen::Vector3d& origin,
+                         const Eigen::Vector3d& direction) const
+{
+  const Eigen::Vector3d local_origin = inverse_pose_ * origin;
+  const Eigen::Vector3d local_direction = inverse_pose_.linear() * direction;
+  // Interval of the ray inside the infinite cylinder.
+  double entry = 0.0;
+  double exit = std::numeric_limits<double>::infinity();
+  const double a = local_direction.head<2>().squaredNorm();
+  const double b = 2.0 * local_origin.head<2>().dot(local_direction.head<2>());
+  const double c = local_origin.head<2>().squaredNorm() - (radius_ * radius_);
+  if (a == 0.0)
+  {
+    if (c > 0.0)
+    {
+      return std::numeric_limits<double>::infinity();
+    }
+  }
+  else
+  {
+    const double discriminant = (b * b) - (4.0 * a * c);
+    if (discriminant < 0.0)
+    {
+      return std::numeric_limits<double>::infinity();
+    }
+    const double root = std::sqrt(discriminant);
+    entry = std::max(entry, (-b - root) / (2.0 * a));
+    exit = std::min(exit, (-b + root) / (2.0 * a));
+  }
+  // Intersect with the slab between the caps.
+  if (local_direction.z() == 0.0)
+  {
+    if (std::abs(local_origin.z()) > half_height_)
+    {
+      return std::numeric_limits<double>::infinity();
+    }
+  }
+  else
+  {
+    double near = (-half_height_ - local_origin.z()) / local_direction.z();
+    double far = (half_height_ - local_origin.z()) / local_direction.z();
+    if (near > far)
+    {
+      std::swap(near, far);
+    }
+    entry = std::max(entry, near);
+    exit = std::min(exit, far);
+  }
+  if (entry > exit)
+  {
+    return std::numeric_limits<double>::infinity();
+  }
+  return entry;
+}
+
+double Scene::Raycast(const Eigen::Vector3d& origin,
+                      const Eigen::Vector3d& direction) const
+{
+  double closest = std::numeric_limits<double>::infinity();
+  for (const Box& box : boxes_)
+  {
+    closest = std::min(closest, box.Raycast(origin, direction));
+  }
+  for (const Cylinder& cylinder : cylinders_)
+  {
+    closest = std::min(closest, cylinder.Raycast(origin, direction));
+  }
+  return closest;
+}
+
+Scene MakeRandomClutterScene(
+    const Eigen::Vector3d& workspace_size, const int32_t num_boxes,
+    const int32_t num_cylinders, const double min_object_size,
+    const double max_object_size, const uint64_t seed)
+{
+  if (num_boxes < 0 || num_cylinders < 0)
+  {
+    throw std::invalid_argument("num_boxes < 0 or num_cylinders < 0");
+  }
+  if (min_object_size <= 0.0 || max_object_size < min_object_size)
+  {
+    throw std::invalid_argument("invalid object size range");
+  }
+  std::mt19937_64 prng(seed);
+  std::uniform_real_distribution<double> size_dist(
+      min_object_size, max_object_size);
+  std::uniform_real_distribution<double> x_dist(0.0, workspace_size.x());
+  std::uniform_real_distribution<double> y_dist(0.0, workspace_size.y());
+  std::uniform_real_distribution<double> yaw_dist(-M_PI, M_PI);
+  // Objects rest on the floor, at z = 0.
+  const auto random_pose = [&] (const double half_height)
+  {
+    const double x = x_dist(prng);
+    const double y = y_dist(prng);
+    const double yaw = yaw_dist(prng);
+    return Eigen::Isometry3d(
+        Eigen::Translation3d(x, y, half_height)
+        * Eigen::AngleAxisd(yaw, Eigen::Vector3d::UnitZ()));
+  };
+  Scene scene;
+  for (int32_t idx = 0; idx < num_boxes; idx++)
+  {
+    const Eigen::Vector3d half_extents(
+        size_dist(prng) * 0.5, size_dist(prng) * 0.5, size_dist(prng) * 0.5);
+    scene.AddBox(random_pose(half_extents.z()), half_extents);
+  }
+  for (int32_t idx = 0; idx < num_cylinders; idx++)
+  {
+    const double radius = size_dist(prng) * 0.5;
+    const double half_height = size_dist(prng) * 0.5;
+    scene.AddCylinder(random_pose(half_height), radius, half_height);
+  }
+  return scene;
+}
+
+Scene MakeFloorplanScene(
+    const Eigen::Vector3d& building_size, const double room_size,
+    const double wall_thickness, const double door_width, const uint64_t seed)
+{
+  if (wall_thickness <= 0.0)
+  {
+    throw std::invalid_argument("wall_thickness <= 0.0");
+  }
+  if (door_width < 0.0)
+  {
+    throw std::invalid_argument("door_width < 0.0");
+  }
+  std::mt19937_64 prng(seed);
+  const double half_thickness = wall_thickness * 0.5;
+  const double wall_height = building_size.z() - wall_thickness;
+  const double wall_center_z = wall_thickness + (wall_height * 0.5);
+  Scene scene;
+  // Floor slab.
+  scene.AddBox(
+      Eigen::Isometry3d(Eigen::Translation3d(
+          building_size.x() * 0.5, building_size.y() * 0.5, half_thickness)),
+      Eigen::Vector3d(
+          building_size.x() * 0.5, building_size.y() * 0.5, half_thickness));
+  const int32_t num_x_rooms = std::max(
+      1, static_cast<int32_t>(std::floor(building_size.x() / room_size)));
+  const int32_t num_y_rooms = std::max(
+      1, static_cast<int32_t>(std::floor(building_size.y() / room_size)));
+  const double room_x_size = building_size.x() / num_x_rooms;
+  const double room_y_size = building_size.y() / num_y_rooms;
+  if (std::min(room_x_size, room_y_size) < (door_width + 2.0 * wall_thickness))
+  {
+    throw std::invalid_argument("room_size too small for doors");
+  }
+  // Adds a wall segment along x (axis 0) or y (axis 1) spanning
+  // [start, end] at the given fixed coordinate, optionally with a door.
+  const auto add_wall
+      = [&] (const int32_t axis, const double fixed, const double start,
+             const double end, const bool with_door)
+  {
+    std::vector<std::pair<double, double>> spans;
+    if (with_door)
+    {
+      std::uniform_real_distribution<double> door_dist(
+          start + wall_thickness, end - wall_thickness - door_width);
+      const double door_start = door_dist(prng);
+      spans.push_back(std::make_pair(start, door_start));
+      spans.push_back(std::make_pair(door_start + door_width, end));
+    }
+    else
+    {
+      spans.push_back(std::make_pair(start, end));
+    }
+    for (const auto& span : spans)
+    {
+      const double center = (span.first + span.second) * 0.5;
+      const double half_length = (span.second - span.first) * 0.5;
+      if (half_length <= 0.0)
+      {
+        continue;
+      }
+      const Eigen::Vector3d position = (axis == 0)
+          ? Eigen::Vector3d(center, fixed, wall_center_z)
+          : Eigen::Vector3d(fixed, center, wall_center_z);
+      const Eigen::Vector3d half_extents = (axis == 0)
+          ? Eigen::Vector3d(half_length, half_thickness, wall_height * 0.5)
+          : Eigen::Vector3d(half_thickness, half_length, wall_height * 0.5);
+      scene.AddBox(Eigen::Isometry3d(Eigen::Translation3d(position)),
+                   half_extents);
+    }
+  };
+  // Walls along x, at each room boundary in y.
+  for (int32_t y_room = 0; y_room <= num_y_rooms; y_room++)
+  {
+    const double y = std::min(std::max(y_room * room_y_size, half_thickness),
+                              building_size.y() - half_thickness);
+    const bool outer = (y_room == 0 || y_room == num_y_rooms);
+    for (int32_t x_room = 0; x_room < num_x_rooms; x_room++)
+    {
+      add_wall(0, y, x_room * room_x_size, (x_room + 1) * room_x_size,
+               !outer && door_width > 0.0);
+    }
+  }
+  // Walls along y, at each room boundary in x.
+  for (int32_t x_room = 0; x_room <= num_x_rooms; x_room++)
+  {
+    const double x = std::min(std::max(x_room * room_x_size, half_thickness),
+                              building_size.x() - half_thickness);
+    const bool outer = (x_room == 0 || x_room == num_x_rooms);
+    for (int32_t y_room = 0; y_room < num_y_rooms; y_room++)
+    {
+      add_wall(1, x, y_room * room_y_size, (y_room + 1) * room_y_size,
+               !outer && door_width > 0.0);
+    }
+  }
+  return scene;
+}
+
+Scene MakeThinWallScene(
+    const Eigen::Vector3d& workspace_size, const int32_t num_walls,
+    const double wall_thickness, const uint64_t seed)
+{
+  if (num_walls < 0)
+  {
+    throw std::invalid_argument("num_walls < 0");
+  }
+  if (wall_thickness <= 0.0)
+  {
+    throw std::invalid_argument("wall_thickness <= 0.0");
+  }
+  std::mt19937_64 prng(seed);
+  std::uniform_int_distribution<int32_t> axis_dist(0, 2);
+  std::uniform_real_distribution<double> unit_dist(0.0, 1.0);
+  Scene scene;
+  for (int32_t idx = 0; idx < num_walls; idx++)
+  {
+    // Each wall spans the workspace in the two axes other than its normal.
+    const int32_t normal_axis = axis_dist(prng);
+    Eigen::Vector3d position = workspace_size * 0.5;
+    position(normal_axis) = unit_dist(prng) * workspace_size(normal_axis);
+    Eigen::Vector3d half_extents = workspace_size * 0.5;
+    half_extents(normal_axis) = wall_thickness * 0.5;
+    scene.AddBox(Eigen::Isometry3d(Eigen::Translation3d(position)),
+                 half_extents);
+  }
+  return scene;
+}
+
+/// Calls fill_fn(index, object_id) for every cell of grid covered by each
+/// primitive, in primitive order, parallel within each primitive.
+template<typename T, typename BackingStore, typename Primitive,
+         typename FillFn>
+void RasterizePrimitives(
+    const std::vector<Primitive>& primitives, const double inflation,
+    const bool use_parallel,
+    common_robotics_utilities::voxel_grid::VoxelGridBase<T, BackingStore>&
+        grid,
+    const FillFn& fill_fn)
+{
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  for (const Primitive& primitive : primitives)
+  {
+    // Grid-frame bounds of the primitive's (inflated) bounding box.
+    const Eigen::Isometry3d primitive_in_grid
+        = grid.GetInverseOriginTransform() * primitive.Pose();
+    const Eigen::Vector3d half_bounds
+        = primitive.LocalHalfBounds() + Eigen::Vector3d::Constant(inflation);
+    const Eigen::Vector3d grid_half_bounds
+        = primitive_in_grid.linear().cwiseAbs() * half_bounds;
+    const Eigen::Vector3d lower
+        = primitive_in_grid.translation() - grid_half_bounds;
+    const Eigen::Vector3d upper
+        = primitive_in_grid.translation() + grid_half_bounds;
+    const Eigen::Vector3d cell_sizes = grid.GetCellSizes();
+    const int64_t num_cells[3]
+        = {grid.GetNumXCells(), grid.GetNumYCells(), grid.GetNumZCells()};
+    int64_t lower_index[3];
+    int64_t upper_index[3];
+    for (int32_t axis = 0; axis < 3; axis++)
+    {
+      lower_index[axis] = std::max(
+          INT64_C(0),
+          static_cast<int64_t>(std::floor(lower(axis) / cell_sizes(axis))));
+      upper_index[axis] = std::min(
+          num_cells[axis],
+          static_cast<int64_t>(std::floor(upper(axis) / cell_sizes(axis)))
+              + 1);
+    }
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+    UNUSED(use_parallel);
+#endif
+    for (int64_t x_index = lower_index[0]; x_index < upper_index[0];
+         x_index++)
+    {
+      for (int64_t y_index = lower_index[1]; y_index < upper_index[1];
+           y_index++)
+      {
+        for (int64_t z_index = lower_index[2]; z_index < upper_index[2];
+             z_index++)
+        {
+          const GridIndex index(x_index, y_index, z_index);
+          const Eigen::Vector3d cell_center
+              = grid.GridIndexToLocation(index).template head<3>();
+          if (primitive.Contains(cell_center, inflation))
+          {
+            fill_fn(index, primitive.ObjectId());
+          }
+        }
+      }
+    }
+  }
+}
+
+CollisionMap MakeCollisionMap(
+    const Scene& scene, const Eigen::Isometry3d& origin_transform,
+    const std::string& frame,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+    const bool conservative, const bool use_parallel)
+{
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  CollisionMap map(origin_transform, frame, sizes, CollisionCell(0.0f));
+  // Cells are filled in parallel, so no tile may be shared.
+  map.GetMutableRawData().MakeUnique();
+  const double inflation
+      = conservative ? (map.GetCellSizes().norm() * 0.5) : 0.0;
+  const auto fill_fn = [&] (const GridIndex& index, const uint32_t)
+  {
+    map.GetMutable(index).Value().Occupancy() = 1.0f;
+  };
+  RasterizePrimitives(scene.Boxes(), inflation, use_parallel, map, fill_fn);
+  RasterizePrimitives(
+      scene.Cylinders(), inflation, use_parallel, map, fill_fn);
+  return map;
+}
+
+TaggedObjectCollisionMap MakeTaggedObjectCollisionMap(
+    const Scene& scene, const Eigen::Isometry3d& origin_transform,
+    const std::string& frame,
+    const common_robotics_utilities::voxel_grid::GridSizes& sizes,
+    const bool conservative, const bool use_parallel)
+{
+  using common_robotics_utilities::voxel_grid::GridIndex;
+  TaggedObjectCollisionMap map(
+      origin_transform, frame, sizes, TaggedObjectCollisionCell(0.0f, 0u));
+  const double inflation
+      = conservative ? (map.GetCellSizes().norm() * 0.5) : 0.0;
+  const auto fill_fn = [&] (const GridIndex& index, const uint32_t object_id)
+  {
+    map.GetMutable(index).Value() = TaggedObjectCollisionCell(1.0f, object_id);
+  };
+  RasterizePrimitives(scene.Boxes(), inflation, use_parallel, map, fill_fn);
+  RasterizePrimitives(
+      scene.Cylinders(), inflation, use_parallel, map, fill_fn);
+  return map;
+}
+
+pointcloud_voxelization::PointCloudWrapperPtr SimulateDepthCamera(
+    const Scene& scene, const Eigen::Isometry3d& camera_pose,
+    const int32_t width, const int32_t height,
+    const double horizontal_field_of_view, const double max_range,
+    const double depth_noise_stddev, const uint64_t seed,
+    const bool use_parallel)
+{
+  if (width < 1 || height < 1)
+  {
+    throw std::invalid_argument("width < 1 or height < 1");
+  }
+  if (horizontal_field_of_view <= 0.0 || horizontal_field_of_view >= M_PI)
+  {
+    throw std::invalid_argument("horizontal_field_of_view out of (0, pi)");
+  }
+  if (depth_noise_stddev < 0.0)
+  {
+    throw std::invalid_argument("depth_noise_stddev < 0.0");
+  }
+  const size_t num_pixels
+      = static_cast<size_t>(width) * static_cast<size_t>(height);
+  // Draw noise serially so that results do not depend on thread count.
+  std::vector<float> depth_noise(num_pixels, 0.0f);
+  if (depth_noise_stddev > 0.0)
+  {
+    std::mt19937_64 prng(seed);
+    std::normal_distribution<double> noise_dist(0.0, depth_noise_stddev);
+    for (float& noise : depth_noise)
+    {
+      noise = static_cast<float>(noise_dist(prng));
+    }
+  }
+  const double focal_length
+      = (static_cast<double>(width) * 0.5)
+        / std::tan(horizontal_field_of_view * 0.5);
+  const double center_x = (static_cast<double>(width) - 1.0) * 0.5;
+  const double center_y = (static_cast<double>(height) - 1.0) * 0.5;
+  // Hits are stored per pixel first, then compacted in pixel order.
+  std::vector<Eigen::Vector3f> hits(num_pixels);
+  std::vector<uint8_t> hit_mask(num_pixels, 0);
+#if defined(_OPENMP)
+#pragma omp parallel for if (use_parallel)
+#else
+  UNUSED(use_parallel);
+#endif
+  for (int32_t row = 0; row < height; row++)
+  {
+    for (int32_t col = 0; col < width; col++)
+    {
+      const size_t pixel = (static_cast<size_t>(row)
+                            * static_cast<size_t>(width))
+                           + static_cast<size_t>(col);
+      const Eigen::Vector3d camera_ray
+          = Eigen::Vector3d((col - center_x) / focal_length,
+                            (row - center_y) / focal_length, 1.0)
+              .normalized();
+      const double range = scene.Raycast(
+          camera_pose.translation(), camera_pose.linear() * camera_ray);
+      if (range <= max_range)
+      {
+        // Noise is applied to depth (z), as for real depth cameras.
+        const double depth = (range * camera_ray.z()) + depth_noise[pixel];
+        if (depth > 0.0)
+        {
+          hits[pixel]
+              = (camera_ray * (depth / camera_ray.z())).cast<float>();
+          hit_mask[pixel] = 1;
+        }
+      }
+    }
+  }
+  auto cloud = std::make_shared<VectorPointCloudWrapper>(
+      camera_pose, max_range);
+  for (size_t pixel = 0; pixel < num_pixels; pixel++)
+  {
+    if (hit_mask[pixel] > 0)
+    {
+      cloud->PushBack(hits[pixel]);
+    }
+  }
+  return cloud;
+}
+}  // namespace scene_generation
+}  // namespace voxelized_geometry_tools
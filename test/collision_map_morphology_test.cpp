@@ -0,0 +1,208 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/collision_map_morphology.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+/// Map with free space, a solid block, a one-cell-thick wall, isolated
+/// filled cells, and a block of unknown cells touching the solid block.
+CollisionMap MakeTestMap()
+{
+  const GridSizes sizes(
+      0.1, static_cast<int64_t>(9), static_cast<int64_t>(8),
+      static_cast<int64_t>(7));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+      {
+        float occupancy = 0.0f;
+        if (x_index >= 1 && x_index < 5 && y_index >= 1 && y_index < 5
+            && z_index >= 1 && z_index < 5)
+        {
+          occupancy = 1.0f;
+        }
+        else if (x_index >= 5 && x_index < 8 && y_index >= 2 && y_index < 6
+                 && z_index >= 2 && z_index < 6)
+        {
+          occupancy = 0.5f;
+        }
+        else if (y_index == 6 && z_index != 3)
+        {
+          occupancy = 1.0f;
+        }
+        else if ((x_index + y_index + z_index) % 11 == 0)
+        {
+          occupancy = 1.0f;
+        }
+        map.SetValue(x_index, y_index, z_index, CollisionCell(occupancy));
+      }
+    }
+  }
+  return map;
+}
+
+std::vector<uint8_t> BruteForceObstacleMask(
+    const CollisionMap& map, const bool unknown_is_filled)
+{
+  std::vector<uint8_t> mask(static_cast<size_t>(map.GetTotalCells()), 0u);
+  for (size_t data_index = 0; data_index < mask.size(); data_index++)
+  {
+    const float occupancy
+        = map.GetImmutableRawData()[data_index].Occupancy();
+    mask[data_index] = static_cast<uint8_t>(
+        occupancy > 0.5f || (unknown_is_filled && occupancy == 0.5f));
+  }
+  return mask;
+}
+
+/// Sets every cell within radius_in_cells of a feature_value cell to
+/// feature_value, by checking every pair of cells.
+std::vector<uint8_t> BruteForceGrowMask(
+    const CollisionMap& map, const std::vector<uint8_t>& mask,
+    const double radius_in_cells, const uint8_t feature_value)
+{
+  const int64_t num_x_cells = map.GetNumXCells();
+  const int64_t num_y_cells = map.GetNumYCells();
+  const int64_t num_z_cells = map.GetNumZCells();
+  const auto data_index = [&] (const int64_t x_index, const int64_t y_index,
+                               const int64_t z_index)
+  {
+    return static_cast<size_t>(
+        (((x_index * num_y_cells) + y_index) * num_z_cells) + z_index);
+  };
+  std::vector<uint8_t> grown_mask = mask;
+  for (int64_t x_index = 0; x_index < num_x_cells; x_index++)
+  {
+    for (int64_t y_index = 0; y_index < num_y_cells; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < num_z_cells; z_index++)
+      {
+        for (int64_t fx_index = 0; fx_index < num_x_cells; fx_index++)
+        {
+          for (int64_t fy_index = 0; fy_index < num_y_cells; fy_index++)
+          {
+            for (int64_t fz_index = 0; fz_index < num_z_cells; fz_index++)
+            {
+              const double distance = std::sqrt(static_cast<double>(
+                  ((fx_index - x_index) * (fx_index - x_index))
+                  + ((fy_index - y_index) * (fy_index - y_index))
+                  + ((fz_index - z_index) * (fz_index - z_index))));
+              if (mask[data_index(fx_index, fy_index, fz_index)]
+                      == feature_value
+                  && distance <= radius_in_cells + 1e-9)
+              {
+                grown_mask[data_index(x_index, y_index, z_index)]
+                    = feature_value;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return grown_mask;
+}
+
+/// Checks result against the brute-force mask: cells that join the obstacle
+/// set are filled, filled cells that leave it are free, and all other cells
+/// (including unknown cells that leave it) keep their occupancy.
+void CheckResult(
+    const CollisionMap& map, const std::vector<uint8_t>& original_mask,
+    const std::vector<uint8_t>& expected_mask, const CollisionMap& result)
+{
+  ASSERT_EQ(result.GetTotalCells(), map.GetTotalCells());
+  for (size_t data_index = 0; data_index < original_mask.size(); data_index++)
+  {
+    const float occupancy
+        = map.GetImmutableRawData()[data_index].Occupancy();
+    float expected_occupancy = occupancy;
+    if (expected_mask[data_index] > original_mask[data_index])
+    {
+      expected_occupancy = 1.0f;
+    }
+    else if (expected_mask[data_index] < original_mask[data_index]
+             && occupancy > 0.5f)
+    {
+      expected_occupancy = 0.0f;
+    }
+    ASSERT_EQ(result.GetImmutableRawData()[data_index].Occupancy(),
+              expected_occupancy) << "data_index " << data_index;
+  }
+}
+
+GTEST_TEST(CollisionMapMorphologyTest, OperationsMatchBruteForce)
+{
+  const CollisionMap map = MakeTestMap();
+  for (const bool unknown_is_filled : {false, true})
+  {
+    const std::vector<uint8_t> original_mask
+        = BruteForceObstacleMask(map, unknown_is_filled);
+    ASSERT_EQ(collision_map_morphology::MakeObstacleMask(
+                  map, unknown_is_filled, false),
+              original_mask);
+    for (const double radius_in_cells : {0.5, 1.0, 1.5, 2.3})
+    {
+      const double radius = radius_in_cells * map.GetResolution();
+      const std::vector<uint8_t> dilated_mask
+          = BruteForceGrowMask(map, original_mask, radius_in_cells, 1u);
+      const std::vector<uint8_t> eroded_mask
+          = BruteForceGrowMask(map, original_mask, radius_in_cells, 0u);
+      const std::vector<uint8_t> opened_mask
+          = BruteForceGrowMask(map, eroded_mask, radius_in_cells, 1u);
+      const std::vector<uint8_t> closed_mask
+          = BruteForceGrowMask(map, dilated_mask, radius_in_cells, 0u);
+      for (const bool use_parallel : {false, true})
+      {
+        CheckResult(map, original_mask, dilated_mask,
+                    collision_map_morphology::Dilate(
+                        map, radius, unknown_is_filled, use_parallel));
+        CheckResult(map, original_mask, eroded_mask,
+                    collision_map_morphology::Erode(
+                        map, radius, unknown_is_filled, use_parallel));
+        CheckResult(map, original_mask, opened_mask,
+                    collision_map_morphology::Open(
+                        map, radius, unknown_is_filled, use_parallel));
+        CheckResult(map, original_mask, closed_mask,
+                    collision_map_morphology::Close(
+                        map, radius, unknown_is_filled, use_parallel));
+      }
+    }
+  }
+}
+
+GTEST_TEST(CollisionMapMorphologyTest, ErodingUnknownCellsLeavesThemUnknown)
+{
+  const GridSizes sizes(
+      0.1, static_cast<int64_t>(5), static_cast<int64_t>(5),
+      static_cast<int64_t>(5));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  map.SetValue(2, 2, 2, CollisionCell(0.5f));
+  map.SetValue(2, 2, 3, CollisionCell(1.0f));
+  const CollisionMap eroded
+      = collision_map_morphology::Erode(map, 0.1, true, false);
+  EXPECT_EQ(eroded.GetImmutable(2, 2, 2).Value().Occupancy(), 0.5f);
+  EXPECT_EQ(eroded.GetImmutable(2, 2, 3).Value().Occupancy(), 0.0f);
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,163 @@
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/copy_on_write_tiled_vector.hpp>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using TestTiledVector = CopyOnWriteTiledVector<int32_t, 4>;
+
+TestTiledVector MakeSequence(const size_t size)
+{
+  TestTiledVector values(size);
+  for (size_t idx = 0; idx < size; idx++)
+  {
+    values[idx] = static_cast<int32_t>(idx);
+  }
+  return values;
+}
+
+GTEST_TEST(CopyOnWriteTiledVectorTest, CopiesShareTilesUntilWritten)
+{
+  const TestTiledVector original = MakeSequence(10);
+  ASSERT_EQ(original.size(), 10u);
+  ASSERT_EQ(original.NumTiles(), 3u);
+  EXPECT_EQ(original.NumSharedTiles(), 0u);
+
+  TestTiledVector copy = original;
+  EXPECT_EQ(original.NumSharedTiles(), 3u);
+  EXPECT_EQ(copy.NumSharedTiles(), 3u);
+
+  // Writing an element only duplicates its tile.
+  copy[5] = -5;
+  EXPECT_EQ(copy[5], -5);
+  EXPECT_EQ(original[5], 5);
+  EXPECT_TRUE(copy.IsTileShared(0));
+  EXPECT_FALSE(copy.IsTileShared(1));
+  EXPECT_TRUE(copy.IsTileShared(2));
+  EXPECT_EQ(original.NumSharedTiles(), 2u);
+  for (size_t idx = 0; idx < original.size(); idx++)
+  {
+    EXPECT_EQ(original[idx], static_cast<int32_t>(idx));
+  }
+
+  copy.MakeUnique();
+  EXPECT_EQ(copy.NumSharedTiles(), 0u);
+  EXPECT_EQ(original.NumSharedTiles(), 0u);
+  EXPECT_EQ(copy[9], 9);
+}
+
+GTEST_TEST(CopyOnWriteTiledVectorTest, ResizeAndPushBack)
+{
+  TestTiledVector values = MakeSequence(6);
+  const TestTiledVector copy = values;
+
+  values.resize(9, -1);
+  ASSERT_EQ(values.size(), 9u);
+  EXPECT_EQ(values.NumTiles(), 3u);
+  EXPECT_EQ(values[5], 5);
+  EXPECT_EQ(values[6], -1);
+  EXPECT_EQ(values[8], -1);
+  // The partial last tile grew, so the copy keeps its own.
+  ASSERT_EQ(copy.size(), 6u);
+  EXPECT_EQ(copy.GetImmutableTile(1).size(), 2u);
+  EXPECT_TRUE(copy.IsTileShared(0));
+  EXPECT_FALSE(copy.IsTileShared(1));
+
+  values.push_back(100);
+  ASSERT_EQ(values.size(), 10u);
+  EXPECT_EQ(values.back(), 100);
+
+  values.resize(3);
+  ASSERT_EQ(values.size(), 3u);
+  EXPECT_EQ(values.NumTiles(), 1u);
+  EXPECT_EQ(values.GetImmutableTile(0).size(), 3u);
+  EXPECT_EQ(copy.GetImmutableTile(0).size(), 4u);
+  EXPECT_THROW(values.at(3), std::out_of_range);
+}
+
+GTEST_TEST(CopyOnWriteTiledVectorTest, IteratorsAndVectorExchange)
+{
+  const TestTiledVector values = MakeSequence(11);
+  int32_t expected = 0;
+  for (const int32_t value : values)
+  {
+    EXPECT_EQ(value, expected);
+    expected++;
+  }
+  EXPECT_EQ(expected, 11);
+  EXPECT_EQ(values.end() - values.begin(), 11);
+  EXPECT_EQ(*(values.begin() + 7), 7);
+
+  const std::vector<int32_t> vector_values = values.ToVector();
+  ASSERT_EQ(vector_values.size(), 11u);
+  for (size_t idx = 0; idx < vector_values.size(); idx++)
+  {
+    EXPECT_EQ(vector_values[idx], static_cast<int32_t>(idx));
+  }
+
+  TestTiledVector assigned = values;
+  assigned.Assign(std::vector<int32_t>(5, 3));
+  ASSERT_EQ(assigned.size(), 5u);
+  EXPECT_EQ(assigned.NumTiles(), 2u);
+  EXPECT_EQ(assigned.NumSharedTiles(), 0u);
+  EXPECT_EQ(values.NumSharedTiles(), 0u);
+  EXPECT_EQ(assigned[4], 3);
+
+  assigned.Assign(std::vector<int32_t>());
+  EXPECT_TRUE(assigned.empty());
+  EXPECT_EQ(assigned.NumTiles(), 0u);
+}
+
+GTEST_TEST(CopyOnWriteTiledVectorTest, SignedDistanceFieldCopiesShareTiles)
+{
+  // Three tiles of cells, the last one partial.
+  const common_robotics_utilities::voxel_grid::GridSizes sizes(
+      0.1, static_cast<int64_t>(20), static_cast<int64_t>(20),
+      static_cast<int64_t>(21));
+  CopyOnWriteSignedDistanceField sdf(
+      Eigen::Isometry3d::Identity(), "world", sizes, 1.0f);
+  ASSERT_EQ(sdf.GetImmutableRawData().NumTiles(), 3u);
+
+  CopyOnWriteSignedDistanceField copy = sdf;
+  EXPECT_EQ(sdf.GetImmutableRawData().NumSharedTiles(), 3u);
+  ASSERT_TRUE(copy.SetValue(0, 0, 0, -1.0f));
+  EXPECT_EQ(copy.GetImmutable(0, 0, 0).Value(), -1.0f);
+  EXPECT_EQ(sdf.GetImmutable(0, 0, 0).Value(), 1.0f);
+  EXPECT_FALSE(copy.GetImmutableRawData().IsTileShared(0));
+  EXPECT_TRUE(copy.GetImmutableRawData().IsTileShared(1));
+  EXPECT_TRUE(copy.GetImmutableRawData().IsTileShared(2));
+
+  // Clones (snapshots) share tiles in the same way.
+  const auto clone = sdf.Clone();
+  EXPECT_EQ(sdf.GetImmutableRawData().NumSharedTiles(), 3u);
+  ASSERT_TRUE(sdf.SetValue(19, 19, 20, 2.0f));
+  EXPECT_EQ(clone->GetImmutable(19, 19, 20).Value(), 1.0f);
+  EXPECT_FALSE(sdf.GetImmutableRawData().IsTileShared(2));
+  EXPECT_TRUE(clone->GetImmutableRawData().IsTileShared(0));
+  EXPECT_TRUE(clone->GetImmutableRawData().IsTileShared(1));
+
+  // Serialization round-trips the tiled storage.
+  std::vector<uint8_t> buffer;
+  CopyOnWriteSignedDistanceField::Serialize(sdf, buffer);
+  const CopyOnWriteSignedDistanceField loaded
+      = CopyOnWriteSignedDistanceField::Deserialize(buffer, 0).Value();
+  EXPECT_EQ(loaded.GetFrame(), "world");
+  EXPECT_EQ(loaded.GetImmutable(19, 19, 20).Value(), 2.0f);
+  EXPECT_EQ(loaded.GetImmutable(0, 0, 0).Value(), 1.0f);
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/serialization.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/dirty_tile_tracker.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+/// Regions of the tiles containing any of marked_cells, clipped to the grid,
+/// found by checking every cell of every tile.
+std::vector<GridIndexRegion> BruteForceDirtyTiles(
+    const int64_t num_x_cells, const int64_t num_y_cells,
+    const int64_t num_z_cells, const int64_t tile_size,
+    const std::vector<GridIndex>& marked_cells)
+{
+  std::vector<GridIndexRegion> dirty_tiles;
+  for (int64_t x_lower = 0; x_lower < num_x_cells; x_lower += tile_size)
+  {
+    for (int64_t y_lower = 0; y_lower < num_y_cells; y_lower += tile_size)
+    {
+      for (int64_t z_lower = 0; z_lower < num_z_cells; z_lower += tile_size)
+      {
+        GridIndex upper(x_lower, y_lower, z_lower);
+        bool dirty = false;
+        for (int64_t x_index = x_lower;
+             x_index < x_lower + tile_size && x_index < num_x_cells;
+             x_index++)
+        {
+          for (int64_t y_index = y_lower;
+               y_index < y_lower + tile_size && y_index < num_y_cells;
+               y_index++)
+          {
+            for (int64_t z_index = z_lower;
+                 z_index < z_lower + tile_size && z_index < num_z_cells;
+                 z_index++)
+            {
+              upper = GridIndex(x_index + 1, y_index + 1, z_index + 1);
+              const GridIndex index(x_index, y_index, z_index);
+              dirty |= std::find(marked_cells.begin(), marked_cells.end(),
+                                 index) != marked_cells.end();
+            }
+          }
+        }
+        if (dirty)
+        {
+          dirty_tiles.emplace_back(GridIndex(x_lower, y_lower, z_lower),
+                                   upper);
+        }
+      }
+    }
+  }
+  return dirty_tiles;
+}
+
+void ExpectSameRegions(const std::vector<GridIndexRegion>& regions,
+                       const std::vector<GridIndexRegion>& expected)
+{
+  ASSERT_EQ(regions.size(), expected.size());
+  for (size_t idx = 0; idx < regions.size(); idx++)
+  {
+    EXPECT_EQ(regions[idx].Lower(), expected[idx].Lower());
+    EXPECT_EQ(regions[idx].Upper(), expected[idx].Upper());
+  }
+}
+
+GTEST_TEST(DirtyTileTrackerTest, TilesAreClippedToGrid)
+{
+  DirtyTileTracker tracker(7, 6, 5, 4);
+  EXPECT_TRUE(tracker.IsEnabled());
+  EXPECT_FALSE(tracker.HasDirtyTiles());
+
+  // The upper corner tile covers only the cells left in the grid.
+  tracker.MarkCell(6, 5, 4);
+  ExpectSameRegions(tracker.GetDirtyTiles(), {GridIndexRegion(
+      GridIndex(4, 4, 4), GridIndex(7, 6, 5))});
+
+  // Out-of-bounds cells are ignored.
+  tracker.Clear();
+  tracker.MarkCell(-1, 0, 0);
+  tracker.MarkCell(7, 0, 0);
+  tracker.MarkCell(0, 6, 0);
+  tracker.MarkCell(0, 0, 5);
+  EXPECT_FALSE(tracker.HasDirtyTiles());
+
+  // Regions partly outside the grid mark the tiles of the cells inside it.
+  const GridIndexRegion region(GridIndex(-2, 3, 3), GridIndex(5, 9, 9));
+  std::vector<GridIndex> region_cells;
+  for (int64_t x_index = 0; x_index < 7; x_index++)
+  {
+    for (int64_t y_index = 0; y_index < 6; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < 5; z_index++)
+      {
+        const GridIndex index(x_index, y_index, z_index);
+        if (region.Contains(index))
+        {
+          region_cells.push_back(index);
+        }
+      }
+    }
+  }
+  tracker.MarkRegion(region);
+  ExpectSameRegions(tracker.GetDirtyTiles(),
+                    BruteForceDirtyTiles(7, 6, 5, 4, region_cells));
+
+  // Every cell is covered by exactly one tile.
+  tracker.MarkAll();
+  const std::vector<GridIndexRegion> all_tiles = tracker.GetDirtyTiles();
+  ASSERT_EQ(all_tiles.size(), 8u);
+  int64_t total_cells = 0;
+  for (const GridIndexRegion& tile : all_tiles)
+  {
+    total_cells += tile.TotalCells();
+    EXPECT_LE(tile.Upper().X(), 7);
+    EXPECT_LE(tile.Upper().Y(), 6);
+    EXPECT_LE(tile.Upper().Z(), 5);
+  }
+  EXPECT_EQ(total_cells, 7 * 6 * 5);
+
+  // A default-constructed tracker ignores marks.
+  DirtyTileTracker disabled;
+  EXPECT_FALSE(disabled.IsEnabled());
+  disabled.MarkCell(0, 0, 0);
+  disabled.MarkDataIndex(0);
+  disabled.MarkRegion(region);
+  EXPECT_FALSE(disabled.HasDirtyTiles());
+  EXPECT_TRUE(disabled.GetDirtyTiles().empty());
+}
+
+GTEST_TEST(DirtyTileTrackerTest, MarkDataIndexDecodesCell)
+{
+  // Data indices of the x-major, z-minor backing store run over z fastest.
+  int64_t data_index = 0;
+  for (int64_t x_index = 0; x_index < 7; x_index++)
+  {
+    for (int64_t y_index = 0; y_index < 6; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < 5; z_index++)
+      {
+        DirtyTileTracker tracker(7, 6, 5, 2);
+        tracker.MarkDataIndex(data_index);
+        ExpectSameRegions(tracker.GetDirtyTiles(), BruteForceDirtyTiles(
+            7, 6, 5, 2, {GridIndex(x_index, y_index, z_index)}));
+        data_index++;
+      }
+    }
+  }
+  DirtyTileTracker tracker(7, 6, 5, 2);
+  tracker.MarkDataIndex(-1);
+  tracker.MarkDataIndex(7 * 6 * 5);
+  EXPECT_FALSE(tracker.HasDirtyTiles());
+}
+
+GTEST_TEST(DirtyTileTrackerTest, CollisionMapMarksMutableAccess)
+{
+  const GridSizes sizes(
+      0.1, static_cast<int64_t>(7), static_cast<int64_t>(6),
+      static_cast<int64_t>(5));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  // Tracking is off by default.
+  EXPECT_FALSE(map.IsDirtyTileTrackingEnabled());
+  map.SetValue(1, 1, 1, CollisionCell(1.0f));
+  EXPECT_FALSE(map.HasDirtyTiles());
+
+  map.EnableDirtyTileTracking(4);
+  EXPECT_TRUE(map.IsDirtyTileTrackingEnabled());
+  EXPECT_EQ(map.GetDirtyTileSize(), 4);
+  EXPECT_FALSE(map.HasDirtyTiles());
+
+  // Immutable access does not mark tiles, mutable access does.
+  EXPECT_EQ(map.GetImmutable(6, 5, 4).Value().Occupancy(), 0.0f);
+  EXPECT_FALSE(map.HasDirtyTiles());
+  map.SetValue(1, 1, 1, CollisionCell(0.0f));
+  map.GetMutable(6, 5, 4).Value().Occupancy() = 1.0f;
+  EXPECT_FALSE(map.SetValue(7, 0, 0, CollisionCell(1.0f)));
+  ExpectSameRegions(map.GetDirtyTiles(), BruteForceDirtyTiles(
+      7, 6, 5, 4, {GridIndex(1, 1, 1), GridIndex(6, 5, 4)}));
+
+  map.ClearDirtyTiles();
+  EXPECT_FALSE(map.HasDirtyTiles());
+  map.DisableDirtyTileTracking();
+  EXPECT_FALSE(map.IsDirtyTileTrackingEnabled());
+  map.SetValue(1, 1, 1, CollisionCell(1.0f));
+  EXPECT_FALSE(map.HasDirtyTiles());
+}
+
+GTEST_TEST(DirtyTileTrackerTest, DeserializeMarksEveryTileDirty)
+{
+  const GridSizes source_sizes(
+      0.1, static_cast<int64_t>(9), static_cast<int64_t>(3),
+      static_cast<int64_t>(6));
+  CollisionMap source(Eigen::Isometry3d::Identity(), "world", source_sizes,
+                      CollisionCell(0.0f));
+  source.SetValue(2, 1, 3, CollisionCell(1.0f));
+  std::vector<uint8_t> buffer;
+  CollisionMap::Serialize(source, buffer);
+
+  // Loading into a tracking map keeps tracking with the same tile size,
+  // resized to the loaded grid, with every tile dirty.
+  const GridSizes sizes(
+      0.1, static_cast<int64_t>(7), static_cast<int64_t>(6),
+      static_cast<int64_t>(5));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  map.EnableDirtyTileTracking(4);
+  map.DeserializeSelf(
+      buffer, 0,
+      common_robotics_utilities::serialization
+          ::DeserializeMemcpyable<CollisionCell>);
+  ASSERT_EQ(map.GetNumXCells(), 9);
+  EXPECT_TRUE(map.IsDirtyTileTrackingEnabled());
+  EXPECT_EQ(map.GetDirtyTileSize(), 4);
+  std::vector<GridIndex> all_cells;
+  for (int64_t x_index = 0; x_index < 9; x_index++)
+  {
+    for (int64_t y_index = 0; y_index < 3; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < 6; z_index++)
+      {
+        all_cells.emplace_back(x_index, y_index, z_index);
+      }
+    }
+  }
+  ExpectSameRegions(map.GetDirtyTiles(),
+                    BruteForceDirtyTiles(9, 3, 6, 4, all_cells));
+
+  // Loading into a map without tracking does not enable it.
+  const CollisionMap loaded = CollisionMap::Deserialize(buffer, 0).Value();
+  EXPECT_FALSE(loaded.IsDirtyTileTrackingEnabled());
+  EXPECT_FALSE(loaded.HasDirtyTiles());
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/dynamic_spatial_hashed_voxel_grid.hpp>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/chunk_pool_allocator.hpp>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/dynamic_spatial_hashed_collision_map.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::DSHVGFoundStatus;
+using common_robotics_utilities::voxel_grid::DSHVGSetType;
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+constexpr double kResolution = 0.25;
+constexpr int64_t kChunkCells = 8;
+
+/// Center of the cell with the provided (possibly negative) cell indices.
+Eigen::Vector4d CellCenter(
+    const int64_t x_index, const int64_t y_index, const int64_t z_index)
+{
+  return Eigen::Vector4d((static_cast<double>(x_index) + 0.5) * kResolution,
+                         (static_cast<double>(y_index) + 0.5) * kResolution,
+                         (static_cast<double>(z_index) + 0.5) * kResolution,
+                         1.0);
+}
+
+GTEST_TEST(DynamicSpatialHashedCollisionMapTest, ConcurrentSetValue)
+{
+  const GridSizes chunk_sizes(
+      kResolution, kChunkCells, kChunkCells, kChunkCells);
+  DynamicSpatialHashedCollisionMap map(
+      chunk_sizes, CollisionCell(0.5f), 16, "world");
+  // A CHUNK_FILLED chunk at negative cell indices, which every thread below
+  // writes into, forcing one of them to expand it to CELL_FILLED.
+  map.SetValue4d(CellCenter(-kChunkCells, -kChunkCells, -kChunkCells),
+                 DSHVGSetType::SET_CHUNK, CollisionCell(1.0f));
+
+  // Each thread writes its own cells, spread over the filled chunk, its
+  // neighbors across the chunk boundaries at zero, and unallocated chunks.
+  // The lower corner of the filled chunk is left unwritten.
+  constexpr int64_t kNumThreads = 8;
+  const int64_t lower_index = -kChunkCells - 2;
+  const int64_t upper_index = 2;
+  const auto is_unwritten = [] (const int64_t x_index, const int64_t y_index,
+                                const int64_t z_index)
+  {
+    return x_index == -kChunkCells && y_index == -kChunkCells
+           && z_index == -kChunkCells;
+  };
+  const auto is_written_by = [] (const int64_t x_index, const int64_t y_index,
+                                 const int64_t z_index)
+  {
+    const int64_t sum = x_index + (3 * y_index) + (7 * z_index);
+    return ((sum % kNumThreads) + kNumThreads) % kNumThreads;
+  };
+  const auto write_cells = [&] (const int64_t thread_index)
+  {
+    for (int64_t x_index = lower_index; x_index < upper_index; x_index++)
+    {
+      for (int64_t y_index = lower_index; y_index < upper_index; y_index++)
+      {
+        for (int64_t z_index = lower_index; z_index < upper_index; z_index++)
+        {
+          if (!is_unwritten(x_index, y_index, z_index)
+              && is_written_by(x_index, y_index, z_index) == thread_index)
+          {
+            map.ConcurrentSetValue4d(
+                CellCenter(x_index, y_index, z_index), DSHVGSetType::SET_CELL,
+                CollisionCell(0.0f, static_cast<uint32_t>(thread_index + 1)));
+          }
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int64_t thread_index = 0; thread_index < kNumThreads; thread_index++)
+  {
+    threads.emplace_back(write_cells, thread_index);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (int64_t x_index = lower_index; x_index < upper_index; x_index++)
+  {
+    for (int64_t y_index = lower_index; y_index < upper_index; y_index++)
+    {
+      for (int64_t z_index = lower_index; z_index < upper_index; z_index++)
+      {
+        if (is_unwritten(x_index, y_index, z_index))
+        {
+          continue;
+        }
+        const auto cell
+            = map.ConcurrentGetValue4d(CellCenter(x_index, y_index, z_index));
+        ASSERT_TRUE(cell.HasValue());
+        EXPECT_EQ(cell.Value().Occupancy(), 0.0f);
+        EXPECT_EQ(cell.Value().Component(),
+                  static_cast<uint32_t>(
+                      is_written_by(x_index, y_index, z_index) + 1));
+      }
+    }
+  }
+  // Cells of the expanded chunk that were not written keep the chunk value.
+  const auto unwritten_query = map.GetImmutable4d(
+      CellCenter(-kChunkCells, -kChunkCells, -kChunkCells));
+  ASSERT_EQ(unwritten_query.FoundStatus(), DSHVGFoundStatus::FOUND_IN_CELL);
+  EXPECT_EQ(unwritten_query.Value().Occupancy(), 1.0f);
+}
+
+GTEST_TEST(DynamicSpatialHashedCollisionMapTest, ExportImportRoundTrip)
+{
+  const GridSizes chunk_sizes(
+      kResolution, kChunkCells, kChunkCells, kChunkCells);
+  const CollisionCell default_cell(0.5f);
+  DynamicSpatialHashedCollisionMap map(
+      chunk_sizes, default_cell, 16, "world");
+  // One CHUNK_FILLED chunk, and a sparse set of cells in CELL_FILLED chunks
+  // on both sides of the origin.
+  map.SetValue4d(CellCenter(-kChunkCells, 0, 0), DSHVGSetType::SET_CHUNK,
+                 CollisionCell(1.0f, 7u));
+  for (int64_t index = -11; index < 11; index += 3)
+  {
+    map.SetValue4d(CellCenter(index, -index, index / 2),
+                   DSHVGSetType::SET_CELL,
+                   CollisionCell(0.0f, static_cast<uint32_t>(index + 20)));
+  }
+  const auto expected_cell = [&] (const int64_t x_index,
+                                  const int64_t y_index,
+                                  const int64_t z_index)
+  {
+    const auto query = map.GetImmutable4d(
+        CellCenter(x_index, y_index, z_index));
+    return (query) ? query.Value() : default_cell;
+  };
+
+  // The region cuts through chunks, includes unallocated chunks, and covers
+  // the CHUNK_FILLED chunk entirely.
+  const GridIndexRegion region(
+      GridIndex(-13, -10, -6), GridIndex(12, 9, 9));
+  const CollisionMap exported = map.ExportRegion(region);
+  ASSERT_EQ(exported.GetNumXCells(), region.NumXCells());
+  ASSERT_EQ(exported.GetNumYCells(), region.NumYCells());
+  ASSERT_EQ(exported.GetNumZCells(), region.NumZCells());
+  for (int64_t x_index = region.Lower().X(); x_index < region.Upper().X();
+       x_index++)
+  {
+    for (int64_t y_index = region.Lower().Y(); y_index < region.Upper().Y();
+         y_index++)
+    {
+      for (int64_t z_index = region.Lower().Z();
+           z_index < region.Upper().Z(); z_index++)
+      {
+        const CollisionCell& cell = exported.GetImmutable(
+            x_index - region.Lower().X(), y_index - region.Lower().Y(),
+            z_index - region.Lower().Z()).Value();
+        const CollisionCell expected
+            = expected_cell(x_index, y_index, z_index);
+        EXPECT_EQ(cell.Occupancy(), expected.Occupancy());
+        EXPECT_EQ(cell.Component(), expected.Component());
+      }
+    }
+  }
+
+  // Importing into an empty map reproduces the region, and stores a chunk
+  // covered by one value as CHUNK_FILLED.
+  DynamicSpatialHashedCollisionMap imported(
+      chunk_sizes, default_cell, 16, "world");
+  imported.ImportRegion(region, exported);
+  for (int64_t x_index = region.Lower().X(); x_index < region.Upper().X();
+       x_index++)
+  {
+    for (int64_t y_index = region.Lower().Y(); y_index < region.Upper().Y();
+         y_index++)
+    {
+      for (int64_t z_index = region.Lower().Z();
+           z_index < region.Upper().Z(); z_index++)
+      {
+        const auto query = imported.GetImmutable4d(
+            CellCenter(x_index, y_index, z_index));
+        ASSERT_TRUE(query);
+        const CollisionCell expected
+            = expected_cell(x_index, y_index, z_index);
+        EXPECT_EQ(query.Value().Occupancy(), expected.Occupancy());
+        EXPECT_EQ(query.Value().Component(), expected.Component());
+      }
+    }
+  }
+  EXPECT_EQ(imported.GetImmutable4d(
+                CellCenter(-kChunkCells, 0, 0)).FoundStatus(),
+            DSHVGFoundStatus::FOUND_IN_CHUNK);
+  // Cells outside the region are untouched.
+  const auto outside_query = imported.GetImmutable4d(CellCenter(12, 0, 0));
+  if (outside_query)
+  {
+    EXPECT_EQ(outside_query.Value().Occupancy(), default_cell.Occupancy());
+  }
+}
+
+GTEST_TEST(DynamicSpatialHashedCollisionMapTest, ExtractSignedDistanceField)
+{
+  const GridSizes chunk_sizes(
+      kResolution, static_cast<int64_t>(4), static_cast<int64_t>(4),
+      static_cast<int64_t>(4));
+  DynamicSpatialHashedCollisionMap map(
+      chunk_sizes, CollisionCell(0.0f), 16, "world");
+  // Obstacles in separate chunks, one of them uniformly filled, plus an
+  // allocated chunk that only holds free cells.
+  map.SetValue4d(CellCenter(1, 2, 3), DSHVGSetType::SET_CELL,
+                 CollisionCell(1.0f));
+  map.SetValue4d(CellCenter(-6, 5, 0), DSHVGSetType::SET_CELL,
+                 CollisionCell(1.0f));
+  map.SetValue4d(CellCenter(8, -4, 2), DSHVGSetType::SET_CHUNK,
+                 CollisionCell(1.0f));
+  map.SetValue4d(CellCenter(-20, -20, -20), DSHVGSetType::SET_CELL,
+                 CollisionCell(0.2f));
+  const double truncation_distance = 0.6;
+  const auto sparse_sdf
+      = map.ExtractSignedDistanceField(truncation_distance, false, true);
+
+  // Compare against a dense SDF of a region large enough that distances near
+  // the obstacles are exact.
+  const GridIndexRegion compared_region(
+      GridIndex(-12, -12, -8), GridIndex(16, 12, 12));
+  const CollisionMap dense_map
+      = map.ExportRegion(compared_region.Expanded(8));
+  const auto dense_sdf_result = dense_map.ExtractSignedDistanceField(
+      std::numeric_limits<float>::infinity(), false, false, false);
+  const auto& dense_sdf = dense_sdf_result.DistanceField();
+  const float truncation = static_cast<float>(truncation_distance);
+  for (int64_t x_index = compared_region.Lower().X();
+       x_index < compared_region.Upper().X(); x_index++)
+  {
+    for (int64_t y_index = compared_region.Lower().Y();
+         y_index < compared_region.Upper().Y(); y_index++)
+    {
+      for (int64_t z_index = compared_region.Lower().Z();
+           z_index < compared_region.Upper().Z(); z_index++)
+      {
+        const float dense_distance = dense_sdf.GetImmutable(
+            x_index - compared_region.Lower().X() + 8,
+            y_index - compared_region.Lower().Y() + 8,
+            z_index - compared_region.Lower().Z() + 8).Value();
+        const float expected_distance
+            = std::max(-truncation, std::min(truncation, dense_distance));
+        EXPECT_NEAR(
+            sparse_sdf.GetDistance4d(CellCenter(x_index, y_index, z_index)),
+            expected_distance, 1e-5f);
+      }
+    }
+  }
+  // Far from every obstacle, including in the free allocated chunk, the
+  // distance is the unallocated distance.
+  EXPECT_EQ(sparse_sdf.GetDistance4d(CellCenter(-20, -20, -20)), truncation);
+  EXPECT_EQ(sparse_sdf.GetDistance4d(CellCenter(100, 0, 0)), truncation);
+}
+
+GTEST_TEST(DynamicSpatialHashedCollisionMapTest, AutoCollapseReleasesStorage)
+{
+  // An unusual chunk size, so no other chunks share its pool slabs.
+  const GridSizes chunk_sizes(kResolution, kChunkCells, kChunkCells, 9);
+  DynamicSpatialHashedCollisionMap map(
+      chunk_sizes, CollisionCell(0.5f), 16, "world");
+  map.SetAutoCollapseBatchSize(1);
+  // Writes through the base class are recorded too.
+  common_robotics_utilities::voxel_grid::DynamicSpatialHashedVoxelGridBase<
+      CollisionCell, DSHCollisionCellBackingStore>& base_map = map;
+  ChunkMemoryPool::Instance().ReleaseUnusedSlabs();
+  const size_t initial_bytes = ChunkMemoryPool::Instance().TotalBytes();
+  const size_t chunk_bytes = static_cast<size_t>(chunk_sizes.TotalCells())
+                             * sizeof(CollisionCell);
+
+  // Fill every cell of one chunk, one cell at a time.
+  size_t filled_bytes = 0;
+  for (int64_t x_index = 0; x_index < chunk_sizes.NumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < chunk_sizes.NumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < chunk_sizes.NumZCells(); z_index++)
+      {
+        base_map.SetValue4d(CellCenter(x_index, y_index, z_index),
+                            DSHVGSetType::SET_CELL, CollisionCell(1.0f));
+        filled_bytes = std::max(
+            filled_bytes, ChunkMemoryPool::Instance().TotalBytes());
+      }
+    }
+  }
+  EXPECT_GE(filled_bytes, initial_bytes + chunk_bytes);
+  EXPECT_EQ(map.GetImmutable4d(CellCenter(3, 4, 5)).FoundStatus(),
+            DSHVGFoundStatus::FOUND_IN_CELL);
+
+  // The chunk became uniform with the last write, so the next mutable access
+  // (here, to another chunk) collapses it and returns its cell storage to
+  // the system allocator.
+  base_map.GetMutable4d(CellCenter(-1, -1, -1));
+  const auto query = map.GetImmutable4d(CellCenter(3, 4, 5));
+  ASSERT_TRUE(query);
+  EXPECT_EQ(query.FoundStatus(), DSHVGFoundStatus::FOUND_IN_CHUNK);
+  EXPECT_EQ(query.Value().Occupancy(), 1.0f);
+  EXPECT_LE(ChunkMemoryPool::Instance().TotalBytes() + chunk_bytes,
+            filled_bytes);
+  EXPECT_EQ(map.CollapseUniformChunks(), 0u);
+}
+
+GTEST_TEST(DynamicSpatialHashedCollisionMapTest, PoolReleasesEmptySlabs)
+{
+  // An unusual block size, so no other allocations share its slabs.
+  const size_t block_bytes = 40000 + 24;
+  ChunkMemoryPool& pool = ChunkMemoryPool::Instance();
+  pool.ReleaseUnusedSlabs();
+  const size_t initial_bytes = pool.TotalBytes();
+  std::vector<void*> blocks;
+  size_t allocated_bytes = initial_bytes;
+  while (allocated_bytes < initial_bytes + (3 * ChunkMemoryPool::kSlabBytes))
+  {
+    blocks.push_back(pool.Allocate(block_bytes));
+    allocated_bytes = pool.TotalBytes();
+  }
+  const size_t slab_bytes = (allocated_bytes - initial_bytes) / 4;
+  EXPECT_EQ(allocated_bytes, initial_bytes + (4 * slab_bytes));
+
+  // Slabs are released as soon as they are empty, except for one.
+  for (void* block : blocks)
+  {
+    pool.Deallocate(block, block_bytes);
+  }
+  EXPECT_EQ(pool.TotalBytes(), initial_bytes + slab_bytes);
+
+  // The empty slab is reused, and released on request.
+  void* block = pool.Allocate(block_bytes);
+  EXPECT_EQ(pool.TotalBytes(), initial_bytes + slab_bytes);
+  pool.Deallocate(block, block_bytes);
+  EXPECT_EQ(pool.ReleaseUnusedSlabs(), slab_bytes);
+  EXPECT_EQ(pool.TotalBytes(), initial_bytes);
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
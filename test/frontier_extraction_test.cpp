@@ -0,0 +1,232 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/frontier_extraction.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+/// Map with scattered unknown and filled cells in free space, plus an unknown
+/// block against the upper x border.
+CollisionMap MakeTestMap()
+{
+  const GridSizes sizes(
+      0.1, static_cast<int64_t>(9), static_cast<int64_t>(8),
+      static_cast<int64_t>(7));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+      {
+        const int64_t pattern
+            = ((x_index * 7) + (y_index * 13) + (z_index * 5)) % 23;
+        float occupancy = 0.0f;
+        if (x_index >= 7 && y_index >= 2 && y_index < 6)
+        {
+          occupancy = 0.5f;
+        }
+        else if (pattern < 2)
+        {
+          occupancy = 0.5f;
+        }
+        else if (pattern < 5)
+        {
+          occupancy = 1.0f;
+        }
+        else if (pattern == 5)
+        {
+          occupancy = 0.2f;
+        }
+        map.SetValue(x_index, y_index, z_index, CollisionCell(occupancy));
+      }
+    }
+  }
+  return map;
+}
+
+GridIndex IndexOf(const CollisionMap& map, const int64_t data_index)
+{
+  const int64_t num_y_cells = map.GetNumYCells();
+  const int64_t num_z_cells = map.GetNumZCells();
+  return GridIndex(data_index / (num_y_cells * num_z_cells),
+                   (data_index / num_z_cells) % num_y_cells,
+                   data_index % num_z_cells);
+}
+
+bool BruteForceIsFrontier(const CollisionMap& map, const GridIndex& index)
+{
+  if (!(map.GetImmutable(index).Value().Occupancy() < 0.5f))
+  {
+    return false;
+  }
+  const std::vector<GridIndex> offsets = {
+      GridIndex(-1, 0, 0), GridIndex(1, 0, 0), GridIndex(0, -1, 0),
+      GridIndex(0, 1, 0), GridIndex(0, 0, -1), GridIndex(0, 0, 1)};
+  for (const GridIndex& offset : offsets)
+  {
+    const auto neighbor = map.GetImmutable(
+        index.X() + offset.X(), index.Y() + offset.Y(),
+        index.Z() + offset.Z());
+    if (neighbor && neighbor.Value().Occupancy() == 0.5f)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<int64_t> BruteForceFrontierCells(const CollisionMap& map)
+{
+  std::vector<int64_t> frontier_cells;
+  for (int64_t data_index = 0; data_index < map.GetTotalCells(); data_index++)
+  {
+    if (BruteForceIsFrontier(map, IndexOf(map, data_index)))
+    {
+      frontier_cells.push_back(data_index);
+    }
+  }
+  return frontier_cells;
+}
+
+/// Components of cells connected through faces, edges, or corners, found by
+/// flood fill over every pair of cells.
+std::vector<std::vector<int64_t>> BruteForceClusters(
+    const CollisionMap& map, const std::vector<int64_t>& cells)
+{
+  std::vector<int64_t> labels(cells.size(), -1);
+  std::vector<std::vector<int64_t>> components;
+  for (size_t seed = 0; seed < cells.size(); seed++)
+  {
+    if (labels[seed] >= 0)
+    {
+      continue;
+    }
+    const int64_t label = static_cast<int64_t>(components.size());
+    components.emplace_back();
+    std::vector<size_t> queue = {seed};
+    labels[seed] = label;
+    while (!queue.empty())
+    {
+      const size_t current = queue.back();
+      queue.pop_back();
+      components.back().push_back(cells[current]);
+      const GridIndex current_index = IndexOf(map, cells[current]);
+      for (size_t other = 0; other < cells.size(); other++)
+      {
+        const GridIndex other_index = IndexOf(map, cells[other]);
+        if (labels[other] < 0
+            && std::abs(other_index.X() - current_index.X()) <= 1
+            && std::abs(other_index.Y() - current_index.Y()) <= 1
+            && std::abs(other_index.Z() - current_index.Z()) <= 1)
+        {
+          labels[other] = label;
+          queue.push_back(other);
+        }
+      }
+    }
+    std::sort(components.back().begin(), components.back().end());
+  }
+  return components;
+}
+
+GTEST_TEST(FrontierExtractionTest, WholeMapMatchesBruteForce)
+{
+  const CollisionMap map = MakeTestMap();
+  const std::vector<int64_t> expected = BruteForceFrontierCells(map);
+  ASSERT_FALSE(expected.empty());
+  for (const bool use_parallel : {false, true})
+  {
+    EXPECT_EQ(frontier_extraction::ExtractFrontierCells(map, use_parallel),
+              expected);
+  }
+}
+
+GTEST_TEST(FrontierExtractionTest, RegionsMatchBruteForce)
+{
+  const CollisionMap map = MakeTestMap();
+  const std::vector<int64_t> all_frontier_cells
+      = BruteForceFrontierCells(map);
+  // Overlapping regions, one on the border, and one partly outside the grid.
+  const std::vector<GridIndexRegion> regions = {
+      GridIndexRegion(GridIndex(1, 1, 1), GridIndex(3, 4, 3)),
+      GridIndexRegion(GridIndex(2, 3, 2), GridIndex(5, 5, 4)),
+      GridIndexRegion(GridIndex(0, 0, 5), GridIndex(2, 8, 7)),
+      GridIndexRegion(GridIndex(7, -2, 4), GridIndex(12, 3, 9))};
+  std::vector<int64_t> expected;
+  for (const int64_t data_index : all_frontier_cells)
+  {
+    const GridIndex index = IndexOf(map, data_index);
+    for (const GridIndexRegion& region : regions)
+    {
+      if (region.Expanded(1).Contains(index))
+      {
+        expected.push_back(data_index);
+        break;
+      }
+    }
+  }
+  ASSERT_FALSE(expected.empty());
+  for (const bool use_parallel : {false, true})
+  {
+    EXPECT_EQ(frontier_extraction::ExtractFrontierCells(
+                  map, regions, use_parallel),
+              expected);
+  }
+  EXPECT_TRUE(frontier_extraction::ExtractFrontierCells(
+      map, std::vector<GridIndexRegion>(), false).empty());
+}
+
+GTEST_TEST(FrontierExtractionTest, ClustersMatchBruteForce)
+{
+  const CollisionMap map = MakeTestMap();
+  // Frontiers of the test map are mostly connected, so drop the cells of one
+  // x slice to split them.
+  std::vector<int64_t> frontier_cells;
+  for (const int64_t data_index
+           : frontier_extraction::ExtractFrontierCells(map, false))
+  {
+    if (IndexOf(map, data_index).X() != 3)
+    {
+      frontier_cells.push_back(data_index);
+    }
+  }
+  const std::vector<std::vector<int64_t>> expected
+      = BruteForceClusters(map, frontier_cells);
+  ASSERT_GT(expected.size(), 1u);
+  EXPECT_EQ(frontier_extraction::ClusterFrontierCells(map, frontier_cells),
+            expected);
+
+  // Input order and duplicates do not matter.
+  std::vector<int64_t> shuffled_cells = frontier_cells;
+  std::reverse(shuffled_cells.begin(), shuffled_cells.end());
+  shuffled_cells.push_back(frontier_cells.front());
+  EXPECT_EQ(frontier_extraction::ClusterFrontierCells(map, shuffled_cells),
+            expected);
+
+  EXPECT_THROW(frontier_extraction::ClusterFrontierCells(
+                   map, {map.GetTotalCells()}),
+               std::invalid_argument);
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
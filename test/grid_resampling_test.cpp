@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/grid_resampling.hpp>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+/// Map with sizes that are not multiples of the test factors, so coarse
+/// cells along the upper edges cover partial blocks, and a unique component
+/// per cell.
+CollisionMap MakeTestMap(const Eigen::Isometry3d& origin_transform)
+{
+  const GridSizes sizes(
+      0.5, static_cast<int64_t>(7), static_cast<int64_t>(6),
+      static_cast<int64_t>(5));
+  CollisionMap map(origin_transform, "world", sizes, CollisionCell(0.0f),
+                   CollisionCell(0.5f, 1000u));
+  const std::vector<float> occupancies = {0.0f, 0.2f, 0.5f, 0.7f, 1.0f};
+  for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+      {
+        const int64_t pattern
+            = ((x_index * 7) + (y_index * 13) + (z_index * 5)) % 17;
+        const float occupancy
+            = (pattern < 10) ? 0.0f
+                             : occupancies[static_cast<size_t>(pattern % 5)];
+        const uint32_t component = static_cast<uint32_t>(
+            1 + (x_index * 100) + (y_index * 10) + z_index);
+        map.SetValue(x_index, y_index, z_index,
+                     CollisionCell(occupancy, component));
+      }
+    }
+  }
+  return map;
+}
+
+/// Distance from location (in the grid frame) to the nearest obstacle point.
+double BruteForceDistance(
+    const std::vector<Eigen::Vector3d>& obstacles,
+    const Eigen::Vector3d& location)
+{
+  double distance = std::numeric_limits<double>::infinity();
+  for (const Eigen::Vector3d& obstacle : obstacles)
+  {
+    distance = std::min(distance, (obstacle - location).norm());
+  }
+  return distance;
+}
+
+/// Center of a cell in the grid frame.
+Eigen::Vector3d CellCenter(
+    const double resolution, const int64_t x_index, const int64_t y_index,
+    const int64_t z_index)
+{
+  return Eigen::Vector3d(static_cast<double>(x_index) + 0.5,
+                         static_cast<double>(y_index) + 0.5,
+                         static_cast<double>(z_index) + 0.5) * resolution;
+}
+
+GTEST_TEST(GridResamplingTest, DownsampleTakesMaxOccupancy)
+{
+  const CollisionMap map = MakeTestMap(Eigen::Isometry3d::Identity());
+  for (const int64_t factor : {1, 2, 3, 4})
+  {
+    for (const bool use_parallel : {false, true})
+    {
+      const CollisionMap coarse
+          = grid_resampling::Downsample(map, factor, use_parallel);
+      ASSERT_EQ(coarse.GetNumXCells(), (7 + factor - 1) / factor);
+      ASSERT_EQ(coarse.GetNumYCells(), (6 + factor - 1) / factor);
+      ASSERT_EQ(coarse.GetNumZCells(), (5 + factor - 1) / factor);
+      EXPECT_DOUBLE_EQ(coarse.GetResolution(),
+                       0.5 * static_cast<double>(factor));
+      EXPECT_TRUE(coarse.GetOriginTransform().isApprox(
+          map.GetOriginTransform()));
+      std::vector<float> expected(
+          static_cast<size_t>(coarse.GetTotalCells()), -1.0f);
+      for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+      {
+        for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+        {
+          for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+          {
+            const size_t coarse_data_index = static_cast<size_t>(
+                coarse.GridIndexToDataIndex(
+                    x_index / factor, y_index / factor, z_index / factor));
+            expected[coarse_data_index] = std::max(
+                expected[coarse_data_index],
+                map.GetImmutable(x_index, y_index, z_index).Value()
+                    .Occupancy());
+          }
+        }
+      }
+      const CollisionMapBackingStore& coarse_cells
+          = coarse.GetImmutableRawData();
+      for (size_t data_index = 0; data_index < expected.size(); data_index++)
+      {
+        ASSERT_EQ(coarse_cells[data_index].Occupancy(), expected[data_index])
+            << "factor " << factor << " data_index " << data_index;
+        ASSERT_EQ(coarse_cells[data_index].Component(), 0u);
+      }
+    }
+  }
+}
+
+GTEST_TEST(GridResamplingTest, UpsampleCopiesOccupancy)
+{
+  const CollisionMap map = MakeTestMap(Eigen::Isometry3d::Identity());
+  for (const int64_t factor : {1, 2, 3})
+  {
+    for (const bool use_parallel : {false, true})
+    {
+      const CollisionMap fine
+          = grid_resampling::Upsample(map, factor, use_parallel);
+      ASSERT_EQ(fine.GetNumXCells(), 7 * factor);
+      ASSERT_EQ(fine.GetNumYCells(), 6 * factor);
+      ASSERT_EQ(fine.GetNumZCells(), 5 * factor);
+      for (int64_t x_index = 0; x_index < fine.GetNumXCells(); x_index++)
+      {
+        for (int64_t y_index = 0; y_index < fine.GetNumYCells(); y_index++)
+        {
+          for (int64_t z_index = 0; z_index < fine.GetNumZCells(); z_index++)
+          {
+            ASSERT_EQ(
+                fine.GetImmutable(x_index, y_index, z_index).Value()
+                    .Occupancy(),
+                map.GetImmutable(x_index / factor, y_index / factor,
+                                 z_index / factor).Value().Occupancy());
+          }
+        }
+      }
+    }
+  }
+}
+
+GTEST_TEST(GridResamplingTest, ResampledDistancesAreLowerBounds)
+{
+  // Fine distances are exact distances to obstacle points, which change by at
+  // most the distance moved, as SDF distances do.
+  const std::vector<Eigen::Vector3d> obstacles = {
+      Eigen::Vector3d(0.83, 1.27, 0.41), Eigen::Vector3d(2.96, 0.38, 2.12),
+      Eigen::Vector3d(1.71, 2.64, 1.93)};
+  const GridSizes sizes(
+      0.25, static_cast<int64_t>(13), static_cast<int64_t>(11),
+      static_cast<int64_t>(10));
+  SignedDistanceField<std::vector<float>> sdf(
+      Eigen::Isometry3d::Identity(), "world", sizes, 0.0f,
+      std::numeric_limits<float>::infinity());
+  for (int64_t x_index = 0; x_index < sdf.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < sdf.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < sdf.GetNumZCells(); z_index++)
+      {
+        sdf.SetValue(x_index, y_index, z_index, static_cast<float>(
+            BruteForceDistance(obstacles, CellCenter(
+                sdf.GetResolution(), x_index, y_index, z_index))));
+      }
+    }
+  }
+  const double tolerance = 1e-5;
+  for (const int64_t factor : {2, 3, 4})
+  {
+    for (const bool use_parallel : {false, true})
+    {
+      // Coarse distances never exceed the true distance, and are off by at
+      // most twice the largest center offset within a block.
+      const SignedDistanceField<std::vector<float>> coarse
+          = grid_resampling::Downsample(sdf, factor, use_parallel);
+      const double max_center_offset
+          = std::sqrt(3.0) * (static_cast<double>(factor - 1) * 0.5)
+            * sdf.GetResolution();
+      for (int64_t x_index = 0; x_index < coarse.GetNumXCells(); x_index++)
+      {
+        for (int64_t y_index = 0; y_index < coarse.GetNumYCells(); y_index++)
+        {
+          for (int64_t z_index = 0; z_index < coarse.GetNumZCells();
+               z_index++)
+          {
+            const double distance = static_cast<double>(
+                coarse.GetImmutable(x_index, y_index, z_index).Value());
+            const double true_distance = BruteForceDistance(
+                obstacles, CellCenter(coarse.GetResolution(),
+                                      x_index, y_index, z_index));
+            ASSERT_LE(distance, true_distance + tolerance);
+            ASSERT_GE(distance,
+                      true_distance - (2.0 * max_center_offset) - tolerance);
+          }
+        }
+      }
+
+      const SignedDistanceField<std::vector<float>> fine
+          = grid_resampling::Upsample(coarse, factor, use_parallel);
+      for (int64_t x_index = 0; x_index < fine.GetNumXCells(); x_index++)
+      {
+        for (int64_t y_index = 0; y_index < fine.GetNumYCells(); y_index++)
+        {
+          for (int64_t z_index = 0; z_index < fine.GetNumZCells(); z_index++)
+          {
+            const double distance = static_cast<double>(
+                fine.GetImmutable(x_index, y_index, z_index).Value());
+            const double true_distance = BruteForceDistance(
+                obstacles, CellCenter(fine.GetResolution(),
+                                      x_index, y_index, z_index));
+            ASSERT_LE(distance, true_distance + tolerance);
+          }
+        }
+      }
+    }
+  }
+}
+
+GTEST_TEST(GridResamplingTest, RegridMatchesLocationLookup)
+{
+  Eigen::Isometry3d source_origin = Eigen::Isometry3d::Identity();
+  source_origin.translation() = Eigen::Vector3d(0.31, -0.47, 0.12);
+  source_origin.linear()
+      = Eigen::AngleAxisd(0.37, Eigen::Vector3d(0.2, 0.9, 0.4).normalized())
+          .toRotationMatrix();
+  const CollisionMap map = MakeTestMap(source_origin);
+  // The new grid is rotated relative to the source grid and extends beyond
+  // it, so some of its cells are out of bounds of the source.
+  Eigen::Isometry3d new_origin = Eigen::Isometry3d::Identity();
+  new_origin.translation() = Eigen::Vector3d(-0.23, -0.81, -0.36);
+  new_origin.linear()
+      = Eigen::AngleAxisd(-0.61, Eigen::Vector3d(0.7, -0.3, 0.6).normalized())
+          .toRotationMatrix();
+  const GridSizes new_sizes(
+      0.3, static_cast<int64_t>(14), static_cast<int64_t>(12),
+      static_cast<int64_t>(11));
+  for (const bool use_parallel : {false, true})
+  {
+    const CollisionMap regridded
+        = grid_resampling::Regrid(map, new_origin, new_sizes, use_parallel);
+    ASSERT_EQ(regridded.GetNumXCells(), 14);
+    ASSERT_EQ(regridded.GetNumYCells(), 12);
+    ASSERT_EQ(regridded.GetNumZCells(), 11);
+    EXPECT_TRUE(regridded.GetOriginTransform().isApprox(new_origin));
+    int64_t num_in_bounds = 0;
+    int64_t num_out_of_bounds = 0;
+    for (int64_t x_index = 0; x_index < regridded.GetNumXCells(); x_index++)
+    {
+      for (int64_t y_index = 0; y_index < regridded.GetNumYCells(); y_index++)
+      {
+        for (int64_t z_index = 0; z_index < regridded.GetNumZCells();
+             z_index++)
+        {
+          const Eigen::Vector4d location
+              = regridded.GridIndexToLocation(x_index, y_index, z_index);
+          const auto source_cell
+              = map.GetImmutable(map.LocationToGridIndex4d(location));
+          const CollisionCell expected
+              = source_cell ? source_cell.Value() : map.GetOOBValue();
+          if (source_cell)
+          {
+            num_in_bounds++;
+          }
+          else
+          {
+            num_out_of_bounds++;
+          }
+          const CollisionCell& cell
+              = regridded.GetImmutable(x_index, y_index, z_index).Value();
+          ASSERT_EQ(cell.Occupancy(), expected.Occupancy());
+          ASSERT_EQ(cell.Component(), expected.Component());
+        }
+      }
+    }
+    EXPECT_GT(num_in_bounds, 100);
+    EXPECT_GT(num_out_of_bounds, 100);
+  }
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
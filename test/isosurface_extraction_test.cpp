@@ -0,0 +1,187 @@
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/isosurface_extraction.hpp>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridSizes;
+using isosurface_extraction::TriangleMesh;
+
+const int64_t kNumCells = 20;
+const double kResolution = 0.1;
+
+/// SDF of a sphere, exact at every cell center.
+SignedDistanceField<std::vector<float>> MakeSphereSDF(
+    const Eigen::Vector3d& center, const double radius)
+{
+  const GridSizes sizes(kResolution, kNumCells, kNumCells, kNumCells);
+  SignedDistanceField<std::vector<float>> sdf(
+      Eigen::Isometry3d::Identity(), "world", sizes, 0.0f);
+  for (int64_t x_index = 0; x_index < kNumCells; x_index++)
+  {
+    for (int64_t y_index = 0; y_index < kNumCells; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < kNumCells; z_index++)
+      {
+        const Eigen::Vector3d cell_center
+            = Eigen::Vector3d(static_cast<double>(x_index) + 0.5,
+                              static_cast<double>(y_index) + 0.5,
+                              static_cast<double>(z_index) + 0.5)
+              * kResolution;
+        sdf.SetValue(x_index, y_index, z_index, static_cast<float>(
+            (cell_center - center).norm() - radius));
+      }
+    }
+  }
+  return sdf;
+}
+
+/// Whether the vertex lies in a dual cube away from the grid boundary, whose
+/// faces are all complete.
+bool IsInteriorVertex(const Eigen::Vector3d& vertex)
+{
+  const double lower = 1.5 * kResolution;
+  const double upper = (static_cast<double>(kNumCells) - 1.5) * kResolution;
+  return (vertex.array() > lower).all() && (vertex.array() < upper).all();
+}
+
+/// Number of times each directed edge appears in the mesh triangles.
+std::map<std::pair<int32_t, int32_t>, int32_t> CountDirectedEdges(
+    const TriangleMesh& mesh)
+{
+  std::map<std::pair<int32_t, int32_t>, int32_t> edge_counts;
+  for (const Eigen::Vector3i& triangle : mesh.GetTriangles())
+  {
+    for (int32_t corner = 0; corner < 3; corner++)
+    {
+      edge_counts[std::make_pair(
+          triangle(corner), triangle((corner + 1) % 3))]++;
+    }
+  }
+  return edge_counts;
+}
+
+/// Checks that the mesh approximates the sphere at radius, with every
+/// triangle wound outward, and that each edge between interior vertices is
+/// shared by exactly two triangles, once in each direction. Returns the
+/// number of edges checked.
+int64_t CheckSphereMesh(
+    const TriangleMesh& mesh, const Eigen::Vector3d& center,
+    const double radius)
+{
+  const std::vector<Eigen::Vector3d>& vertices = mesh.GetVertices();
+  const std::vector<Eigen::Vector3i>& triangles = mesh.GetTriangles();
+  EXPECT_FALSE(triangles.empty());
+  for (const Eigen::Vector3d& vertex : vertices)
+  {
+    EXPECT_NEAR((vertex - center).norm(), radius, 0.5 * kResolution);
+  }
+  for (const Eigen::Vector3i& triangle : triangles)
+  {
+    const Eigen::Vector3d& a = vertices.at(static_cast<size_t>(triangle(0)));
+    const Eigen::Vector3d& b = vertices.at(static_cast<size_t>(triangle(1)));
+    const Eigen::Vector3d& c = vertices.at(static_cast<size_t>(triangle(2)));
+    const Eigen::Vector3d normal = (b - a).cross(c - a);
+    const Eigen::Vector3d centroid = (a + b + c) / 3.0;
+    EXPECT_GT(normal.dot(centroid - center), 0.0);
+  }
+  const auto edge_counts = CountDirectedEdges(mesh);
+  int64_t num_checked_edges = 0;
+  for (const auto& edge_count : edge_counts)
+  {
+    const int32_t from = edge_count.first.first;
+    const int32_t to = edge_count.first.second;
+    if (!IsInteriorVertex(vertices.at(static_cast<size_t>(from)))
+        || !IsInteriorVertex(vertices.at(static_cast<size_t>(to))))
+    {
+      continue;
+    }
+    EXPECT_EQ(edge_count.second, 1);
+    const auto reverse_edge = edge_counts.find(std::make_pair(to, from));
+    EXPECT_TRUE(reverse_edge != edge_counts.end()
+                && reverse_edge->second == 1);
+    num_checked_edges++;
+  }
+  return num_checked_edges;
+}
+
+void ExpectSameMesh(const TriangleMesh& mesh, const TriangleMesh& expected)
+{
+  ASSERT_EQ(mesh.GetVertices().size(), expected.GetVertices().size());
+  ASSERT_EQ(mesh.GetTriangles().size(), expected.GetTriangles().size());
+  for (size_t idx = 0; idx < mesh.GetVertices().size(); idx++)
+  {
+    EXPECT_EQ(mesh.GetVertices()[idx], expected.GetVertices()[idx]);
+  }
+  for (size_t idx = 0; idx < mesh.GetTriangles().size(); idx++)
+  {
+    EXPECT_EQ(mesh.GetTriangles()[idx], expected.GetTriangles()[idx]);
+  }
+}
+
+GTEST_TEST(IsosurfaceExtractionTest, SphereMeshIsClosedAndOutward)
+{
+  // The iso-level surface is a sphere of radius + iso_level, well inside the
+  // grid, so every vertex is interior and the mesh is closed.
+  const Eigen::Vector3d center(1.03, 0.97, 1.01);
+  const double radius = 0.6;
+  const float iso_level = 0.05f;
+  const auto sdf = MakeSphereSDF(center, radius);
+  const TriangleMesh serial_mesh
+      = isosurface_extraction::ExtractIsosurfaceMesh(sdf, iso_level, false);
+  const TriangleMesh parallel_mesh
+      = isosurface_extraction::ExtractIsosurfaceMesh(sdf, iso_level, true);
+  ExpectSameMesh(parallel_mesh, serial_mesh);
+
+  for (const Eigen::Vector3d& vertex : serial_mesh.GetVertices())
+  {
+    ASSERT_TRUE(IsInteriorVertex(vertex));
+  }
+  const int64_t num_checked_edges = CheckSphereMesh(
+      serial_mesh, center, radius + static_cast<double>(iso_level));
+  EXPECT_EQ(num_checked_edges,
+            static_cast<int64_t>(serial_mesh.GetTriangles().size()) * 3);
+}
+
+GTEST_TEST(IsosurfaceExtractionTest, ClippedSphereMeshIsManifoldInside)
+{
+  // The sphere leaves the grid through the lower x face, where the mesh is
+  // open, but it is still closed and manifold away from the boundary.
+  const Eigen::Vector3d center(0.23, 1.02, 0.98);
+  const double radius = 0.55;
+  const auto sdf = MakeSphereSDF(center, radius);
+  const TriangleMesh serial_mesh
+      = isosurface_extraction::ExtractIsosurfaceMesh(sdf, 0.0f, false);
+  const TriangleMesh parallel_mesh
+      = isosurface_extraction::ExtractIsosurfaceMesh(sdf, 0.0f, true);
+  ExpectSameMesh(parallel_mesh, serial_mesh);
+
+  int64_t num_boundary_vertices = 0;
+  for (const Eigen::Vector3d& vertex : serial_mesh.GetVertices())
+  {
+    if (!IsInteriorVertex(vertex))
+    {
+      num_boundary_vertices++;
+    }
+  }
+  EXPECT_GT(num_boundary_vertices, 0);
+  EXPECT_GT(CheckSphereMesh(serial_mesh, center, radius), 100);
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
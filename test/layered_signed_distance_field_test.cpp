@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/layered_signed_distance_field.hpp>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridSizes;
+using LayeredSDF = LayeredSignedDistanceField<std::vector<float>>;
+using SDF = SignedDistanceField<std::vector<float>>;
+using SDFMap = std::map<uint32_t, std::shared_ptr<const SDF>>;
+using PoseMap = std::map<uint32_t, Eigen::Isometry3d>;
+
+/// SDF with varied distances, offset so that different layers win the
+/// minimum in different places.
+std::shared_ptr<const SDF> MakeTestSDF(
+    const Eigen::Isometry3d& origin_transform, const GridSizes& sizes,
+    const double offset)
+{
+  std::shared_ptr<SDF> sdf(
+      new SDF(origin_transform, "world", sizes, 0.0f));
+  for (int64_t x_index = 0; x_index < sdf->GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < sdf->GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < sdf->GetNumZCells(); z_index++)
+      {
+        const double value
+            = offset + std::sin(static_cast<double>(x_index) * 0.9)
+              + std::cos(static_cast<double>(y_index + z_index) * 0.6);
+        sdf->SetValue(x_index, y_index, z_index, static_cast<float>(value));
+      }
+    }
+  }
+  return sdf;
+}
+
+Eigen::Isometry3d MakePose(
+    const Eigen::Vector3d& translation, const double angle,
+    const Eigen::Vector3d& axis)
+{
+  Eigen::Isometry3d pose = Eigen::Isometry3d::Identity();
+  pose.translation() = translation;
+  pose.linear()
+      = Eigen::AngleAxisd(angle, axis.normalized()).toRotationMatrix();
+  return pose;
+}
+
+/// Minimum over every layer containing location, with no culling.
+EstimateDistanceQuery BruteForceDistance(
+    const SDF& static_layer, const SDFMap& fields, const PoseMap& poses,
+    const Eigen::Vector3d& location)
+{
+  EstimateDistanceQuery distance = static_layer.EstimateDistance3d(location);
+  for (const auto& field : fields)
+  {
+    const EstimateDistanceQuery layer_distance
+        = field.second->EstimateDistance3d(
+            poses.at(field.first).inverse() * location);
+    if (layer_distance
+        && (!distance || layer_distance.Value() < distance.Value()))
+    {
+      distance = layer_distance;
+    }
+  }
+  return distance;
+}
+
+void ExpectSameDistance(
+    const EstimateDistanceQuery& distance,
+    const EstimateDistanceQuery& expected)
+{
+  ASSERT_EQ(static_cast<bool>(distance), static_cast<bool>(expected));
+  if (expected)
+  {
+    EXPECT_NEAR(distance.Value(), expected.Value(), 1e-9);
+  }
+}
+
+GTEST_TEST(LayeredSignedDistanceFieldTest, MatchesBruteForceOverLayers)
+{
+  const std::shared_ptr<const SDF> static_layer = MakeTestSDF(
+      MakePose(Eigen::Vector3d(-1.0, -1.0, -0.5), 0.0,
+               Eigen::Vector3d::UnitZ()),
+      GridSizes(0.25, static_cast<int64_t>(8), static_cast<int64_t>(8),
+                static_cast<int64_t>(4)),
+      0.5);
+  // Small dynamic fields with their own rotated origins, posed so that one
+  // overlaps the static layer, one sticks out of it, and one is far from it.
+  const GridSizes dynamic_sizes(
+      0.1, static_cast<int64_t>(6), static_cast<int64_t>(5),
+      static_cast<int64_t>(4));
+  SDFMap fields;
+  fields[1] = MakeTestSDF(
+      MakePose(Eigen::Vector3d(-0.2, -0.1, 0.0), 0.4,
+               Eigen::Vector3d(0.0, 0.3, 1.0)),
+      dynamic_sizes, -0.6);
+  fields[4] = MakeTestSDF(
+      MakePose(Eigen::Vector3d(0.1, -0.3, -0.2), -0.7,
+               Eigen::Vector3d(1.0, 0.2, 0.1)),
+      dynamic_sizes, -0.9);
+  fields[9] = MakeTestSDF(Eigen::Isometry3d::Identity(), dynamic_sizes, -0.2);
+  PoseMap poses;
+  poses[1] = MakePose(Eigen::Vector3d(0.13, -0.21, 0.07), 0.8,
+                      Eigen::Vector3d(0.2, 0.9, -0.3));
+  poses[4] = MakePose(Eigen::Vector3d(0.92, 0.71, 0.34), -1.1,
+                      Eigen::Vector3d(0.5, -0.4, 0.7));
+  poses[9] = MakePose(Eigen::Vector3d(5.0, 5.0, 5.0), 0.3,
+                      Eigen::Vector3d::UnitX());
+  LayeredSDF layered(static_layer);
+  for (const auto& field : fields)
+  {
+    layered.SetDynamicLayer(field.first, field.second, poses.at(field.first));
+  }
+  ASSERT_EQ(layered.NumDynamicLayers(), 3u);
+
+  // A lattice covering the static layer, the dynamic layers, and the space
+  // outside all of them.
+  std::vector<Eigen::Vector3d> points;
+  for (int32_t x_step = 0; x_step < 26; x_step++)
+  {
+    for (int32_t y_step = 0; y_step < 26; y_step++)
+    {
+      for (int32_t z_step = 0; z_step < 14; z_step++)
+      {
+        points.emplace_back(-1.3 + (static_cast<double>(x_step) * 0.101),
+                            -1.3 + (static_cast<double>(y_step) * 0.103),
+                            -0.8 + (static_cast<double>(z_step) * 0.107));
+      }
+    }
+  }
+  // A coherent batch around the far layer, and one that misses every layer.
+  std::vector<Eigen::Vector3d> far_points;
+  std::vector<Eigen::Vector3d> outside_points;
+  for (int32_t step = 0; step < 40; step++)
+  {
+    const double fraction = static_cast<double>(step) / 40.0;
+    far_points.push_back(
+        poses[9] * Eigen::Vector3d(0.6 * fraction, 0.5 - (0.5 * fraction),
+                                   0.4 * fraction));
+    outside_points.push_back(
+        Eigen::Vector3d(-3.0 + fraction, -3.0, 2.0 * fraction));
+  }
+
+  const auto check_layered = [&] ()
+  {
+    int64_t num_dynamic_minimums = 0;
+    int64_t num_empty = 0;
+    for (const std::vector<Eigen::Vector3d>* batch
+             : {&points, &far_points, &outside_points})
+    {
+      Eigen::Matrix3Xd locations(3, static_cast<int64_t>(batch->size()));
+      for (size_t idx = 0; idx < batch->size(); idx++)
+      {
+        locations.col(static_cast<int64_t>(idx)) = batch->at(idx);
+      }
+      const std::vector<EstimateDistanceQuery> serial_distances
+          = layered.EstimateDistances(locations, false);
+      const std::vector<EstimateDistanceQuery> parallel_distances
+          = layered.EstimateDistances(locations, true);
+      ASSERT_EQ(serial_distances.size(), batch->size());
+      ASSERT_EQ(parallel_distances.size(), batch->size());
+      for (size_t idx = 0; idx < batch->size(); idx++)
+      {
+        const Eigen::Vector3d& location = batch->at(idx);
+        const EstimateDistanceQuery expected
+            = BruteForceDistance(*static_layer, fields, poses, location);
+        ExpectSameDistance(layered.EstimateDistance3d(location), expected);
+        ExpectSameDistance(serial_distances[idx], expected);
+        ExpectSameDistance(parallel_distances[idx], expected);
+        const EstimateDistanceQuery static_distance
+            = static_layer->EstimateDistance3d(location);
+        if (!expected)
+        {
+          num_empty++;
+        }
+        else if (!static_distance
+                 || expected.Value() < static_distance.Value())
+        {
+          num_dynamic_minimums++;
+        }
+      }
+    }
+    EXPECT_GT(num_dynamic_minimums, 100);
+    EXPECT_GE(num_empty, 40);
+  };
+  check_layered();
+
+  // Moving, replacing, and removing layers.
+  poses[1] = MakePose(Eigen::Vector3d(-0.55, 0.42, -0.11), -0.2,
+                      Eigen::Vector3d(0.7, 0.1, 0.7));
+  layered.SetDynamicLayerPose(1, poses[1]);
+  fields[4] = MakeTestSDF(
+      MakePose(Eigen::Vector3d(0.0, 0.1, 0.0), 1.3,
+               Eigen::Vector3d(0.1, 0.1, 1.0)),
+      dynamic_sizes, -1.2);
+  layered.SetDynamicLayer(4, fields[4], poses[4]);
+  EXPECT_EQ(layered.NumDynamicLayers(), 3u);
+  check_layered();
+  fields.erase(4);
+  layered.RemoveDynamicLayer(4);
+  EXPECT_FALSE(layered.HasDynamicLayer(4));
+  check_layered();
+
+  EXPECT_THROW(layered.SetDynamicLayerPose(4, poses[4]),
+               std::invalid_argument);
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
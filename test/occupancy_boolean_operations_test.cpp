@@ -0,0 +1,200 @@
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/occupancy_boolean_operations.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridSizes;
+using occupancy_boolean_operations::BooleanOperation;
+
+enum class CellClass { FREE, UNKNOWN, FILLED };
+
+CellClass Classify(const float occupancy)
+{
+  if (occupancy > 0.5f)
+  {
+    return CellClass::FILLED;
+  }
+  return (occupancy == 0.5f) ? CellClass::UNKNOWN : CellClass::FREE;
+}
+
+/// Boolean values a cell of the class could have, with unknown being either.
+std::vector<bool> PossibleValues(const CellClass cell_class)
+{
+  switch (cell_class)
+  {
+    case CellClass::FREE:
+      return {false};
+    case CellClass::FILLED:
+      return {true};
+    default:
+      return {false, true};
+  }
+}
+
+/// Class of the result, found by applying operation to every combination of
+/// values that a and b could have.
+CellClass BruteForceCombine(
+    const BooleanOperation operation, const CellClass a_class,
+    const CellClass b_class)
+{
+  bool can_be_true = false;
+  bool can_be_false = false;
+  for (const bool a : PossibleValues(a_class))
+  {
+    for (const bool b : PossibleValues(b_class))
+    {
+      bool result = false;
+      switch (operation)
+      {
+        case BooleanOperation::UNION:
+          result = a || b;
+          break;
+        case BooleanOperation::INTERSECTION:
+          result = a && b;
+          break;
+        case BooleanOperation::DIFFERENCE:
+          result = a && !b;
+          break;
+        case BooleanOperation::SYMMETRIC_DIFFERENCE:
+          result = a != b;
+          break;
+      }
+      can_be_true |= result;
+      can_be_false |= !result;
+    }
+  }
+  if (can_be_true && can_be_false)
+  {
+    return CellClass::UNKNOWN;
+  }
+  return can_be_true ? CellClass::FILLED : CellClass::FREE;
+}
+
+/// Fills a and b so that they cover every pair of classes, with varied
+/// occupancies and components within each class. Cells beyond z index 2 are
+/// left at the (unknown) defaults.
+void MakeTestMaps(CollisionMap& a, CollisionMap& b)
+{
+  const std::vector<float> occupancies = {0.0f, 0.2f, 0.5f, 0.7f, 1.0f};
+  for (int64_t x_index = 0; x_index < a.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < a.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < 3; z_index++)
+      {
+        const size_t a_option
+            = static_cast<size_t>((x_index + z_index) % 5);
+        const size_t b_option
+            = static_cast<size_t>((y_index + (2 * z_index)) % 5);
+        a.SetValue(x_index, y_index, z_index, CollisionCell(
+            occupancies[a_option], static_cast<uint32_t>(1 + x_index)));
+        b.SetValue(x_index, y_index, z_index, CollisionCell(
+            occupancies[b_option], static_cast<uint32_t>(10 + y_index)));
+      }
+    }
+  }
+}
+
+GTEST_TEST(OccupancyBooleanOperationsTest, CombineMatchesBruteForce)
+{
+  const GridSizes sizes(
+      0.1, static_cast<int64_t>(4), static_cast<int64_t>(5),
+      static_cast<int64_t>(6));
+  CollisionMap a(Eigen::Isometry3d::Identity(), "world", sizes,
+                 CollisionCell(0.5f));
+  CollisionMap b(Eigen::Isometry3d::Identity(), "world", sizes,
+                 CollisionCell(0.5f));
+  MakeTestMaps(a, b);
+  const std::vector<BooleanOperation> operations = {
+      BooleanOperation::UNION, BooleanOperation::INTERSECTION,
+      BooleanOperation::DIFFERENCE, BooleanOperation::SYMMETRIC_DIFFERENCE};
+  for (const BooleanOperation operation : operations)
+  {
+    for (const bool use_parallel : {false, true})
+    {
+      const CollisionMap result = occupancy_boolean_operations::Combine(
+          a, b, operation, use_parallel);
+      ASSERT_EQ(result.GetTotalCells(), a.GetTotalCells());
+      const CollisionMapBackingStore& a_cells = a.GetImmutableRawData();
+      const CollisionMapBackingStore& b_cells = b.GetImmutableRawData();
+      const CollisionMapBackingStore& result_cells
+          = result.GetImmutableRawData();
+      for (size_t data_index = 0; data_index < a_cells.size(); data_index++)
+      {
+        const CollisionCell& a_cell = a_cells[data_index];
+        const CollisionCell& b_cell = b_cells[data_index];
+        const CollisionCell& result_cell = result_cells[data_index];
+        const CellClass a_class = Classify(a_cell.Occupancy());
+        const CellClass b_class = Classify(b_cell.Occupancy());
+        const CellClass expected_class
+            = BruteForceCombine(operation, a_class, b_class);
+        ASSERT_EQ(Classify(result_cell.Occupancy()), expected_class)
+            << "data_index " << data_index;
+        // Unchanged cells keep a's cell, changed cells take b's cell if it
+        // has the resulting class, or else the canonical occupancy.
+        CollisionCell expected_cell = a_cell;
+        if (expected_class != a_class)
+        {
+          if (expected_class == b_class)
+          {
+            expected_cell = b_cell;
+          }
+          else if (expected_class == CellClass::FILLED)
+          {
+            expected_cell = CollisionCell(1.0f);
+          }
+          else if (expected_class == CellClass::UNKNOWN)
+          {
+            expected_cell = CollisionCell(0.5f);
+          }
+          else
+          {
+            expected_cell = CollisionCell(0.0f);
+          }
+        }
+        ASSERT_EQ(result_cell.Occupancy(), expected_cell.Occupancy());
+        ASSERT_EQ(result_cell.Component(), expected_cell.Component());
+      }
+    }
+  }
+}
+
+GTEST_TEST(OccupancyBooleanOperationsTest, MismatchedGridsThrow)
+{
+  const GridSizes sizes(
+      0.1, static_cast<int64_t>(4), static_cast<int64_t>(5),
+      static_cast<int64_t>(6));
+  const GridSizes longer_sizes(
+      0.1, static_cast<int64_t>(4), static_cast<int64_t>(5),
+      static_cast<int64_t>(7));
+  const CollisionMap a(Eigen::Isometry3d::Identity(), "world", sizes,
+                       CollisionCell(0.0f));
+  const CollisionMap b(Eigen::Isometry3d::Identity(), "world", longer_sizes,
+                       CollisionCell(0.0f));
+  EXPECT_THROW(occupancy_boolean_operations::Combine(
+                   a, b, BooleanOperation::UNION, false),
+               std::invalid_argument);
+  Eigen::Isometry3d shifted_origin = Eigen::Isometry3d::Identity();
+  shifted_origin.translation() = Eigen::Vector3d(0.05, 0.0, 0.0);
+  const CollisionMap c(shifted_origin, "world", sizes, CollisionCell(0.0f));
+  EXPECT_THROW(occupancy_boolean_operations::Combine(
+                   a, c, BooleanOperation::UNION, false),
+               std::invalid_argument);
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
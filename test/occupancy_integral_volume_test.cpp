@@ -0,0 +1,190 @@
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+#include <voxelized_geometry_tools/occupancy_integral_volume.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+/// Fills region of map with a mix of free, unknown, and filled cells that
+/// depends on seed.
+void FillPattern(
+    CollisionMap& map, const GridIndexRegion& region, const int64_t seed)
+{
+  for (int64_t x_index = region.Lower().X(); x_index < region.Upper().X();
+       x_index++)
+  {
+    for (int64_t y_index = region.Lower().Y(); y_index < region.Upper().Y();
+         y_index++)
+    {
+      for (int64_t z_index = region.Lower().Z(); z_index < region.Upper().Z();
+           z_index++)
+      {
+        const int64_t pattern
+            = ((x_index * 7) + (y_index * 13) + (z_index * 5) + seed) % 5;
+        const float occupancy
+            = (pattern < 2) ? 0.0f : ((pattern == 2) ? 0.5f : 1.0f);
+        map.SetValue(x_index, y_index, z_index, CollisionCell(occupancy));
+      }
+    }
+  }
+}
+
+OccupancyCounts BruteForceCountCells(
+    const CollisionMap& map, const GridIndexRegion& region)
+{
+  int64_t filled = 0;
+  int64_t unknown = 0;
+  int64_t free = 0;
+  for (int64_t x_index = region.Lower().X(); x_index < region.Upper().X();
+       x_index++)
+  {
+    for (int64_t y_index = region.Lower().Y(); y_index < region.Upper().Y();
+         y_index++)
+    {
+      for (int64_t z_index = region.Lower().Z(); z_index < region.Upper().Z();
+           z_index++)
+      {
+        const auto query = map.GetImmutable(x_index, y_index, z_index);
+        if (!query)
+        {
+          continue;
+        }
+        const float occupancy = query.Value().Occupancy();
+        if (occupancy > 0.5f)
+        {
+          filled++;
+        }
+        else if (occupancy == 0.5f)
+        {
+          unknown++;
+        }
+        else
+        {
+          free++;
+        }
+      }
+    }
+  }
+  return OccupancyCounts(filled, unknown, free);
+}
+
+/// Compares the counts of boxes with corners inside, on, and beyond the grid
+/// bounds against brute force.
+void CheckAllBoxes(
+    const CollisionMap& map, const OccupancyIntegralVolume& integral_volume)
+{
+  // [lower, upper) ranges along one axis.
+  std::vector<std::pair<int64_t, int64_t>> ranges;
+  for (const int64_t lower : {-2, 0, 1, 3})
+  {
+    for (const int64_t upper : {0, 2, 4, 5, 8})
+    {
+      if (upper >= lower)
+      {
+        ranges.emplace_back(lower, upper);
+      }
+    }
+  }
+  for (const auto& x_range : ranges)
+  {
+    for (const auto& y_range : ranges)
+    {
+      for (const auto& z_range : ranges)
+      {
+        const GridIndexRegion region(
+            GridIndex(x_range.first, y_range.first, z_range.first),
+            GridIndex(x_range.second, y_range.second, z_range.second));
+        const OccupancyCounts expected = BruteForceCountCells(map, region);
+        const OccupancyCounts counts = integral_volume.CountCells(region);
+        ASSERT_EQ(counts.Filled(), expected.Filled());
+        ASSERT_EQ(counts.Unknown(), expected.Unknown());
+        ASSERT_EQ(counts.Free(), expected.Free());
+        ASSERT_EQ(counts.HasFilledOrUnknown(),
+                  (expected.Filled() + expected.Unknown()) > 0);
+      }
+    }
+  }
+}
+
+GTEST_TEST(OccupancyIntegralVolumeTest, CountsMatchBruteForce)
+{
+  const GridSizes sizes(
+      0.25, static_cast<int64_t>(6), static_cast<int64_t>(5),
+      static_cast<int64_t>(7));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  const GridIndexRegion whole_grid(GridIndex(0, 0, 0), GridIndex(6, 5, 7));
+  FillPattern(map, whole_grid, 0);
+  for (const bool use_parallel : {false, true})
+  {
+    const OccupancyIntegralVolume integral_volume(map, use_parallel);
+    EXPECT_EQ(integral_volume.GetNumXCells(), 6);
+    EXPECT_EQ(integral_volume.GetNumYCells(), 5);
+    EXPECT_EQ(integral_volume.GetNumZCells(), 7);
+    CheckAllBoxes(map, integral_volume);
+  }
+}
+
+GTEST_TEST(OccupancyIntegralVolumeTest, UpdateMatchesRebuild)
+{
+  const GridSizes sizes(
+      0.25, static_cast<int64_t>(6), static_cast<int64_t>(5),
+      static_cast<int64_t>(7));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  const GridIndexRegion whole_grid(GridIndex(0, 0, 0), GridIndex(6, 5, 7));
+  FillPattern(map, whole_grid, 0);
+  OccupancyIntegralVolume integral_volume(map, true);
+
+  // Changes in the interior, at the far corner, and in two regions at once.
+  const std::vector<std::vector<GridIndexRegion>> updates = {
+      {GridIndexRegion(GridIndex(2, 1, 3), GridIndex(4, 3, 5))},
+      {GridIndexRegion(GridIndex(5, 4, 6), GridIndex(6, 5, 7))},
+      {GridIndexRegion(GridIndex(0, 3, 1), GridIndex(2, 5, 2)),
+       GridIndexRegion(GridIndex(3, 0, 4), GridIndex(6, 2, 7))}};
+  int64_t seed = 1;
+  for (const auto& changed_regions : updates)
+  {
+    for (const GridIndexRegion& changed_region : changed_regions)
+    {
+      FillPattern(map, changed_region, seed);
+      seed++;
+    }
+    integral_volume.Update(map, changed_regions, true);
+    CheckAllBoxes(map, integral_volume);
+  }
+
+  // Regions outside the grid change nothing.
+  integral_volume.Update(
+      map, {GridIndexRegion(GridIndex(7, 0, 0), GridIndex(9, 2, 2))}, false);
+  CheckAllBoxes(map, integral_volume);
+
+  const GridSizes other_sizes(
+      0.25, static_cast<int64_t>(6), static_cast<int64_t>(5),
+      static_cast<int64_t>(6));
+  const CollisionMap other_map(
+      Eigen::Isometry3d::Identity(), "world", other_sizes,
+      CollisionCell(0.0f));
+  EXPECT_THROW(integral_volume.Update(other_map, {whole_grid}, false),
+               std::invalid_argument);
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/occupancy_raycasting.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+const int64_t kNumXCells = 7;
+const int64_t kNumYCells = 5;
+const int64_t kNumZCells = 6;
+const double kResolution = 0.5;
+
+std::vector<GridIndex> TraverseRayCells(
+    const Eigen::Vector3d& origin, const Eigen::Vector3d& direction,
+    const double max_range)
+{
+  std::vector<GridIndex> cells;
+  occupancy_raycasting::TraverseRay(
+      kNumXCells, kNumYCells, kNumZCells, kResolution, origin, direction,
+      max_range, [&] (const int64_t x_index, const int64_t y_index,
+                      const int64_t z_index)
+  {
+    cells.emplace_back(x_index, y_index, z_index);
+    return true;
+  });
+  return cells;
+}
+
+/// Cells the ray crosses for a positive length, in order, found by
+/// intersecting the ray with the box of every cell.
+std::vector<GridIndex> BruteForceRayCells(
+    const Eigen::Vector3d& origin, const Eigen::Vector3d& direction,
+    const double max_range)
+{
+  std::vector<std::pair<double, GridIndex>> entered_cells;
+  for (int64_t x_index = 0; x_index < kNumXCells; x_index++)
+  {
+    for (int64_t y_index = 0; y_index < kNumYCells; y_index++)
+    {
+      for (int64_t z_index = 0; z_index < kNumZCells; z_index++)
+      {
+        const Eigen::Vector3d lower
+            = Eigen::Vector3d(static_cast<double>(x_index),
+                              static_cast<double>(y_index),
+                              static_cast<double>(z_index)) * kResolution;
+        double t_enter = 0.0;
+        double t_exit = max_range;
+        for (int axis = 0; axis < 3; axis++)
+        {
+          if (direction(axis) == 0.0)
+          {
+            if (origin(axis) < lower(axis)
+                || origin(axis) >= lower(axis) + kResolution)
+            {
+              t_exit = -std::numeric_limits<double>::infinity();
+            }
+            continue;
+          }
+          const double t_lower
+              = (lower(axis) - origin(axis)) / direction(axis);
+          const double t_upper
+              = (lower(axis) + kResolution - origin(axis)) / direction(axis);
+          t_enter = std::max(t_enter, std::min(t_lower, t_upper));
+          t_exit = std::min(t_exit, std::max(t_lower, t_upper));
+        }
+        if (t_enter < t_exit)
+        {
+          entered_cells.emplace_back(
+              t_enter, GridIndex(x_index, y_index, z_index));
+        }
+      }
+    }
+  }
+  std::sort(entered_cells.begin(), entered_cells.end(),
+            [] (const std::pair<double, GridIndex>& a,
+                const std::pair<double, GridIndex>& b)
+  {
+    return a.first < b.first;
+  });
+  std::vector<GridIndex> cells;
+  for (const auto& entered_cell : entered_cells)
+  {
+    cells.push_back(entered_cell.second);
+  }
+  return cells;
+}
+
+GTEST_TEST(OccupancyRaycastingTest, TraverseRayMatchesBruteForce)
+{
+  // Rays that start inside the grid, enter it from outside, run along an
+  // axis, or miss it, with ranges that end inside and beyond it.
+  const std::vector<Eigen::Vector3d> origins = {
+      Eigen::Vector3d(1.23, 0.91, 1.37), Eigen::Vector3d(-1.07, 1.19, 0.33),
+      Eigen::Vector3d(4.01, 3.07, 3.52), Eigen::Vector3d(0.61, -0.93, 2.77)};
+  const std::vector<Eigen::Vector3d> directions = {
+      Eigen::Vector3d(0.83, 0.31, 0.47), Eigen::Vector3d(-0.57, 0.22, -0.79),
+      Eigen::Vector3d(-0.91, -0.63, 0.12), Eigen::Vector3d(0.13, 0.97, -0.21),
+      Eigen::Vector3d(1.0, 0.0, 0.0), Eigen::Vector3d(0.0, -1.0, 0.0),
+      Eigen::Vector3d(0.0, 0.6, 0.8), Eigen::Vector3d(-0.7, 0.0, -0.3)};
+  int64_t num_nonempty_traversals = 0;
+  for (const Eigen::Vector3d& origin : origins)
+  {
+    for (const Eigen::Vector3d& unnormalized_direction : directions)
+    {
+      const Eigen::Vector3d direction = unnormalized_direction.normalized();
+      for (const double max_range : {0.0, 0.4, 1.7, 10.0})
+      {
+        const std::vector<GridIndex> expected
+            = BruteForceRayCells(origin, direction, max_range);
+        const std::vector<GridIndex> cells
+            = TraverseRayCells(origin, direction, max_range);
+        ASSERT_EQ(cells.size(), expected.size());
+        for (size_t idx = 0; idx < cells.size(); idx++)
+        {
+          ASSERT_EQ(cells[idx], expected[idx]);
+        }
+        if (!cells.empty())
+        {
+          num_nonempty_traversals++;
+        }
+      }
+    }
+  }
+  EXPECT_GT(num_nonempty_traversals, 20);
+}
+
+GTEST_TEST(OccupancyRaycastingTest, TraverseRayStopsWhenVisitorReturnsFalse)
+{
+  const Eigen::Vector3d origin(0.1, 1.2, 1.3);
+  const Eigen::Vector3d direction
+      = Eigen::Vector3d(1.0, 0.2, 0.1).normalized();
+  const std::vector<GridIndex> all_cells
+      = TraverseRayCells(origin, direction, 10.0);
+  ASSERT_GT(all_cells.size(), 3u);
+  std::vector<GridIndex> cells;
+  occupancy_raycasting::TraverseRay(
+      kNumXCells, kNumYCells, kNumZCells, kResolution, origin, direction,
+      10.0, [&] (const int64_t x_index, const int64_t y_index,
+                 const int64_t z_index)
+  {
+    cells.emplace_back(x_index, y_index, z_index);
+    return cells.size() < 3u;
+  });
+  ASSERT_EQ(cells.size(), 3u);
+  for (size_t idx = 0; idx < cells.size(); idx++)
+  {
+    EXPECT_EQ(cells[idx], all_cells[idx]);
+  }
+}
+
+GTEST_TEST(OccupancyRaycastingTest, EvaluateViewsCountsCells)
+{
+  // A column of free cells with two unknown cells and then a filled cell.
+  const GridSizes sizes(
+      0.1, static_cast<int64_t>(5), static_cast<int64_t>(5),
+      static_cast<int64_t>(10));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  map.SetValue(2, 2, 4, CollisionCell(0.5f));
+  map.SetValue(2, 2, 5, CollisionCell(0.5f));
+  map.SetValue(2, 2, 7, CollisionCell(1.0f));
+  map.SetValue(2, 2, 8, CollisionCell(0.5f));
+  // The sensor looks along +z from the center of cell (2, 2, 0).
+  Eigen::Isometry3d sensor_pose = Eigen::Isometry3d::Identity();
+  sensor_pose.translation() = Eigen::Vector3d(0.25, 0.25, 0.05);
+  const occupancy_raycasting::VectorIsometry3d view_poses = {sensor_pose};
+  const Eigen::Matrix3Xd one_ray
+      = occupancy_raycasting::MakePinholeRayDirections(0.5, 0.5, 1, 1);
+  Eigen::Matrix3Xd two_rays(3, 2);
+  two_rays << one_ray, one_ray;
+
+  for (const bool use_parallel : {false, true})
+  {
+    // The filled cell hides the unknown cell behind it.
+    const auto gains = occupancy_raycasting::EvaluateViews(
+        map, view_poses, two_rays, 10.0, use_parallel);
+    ASSERT_EQ(gains.size(), 1u);
+    EXPECT_EQ(gains[0].NumUnknownCellVisits(), 4);
+    EXPECT_EQ(gains[0].NumUniqueUnknownCells(), 2);
+    EXPECT_EQ(gains[0].NumRaysHitFilled(), 2);
+
+    // The range ends before the unknown cells.
+    const auto short_gains = occupancy_raycasting::EvaluateViews(
+        map, view_poses, one_ray, 0.3, use_parallel);
+    ASSERT_EQ(short_gains.size(), 1u);
+    EXPECT_EQ(short_gains[0].NumUnknownCellVisits(), 0);
+    EXPECT_EQ(short_gains[0].NumUniqueUnknownCells(), 0);
+    EXPECT_EQ(short_gains[0].NumRaysHitFilled(), 0);
+  }
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
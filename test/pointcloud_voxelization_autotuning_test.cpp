@@ -0,0 +1,246 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/cpu_pointcloud_voxelization.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization.hpp>
+#include <voxelized_geometry_tools/pointcloud_voxelization_autotuning.hpp>
+#include <voxelized_geometry_tools/scene_generation.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace pointcloud_voxelization
+{
+namespace
+{
+/// Path of an empty (deleted) cache file in the test temporary directory.
+std::string MakeCacheFilePath(const std::string& name)
+{
+  const std::string cache_file = testing::TempDir() + name;
+  std::remove(cache_file.c_str());
+  return cache_file;
+}
+
+std::vector<std::string> ReadLines(const std::string& file)
+{
+  std::vector<std::string> lines;
+  std::ifstream input_file(file);
+  std::string line;
+  while (std::getline(input_file, line))
+  {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+void ExpectSameBackend(
+    const common_robotics_utilities::OwningMaybe<AvailableBackend>& backend,
+    const AvailableBackend& expected)
+{
+  ASSERT_TRUE(backend);
+  EXPECT_EQ(backend.Value().DeviceName(), expected.DeviceName());
+  EXPECT_EQ(backend.Value().DeviceOptions(), expected.DeviceOptions());
+  EXPECT_EQ(backend.Value().BackendOption(), expected.BackendOption());
+}
+
+GTEST_TEST(PointCloudVoxelizationAutotuningTest, CacheRoundTrip)
+{
+  const std::string cache_file
+      = MakeCacheFilePath("voxelizer_calibration_round_trip.txt");
+  // A missing cache file is treated as empty.
+  EXPECT_FALSE(LoadCalibratedBackend(cache_file, "workload_a"));
+
+  // Device names may contain spaces.
+  const AvailableBackend device_backend(
+      "NVIDIA GeForce RTX 3080 Ti", {{"CUDA_BLOCK_SIZE", 256},
+                                     {"CUDA_DEVICE", 1}},
+      BackendOptions::CUDA);
+  const AvailableBackend cpu_backend(
+      "CPU/OpenMP", {{"CPU_NUM_THREADS", 4}}, BackendOptions::CPU);
+  SaveCalibratedBackend(cache_file, "workload_a", device_backend);
+  SaveCalibratedBackend(cache_file, "workload_b", cpu_backend);
+  ExpectSameBackend(
+      LoadCalibratedBackend(cache_file, "workload_a"), device_backend);
+  ExpectSameBackend(
+      LoadCalibratedBackend(cache_file, "workload_b"), cpu_backend);
+  EXPECT_FALSE(LoadCalibratedBackend(cache_file, "workload"));
+
+  // Saving with the same key replaces the entry and keeps the others.
+  const AvailableBackend options_free_backend(
+      "Intel(R) UHD Graphics 620", {}, BackendOptions::OPENCL);
+  SaveCalibratedBackend(cache_file, "workload_a", options_free_backend);
+  ExpectSameBackend(
+      LoadCalibratedBackend(cache_file, "workload_a"), options_free_backend);
+  ExpectSameBackend(
+      LoadCalibratedBackend(cache_file, "workload_b"), cpu_backend);
+  int32_t num_workload_a_entries = 0;
+  for (const std::string& line : ReadLines(cache_file))
+  {
+    if (line.compare(0, 11, "workload_a ") == 0)
+    {
+      num_workload_a_entries++;
+    }
+  }
+  EXPECT_EQ(num_workload_a_entries, 1);
+
+  EXPECT_THROW(SaveCalibratedBackend(cache_file, "", cpu_backend),
+               std::invalid_argument);
+  EXPECT_THROW(SaveCalibratedBackend(cache_file, "workload a", cpu_backend),
+               std::invalid_argument);
+  std::remove(cache_file.c_str());
+}
+
+GTEST_TEST(PointCloudVoxelizationAutotuningTest, MalformedEntriesAreIgnored)
+{
+  const std::string cache_file
+      = MakeCacheFilePath("voxelizer_calibration_malformed.txt");
+  {
+    std::ofstream output_file(cache_file);
+    output_file << "# workload_a 1 0 Commented Out\n"
+                << "\n"
+                << "workload_a\n"
+                << "workload_a one 0 Bad Backend Option\n"
+                << "workload_a 0 0 Best Available Is Not A Backend\n"
+                << "workload_a 7 0 Unknown Backend\n"
+                << "workload_a 1 2 CPU_NUM_THREADS 4\n"
+                << "workload_a 1 1 CPU_NUM_THREADS four CPU/OpenMP\n"
+                << "\x01\x02 garbage \xff\n"
+                << "workload_b 3 1 CUDA_DEVICE 0 Tesla V100-SXM2-16GB\n";
+  }
+  EXPECT_FALSE(LoadCalibratedBackend(cache_file, "workload_a"));
+  ExpectSameBackend(
+      LoadCalibratedBackend(cache_file, "workload_b"),
+      AvailableBackend("Tesla V100-SXM2-16GB", {{"CUDA_DEVICE", 0}},
+                       BackendOptions::CUDA));
+
+  // A valid entry after malformed ones with the same key is found, and saving
+  // replaces every entry with the key.
+  {
+    std::ofstream output_file(cache_file, std::ios::app);
+    output_file << "workload_a 1 1 CPU_NUM_THREADS 2 CPU/OpenMP\n";
+  }
+  ExpectSameBackend(
+      LoadCalibratedBackend(cache_file, "workload_a"),
+      AvailableBackend("CPU/OpenMP", {{"CPU_NUM_THREADS", 2}},
+                       BackendOptions::CPU));
+  const AvailableBackend cpu_backend(
+      "CPU/OpenMP", {{"CPU_NUM_THREADS", 8}}, BackendOptions::CPU);
+  SaveCalibratedBackend(cache_file, "workload_a", cpu_backend);
+  ExpectSameBackend(
+      LoadCalibratedBackend(cache_file, "workload_a"), cpu_backend);
+  int32_t num_workload_a_entries = 0;
+  for (const std::string& line : ReadLines(cache_file))
+  {
+    if (line.compare(0, 10, "workload_a") == 0)
+    {
+      num_workload_a_entries++;
+    }
+  }
+  EXPECT_EQ(num_workload_a_entries, 1);
+  std::remove(cache_file.c_str());
+}
+
+GTEST_TEST(PointCloudVoxelizationAutotuningTest, RecalibratesWithoutUsableEntry)
+{
+  // A small workload, calibrated over a single CPU thread count.
+  const double size = 1.0;
+  const scene_generation::Scene scene =
+      scene_generation::MakeRandomClutterScene(
+          Eigen::Vector3d::Constant(size), 3, 3, 0.1, 0.3, 7);
+  const CollisionMap static_environment(
+      Eigen::Isometry3d::Identity(), "world",
+      common_robotics_utilities::voxel_grid::GridSizes(0.1, size, size, size),
+      CollisionCell(0.5f));
+  const Eigen::Isometry3d X_WC
+      = Eigen::Translation3d(-0.2, size * 0.5, size * 0.5)
+        * Eigen::Quaterniond(
+            Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitZ())
+            * Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitX()));
+  const std::vector<PointCloudWrapperPtr> pointclouds = {
+      scene_generation::SimulateDepthCamera(
+          scene, X_WC, 16, 12, M_PI_2, size * 2.0, 0.0, 7, false)};
+  const PointCloudVoxelizationFilterOptions filter_options;
+  const VoxelizerCalibrationOptions options(0, 1, {1}, {});
+  const std::string key
+      = MakeVoxelizerCalibrationKey(static_environment, pointclouds);
+  // The fastest candidate depends on the hardware, so recalibration is only
+  // checked to cache one of the candidates.
+  const std::vector<AvailableBackend> candidates
+      = GetCalibrationCandidates(options);
+  const auto expect_calibrated_backend = [&] (const std::string& cache_file)
+  {
+    const auto backend = LoadCalibratedBackend(cache_file, key);
+    ASSERT_TRUE(backend);
+    int32_t num_matching_candidates = 0;
+    for (const AvailableBackend& candidate : candidates)
+    {
+      if (backend.Value().DeviceName() == candidate.DeviceName()
+          && backend.Value().DeviceOptions() == candidate.DeviceOptions()
+          && backend.Value().BackendOption() == candidate.BackendOption())
+      {
+        num_matching_candidates++;
+      }
+    }
+    EXPECT_EQ(num_matching_candidates, 1);
+  };
+
+  const auto make_voxelizer = [&] (const std::string& cache_file)
+  {
+    return MakeCalibratedPointCloudVoxelizer(
+        cache_file, static_environment, 0.5, filter_options, pointclouds,
+        options);
+  };
+  const auto num_threads = [] (
+      const std::unique_ptr<PointCloudVoxelizationInterface>& voxelizer)
+  {
+    const CpuPointCloudVoxelizer* cpu_voxelizer
+        = dynamic_cast<const CpuPointCloudVoxelizer*>(voxelizer.get());
+    return (cpu_voxelizer != nullptr) ? cpu_voxelizer->NumThreads() : -1;
+  };
+
+  // Without a cache file, calibrates and caches the result.
+  const std::string cache_file
+      = MakeCacheFilePath("voxelizer_calibration_fallback.txt");
+  EXPECT_TRUE(make_voxelizer(cache_file));
+  expect_calibrated_backend(cache_file);
+
+  // A usable cached entry is used as-is.
+  const AvailableBackend cached_backend(
+      "CPU/OpenMP", {{"CPU_NUM_THREADS", 3}}, BackendOptions::CPU);
+  SaveCalibratedBackend(cache_file, key, cached_backend);
+  EXPECT_EQ(num_threads(make_voxelizer(cache_file)), 3);
+  ExpectSameBackend(LoadCalibratedBackend(cache_file, key), cached_backend);
+
+  // An entry that can no longer be constructed, or is malformed, triggers
+  // recalibration, which replaces it.
+  SaveCalibratedBackend(cache_file, key, AvailableBackend(
+      "CPU/OpenMP", {{"CPU_NUM_THREADS", -1}}, BackendOptions::CPU));
+  EXPECT_TRUE(make_voxelizer(cache_file));
+  expect_calibrated_backend(cache_file);
+  {
+    std::ofstream output_file(cache_file, std::ios::trunc);
+    output_file << key << " 9 0 Unknown Backend\n";
+  }
+  EXPECT_TRUE(make_voxelizer(cache_file));
+  expect_calibrated_backend(cache_file);
+  std::remove(cache_file.c_str());
+}
+}  // namespace
+}  // namespace pointcloud_voxelization
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
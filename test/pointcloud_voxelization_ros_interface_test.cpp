@@ -0,0 +1,212 @@
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/pointcloud_voxelization_ros_interface.hpp>
+
+#if VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 2
+#include <sensor_msgs/msg/point_field.hpp>
+#elif VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 1
+#include <sensor_msgs/PointField.h>
+#endif
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using pointcloud_voxelization::NonOwningPointCloud2Wrapper;
+using pointcloud_voxelization::PointCloud2;
+
+#if VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 2
+using PointField = sensor_msgs::msg::PointField;
+#elif VOXELIZED_GEOMETRY_TOOLS__SUPPORTED_ROS_VERSION == 1
+using PointField = sensor_msgs::PointField;
+#endif
+
+/// Cloud of width x height points with x, y, and z fields of datatype at the
+/// provided offsets, and zeroed data sized for its layout.
+PointCloud2 MakeCloud(
+    const uint32_t width, const uint32_t height, const uint8_t datatype,
+    const uint32_t x_offset, const uint32_t y_offset, const uint32_t z_offset,
+    const uint32_t point_step, const uint32_t row_step)
+{
+  PointCloud2 cloud;
+  cloud.width = width;
+  cloud.height = height;
+  cloud.point_step = point_step;
+  cloud.row_step = row_step;
+  const std::vector<std::string> names = {"x", "y", "z"};
+  const std::vector<uint32_t> offsets = {x_offset, y_offset, z_offset};
+  for (size_t idx = 0; idx < names.size(); idx++)
+  {
+    PointField field;
+    field.name = names[idx];
+    field.offset = offsets[idx];
+    field.datatype = datatype;
+    field.count = 1;
+    cloud.fields.push_back(field);
+  }
+  cloud.data.resize(
+      (static_cast<size_t>(height - 1) * row_step) + (width * point_step), 0u);
+  return cloud;
+}
+
+/// Write the xyz fields of a point as FieldType.
+template<typename FieldType>
+void WritePoint(
+    PointCloud2& cloud, const uint32_t column, const uint32_t row,
+    const FieldType x, const FieldType y, const FieldType z)
+{
+  const FieldType values[3] = {x, y, z};
+  const size_t point_start
+      = (row * cloud.row_step) + (column * cloud.point_step);
+  for (size_t idx = 0; idx < 3; idx++)
+  {
+    std::memcpy(cloud.data.data() + point_start + cloud.fields[idx].offset,
+                &values[idx], sizeof(FieldType));
+  }
+}
+
+/// Check that both the single-point and bulk reads of wrapper match
+/// expected_points, packed as xyz triples.
+void CheckPoints(
+    const NonOwningPointCloud2Wrapper& wrapper,
+    const std::vector<float>& expected_points)
+{
+  ASSERT_EQ(wrapper.Size() * 3, static_cast<int64_t>(expected_points.size()));
+  std::vector<float> bulk_points;
+  wrapper.CopyPointLocationsIntoVectorFloat(bulk_points);
+  for (int64_t point = 0; point < wrapper.Size(); point++)
+  {
+    const Eigen::Vector4d point_location
+        = wrapper.GetPointLocationVector4d(point);
+    const Eigen::Vector4f point_location_float
+        = wrapper.GetPointLocationVector4f(point);
+    for (int64_t axis = 0; axis < 3; axis++)
+    {
+      const float expected
+          = expected_points[static_cast<size_t>((point * 3) + axis)];
+      EXPECT_FLOAT_EQ(static_cast<float>(point_location(axis)), expected);
+      EXPECT_FLOAT_EQ(point_location_float(axis), expected);
+      EXPECT_FLOAT_EQ(
+          bulk_points[static_cast<size_t>((point * 3) + axis)], expected);
+    }
+  }
+}
+
+GTEST_TEST(PointCloud2WrapperTest, Float64FieldsInPaddedRows)
+{
+  // Fields out of order, with padding between points and rows.
+  PointCloud2 cloud = MakeCloud(3, 2, PointField::FLOAT64, 24, 8, 40, 56, 200);
+  std::vector<float> expected_points;
+  for (uint32_t row = 0; row < cloud.height; row++)
+  {
+    for (uint32_t column = 0; column < cloud.width; column++)
+    {
+      const double x = static_cast<double>(column) + 0.25;
+      const double y = static_cast<double>(row) - 1.5;
+      const double z = static_cast<double>(column * row) + 2.0;
+      WritePoint<double>(cloud, column, row, x, y, z);
+      expected_points.insert(
+          expected_points.end(), {static_cast<float>(x),
+                                  static_cast<float>(y),
+                                  static_cast<float>(z)});
+    }
+  }
+  const NonOwningPointCloud2Wrapper wrapper(
+      &cloud, Eigen::Isometry3d::Identity());
+  CheckPoints(wrapper, expected_points);
+}
+
+GTEST_TEST(PointCloud2WrapperTest, IntegerFieldsAreScaled)
+{
+  PointCloud2 cloud = MakeCloud(4, 1, PointField::INT16, 0, 2, 4, 8, 32);
+  std::vector<float> expected_points;
+  for (uint32_t column = 0; column < cloud.width; column++)
+  {
+    const int16_t x = static_cast<int16_t>(column * 250);
+    const int16_t y = static_cast<int16_t>(-1000);
+    const int16_t z = static_cast<int16_t>(1500 + column);
+    WritePoint<int16_t>(cloud, column, 0, x, y, z);
+    expected_points.insert(
+        expected_points.end(), {static_cast<float>(x) * 0.001f,
+                                static_cast<float>(y) * 0.001f,
+                                static_cast<float>(z) * 0.001f});
+  }
+  const NonOwningPointCloud2Wrapper wrapper(
+      &cloud, Eigen::Isometry3d::Identity(), 10.0, 0.001);
+  CheckPoints(wrapper, expected_points);
+}
+
+GTEST_TEST(PointCloud2WrapperTest, PackedFloat32Fields)
+{
+  // Sequential FLOAT32 xyz followed by another field, as from most sensors.
+  PointCloud2 cloud = MakeCloud(2, 3, PointField::FLOAT32, 4, 8, 12, 20, 40);
+  std::vector<float> expected_points;
+  for (uint32_t row = 0; row < cloud.height; row++)
+  {
+    for (uint32_t column = 0; column < cloud.width; column++)
+    {
+      const float x = static_cast<float>(row) + 0.5f;
+      const float y = static_cast<float>(column) * 2.0f;
+      const float z = -static_cast<float>(row + column);
+      WritePoint<float>(cloud, column, row, x, y, z);
+      expected_points.insert(expected_points.end(), {x, y, z});
+    }
+  }
+  const NonOwningPointCloud2Wrapper wrapper(
+      &cloud, Eigen::Isometry3d::Identity());
+  CheckPoints(wrapper, expected_points);
+}
+
+GTEST_TEST(PointCloud2WrapperTest, InvalidLayouts)
+{
+  const Eigen::Isometry3d origin = Eigen::Isometry3d::Identity();
+
+  // Data that ends partway through the last point.
+  PointCloud2 short_cloud
+      = MakeCloud(3, 2, PointField::FLOAT32, 0, 4, 8, 16, 64);
+  short_cloud.data.resize(short_cloud.data.size() - 1);
+  EXPECT_THROW(NonOwningPointCloud2Wrapper(&short_cloud, origin),
+               std::invalid_argument);
+
+  // Packed rows, so only the row_step of the last row can be omitted.
+  PointCloud2 packed_cloud
+      = MakeCloud(3, 2, PointField::FLOAT32, 0, 4, 8, 16, 48);
+  packed_cloud.data.resize(packed_cloud.data.size() - 1);
+  EXPECT_THROW(NonOwningPointCloud2Wrapper(&packed_cloud, origin),
+               std::invalid_argument);
+
+  // Fields that do not fit within point_step.
+  PointCloud2 overlapping_cloud
+      = MakeCloud(2, 1, PointField::FLOAT64, 0, 8, 16, 16, 32);
+  EXPECT_THROW(NonOwningPointCloud2Wrapper(&overlapping_cloud, origin),
+               std::invalid_argument);
+
+  // Multi-byte fields in the other byte order.
+  PointCloud2 swapped_cloud
+      = MakeCloud(2, 1, PointField::FLOAT32, 0, 4, 8, 12, 24);
+  const uint16_t host_order = 0x0102;
+  uint8_t first_byte = 0;
+  std::memcpy(&first_byte, &host_order, sizeof(first_byte));
+  swapped_cloud.is_bigendian = static_cast<uint8_t>(first_byte != 0x01);
+  EXPECT_THROW(NonOwningPointCloud2Wrapper(&swapped_cloud, origin),
+               std::invalid_argument);
+
+  // An empty cloud has no data to check.
+  PointCloud2 empty_cloud
+      = MakeCloud(0, 1, PointField::FLOAT32, 0, 4, 8, 12, 0);
+  EXPECT_NO_THROW(NonOwningPointCloud2Wrapper(&empty_cloud, origin));
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
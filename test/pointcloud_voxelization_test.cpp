@@ -2,6 +2,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -9,6 +10,7 @@
 #include <common_robotics_utilities/math.hpp>
 #include <gtest/gtest.h>
 #include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/cpu_pointcloud_voxelization.hpp>
 #include <voxelized_geometry_tools/pointcloud_voxelization.hpp>
 
 namespace voxelized_geometry_tools
@@ -250,6 +252,77 @@ GTEST_TEST(PointCloudVoxelizationTest, Test)
     check_voxelization(voxelized);
   }
 }
+
+GTEST_TEST(PointCloudVoxelizationTest, CpuVoxelizerMarksOnlyChangedTiles)
+{
+  // 8 cells/axis, unknown except for the filled bottom cells.
+  const Eigen::Isometry3d X_WG(Eigen::Translation3d(-1.0, -1.0, -1.0));
+  const common_robotics_utilities::voxel_grid::GridSizes grid_size(
+      0.25, 2.0, 2.0, 2.0);
+  CollisionMap static_environment(
+      X_WG, "world", grid_size, CollisionCell(0.5f));
+  for (int64_t xidx = 0; xidx < static_environment.GetNumXCells(); xidx++)
+  {
+    for (int64_t yidx = 0; yidx < static_environment.GetNumYCells(); yidx++)
+    {
+      static_environment.SetValue(xidx, yidx, 0, CollisionCell(1.0f));
+    }
+  }
+  const int64_t tile_size = 2;
+  static_environment.EnableDirtyTileTracking(tile_size);
+  static_environment.ClearDirtyTiles();
+
+  // One camera looking along +x at a wall, which leaves the cells behind the
+  // wall, and so some tiles, unchanged.
+  const Eigen::Isometry3d X_CO = Eigen::Translation3d(0.0, 0.0, 0.0) *
+      Eigen::Quaterniond(Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitZ()) *
+                         Eigen::AngleAxisd(-M_PI_2, Eigen::Vector3d::UnitX()));
+  const Eigen::Isometry3d X_WC(Eigen::Translation3d(-2.0, 0.0, 0.0));
+  std::shared_ptr<VectorVector3dPointCloudWrapper> cloud(
+      new VectorVector3dPointCloudWrapper());
+  cloud->SetPointCloudOriginTransform(X_WC * X_CO);
+  for (double x = -2.0; x <= 2.0; x += 0.03125)
+  {
+    for (double y = -2.0; y <= 2.0; y += 0.03125)
+    {
+      cloud->PushBack(Eigen::Vector3d(x, y, 2.125));
+    }
+  }
+  const PointCloudVoxelizationFilterOptions filter_options(1.0, 1, 1);
+
+  const pointcloud_voxelization::CpuPointCloudVoxelizer voxelizer;
+  const CollisionMap voxelized = voxelizer.VoxelizePointClouds(
+      static_environment, 0.5, filter_options, {cloud});
+
+  std::set<std::vector<int64_t>> expected_tiles;
+  for (int64_t xidx = 0; xidx < voxelized.GetNumXCells(); xidx++)
+  {
+    for (int64_t yidx = 0; yidx < voxelized.GetNumYCells(); yidx++)
+    {
+      for (int64_t zidx = 0; zidx < voxelized.GetNumZCells(); zidx++)
+      {
+        if (voxelized.GetImmutable(xidx, yidx, zidx).Value().Occupancy()
+            != static_environment.GetImmutable(xidx, yidx, zidx).Value()
+                   .Occupancy())
+        {
+          expected_tiles.insert(
+              {xidx / tile_size, yidx / tile_size, zidx / tile_size});
+        }
+      }
+    }
+  }
+  std::set<std::vector<int64_t>> dirty_tiles;
+  for (const GridIndexRegion& tile : voxelized.GetDirtyTiles())
+  {
+    dirty_tiles.insert({tile.Lower().X() / tile_size,
+                        tile.Lower().Y() / tile_size,
+                        tile.Lower().Z() / tile_size});
+  }
+  ASSERT_FALSE(expected_tiles.empty());
+  EXPECT_LT(expected_tiles.size(), 64u);
+  EXPECT_EQ(dirty_tiles, expected_tiles);
+  EXPECT_FALSE(static_environment.HasDirtyTiles());
+}
 }  // namespace
 }  // namespace voxelized_geometry_tools
 
@@ -0,0 +1,192 @@
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/grid_index_region.hpp>
+#include <voxelized_geometry_tools/rolling_collision_map.hpp>
+#include <voxelized_geometry_tools/rolling_signed_distance_field.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+/// Component encoding a global (window offset + window index) cell index, so
+/// that cells can be recognized after the window moves.
+uint32_t GlobalCellId(
+    const RollingCollisionMap& map, const GridIndex& window_index)
+{
+  const GridIndex& offset = map.GetWindowOffset();
+  const int64_t x_index = offset.X() + window_index.X();
+  const int64_t y_index = offset.Y() + window_index.Y();
+  const int64_t z_index = offset.Z() + window_index.Z();
+  return static_cast<uint32_t>(
+      1 + ((x_index + 100) * 40000) + ((y_index + 100) * 200)
+      + (z_index + 100));
+}
+
+GTEST_TEST(RollingVoxelGridTest, ShiftExposesOnlyNewCells)
+{
+  const GridSizes sizes(
+      0.5, static_cast<int64_t>(10), static_cast<int64_t>(8),
+      static_cast<int64_t>(6));
+  RollingCollisionMap map(
+      Eigen::Isometry3d::Identity(), "world", sizes, CollisionCell(0.5f));
+  map.ForEachCellInRegion(map.GetWindowRegion(), [&] (
+      const GridIndex& window_index, CollisionCell& cell)
+  {
+    cell = CollisionCell(0.0f, GlobalCellId(map, window_index));
+  });
+
+  const std::vector<GridIndex> shifts = {
+      GridIndex(2, -1, 3), GridIndex(-3, 0, 0), GridIndex(0, 7, -5),
+      GridIndex(1, 1, 1)};
+  for (const GridIndex& shift : shifts)
+  {
+    const std::vector<GridIndexRegion> exposed_regions = map.Shift(shift);
+    // Exposed regions are disjoint, and cover exactly the cells whose global
+    // index was outside the previous window.
+    map.ForEachCellInRegion(map.GetWindowRegion(), [&] (
+        const GridIndex& window_index, const CollisionCell& cell)
+    {
+      int64_t num_containing_regions = 0;
+      for (const GridIndexRegion& exposed_region : exposed_regions)
+      {
+        if (exposed_region.Contains(window_index))
+        {
+          num_containing_regions++;
+        }
+      }
+      const GridIndex previous_index(
+          window_index.X() + shift.X(), window_index.Y() + shift.Y(),
+          window_index.Z() + shift.Z());
+      if (map.IndexInBounds(previous_index))
+      {
+        EXPECT_EQ(num_containing_regions, 0);
+        EXPECT_EQ(cell.Occupancy(), 0.0f);
+        EXPECT_EQ(cell.Component(), GlobalCellId(map, window_index));
+      }
+      else
+      {
+        EXPECT_EQ(num_containing_regions, 1);
+        EXPECT_EQ(cell.Occupancy(), 0.5f);
+      }
+    });
+    // Fill the exposed cells, as a voxelizer would.
+    for (const GridIndexRegion& exposed_region : exposed_regions)
+    {
+      map.ForEachCellInRegion(exposed_region, [&] (
+          const GridIndex& window_index, CollisionCell& cell)
+      {
+        cell = CollisionCell(0.0f, GlobalCellId(map, window_index));
+      });
+    }
+  }
+}
+
+/// Exact distance from the center of every free cell to the nearest filled
+/// cell center in the window, or infinity if there is none.
+std::vector<double> BruteForceFreeDistances(const RollingCollisionMap& map)
+{
+  std::vector<GridIndex> filled_cells;
+  map.ForEachCellInRegion(map.GetWindowRegion(), [&] (
+      const GridIndex& window_index, const CollisionCell& cell)
+  {
+    if (cell.Occupancy() > 0.5f)
+    {
+      filled_cells.push_back(window_index);
+    }
+  });
+  std::vector<double> distances;
+  map.ForEachCellInRegion(map.GetWindowRegion(), [&] (
+      const GridIndex& window_index, const CollisionCell&)
+  {
+    double distance = std::numeric_limits<double>::infinity();
+    for (const GridIndex& filled_cell : filled_cells)
+    {
+      const Eigen::Vector3d offset(
+          static_cast<double>(filled_cell.X() - window_index.X()),
+          static_cast<double>(filled_cell.Y() - window_index.Y()),
+          static_cast<double>(filled_cell.Z() - window_index.Z()));
+      distance = std::min(distance, offset.norm() * map.GetResolution());
+    }
+    distances.push_back(distance);
+  });
+  return distances;
+}
+
+GTEST_TEST(RollingVoxelGridTest, UpdatedDistancesAreLowerBounds)
+{
+  const double resolution = 0.25;
+  const GridSizes sizes(
+      resolution, static_cast<int64_t>(16), static_cast<int64_t>(16),
+      static_cast<int64_t>(16));
+  const CollisionCell free_cell(0.0f);
+  const CollisionCell filled_cell(1.0f);
+  RollingCollisionMap map(
+      Eigen::Isometry3d::Identity(), "world", sizes, free_cell);
+  RollingSignedDistanceField sdf(
+      Eigen::Isometry3d::Identity(), "world", sizes,
+      std::numeric_limits<float>::infinity());
+  map.SetValue(GridIndex(3, 8, 8), filled_cell);
+  sdf.UpdateWindow(map, false);
+
+  // Move diagonally, so the padded exposed slabs overlap, and put an
+  // obstacle into view right at the new edge of the window.
+  const GridIndex shift(2, 2, 0);
+  const std::vector<GridIndexRegion> exposed_regions = map.Shift(shift);
+  sdf.Shift(shift);
+  map.SetValue(GridIndex(15, 6, 8), filled_cell);
+  const int64_t margin_cells = 2;
+  sdf.UpdateRegions(map, exposed_regions, margin_cells, false);
+
+  const std::vector<double> true_distances = BruteForceFreeDistances(map);
+  const double margin_distance
+      = static_cast<double>(margin_cells) * resolution;
+  EXPECT_FLOAT_EQ(sdf.GetDistanceBound(), static_cast<float>(margin_distance));
+  size_t cell_index = 0;
+  size_t num_stored_beyond_margin = 0;
+  sdf.ForEachCellInRegion(sdf.GetWindowRegion(), [&] (
+      const GridIndex& window_index, const float& stored_distance)
+  {
+    const double true_distance = true_distances.at(cell_index);
+    cell_index++;
+    const float distance = sdf.GetDistance(window_index).Value();
+    if (map.GetValueOrOOB(window_index).Occupancy() > 0.5f)
+    {
+      EXPECT_LT(distance, 0.0f);
+      return;
+    }
+    // Distances never overestimate, and are exact within the margin.
+    EXPECT_LE(static_cast<double>(distance), true_distance + 1e-6);
+    if (true_distance <= margin_distance)
+    {
+      EXPECT_NEAR(static_cast<double>(distance), true_distance, 1e-6);
+    }
+    if (static_cast<double>(stored_distance) > margin_distance + 1e-6)
+    {
+      num_stored_beyond_margin++;
+    }
+  });
+  // Cells that were not recomputed keep their stored distances.
+  EXPECT_GT(num_stored_beyond_margin, 0u);
+  EXPECT_FALSE(sdf.GetDistance(GridIndex(16, 0, 0)).HasValue());
+
+  sdf.UpdateWindow(map, false);
+  EXPECT_EQ(sdf.GetDistanceBound(), std::numeric_limits<float>::infinity());
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
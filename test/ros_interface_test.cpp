@@ -0,0 +1,285 @@
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/collision_map.hpp>
+#include <voxelized_geometry_tools/ros_interface.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridIndex;
+using common_robotics_utilities::voxel_grid::GridSizes;
+using ros_interface::ColorRGBA;
+using ros_interface::Marker;
+
+GTEST_TEST(RosInterfaceTest, CompressionRoundTrip)
+{
+  for (const size_t num_bytes : {0u, 1u, 1000u, 1000000u})
+  {
+    // Repetitive, like serialized grids, but not uniform.
+    std::vector<uint8_t> raw_bytes(num_bytes);
+    for (size_t idx = 0; idx < num_bytes; idx++)
+    {
+      raw_bytes[idx] = static_cast<uint8_t>((idx * idx) % 7u);
+    }
+    std::vector<uint8_t> compressed_bytes;
+    ros_interface::CompressBytesInto(raw_bytes, compressed_bytes);
+    std::vector<uint8_t> decompressed_bytes;
+    ros_interface::DecompressBytesInto(compressed_bytes, decompressed_bytes);
+    EXPECT_EQ(decompressed_bytes, raw_bytes);
+  }
+  // Truncated data must not decompress.
+  std::vector<uint8_t> compressed_bytes;
+  ros_interface::CompressBytesInto(
+      std::vector<uint8_t>(1000, 1u), compressed_bytes);
+  compressed_bytes.resize(compressed_bytes.size() / 2);
+  std::vector<uint8_t> decompressed_bytes;
+  EXPECT_THROW(
+      ros_interface::DecompressBytesInto(compressed_bytes, decompressed_bytes),
+      std::runtime_error);
+}
+
+GTEST_TEST(RosInterfaceTest, CollisionMapMessageRoundTrip)
+{
+  const GridSizes sizes(0.25, 2.0, 3.0, 1.5);
+  Eigen::Isometry3d origin_transform = Eigen::Isometry3d::Identity();
+  origin_transform.translation() = Eigen::Vector3d(-1.0, 0.5, 2.0);
+  CollisionMap map(origin_transform, "world", sizes, CollisionCell(0.5f),
+                   CollisionCell(1.0f));
+  for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+      {
+        if ((x_index + y_index + z_index) % 3 == 0)
+        {
+          map.SetValue(x_index, y_index, z_index, CollisionCell(
+              1.0f, static_cast<uint32_t>(x_index + 1)));
+        }
+        else if (y_index > 4)
+        {
+          map.SetValue(x_index, y_index, z_index, CollisionCell(0.0f));
+        }
+      }
+    }
+  }
+  for (const bool compress : {true, false})
+  {
+    const auto message = ros_interface::GetMessageRepresentation(map, compress);
+    EXPECT_EQ(message.is_compressed, compress);
+    EXPECT_EQ(message.header.frame_id, "world");
+    const CollisionMap loaded_map
+        = ros_interface::LoadFromMessageRepresentation(message);
+    EXPECT_EQ(loaded_map.GetFrame(), map.GetFrame());
+    EXPECT_TRUE(loaded_map.GetOriginTransform().isApprox(
+        map.GetOriginTransform()));
+    ASSERT_EQ(loaded_map.GetNumXCells(), map.GetNumXCells());
+    ASSERT_EQ(loaded_map.GetNumYCells(), map.GetNumYCells());
+    ASSERT_EQ(loaded_map.GetNumZCells(), map.GetNumZCells());
+    EXPECT_EQ(loaded_map.GetOOBValue().Occupancy(), 1.0f);
+    for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+    {
+      for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+      {
+        for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+        {
+          const CollisionCell& expected
+              = map.GetImmutable(x_index, y_index, z_index).Value();
+          const CollisionCell& loaded
+              = loaded_map.GetImmutable(x_index, y_index, z_index).Value();
+          EXPECT_EQ(loaded.Occupancy(), expected.Occupancy());
+          EXPECT_EQ(loaded.Component(), expected.Component());
+        }
+      }
+    }
+  }
+}
+
+GTEST_TEST(RosInterfaceTest, ParallelExportMatchesSerial)
+{
+  const GridSizes sizes(
+      0.25, static_cast<int64_t>(7), static_cast<int64_t>(6),
+      static_cast<int64_t>(5));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+      {
+        const int64_t pattern
+            = ((x_index * 5) + (y_index * 3) + z_index) % 4;
+        if (x_index == 3)
+        {
+          continue;
+        }
+        if (pattern == 1)
+        {
+          map.SetValue(x_index, y_index, z_index, CollisionCell(
+              1.0f, static_cast<uint32_t>(z_index + 1)));
+        }
+        else if (pattern == 2)
+        {
+          map.SetValue(x_index, y_index, z_index, CollisionCell(0.5f));
+        }
+      }
+    }
+  }
+  // Free cells are hidden, so x slab 3 has no visible cells.
+  std::atomic<int64_t> num_color_calls(0);
+  const std::function<ColorRGBA(const CollisionCell&, const GridIndex&)>
+      color_fn = [&] (const CollisionCell& cell, const GridIndex& index)
+  {
+    num_color_calls++;
+    ColorRGBA color;
+    color.r = cell.Occupancy();
+    color.g = static_cast<float>(cell.Component()) * 0.1f;
+    color.b = static_cast<float>(index.X()) * 0.01f;
+    color.a = (cell.Occupancy() > 0.0f) ? 1.0f : 0.0f;
+    return color;
+  };
+  const Marker serial_marker
+      = ros_interface::ExportVoxelGridToRViz(map, "world", color_fn);
+  ASSERT_GT(serial_marker.points.size(), 0u);
+  for (const bool use_parallel : {false, true})
+  {
+    num_color_calls = 0;
+    const Marker parallel_marker = ros_interface::ExportVoxelGridToRVizParallel(
+        map, "world", color_fn, use_parallel);
+    EXPECT_EQ(num_color_calls.load(), map.GetTotalCells());
+    EXPECT_EQ(parallel_marker.header.frame_id, serial_marker.header.frame_id);
+    EXPECT_EQ(parallel_marker.type, serial_marker.type);
+    EXPECT_EQ(parallel_marker.scale.x, serial_marker.scale.x);
+    ASSERT_EQ(parallel_marker.points.size(), serial_marker.points.size());
+    ASSERT_EQ(parallel_marker.colors.size(), serial_marker.colors.size());
+    for (size_t idx = 0; idx < serial_marker.points.size(); idx++)
+    {
+      EXPECT_EQ(parallel_marker.points.at(idx).x,
+                serial_marker.points.at(idx).x);
+      EXPECT_EQ(parallel_marker.points.at(idx).y,
+                serial_marker.points.at(idx).y);
+      EXPECT_EQ(parallel_marker.points.at(idx).z,
+                serial_marker.points.at(idx).z);
+      EXPECT_EQ(parallel_marker.colors.at(idx).r,
+                serial_marker.colors.at(idx).r);
+      EXPECT_EQ(parallel_marker.colors.at(idx).g,
+                serial_marker.colors.at(idx).g);
+      EXPECT_EQ(parallel_marker.colors.at(idx).b,
+                serial_marker.colors.at(idx).b);
+      EXPECT_EQ(parallel_marker.colors.at(idx).a,
+                serial_marker.colors.at(idx).a);
+    }
+  }
+}
+
+GTEST_TEST(RosInterfaceTest, LODDisplayRespectsBudgetAndCoversCells)
+{
+  // Sizes that are not powers of two, so coarsened blocks cross the upper
+  // edges of the grid.
+  const double resolution = 0.25;
+  const GridSizes sizes(
+      resolution, static_cast<int64_t>(7), static_cast<int64_t>(6),
+      static_cast<int64_t>(5));
+  CollisionMap map(Eigen::Isometry3d::Identity(), "world", sizes,
+                   CollisionCell(0.0f));
+  for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+      {
+        if (z_index < 2 || x_index == 6)
+        {
+          map.SetValue(x_index, y_index, z_index, CollisionCell(1.0f));
+        }
+        else if ((x_index + y_index + z_index) % 5 == 0)
+        {
+          map.SetValue(x_index, y_index, z_index, CollisionCell(0.5f));
+        }
+      }
+    }
+  }
+  ColorRGBA filled_color;
+  filled_color.r = 1.0f;
+  filled_color.a = 1.0f;
+  ColorRGBA unknown_color;
+  unknown_color.b = 1.0f;
+  unknown_color.a = 1.0f;
+  const ColorRGBA free_color;
+  const Eigen::Vector3d grid_extent(
+      static_cast<double>(map.GetNumXCells()) * resolution,
+      static_cast<double>(map.GetNumYCells()) * resolution,
+      static_cast<double>(map.GetNumZCells()) * resolution);
+  for (const size_t max_voxels : {1u, 4u, 20u, 100u, 1000u})
+  {
+    for (const bool merge_uniform_regions : {false, true})
+    {
+      const auto display_reps = ros_interface::ExportForLODDisplay(
+          map, filled_color, free_color, unknown_color, false,
+          merge_uniform_regions, max_voxels, true);
+      std::vector<Eigen::Vector3d> cube_centers;
+      std::vector<Eigen::Vector3d> cube_sizes;
+      for (const Marker& display_rep : display_reps.markers)
+      {
+        const Eigen::Vector3d cube_size(
+            display_rep.scale.x, display_rep.scale.y, display_rep.scale.z);
+        for (const auto& point : display_rep.points)
+        {
+          const Eigen::Vector3d cube_center(point.x, point.y, point.z);
+          // Cubes stay within the grid.
+          EXPECT_TRUE(((cube_center - (cube_size * 0.5)).array()
+                       >= -1e-9).all());
+          EXPECT_TRUE(((cube_center + (cube_size * 0.5)).array()
+                       <= grid_extent.array() + 1e-9).all());
+          cube_centers.push_back(cube_center);
+          cube_sizes.push_back(cube_size);
+        }
+      }
+      EXPECT_LE(cube_centers.size(), max_voxels);
+      // Every visible (filled or unknown) cell is inside a cube.
+      for (int64_t x_index = 0; x_index < map.GetNumXCells(); x_index++)
+      {
+        for (int64_t y_index = 0; y_index < map.GetNumYCells(); y_index++)
+        {
+          for (int64_t z_index = 0; z_index < map.GetNumZCells(); z_index++)
+          {
+            if (map.GetImmutable(x_index, y_index, z_index).Value()
+                    .Occupancy() < 0.5f)
+            {
+              continue;
+            }
+            const Eigen::Vector3d cell_center
+                = map.GridIndexToLocationInGridFrame(
+                    x_index, y_index, z_index).head<3>();
+            bool covered = false;
+            for (size_t idx = 0; !covered && idx < cube_centers.size(); idx++)
+            {
+              covered = ((cell_center - cube_centers.at(idx)).cwiseAbs()
+                             .array()
+                         < (cube_sizes.at(idx) * 0.5).array()).all();
+            }
+            EXPECT_TRUE(covered) << "cell " << x_index << ", " << y_index
+                                 << ", " << z_index;
+          }
+        }
+      }
+    }
+  }
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Geometry>
+#include <common_robotics_utilities/voxel_grid.hpp>
+#include <gtest/gtest.h>
+#include <voxelized_geometry_tools/signed_distance_field.hpp>
+
+namespace voxelized_geometry_tools
+{
+namespace
+{
+using common_robotics_utilities::voxel_grid::GridSizes;
+
+/// SDF with a rotated and translated origin, and varied (not necessarily
+/// metric) distances, so interpolation errors are not hidden by symmetry.
+SignedDistanceField<std::vector<float>> MakeTestSDF()
+{
+  Eigen::Isometry3d origin_transform = Eigen::Isometry3d::Identity();
+  origin_transform.translation() = Eigen::Vector3d(-0.42, 0.17, -0.31);
+  origin_transform.linear()
+      = Eigen::AngleAxisd(0.53, Eigen::Vector3d(0.3, -0.5, 0.8).normalized())
+          .toRotationMatrix();
+  const GridSizes sizes(
+      0.2, static_cast<int64_t>(8), static_cast<int64_t>(7),
+      static_cast<int64_t>(6));
+  SignedDistanceField<std::vector<float>> sdf(
+      origin_transform, "world", sizes, 0.0f);
+  for (int64_t x_index = 0; x_index < sdf.GetNumXCells(); x_index++)
+  {
+    for (int64_t y_index = 0; y_index < sdf.GetNumYCells(); y_index++)
+    {
+      for (int64_t z_index = 0; z_index < sdf.GetNumZCells(); z_index++)
+      {
+        const double value
+            = std::sin(static_cast<double>(x_index) * 0.7)
+              + std::cos(static_cast<double>(y_index) * 0.4)
+              - (static_cast<double>(z_index) * 0.13);
+        sdf.SetValue(x_index, y_index, z_index, static_cast<float>(value));
+      }
+    }
+  }
+  return sdf;
+}
+
+GTEST_TEST(SignedDistanceFieldTest, EstimateDistancesAtPoseMatchesPerPoint)
+{
+  const SignedDistanceField<std::vector<float>> sdf = MakeTestSDF();
+  Eigen::Isometry3d object_pose = Eigen::Isometry3d::Identity();
+  object_pose.translation() = Eigen::Vector3d(0.61, -0.28, 0.44);
+  object_pose.linear()
+      = Eigen::AngleAxisd(-0.87, Eigen::Vector3d(0.6, 0.7, -0.2).normalized())
+          .toRotationMatrix();
+  // A lattice of points around the posed grid, many of them outside it.
+  std::vector<Eigen::Vector3d> points;
+  for (int32_t x_step = -4; x_step <= 14; x_step++)
+  {
+    for (int32_t y_step = -4; y_step <= 14; y_step++)
+    {
+      for (int32_t z_step = -4; z_step <= 14; z_step++)
+      {
+        points.push_back(object_pose * (
+            Eigen::Vector3d(static_cast<double>(x_step) * 0.113,
+                            static_cast<double>(y_step) * 0.097,
+                            static_cast<double>(z_step) * 0.089)
+            + Eigen::Vector3d(-0.5, 0.0, -0.4)));
+      }
+    }
+  }
+  Eigen::Matrix3Xd locations(3, static_cast<int64_t>(points.size()));
+  for (size_t idx = 0; idx < points.size(); idx++)
+  {
+    locations.col(static_cast<int64_t>(idx)) = points[idx];
+  }
+  const Eigen::Isometry3d inverse_object_pose = object_pose.inverse();
+  for (const bool use_parallel : {false, true})
+  {
+    const std::vector<EstimateDistanceQuery> distances
+        = sdf.EstimateDistancesAtPose(object_pose, locations, use_parallel);
+    ASSERT_EQ(distances.size(), points.size());
+    int64_t num_in_bounds = 0;
+    int64_t num_out_of_bounds = 0;
+    for (size_t idx = 0; idx < points.size(); idx++)
+    {
+      const Eigen::Vector3d object_frame_point
+          = inverse_object_pose * points[idx];
+      const EstimateDistanceQuery expected
+          = sdf.EstimateDistance3d(object_frame_point);
+      ASSERT_EQ(static_cast<bool>(distances[idx]),
+                static_cast<bool>(expected)) << "point " << idx;
+      if (expected)
+      {
+        EXPECT_NEAR(distances[idx].Value(), expected.Value(), 1e-9);
+        num_in_bounds++;
+      }
+      else
+      {
+        num_out_of_bounds++;
+      }
+    }
+    EXPECT_GT(num_in_bounds, 100);
+    EXPECT_GT(num_out_of_bounds, 100);
+  }
+
+  // Points outside the grid return empty queries.
+  Eigen::Matrix3Xd outside_locations(3, 2);
+  outside_locations.col(0) = object_pose * (
+      sdf.GetOriginTransform() * Eigen::Vector3d(-0.01, 0.5, 0.5));
+  outside_locations.col(1) = object_pose * (
+      sdf.GetOriginTransform() * Eigen::Vector3d(0.5, 0.5, 1.21));
+  for (const EstimateDistanceQuery& distance
+           : sdf.EstimateDistancesAtPose(object_pose, outside_locations, false))
+  {
+    EXPECT_FALSE(distance);
+  }
+
+  // EstimateDistances() is the identity pose case.
+  const std::vector<EstimateDistanceQuery> identity_distances
+      = sdf.EstimateDistances(locations, false);
+  for (size_t idx = 0; idx < points.size(); idx++)
+  {
+    const EstimateDistanceQuery expected = sdf.EstimateDistance3d(points[idx]);
+    ASSERT_EQ(static_cast<bool>(identity_distances[idx]),
+              static_cast<bool>(expected));
+    if (expected)
+    {
+      EXPECT_NEAR(identity_distances[idx].Value(), expected.Value(), 1e-9);
+    }
+  }
+  EXPECT_TRUE(
+      sdf.EstimateDistances(Eigen::Matrix3Xd(3, 0), false).empty());
+}
+}  // namespace
+}  // namespace voxelized_geometry_tools
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}